@@ -7,37 +7,38 @@
 #include <fstream>
 #include <iostream>
 #include <set>
+#include <sstream>
+#include <stdexcept>
 #include <string>
+#include "3rdparty/json.hpp"
 #include "loom/config/ConfigReader.cpp"
 #include "loom/config/LoomConfig.h"
+#include "loom/optim/BranchBoundOptimizer.h"
 #include "loom/optim/CombOptimizer.h"
 #include "loom/optim/GreedyOptimizer.h"
 #include "loom/optim/ILPEdgeOrderOptimizer.h"
+#include "shared/linegraph/BinGraph.h"
 #include "shared/rendergraph/Penalties.h"
 #include "shared/rendergraph/RenderGraph.h"
+#include "util/Misc.h"
 #include "util/geo/PolyLine.h"
 #include "util/geo/output/GeoGraphJsonOutput.h"
+#include "util/http/Server.h"
 #include "util/log/Log.h"
 
 using namespace loom;
 
 // _____________________________________________________________________________
-int main(int argc, char** argv) {
-  // initialize randomness
-  srand(time(NULL) + rand());
-
-  config::Config cfg;
-
-  config::ConfigReader cr;
-  cr.read(&cfg, argc, argv);
-
+void optimize(const config::Config& cfg, std::istream* in, std::ostream* os) {
   LOGTO(DEBUG, std::cerr) << "Reading graph...";
   shared::rendergraph::RenderGraph g(5, 5);
 
   if (cfg.fromDot) {
-    g.readFromDot(&std::cin, 3);
+    g.readFromDot(in, 3);
+  } else if (cfg.fromBin) {
+    g.readFromBin(in, 3);
   } else {
-    g.readFromJson(&std::cin, 3);
+    g.readFromJson(in, 3);
   }
 
   LOGTO(DEBUG, std::cerr) << "Optimizing...";
@@ -75,6 +76,9 @@ int main(int argc, char** argv) {
   } else if (cfg.optimMethod == "exhaust") {
     optim::ExhaustiveOptimizer exhausOptim(&cfg, pens);
     stats = exhausOptim.optimize(&g);
+  } else if (cfg.optimMethod == "bnb") {
+    optim::BranchBoundOptimizer bnbOptim(&cfg, pens);
+    stats = bnbOptim.optimize(&g);
   } else if (cfg.optimMethod == "hillc") {
     optim::HillClimbOptimizer hillcOptim(&cfg, pens, false);
     stats = hillcOptim.optimize(&g);
@@ -97,14 +101,15 @@ int main(int argc, char** argv) {
     optim::NullOptimizer nullOptim(&cfg, pens);
     stats = nullOptim.optimize(&g);
   } else {
-    LOG(ERROR) << "Unknown optimization method " << cfg.optimMethod
-               << std::endl;
-    exit(1);
+    throw std::runtime_error("Unknown optimization method " +
+                             cfg.optimMethod);
   }
 
   util::geo::output::GeoGraphJsonOutput out;
 
-  if (cfg.outputStats) {
+  if (cfg.toBin) {
+    shared::linegraph::BinGraphWriter().print(g, *os);
+  } else if (cfg.outputStats) {
     util::json::Dict jsonStats = {
         {"statistics",
          util::json::Dict{
@@ -131,6 +136,13 @@ int main(int argc, char** argv) {
              {"runs", stats.runs},
              {"max_num_cols_in_comp", stats.maxNumColsPerComp},
              {"max_num_rows_in_comp", stats.maxNumRowsPerComp},
+             {"ilp_cache_hits", stats.ilpCacheHits},
+             {"ilp_cache_near_hits", stats.ilpCacheNearHits},
+             {"ilp_cache_misses", stats.ilpCacheMisses},
+             {"num_search_nodes", stats.numSearchNds},
+             {"multi_start_scores",
+              std::vector<util::json::Val>(stats.multiStartScores.begin(),
+                                           stats.multiStartScores.end())},
              {"avg_solve_time", stats.avgSolveTime},
              {"avg_score", stats.avgScore},
              {"avg_num_same_seg_crossings", stats.avgSameSegCross},
@@ -142,9 +154,78 @@ int main(int argc, char** argv) {
              {"best_num_separations", stats.separations},
              {"line_graph_simplification_time", stats.simplificationTime},
              {"best_score", stats.score}}}};
-    out.print(g, std::cout, jsonStats);
+    out.print(g, *os, jsonStats);
   } else {
-    out.print(g, std::cout);
+    out.print(g, *os);
+  }
+}
+
+// _____________________________________________________________________________
+class LoomHandler : public util::http::Handler {
+ public:
+  explicit LoomHandler(const config::Config* cfg) : _cfg(cfg) {}
+
+  util::http::Answer handle(const util::http::Req& req, int con) const {
+    UNUSED(con);
+    if (req.cmd != "POST") throw util::http::HttpErr("405 Method Not Allowed");
+
+    std::stringstream in(req.payload);
+    std::stringstream out;
+
+    // the optimizers may not run longer than the request timeout
+    config::Config cfg(*_cfg);
+    if (cfg.serveTimeout) {
+      int lim = cfg.serveTimeout;
+      if (cfg.ilpTimeLimit < 0 || cfg.ilpTimeLimit > lim)
+        cfg.ilpTimeLimit = lim;
+      if (cfg.bnbTimeLimit < 0 || cfg.bnbTimeLimit > lim)
+        cfg.bnbTimeLimit = lim;
+      if (cfg.multiStartTimeLimit < 0 || cfg.multiStartTimeLimit > lim)
+        cfg.multiStartTimeLimit = lim;
+    }
+
+    try {
+      optimize(cfg, &in, &out);
+    } catch (const nlohmann::json::exception& exc) {
+      return util::http::Answer("400 Bad Request", exc.what());
+    } catch (const std::runtime_error& exc) {
+      // thrown on malformed binary graphs
+      return util::http::Answer("400 Bad Request", exc.what());
+    }
+
+    util::http::Answer answ("200 OK", out.str());
+    answ.params["Content-Type"] = "application/json";
+    return answ;
+  }
+
+ private:
+  const config::Config* _cfg;
+};
+
+// _____________________________________________________________________________
+int main(int argc, char** argv) {
+  // initialize randomness
+  srand(time(NULL) + rand());
+
+  config::Config cfg;
+
+  config::ConfigReader cr;
+  cr.read(&cfg, argc, argv);
+
+  try {
+    if (cfg.servePort > -1) {
+      LOGTO(INFO, std::cerr) << "Listening on port " << cfg.servePort
+                             << "...";
+      LoomHandler h(&cfg);
+      util::http::HttpServer serv(cfg.servePort, &h, cfg.serveThreads,
+                                  cfg.serveTimeout);
+      serv.run();
+    } else {
+      optimize(cfg, &std::cin, &std::cout);
+    }
+  } catch (const std::runtime_error& err) {
+    LOG(ERROR) << err.what();
+    exit(1);
   }
 
   return (0);
@@ -46,9 +46,11 @@ void ConfigReader::help(const char* bin) const {
             << std::setw(41) << "  -m [ --optim-method ] arg (=comb)"
             << "Optimization method, one of ilp-naive, ilp,\n"
             << std::setw(41) << " "
-            << " comb, exhaust, hillc, hillc-random, anneal,\n"
+            << " comb, exhaust, bnb, hillc, hillc-random,\n"
             << std::setw(41) << " "
-            << " anneal-random, greedy, greedy-lookahead, null\n"
+            << " anneal, anneal-random, greedy,\n"
+            << std::setw(41) << " "
+            << " greedy-lookahead, null\n"
             << std::setw(41) << "  --same-seg-cross-pen arg (=4)"
             << "Penalty for same-segment crossings\n"
             << std::setw(41) << "  --diff-seg-cross-pen arg (=1)"
@@ -64,6 +66,10 @@ void ConfigReader::help(const char* bin) const {
             << "Misc:\n"
             << std::setw(41) << "  -D [ --from-dot ]"
             << "input is in dot format\n"
+            << std::setw(41) << "  --from-bin"
+            << "input is in binary line graph format\n"
+            << std::setw(41) << "  --to-bin"
+            << "write output in binary line graph format\n"
             << std::setw(41) << "  --output-stats"
             << "Print stats to output\n"
             << std::setw(41) << "  --ilp-solver arg (=gurobi)"
@@ -74,12 +80,55 @@ void ConfigReader::help(const char* bin) const {
             << "Number of threads to use by ILP solver,\n"
             << std::setw(41) << " "
             << " 0 means solver default\n"
+            << std::setw(41) << "  --threads arg (=0)"
+            << "Number of threads used for optimizing\n"
+            << std::setw(41) << " "
+            << " components, 0 means number of available\n"
+            << std::setw(41) << " "
+            << " processors\n"
             << std::setw(41) << "  --ilp-time-limit arg (=-1)"
             << "ILP solve time limit (seconds), -1 for infinite\n"
+            << std::setw(41) << "  --ilp-cache-dir arg"
+            << "Directory to cache ILP solutions of components\n"
+            << std::setw(41) << " "
+            << " in, disabled if empty\n"
+            << std::setw(41) << "  --bnb-time-limit arg (=60)"
+            << "Branch-and-bound time limit per component\n"
+            << std::setw(41) << " "
+            << " (seconds), -1 for infinite\n"
+            << std::setw(41) << "  --multi-starts arg (=1)"
+            << "Number of trajectories per component for\n"
+            << std::setw(41) << " "
+            << " hillc and anneal\n"
+            << std::setw(41) << "  --multi-start-threads arg (=0)"
+            << "Number of threads used for the trajectories,\n"
+            << std::setw(41) << " "
+            << " 0 means number of available processors\n"
+            << std::setw(41) << "  --multi-start-time-limit arg (=-1)"
+            << "Time limit for the trajectories of a\n"
+            << std::setw(41) << " "
+            << " component (seconds), -1 for infinite\n"
+            << std::setw(41) << "  --exchange-interval arg (=0)"
+            << "Exchange solutions between trajectories every\n"
+            << std::setw(41) << " "
+            << " arg steps, 0 to disable\n"
+            << std::setw(41) << "  --seed arg (=0)"
+            << "Random seed for the trajectories\n"
             << std::setw(41) << "  --dbg-output-path arg (=.)"
             << "Path used for debug output\n"
             << std::setw(41) << "  --output-optgraph"
-            << "Output optimization graph to debug path\n";
+            << "Output optimization graph to debug path\n\n"
+            << "Server:\n"
+            << std::setw(41) << "  --serve arg"
+            << "Run as HTTP server on port arg, input graphs\n"
+            << std::setw(41) << " "
+            << " are read from POST requests\n"
+            << std::setw(41) << "  --serve-threads arg (=1)"
+            << "Max number of requests handled in parallel\n"
+            << std::setw(41) << "  --serve-timeout arg (=60)"
+            << "Socket read/write timeout (seconds), also\n"
+            << std::setw(41) << " "
+            << " caps the optimization time limits, 0 to disable\n";
 }
 
 // _____________________________________________________________________________
@@ -104,6 +153,19 @@ void ConfigReader::read(Config* cfg, int argc, char** argv) const {
       {"optim-runs", required_argument, 0, 13},
       {"dbg-output-path", required_argument, 0, 14},
       {"output-optgraph", required_argument, 0, 15},
+      {"serve", required_argument, 0, 16},
+      {"serve-threads", required_argument, 0, 17},
+      {"serve-timeout", required_argument, 0, 18},
+      {"threads", required_argument, 0, 19},
+      {"ilp-cache-dir", required_argument, 0, 20},
+      {"bnb-time-limit", required_argument, 0, 21},
+      {"multi-starts", required_argument, 0, 22},
+      {"multi-start-threads", required_argument, 0, 23},
+      {"multi-start-time-limit", required_argument, 0, 24},
+      {"exchange-interval", required_argument, 0, 25},
+      {"from-bin", no_argument, 0, 26},
+      {"to-bin", no_argument, 0, 27},
+      {"seed", required_argument, 0, 28},
       {0, 0, 0, 0}};
 
   char c;
@@ -163,6 +225,45 @@ void ConfigReader::read(Config* cfg, int argc, char** argv) const {
       case 15:
         cfg->outOptGraph = true;
         break;
+      case 16:
+        cfg->servePort = atoi(optarg);
+        break;
+      case 17:
+        cfg->serveThreads = atoi(optarg);
+        break;
+      case 18:
+        cfg->serveTimeout = atoi(optarg);
+        break;
+      case 19:
+        cfg->numThreads = atoi(optarg);
+        break;
+      case 20:
+        cfg->ilpCacheDir = optarg;
+        break;
+      case 21:
+        cfg->bnbTimeLimit = atoi(optarg);
+        break;
+      case 22:
+        cfg->multiStarts = atoi(optarg);
+        break;
+      case 23:
+        cfg->multiStartThreads = atoi(optarg);
+        break;
+      case 24:
+        cfg->multiStartTimeLimit = atof(optarg);
+        break;
+      case 25:
+        cfg->exchangeInterval = atoi(optarg);
+        break;
+      case 26:
+        cfg->fromBin = true;
+        break;
+      case 27:
+        cfg->toBin = true;
+        break;
+      case 28:
+        cfg->seed = atol(optarg);
+        break;
       case 'D':
         cfg->fromDot = true;
         break;
@@ -27,9 +27,26 @@ struct Config {
 
   bool untangleGraph = true;
   bool fromDot = false;
+  bool fromBin = false;
+  bool toBin = false;
 
   int ilpTimeLimit = -1;
   int ilpNumThreads = 0;
+  std::string ilpCacheDir;
+
+  int bnbTimeLimit = 60;
+
+  // independent trajectories per component for hill climbing and simulated
+  // annealing
+  size_t multiStarts = 1;
+  size_t multiStartThreads = 0;
+  double multiStartTimeLimit = -1;
+  size_t exchangeInterval = 0;
+
+  // seed of the trajectories' random number generators
+  size_t seed = 0;
+
+  size_t numThreads = 0;
 
   double crossPenMultiSameSeg = 4;
   double crossPenMultiDiffSeg = 1;
@@ -40,6 +57,10 @@ struct Config {
 
   std::string worldFilePath;
 
+  int servePort = -1;
+  size_t serveThreads = 1;
+  size_t serveTimeout = 60;
+
   std::string ilpSolver;
 };
 
@@ -0,0 +1,379 @@
+// Copyright 2016, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+// Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <map>
+#include <sstream>
+#include <string>
+#include "loom/optim/BranchBoundOptimizer.h"
+#include "loom/optim/HillClimbOptimizer.h"
+#include "shared/linegraph/Line.h"
+#include "util/log/Log.h"
+
+using namespace loom;
+using namespace optim;
+using loom::optim::BranchBoundOptimizer;
+using shared::linegraph::LineEdge;
+using shared::rendergraph::HierarOrderCfg;
+
+namespace {
+// _____________________________________________________________________________
+bool connects(const OptNode* n, const OptLO& a, const OptLO& b,
+              const LineEdge* adjA, const LineEdge* adjB) {
+  // same condition as in OptGraphScorer::getNumCrossDiffSeg()
+  return (a.dir == 0 || b.dir == 0 ||
+          (a.dir == n->pl().node && b.dir != n->pl().node) ||
+          (a.dir != n->pl().node && b.dir == n->pl().node)) &&
+         n->pl().node->pl().connOccurs(a.line, adjA, adjB);
+}
+}  // namespace
+
+// _____________________________________________________________________________
+double BranchBoundOptimizer::optimizeComp(OptGraph* og,
+                                          const std::set<OptNode*>& g,
+                                          HierarOrderCfg* hc, size_t depth,
+                                          OptResStats& stats) const {
+  UNUSED(og);
+  LOGTO(DEBUG, std::cerr) << prefix(depth)
+                          << "(BranchBoundOptimizer) Optimizing component with "
+                          << g.size() << " nodes.";
+
+  T_START(1);
+
+  Search s;
+
+  // the hill climbing ordering is the first upper bound
+  HillClimbOptimizer hillc(_cfg, _scorer.getPens(), false);
+  hillc.getFlatConfig(g, &s.best);
+  s.bestScore = _optScorer.getTotalScore(g, s.best);
+
+  // the search enumerates permutations from the sorted ordering on
+  initialConfig(g, &s.cur, true);
+  initSearch(g, &s);
+
+  double bound = 0;
+  for (double b : s.lowBnd) bound += b;
+
+  LOGTO(DEBUG, std::cerr) << prefix(depth) << "Starting from score "
+                          << s.bestScore << ", lower bound " << bound;
+
+  if (bound < s.bestScore) search(&s, 0, 0, bound);
+
+  assert(std::fabs(s.bestScore - _optScorer.getTotalScore(g, s.best)) < 1e-6);
+
+  if (s.timedOut) {
+    LOG(WARN) << "Branch-and-bound search hit the time limit of "
+              << _cfg->bnbTimeLimit << " s, ordering may not be optimal";
+  }
+
+  double t = T_STOP(1);
+
+  LOGTO(DEBUG, std::cerr) << prefix(depth) << "Found score " << s.bestScore
+                          << " after " << s.nds << " search nodes ("
+                          << (s.nds / (t / 1000)) << " nodes/s)";
+
+  stats.numSearchNds += s.nds;
+
+  writeHierarch(s.best, hc);
+
+  return t;
+}
+
+// _____________________________________________________________________________
+void BranchBoundOptimizer::initSearch(const std::set<OptNode*>& g,
+                                      Search* s) const {
+  size_t numEdgs = s->cur.numEdgs();
+
+  // edges are fixed in an order which completes nodes early: next is the
+  // edge with the most fixed neighbors, ties are broken by cardinality
+  s->order.clear();
+  s->lvl.assign(numEdgs, OptOrderCfg::NPOS);
+  std::vector<size_t> numFixedAdj(numEdgs, 0);
+
+  while (s->order.size() < numEdgs) {
+    size_t next = OptOrderCfg::NPOS;
+    for (size_t eid = 0; eid < numEdgs; eid++) {
+      if (s->lvl[eid] != OptOrderCfg::NPOS) continue;
+      if (next == OptOrderCfg::NPOS || numFixedAdj[eid] > numFixedAdj[next] ||
+          (numFixedAdj[eid] == numFixedAdj[next] &&
+           s->cur.size(eid) > s->cur.size(next))) {
+        next = eid;
+      }
+    }
+
+    s->lvl[next] = s->order.size();
+    s->order.push_back(next);
+
+    auto e = s->cur.getEdg(next);
+    for (auto nd : {e->getFrom(), e->getTo()}) {
+      for (auto f : nd->getAdjList()) numFixedAdj[s->cur.id(f)]++;
+    }
+  }
+
+  s->pairs.assign(numEdgs, {});
+  size_t id = 0;
+
+  for (size_t eid = 0; eid < numEdgs; eid++) {
+    auto e = s->cur.getEdg(eid);
+    for (auto nd : {e->getFrom(), e->getTo()}) {
+      if (!nd->pl().node) continue;
+
+      double crossPen = _optScorer.getCrossingPenSameSeg(nd);
+      double sepPen = _optScorer.getSeparationPen(nd);
+      if (crossPen == 0 && sepPen == 0) continue;
+
+      for (auto f : nd->getAdjList()) {
+        size_t other = s->cur.id(f);
+        if (f == e || s->lvl[other] > s->lvl[eid]) continue;
+        s->pairs[eid].push_back({nd, other, id++, crossPen, sepPen});
+      }
+    }
+  }
+
+  s->perm.assign(numEdgs, 0);
+  s->memo.clear();
+  s->nds = 0;
+  s->timedOut = false;
+  s->limited = _cfg->bnbTimeLimit >= 0;
+  s->deadline = std::chrono::steady_clock::now() +
+                std::chrono::seconds(std::max(_cfg->bnbTimeLimit, 0));
+
+  initDiffPens(s);
+  initSymmetries(g, s);
+}
+
+// _____________________________________________________________________________
+void BranchBoundOptimizer::initDiffPens(Search* s) const {
+  const auto& c = s->cur;
+
+  s->diffPens.assign(c.numEdgs(), {});
+  s->lowBnd.assign(c.numEdgs(), 0);
+
+  for (size_t a = 0; a < c.numEdgs(); a++) {
+    auto ea = c.getEdg(a);
+    size_t k = c.size(a);
+    std::vector<double> pens(k * k, 0);
+    bool any = false;
+
+    for (auto nd : {ea->getFrom(), ea->getTo()}) {
+      if (!nd->pl().node || nd->getDeg() < 3) continue;
+
+      double pen = _optScorer.getCrossingPenDiffSeg(nd);
+      if (pen == 0) continue;
+
+      bool revA = (ea->getFrom() != nd) ^ ea->pl().lnEdgParts.front().dir;
+      const auto* adjA = OptGraph::getAdjEdg(ea, nd);
+
+      // the lines of ea, grouped by the edge they continue on, in clockwise
+      // order. lines continuing on different edges must appear in this order
+      // on ea, otherwise they cross.
+      std::vector<std::vector<size_t>> groups;
+      for (const auto& eb : OptGraph::clockwEdges(ea, nd)) {
+        size_t b = c.id(eb);
+        const auto* adjB = OptGraph::getAdjEdg(eb, nd);
+
+        groups.push_back({});
+        for (size_t kb = 0; kb < c.size(b); kb++) {
+          size_t ka = c.find(a, c.lineId(b, kb));
+          if (ka == OptOrderCfg::NPOS) continue;
+          if (connects(nd, c.lineOcc(a, ka), c.lineOcc(b, kb), adjA, adjB)) {
+            groups.back().push_back(ka);
+          }
+        }
+      }
+
+      for (size_t i = 0; i < groups.size(); i++) {
+        for (size_t j = i + 1; j < groups.size(); j++) {
+          for (size_t ki : groups[i]) {
+            for (size_t kj : groups[j]) {
+              if (ki == kj) continue;
+              if (revA) {
+                pens[ki * k + kj] += pen;
+              } else {
+                pens[kj * k + ki] += pen;
+              }
+              any = true;
+            }
+          }
+        }
+      }
+    }
+
+    if (!any) continue;
+
+    for (size_t i = 0; i < k; i++) {
+      for (size_t j = i + 1; j < k; j++) {
+        s->lowBnd[a] += std::min(pens[i * k + j], pens[j * k + i]);
+      }
+    }
+
+    s->diffPens[a] = pens;
+  }
+}
+
+// _____________________________________________________________________________
+void BranchBoundOptimizer::initSymmetries(const std::set<OptNode*>& g,
+                                          Search* s) const {
+  const auto& c = s->cur;
+
+  s->symm.assign(c.numEdgs(), {});
+
+  size_t numLines = 0;
+  for (size_t eid = 0; eid < c.numEdgs(); eid++) {
+    for (size_t k = 0; k < c.size(eid); k++) {
+      numLines = std::max(numLines, c.lineId(eid, k) + 1);
+    }
+  }
+
+  // two lines are equivalent if they occur on the same edges in the same
+  // directions and continue in the same way at every node. swapping them
+  // everywhere does not change the score, so on the first edge they are
+  // fixed on, only one of their relative orderings has to be searched.
+  std::vector<std::string> sigs(numLines);
+
+  for (size_t eid = 0; eid < c.numEdgs(); eid++) {
+    for (size_t k = 0; k < c.size(eid); k++) {
+      std::stringstream ss;
+      ss << "e" << eid << ":" << c.lineOcc(eid, k).dir << ";";
+      sigs[c.lineId(eid, k)] += ss.str();
+    }
+  }
+
+  for (auto nd : g) {
+    if (!nd->pl().node) continue;
+    for (auto ea : nd->getAdjList()) {
+      size_t a = c.id(ea);
+      const auto* adjA = OptGraph::getAdjEdg(ea, nd);
+      for (auto eb : nd->getAdjList()) {
+        if (ea == eb) continue;
+        size_t b = c.id(eb);
+        const auto* adjB = OptGraph::getAdjEdg(eb, nd);
+        for (size_t k = 0; k < c.size(a); k++) {
+          size_t lid = c.lineId(a, k);
+          if (c.find(b, lid) == OptOrderCfg::NPOS) continue;
+          std::stringstream ss;
+          ss << "n" << nd << ":" << a << "," << b << ":"
+             << nd->pl().node->pl().connOccurs(c.lineOcc(a, k).line, adjA,
+                                               adjB)
+             << ";";
+          sigs[lid] += ss.str();
+        }
+      }
+    }
+  }
+
+  std::map<std::string, std::vector<size_t>> classes;
+  for (size_t lid = 0; lid < numLines; lid++) classes[sigs[lid]].push_back(lid);
+
+  for (const auto& cl : classes) {
+    if (cl.second.size() < 2) continue;
+
+    for (size_t eid : s->order) {
+      if (c.find(eid, cl.second.front()) == OptOrderCfg::NPOS) continue;
+
+      std::vector<size_t> chain;
+      for (size_t lid : cl.second) chain.push_back(c.find(eid, lid));
+      s->symm[eid].push_back(chain);
+      break;
+    }
+  }
+}
+
+// _____________________________________________________________________________
+void BranchBoundOptimizer::search(Search* s, size_t lvl, double score,
+                                  double bound) const {
+  if (lvl == s->order.size()) {
+    if (score < s->bestScore) {
+      s->bestScore = score;
+      s->best = s->cur;
+    }
+    return;
+  }
+
+  size_t eid = s->order[lvl];
+  bound -= s->lowBnd[eid];
+
+  // the ordering of eid is sorted here, and is sorted again after the last
+  // permutation
+  s->perm[eid] = 0;
+
+  do {
+    if (++s->nds % 1024 == 0 && s->limited &&
+        std::chrono::steady_clock::now() > s->deadline) {
+      s->timedOut = true;
+    }
+    if (s->timedOut) return;
+
+    if (!isCanonical(*s, eid)) continue;
+
+    double cur = score + getEdgeScore(s, eid);
+    if (cur + bound >= s->bestScore) continue;
+
+    search(s, lvl + 1, cur, bound);
+
+    if (s->timedOut || s->bestScore == 0) return;
+  } while (++s->perm[eid], s->cur.nextPermutation(eid));
+}
+
+// _____________________________________________________________________________
+double BranchBoundOptimizer::getEdgeScore(Search* s, size_t eid) const {
+  double ret = 0;
+
+  const auto& pens = s->diffPens[eid];
+  if (pens.size()) {
+    size_t k = s->cur.size(eid);
+    for (size_t p = 0; p < k; p++) {
+      size_t kp = s->cur.at(eid, p);
+      for (size_t q = p + 1; q < k; q++) ret += pens[kp * k + s->cur.at(eid, q)];
+    }
+  }
+
+  for (const auto& t : s->pairs[eid]) ret += getPairScore(s, eid, t);
+
+  return ret;
+}
+
+// _____________________________________________________________________________
+double BranchBoundOptimizer::getPairScore(Search* s, size_t eid,
+                                          const PairTerm& t) const {
+  // permutations are numbered in the order they are enumerated, so the
+  // permutation indices identify both orderings
+  uint64_t pa = s->perm[eid];
+  uint64_t pb = s->perm[t.other];
+  bool memo = pa < (1 << 20) && pb < (1 << 20) && t.id < (1 << 23);
+  uint64_t key = (static_cast<uint64_t>(t.id) << 40) | (pa << 20) | pb;
+
+  if (memo) {
+    auto i = s->memo.find(key);
+    if (i != s->memo.end()) return i->second;
+  }
+
+  auto ea = s->cur.getEdg(eid);
+  auto eb = s->cur.getEdg(t.other);
+
+  auto ab = _optScorer.getNumCrossSeps(t.nd, ea, eb, s->cur);
+  double ret = ab.first.first * t.crossPen + ab.second * t.sepPen;
+  if (t.sepPen > 0) {
+    ret += _optScorer.getNumCrossSeps(t.nd, eb, ea, s->cur).second * t.sepPen;
+  }
+
+  if (memo) {
+    if (s->memo.size() > (1 << 22)) s->memo.clear();
+    s->memo[key] = ret;
+  }
+
+  return ret;
+}
+
+// _____________________________________________________________________________
+bool BranchBoundOptimizer::isCanonical(const Search& s, size_t eid) const {
+  for (const auto& chain : s.symm[eid]) {
+    for (size_t i = 1; i < chain.size(); i++) {
+      if (s.cur.pos(eid, chain[i - 1]) > s.cur.pos(eid, chain[i])) return false;
+    }
+  }
+  return true;
+}
@@ -0,0 +1,96 @@
+// Copyright 2016, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+// Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
+
+#ifndef LOOM_OPTIM_BRANCHBOUNDOPTIMIZER_H_
+#define LOOM_OPTIM_BRANCHBOUNDOPTIMIZER_H_
+
+#include <chrono>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "loom/config/LoomConfig.h"
+#include "loom/optim/ExhaustiveOptimizer.h"
+#include "loom/optim/OptGraph.h"
+#include "loom/optim/OptOrderCfg.h"
+#include "shared/rendergraph/OrderCfg.h"
+
+namespace loom {
+namespace optim {
+
+// Exact optimizer which does not need an ILP solver.
+//
+// The orderings of the component's edges are fixed one edge at a time in a
+// depth-first search over all permutations of each edge. The score of a node
+// is the sum of a diff-segment term for each adjacent edge, which only
+// depends on that edge's ordering, and a same-segment crossing and
+// separation term for each pair of adjacent edges. Both are added as soon as
+// the edges involved are fixed. The diff-segment terms of edges which are not
+// yet fixed are bounded from below by their line pairs: a pair which must be
+// ordered differently at the two endpoints of the edge crosses at one of
+// them.
+class BranchBoundOptimizer : public ExhaustiveOptimizer {
+ public:
+  BranchBoundOptimizer(const config::Config* cfg,
+                       const shared::rendergraph::Penalties& pens)
+      : ExhaustiveOptimizer(cfg, pens){};
+
+  virtual double optimizeComp(OptGraph* og, const std::set<OptNode*>& g,
+                              shared::rendergraph::HierarOrderCfg* c,
+                              size_t depth, OptResStats& stats) const;
+
+ private:
+  // score term of a node for an edge pair, added once both edges are fixed
+  struct PairTerm {
+    OptNode* nd;
+    size_t other;
+    size_t id;
+    double crossPen;
+    double sepPen;
+  };
+
+  struct Search {
+    OptOrderCfg cur, best;
+    double bestScore;
+
+    // edge ids in the order they are fixed, and the reverse mapping
+    std::vector<size_t> order;
+    std::vector<size_t> lvl;
+
+    // per edge, the diff-segment penalty of placing line occurrence i
+    // before line occurrence j at index i * size + j, and its lower bound
+    std::vector<std::vector<double>> diffPens;
+    std::vector<double> lowBnd;
+
+    // per edge, the pair terms with edges fixed before it
+    std::vector<std::vector<PairTerm>> pairs;
+
+    // per edge, chains of equivalent line occurrences which must appear in
+    // this order
+    std::vector<std::vector<std::vector<size_t>>> symm;
+
+    // per edge, the index of its current permutation, and memoized pair
+    // term scores by term id and permutation indices
+    std::vector<size_t> perm;
+    std::unordered_map<uint64_t, double> memo;
+
+    size_t nds;
+    bool limited;
+    bool timedOut;
+    std::chrono::steady_clock::time_point deadline;
+  };
+
+  void initSearch(const std::set<OptNode*>& g, Search* s) const;
+  void initDiffPens(Search* s) const;
+  void initSymmetries(const std::set<OptNode*>& g, Search* s) const;
+
+  void search(Search* s, size_t lvl, double score, double bound) const;
+
+  double getEdgeScore(Search* s, size_t eid) const;
+  double getPairScore(Search* s, size_t eid, const PairTerm& t) const;
+  bool isCanonical(const Search& s, size_t eid) const;
+};
+}  // namespace optim
+}  // namespace loom
+
+#endif  // LOOM_OPTIM_BRANCHBOUNDOPTIMIZER_H_
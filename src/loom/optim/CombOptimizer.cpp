@@ -40,7 +40,7 @@ double CombOptimizer::optimizeComp(OptGraph* og, const std::set<OptNode*>& g,
 #if defined GUROBI_FOUND || defined GLPK_FOUND || defined COIN_FOUND
     return _ilpOpt.optimizeComp(og, g, hc, depth + 1, stats);
 #else
-    return _hillcOpt.optimizeComp(og, g, hc, depth + 1, stats);
+    return _bnbOpt.optimizeComp(og, g, hc, depth + 1, stats);
 #endif
   }
 }
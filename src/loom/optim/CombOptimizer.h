@@ -6,6 +6,7 @@
 #define LOOM_OPTIM_COMBOPTIMIZER_H_
 
 #include "loom/config/LoomConfig.h"
+#include "loom/optim/BranchBoundOptimizer.h"
 #include "loom/optim/ExhaustiveOptimizer.h"
 #include "loom/optim/HillClimbOptimizer.h"
 #include "loom/optim/ILPEdgeOrderOptimizer.h"
@@ -28,6 +29,7 @@ class CombOptimizer : public Optimizer {
         _exhausOpt(cfg, pens),
         _hillcOpt(cfg, pens, false),
         _annealOpt(cfg, pens, false),
+        _bnbOpt(cfg, pens),
         _forceILP(false){};
 
   CombOptimizer(const config::Config* cfg,
@@ -38,6 +40,7 @@ class CombOptimizer : public Optimizer {
         _exhausOpt(cfg, pens),
         _hillcOpt(cfg, pens, false),
         _annealOpt(cfg, pens, false),
+        _bnbOpt(cfg, pens),
         _forceILP(forceILP){};
 
   double optimizeComp(OptGraph* og, const std::set<OptNode*>& g,
@@ -50,6 +53,7 @@ class CombOptimizer : public Optimizer {
   const ExhaustiveOptimizer _exhausOpt;
   const HillClimbOptimizer _hillcOpt;
   const SimulatedAnnealingOptimizer _annealOpt;
+  const BranchBoundOptimizer _bnbOpt;
 
   const bool _forceILP;
 };
@@ -3,6 +3,8 @@
 // Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
 
 #include <algorithm>
+#include <cstdlib>
+#include <random>
 #include <unordered_map>
 #include "loom/optim/ExhaustiveOptimizer.h"
 #include "shared/linegraph/Line.h"
@@ -20,35 +22,25 @@ double ExhaustiveOptimizer::optimizeComp(OptGraph* og,
                                          HierarOrderCfg* hc, size_t depth,
                                          OptResStats& stats) const {
   UNUSED(og);
-  UNUSED(stats);
   LOGTO(DEBUG, std::cerr) << prefix(depth)
                           << "(ExhaustiveOptimizer) Optimizing component with "
                           << g.size() << " nodes.";
 
   T_START(1);
 
-  OptOrderCfg best, cur, null;
+  OptOrderCfg best, cur;
   double bestScore = DBL_MAX;
 
-  // fixed order list of optim graph edges
-  std::vector<OptEdge*> edges;
-
-  for (auto n : g)
-    for (auto e : n->getAdjList())
-      if (n == e->getFrom()) edges.push_back(e);
-
   // this guarantees that all the orderings are sorted, which we need for
-  // std::next_permutation below!
-  initialConfig(g, &null, true);
-  cur = null;
+  // the permutation enumeration below!
+  initialConfig(g, &cur, true);
 
   double iters = 0;
   double last = 0;
   bool running = true;
 
-  double curScore = _optScorer.getCrossingScore(g, cur);
-  if (_optScorer.optimizeSep())
-    curScore += _optScorer.getSeparationScore(g, cur);
+  OptNodeScores scores;
+  double curScore = _optScorer.initNodeScores(g, cur, &scores);
 
   bestScore = curScore;
   best = cur;
@@ -73,7 +65,8 @@ double ExhaustiveOptimizer::optimizeComp(OptGraph* og,
       LOGTO(DEBUG, std::cerr)
           << prefix(depth) << "Found optimal score 0 prematurely after "
           << iters << " iterations!";
-      writeHierarch(&best, hc);
+      stats.numSearchNds += iters;
+      writeHierarch(best, hc);
       return 0;
     }
 
@@ -88,21 +81,22 @@ double ExhaustiveOptimizer::optimizeComp(OptGraph* og,
       itTime = 0;
     }
 
-    for (size_t i = 0; i < edges.size(); i++) {
-      if (std::next_permutation(cur[edges[i]].begin(), cur[edges[i]].end())) {
+    for (size_t i = 0; i < cur.numEdgs(); i++) {
+      bool next = cur.nextPermutation(i);
+
+      // only the endpoints of permuted edges have to be re-scored
+      if (cur.size(i) > 1)
+        curScore += _optScorer.updateNodeScores(cur.getEdg(i), cur, &scores);
+
+      if (next) {
         break;
-      } else if (i == edges.size() - 1) {
+      } else if (i == cur.numEdgs() - 1) {
         running = false;
       }
     }
 
     if (!running) break;
 
-    if (_optScorer.optimizeSep())
-      curScore = _optScorer.getTotalScore(g, cur);
-    else
-      curScore = _optScorer.getCrossingScore(g, cur);
-
     if (curScore < bestScore) {
       bestScore = curScore;
       best = cur;
@@ -113,7 +107,9 @@ double ExhaustiveOptimizer::optimizeComp(OptGraph* og,
   LOGTO(DEBUG, std::cerr) << prefix(depth) << "Found optimal score "
                           << bestScore << " after " << iters << " iterations!";
 
-  writeHierarch(&best, hc);
+  stats.numSearchNds += iters;
+
+  writeHierarch(best, hc);
 
   return T_STOP(1);
 }
@@ -127,52 +123,13 @@ void ExhaustiveOptimizer::initialConfig(const std::set<OptNode*>& g,
 // _____________________________________________________________________________
 void ExhaustiveOptimizer::initialConfig(const std::set<OptNode*>& g,
                                         OptOrderCfg* cfg, bool sorted) const {
-  for (OptNode* n : g) {
-    for (OptEdge* e : n->getAdjList()) {
-      if (e->getFrom() != n) continue;
-      (*cfg)[e] = std::vector<const Line*>(e->pl().getCardinality());
-      size_t p = 0;
-      for (size_t i = 0; i < e->pl().getLines().size(); i++) {
-        (*cfg)[e][p] = e->pl().getLines()[i].line;
-        p++;
-      }
+  // a fresh configuration holds the identity ordering for each edge, which
+  // is sorted
+  *cfg = OptOrderCfg(g);
 
-      if (sorted) {
-        std::sort((*cfg)[e].begin(), (*cfg)[e].end());
-      } else {
-        std::random_shuffle((*cfg)[e].begin(), (*cfg)[e].end());
-      }
-    }
-  }
-}
+  if (sorted) return;
 
-// _____________________________________________________________________________
-void ExhaustiveOptimizer::writeHierarch(OptOrderCfg* cfg,
-                                        HierarOrderCfg* hc) const {
-  for (auto ep : *cfg) {
-    auto e = ep.first;
-
-    for (auto lnEdgPart : e->pl().lnEdgParts) {
-      if (lnEdgPart.wasCut) continue;
-      for (auto r : ep.second) {
-        // get the corresponding route occurance in the opt graph edge
-        // TODO: replace this as soon as a lookup function is present in OptLO
-        OptLO optRO;
-        for (auto ro : e->pl().getLines()) {
-          if (r == ro.line) optRO = ro;
-        }
-
-        for (auto rel : optRO.relatives) {
-          // retrieve the original line pos
-          size_t p = lnEdgPart.lnEdg->pl().linePos(rel);
-          if (!(lnEdgPart.dir ^ e->pl().lnEdgParts.front().dir)) {
-            (*hc)[lnEdgPart.lnEdg][lnEdgPart.order].insert(
-                (*hc)[lnEdgPart.lnEdg][lnEdgPart.order].begin(), p);
-          } else {
-            (*hc)[lnEdgPart.lnEdg][lnEdgPart.order].push_back(p);
-          }
-        }
-      }
-    }
-  }
+  // seeded from the global generator, which main() seeds
+  std::mt19937 rng(rand());
+  for (size_t i = 0; i < cfg->numEdgs(); i++) cfg->shuffle(i, &rng);
 }
@@ -30,8 +30,6 @@ class ExhaustiveOptimizer : public Optimizer {
   void initialConfig(const std::set<OptNode*>& g, OptOrderCfg* cfg) const;
   void initialConfig(const std::set<OptNode*>& g, OptOrderCfg* cfg,
                      bool sorted) const;
-  void writeHierarch(OptOrderCfg* cfg,
-                     shared::rendergraph::HierarOrderCfg* c) const;
 };
 }  // namespace optim
 }  // namespace loom
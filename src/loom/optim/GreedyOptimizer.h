@@ -59,12 +59,14 @@ class GreedyOptimizer : public ExhaustiveOptimizer {
   std::pair<bool, double> guess(const shared::linegraph::Line* a,
                                 const shared::linegraph::Line* b,
                                 const OptEdge* start, const OptNode* refNd,
-                                const OptOrderCfg& cfg) const;
+                                const OptOrderCfg& cfg,
+                                const SettledEdgs& settled) const;
   std::pair<int, double> smallerThanAt(const shared::linegraph::Line* a,
                                        const shared::linegraph::Line* b,
                                        const OptEdge* e, const OptNode* nd,
                                        const OptEdge* ignore,
-                                       const OptOrderCfg& cfg) const;
+                                       const OptOrderCfg& cfg,
+                                       const SettledEdgs& settled) const;
 
   const OptEdge* eligibleNextEdge(const OptEdge* start, const OptNode* nd,
                                   const shared::linegraph::Line* a,
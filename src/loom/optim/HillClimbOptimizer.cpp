@@ -3,6 +3,14 @@
 // Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <sstream>
 #include <unordered_map>
 #include "loom/optim/GreedyOptimizer.h"
 #include "loom/optim/HillClimbOptimizer.h"
@@ -15,78 +23,250 @@ using loom::optim::HillClimbOptimizer;
 using shared::linegraph::Line;
 using shared::rendergraph::HierarOrderCfg;
 
+#ifdef _OPENMP
+#include <omp.h>
+#else
+#define omp_get_num_procs() 1
+#endif
+
+namespace {
+// _____________________________________________________________________________
+uint32_t compKey(const std::set<OptNode*>& g) {
+  // a key of component g which is stable across runs: the sum of the 32 bit
+  // FNV-1a hashes of the node positions, which does not depend on the
+  // (pointer) order of the nodes
+  uint32_t ret = 0;
+  for (auto n : g) {
+    double xy[2] = {n->pl().p.getX(), n->pl().p.getY()};
+    unsigned char bytes[sizeof(xy)];
+    std::memcpy(bytes, xy, sizeof(xy));
+
+    uint32_t h = 2166136261u;
+    for (auto c : bytes) {
+      h ^= c;
+      h *= 16777619u;
+    }
+    ret += h;
+  }
+  return ret;
+}
+}  // namespace
+
 // _____________________________________________________________________________
 double HillClimbOptimizer::optimizeComp(OptGraph* og, const std::set<OptNode*>& g,
                                      HierarOrderCfg* hc, size_t depth,
                                      OptResStats& stats) const {
-  UNUSED(stats);
-  UNUSED(depth);
+  UNUSED(og);
   T_START(1);
-  OptOrderCfg cur;
 
-  // fixed order list of optim graph edges
-  std::vector<OptEdge*> edges;
+  size_t n = std::max<size_t>(1, _cfg->multiStarts);
+  size_t jobs = _cfg->multiStartThreads;
+  if (jobs == 0) jobs = omp_get_num_procs();
+  jobs = std::max<size_t>(1, std::min(jobs, n));
 
-  for (auto n : g)
-    for (auto e : n->getAdjList())
-      if (n == e->getFrom() && e->pl().getCardinality() > 1) edges.push_back(e);
-
-  if (_randomStart) {
-    // this is the starting ordering, which is random
-    initialConfig(g, &cur, false);
-  } else {
-    // take the greedy optimized ordering as a starting point
-    GreedyOptimizer greedy(_cfg, _scorer.getPens(), true);
-    greedy.getFlatConfig(g, &cur);
+  // each trajectory is seeded from the configured seed, the component and
+  // the trajectory index, independent of the order in which components and
+  // trajectories are run
+  std::vector<Trajectory> ts(n);
+  uint32_t key = compKey(g);
+  for (size_t i = 0; i < n; i++) {
+    std::seed_seq seq{static_cast<uint32_t>(_cfg->seed), key,
+                      static_cast<uint32_t>(i)};
+    initTrajectory(g, i, seq, &ts[i]);
   }
 
-  size_t iters = 0;
+  bool limited = _cfg->multiStartTimeLimit >= 0;
+  auto deadline = std::chrono::steady_clock::now() +
+                  std::chrono::milliseconds(static_cast<int64_t>(
+                      std::max(_cfg->multiStartTimeLimit, 0.0) * 1000));
+  std::atomic<bool> timedOut(false);
+
+  // without exchanges, each trajectory runs until it has converged in a
+  // single round
+  size_t interval = n > 1 ? _cfg->exchangeInterval : 0;
+  double bestScore = std::numeric_limits<double>::infinity();
 
   while (true) {
-    iters++;
-
-    double bestChange = 0;
-    OptEdge* bestEdge = 0;
-    std::vector<const Line*> bestOrder;
-
-    for (size_t i = 0; i < edges.size(); i++) {
-      double oldScore = getScore(og, edges[i], cur);
-
-      for (size_t p1 = 0; p1 < cur[edges[i]].size(); p1++) {
-        for (size_t p2 = p1; p2 < cur[edges[i]].size(); p2++) {
-          // switch p1 and p2
-          auto tmp = cur[edges[i]][p1];
-          cur[edges[i]][p1] = cur[edges[i]][p2];
-          cur[edges[i]][p2] = tmp;
-
-          double s = getScore(og, edges[i], cur);
-          if (s < oldScore && oldScore - s > bestChange) {
-            bestChange = oldScore - s;
-            bestEdge = edges[i];
-            bestOrder = cur[edges[i]];
-          }
-
-          // switch back
-          tmp = cur[edges[i]][p1];
-          cur[edges[i]][p1] = cur[edges[i]][p2];
-          cur[edges[i]][p2] = tmp;
+#pragma omp parallel for num_threads(jobs) schedule(dynamic, 1)
+    for (size_t i = 0; i < n; i++) {
+      auto& t = ts[i];
+      for (size_t s = 0; !t.done && (interval == 0 || s < interval); s++) {
+        if (limited && std::chrono::steady_clock::now() > deadline) {
+          timedOut = true;
+          break;
+        }
+
+        t.done = !step(&t);
+
+        if (t.score < t.bestScore) {
+          t.bestScore = t.score;
+          t.best = t.cur;
         }
       }
     }
 
-    if (bestEdge == 0) break;
+    if (timedOut) break;
+
+    double roundBest = bestScore;
+    for (const auto& t : ts) roundBest = std::min(roundBest, t.bestScore);
 
-    cur[bestEdge] = bestOrder;
+    if (interval) exchange(&ts, roundBest < bestScore);
+    bestScore = roundBest;
+
+    bool running = false;
+    for (const auto& t : ts) running = running || !t.done;
+    if (!running) break;
+  }
+
+  size_t best = 0;
+  std::stringstream ss;
+  stats.multiStartScores.resize(std::max(stats.multiStartScores.size(), n), 0);
+  for (size_t i = 0; i < n; i++) {
+    if (ts[i].bestScore < ts[best].bestScore) best = i;
+    stats.multiStartScores[i] += ts[i].bestScore;
+    ss << (i ? ", " : "") << ts[i].bestScore;
+  }
+
+  if (n > 1) {
+    LOGTO(DEBUG, std::cerr) << prefix(depth) << "Trajectory scores: " << ss.str()
+                            << (timedOut ? " (time limit hit)" : "");
   }
 
-  writeHierarch(&cur, hc);
+  writeHierarch(ts[best].best, hc);
   return T_STOP(1);
 }
 
 // _____________________________________________________________________________
-double HillClimbOptimizer::getScore(OptGraph* og, OptEdge* e,
-                                    OptOrderCfg& cur) const {
-  UNUSED(og);
-  if (_optScorer.optimizeSep()) return _optScorer.getTotalScore(e, cur);
-  return _optScorer.getCrossingScore(e, cur);
+void HillClimbOptimizer::initTrajectory(const std::set<OptNode*>& g, size_t i,
+                                        std::seed_seq& seed,
+                                        Trajectory* t) const {
+  t->rng.seed(seed);
+
+  if (i == 0 && !_randomStart) {
+    // the first trajectory starts from the greedy optimized ordering
+    GreedyOptimizer greedy(_cfg, _scorer.getPens(), true);
+    greedy.getFlatConfig(g, &t->cur);
+  } else {
+    t->cur = OptOrderCfg(g);
+    for (size_t eid = 0; eid < t->cur.numEdgs(); eid++) {
+      t->cur.shuffle(eid, &t->rng);
+    }
+  }
+
+  t->score = _optScorer.initNodeScores(g, t->cur, &t->scores);
+  t->best = t->cur;
+  t->bestScore = t->score;
+  t->iters = 0;
+  t->lastChange = 0;
+  t->done = false;
+
+  // with exchanges, the trajectories form a temperature ladder for
+  // simulated annealing, from 1 to 4 times the base temperature
+  t->tempFac = 1;
+  if (_cfg->exchangeInterval && _cfg->multiStarts > 1) {
+    t->tempFac = std::pow(4.0, static_cast<double>(i) / (_cfg->multiStarts - 1));
+  }
+}
+
+// _____________________________________________________________________________
+bool HillClimbOptimizer::step(Trajectory* t) const {
+  t->iters++;
+  return climbStep(&t->cur, &t->scores, &t->score);
+}
+
+// _____________________________________________________________________________
+void HillClimbOptimizer::exchange(std::vector<Trajectory>* ts,
+                                  bool improved) const {
+  // once no trajectory improves the best score anymore, all are left to
+  // converge
+  if (!improved) return;
+
+  size_t b = 0;
+  for (size_t i = 1; i < ts->size(); i++) {
+    if ((*ts)[i].bestScore < (*ts)[b].bestScore) b = i;
+  }
+
+  for (size_t i = 0; i < ts->size(); i++) {
+    auto& t = (*ts)[i];
+    if (!t.done || t.bestScore <= (*ts)[b].bestScore) continue;
+
+    // continue converged trajectories from a perturbed copy of the best
+    // ordering, hill climbing never leaves the best ordering, so it is the
+    // current one
+    t.cur = (*ts)[b].cur;
+    t.scores = (*ts)[b].scores;
+    t.score = (*ts)[b].score;
+
+    std::vector<size_t> cands;
+    for (size_t eid = 0; eid < t.cur.numEdgs(); eid++) {
+      if (t.cur.size(eid) > 1) cands.push_back(eid);
+    }
+    if (cands.empty()) return;
+
+    size_t eid = cands[std::uniform_int_distribution<size_t>(
+        0, cands.size() - 1)(t.rng)];
+    t.cur.shuffle(eid, &t.rng);
+    t.score += _optScorer.updateNodeScores(t.cur.getEdg(eid), t.cur, &t.scores);
+    t.done = false;
+  }
+}
+
+// _____________________________________________________________________________
+void HillClimbOptimizer::getFlatConfig(const std::set<OptNode*>& g,
+                                       OptOrderCfg* cur) const {
+  if (_randomStart) {
+    // this is the starting ordering, which is random
+    initialConfig(g, cur, false);
+  } else {
+    // take the greedy optimized ordering as a starting point
+    GreedyOptimizer greedy(_cfg, _scorer.getPens(), true);
+    greedy.getFlatConfig(g, cur);
+  }
+
+  climb(g, cur);
+}
+
+// _____________________________________________________________________________
+void HillClimbOptimizer::climb(const std::set<OptNode*>& g,
+                               OptOrderCfg* cur) const {
+  OptNodeScores scores;
+  double score = _optScorer.initNodeScores(g, *cur, &scores);
+
+  while (climbStep(cur, &scores, &score)) {
+  }
+}
+
+// _____________________________________________________________________________
+bool HillClimbOptimizer::climbStep(OptOrderCfg* cur, OptNodeScores* scores,
+                                   double* score) const {
+  double bestChange = 0;
+  size_t bestEdge = OptOrderCfg::NPOS;
+  size_t bestP1 = 0, bestP2 = 0;
+
+  for (size_t i = 0; i < cur->numEdgs(); i++) {
+    if (cur->size(i) < 2) continue;
+    for (size_t p1 = 0; p1 < cur->size(i); p1++) {
+      for (size_t p2 = p1; p2 < cur->size(i); p2++) {
+        // switch p1 and p2
+        cur->swap(i, p1, p2);
+
+        double delta = _optScorer.getScoreDelta(cur->getEdg(i), *cur, *scores);
+        if (delta < 0 && -delta > bestChange) {
+          bestChange = -delta;
+          bestEdge = i;
+          bestP1 = p1;
+          bestP2 = p2;
+        }
+
+        // switch back
+        cur->swap(i, p1, p2);
+      }
+    }
+  }
+
+  if (bestEdge == OptOrderCfg::NPOS) return false;
+
+  cur->swap(bestEdge, bestP1, bestP2);
+  *score += _optScorer.updateNodeScores(cur->getEdg(bestEdge), *cur, scores);
+  return true;
 }
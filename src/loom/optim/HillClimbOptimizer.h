@@ -5,6 +5,8 @@
 #ifndef LOOM_OPTIM_HILLCLIMBOPTIMIZER_H_
 #define LOOM_OPTIM_HILLCLIMBOPTIMIZER_H_
 
+#include <random>
+#include <vector>
 #include "loom/config/LoomConfig.h"
 #include "loom/optim/ExhaustiveOptimizer.h"
 #include "loom/optim/ILPEdgeOrderOptimizer.h"
@@ -27,10 +29,44 @@ class HillClimbOptimizer : public ExhaustiveOptimizer {
                            shared::rendergraph::HierarOrderCfg* c, size_t depth,
                            OptResStats& stats) const;
 
- protected:
-  double getScore(OptGraph* og, OptEdge* e, OptOrderCfg& cur) const;
+  // write the starting ordering (greedy or random) of component g, improved
+  // by climb(), into cfg
+  void getFlatConfig(const std::set<OptNode*>& g, OptOrderCfg* cfg) const;
+
+  // repeatedly apply the line swap which improves the score of cfg the most,
+  // until there is none left
+  void climb(const std::set<OptNode*>& g, OptOrderCfg* cfg) const;
 
+ protected:
   bool _randomStart;
+
+  // a single search trajectory of a multi-start run
+  struct Trajectory {
+    OptOrderCfg cur, best;
+    OptNodeScores scores;
+    double score, bestScore;
+
+    size_t iters, lastChange;
+    double tempFac;
+    bool done;
+
+    std::mt19937 rng;
+  };
+
+  // apply the best improving line swap to cfg, false if there is none
+  bool climbStep(OptOrderCfg* cfg, OptNodeScores* scores,
+                 double* score) const;
+
+  // advance trajectory t by one step, false if it has converged
+  virtual bool step(Trajectory* t) const;
+
+  // exchange solutions between the trajectories after each round of
+  // _cfg->exchangeInterval steps. improved is true if the best score of all
+  // trajectories improved in the last round.
+  virtual void exchange(std::vector<Trajectory>* ts, bool improved) const;
+
+  void initTrajectory(const std::set<OptNode*>& g, size_t i,
+                      std::seed_seq& seed, Trajectory* t) const;
 };
 }  // namespace optim
 }  // namespace loom
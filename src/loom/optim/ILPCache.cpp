@@ -0,0 +1,283 @@
+// Copyright 2016, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+// Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
+
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include "loom/optim/ILPCache.h"
+#include "util/String.h"
+#include "util/log/Log.h"
+
+using loom::optim::ILPCache;
+using loom::optim::ILPCacheKey;
+using loom::optim::OptLO;
+using loom::optim::OptNode;
+using loom::optim::OptOrderCfg;
+
+namespace {
+// _____________________________________________________________________________
+std::string hash(const std::string& str) {
+  // 64 bit FNV-1a, stable across platforms and runs
+  uint64_t h = 14695981039346656037ULL;
+  for (unsigned char c : str) {
+    h ^= c;
+    h *= 1099511628211ULL;
+  }
+
+  std::stringstream ss;
+  ss << std::hex << std::setw(16) << std::setfill('0') << h;
+  return ss.str();
+}
+
+// _____________________________________________________________________________
+size_t findLine(const OptOrderCfg& cfg, size_t eid, const std::string& id) {
+  for (size_t k = 0; k < cfg.size(eid); k++) {
+    if (cfg.lineOcc(eid, k).line->id() == id) return k;
+  }
+  return OptOrderCfg::NPOS;
+}
+}  // namespace
+
+// _____________________________________________________________________________
+ILPCacheKey ILPCache::getKey(const std::set<OptNode*>& g) const {
+  const auto& pens = _scorer.getPens();
+
+  std::vector<std::string> rows;
+  std::set<std::string> ndKeys;
+
+  std::stringstream penRow;
+  penRow << "P\t" << pens.inStatCrossPenDegTwo << "\t"
+         << pens.inStatSplitPenDegTwo << "\t" << pens.sameSegCrossPen << "\t"
+         << pens.diffSegCrossPen << "\t" << pens.splitPen << "\t"
+         << pens.inStatCrossPenSameSeg << "\t" << pens.inStatCrossPenDiffSeg
+         << "\t" << pens.inStatSplitPen << "\t" << pens.crossAdjPen << "\t"
+         << pens.splitAdjPen << "\t" << _scorer.optimizeSep();
+  rows.push_back(penRow.str());
+
+  for (auto n : g) {
+    // nodes are identified by their position, which must be unique
+    if (!ndKeys.insert(ndKey(n)).second) return ILPCacheKey();
+
+    std::stringstream ndRow;
+    ndRow << "N\t" << ndKey(n) << "\t" << _scorer.getCrossingPenSameSeg(n)
+          << "\t" << _scorer.getCrossingPenDiffSeg(n) << "\t"
+          << _scorer.getSeparationPen(n);
+
+    // the circular edge ordering, rotated to start at the smallest neighbor
+    std::vector<std::string> circ;
+    for (auto e : n->pl().circOrdering) circ.push_back(ndKey(e->getOtherNd(n)));
+    std::rotate(circ.begin(), std::min_element(circ.begin(), circ.end()),
+                circ.end());
+    for (const auto& nb : circ) ndRow << "\t" << nb;
+    rows.push_back(ndRow.str());
+
+    std::set<std::string> nbs;
+    for (auto e : n->getAdjList()) {
+      // edges are identified by their end nodes
+      if (!nbs.insert(ndKey(e->getOtherNd(n))).second) return ILPCacheKey();
+      if (e->getFrom() != n) continue;
+
+      // lines are identified by their ids in the stored orderings
+      std::set<std::string> ids;
+      std::vector<std::string> lns;
+      for (const auto& lo : e->pl().getLines()) {
+        const auto& id = lo.line->id();
+        if (id.empty() || id.find_first_of("\t\n") != std::string::npos)
+          return ILPCacheKey();
+        if (!ids.insert(id).second) return ILPCacheKey();
+        lns.push_back(lnKey(lo));
+      }
+      std::sort(lns.begin(), lns.end());
+
+      std::stringstream edgRow;
+      edgRow << "E\t" << ndKey(e->getFrom()) << "\t" << ndKey(e->getTo());
+      for (const auto& ln : lns) edgRow << "\t" << ln;
+      rows.push_back(edgRow.str());
+    }
+  }
+
+  std::sort(rows.begin(), rows.end());
+
+  ILPCacheKey ret;
+  for (const auto& row : rows) ret.full += row + "\n";
+  for (const auto& nd : ndKeys) ret.topo += (ret.topo.size() ? "\t" : "") + nd;
+
+  return ret;
+}
+
+// _____________________________________________________________________________
+bool ILPCache::get(const ILPCacheKey& k, OptOrderCfg* cfg) const {
+  if (k.full.empty()) return false;
+
+  StoredOrdering ord;
+  if (!read(getPath(k.full, ".ord"), k, true, &ord)) return false;
+
+  std::vector<std::vector<size_t>> orders(cfg->numEdgs());
+
+  for (size_t eid = 0; eid < cfg->numEdgs(); eid++) {
+    auto e = cfg->getEdg(eid);
+    auto i = ord.find({ndKey(e->getFrom()), ndKey(e->getTo())});
+    if (i == ord.end() || i->second.size() != cfg->size(eid)) return false;
+
+    std::vector<bool> used(cfg->size(eid), false);
+    for (const auto& id : i->second) {
+      size_t lo = findLine(*cfg, eid, id);
+      if (lo == OptOrderCfg::NPOS || used[lo]) return false;
+      used[lo] = true;
+      orders[eid].push_back(lo);
+    }
+  }
+
+  // only apply complete orderings
+  for (size_t eid = 0; eid < cfg->numEdgs(); eid++) {
+    cfg->setOrder(eid, orders[eid]);
+  }
+
+  return true;
+}
+
+// _____________________________________________________________________________
+bool ILPCache::getNear(const ILPCacheKey& k, OptOrderCfg* cfg) const {
+  if (k.full.empty()) return false;
+
+  StoredOrdering ord;
+  if (!read(getPath(k.topo, ".near"), k, false, &ord)) return false;
+
+  bool found = false;
+
+  for (size_t eid = 0; eid < cfg->numEdgs(); eid++) {
+    auto e = cfg->getEdg(eid);
+    auto fr = ndKey(e->getFrom());
+    auto to = ndKey(e->getTo());
+
+    std::vector<std::string> ids;
+    auto i = ord.find({fr, to});
+    if (i != ord.end()) {
+      ids = i->second;
+    } else {
+      // the edge may have been stored in the other direction
+      i = ord.find({to, fr});
+      if (i == ord.end()) continue;
+      ids.assign(i->second.rbegin(), i->second.rend());
+    }
+
+    // lines which are still present keep their stored relative order, new
+    // lines are appended
+    std::vector<bool> used(cfg->size(eid), false);
+    std::vector<size_t> order;
+    for (const auto& id : ids) {
+      size_t lo = findLine(*cfg, eid, id);
+      if (lo == OptOrderCfg::NPOS || used[lo]) continue;
+      used[lo] = true;
+      order.push_back(lo);
+    }
+
+    for (size_t lo = 0; lo < cfg->size(eid); lo++) {
+      if (!used[lo]) order.push_back(lo);
+    }
+
+    cfg->setOrder(eid, order);
+    found = true;
+  }
+
+  return found;
+}
+
+// _____________________________________________________________________________
+void ILPCache::put(const ILPCacheKey& k, const OptOrderCfg& cfg) const {
+  if (k.full.empty()) return;
+  write(getPath(k.full, ".ord"), k, cfg);
+  write(getPath(k.topo, ".near"), k, cfg);
+}
+
+// _____________________________________________________________________________
+bool ILPCache::read(const std::string& path, const ILPCacheKey& k, bool exact,
+                    StoredOrdering* ord) const {
+  std::ifstream in(path);
+  if (!in.good()) return false;
+
+  // the keys are stored in front of the orderings to rule out hash
+  // collisions
+  std::string line;
+  if (!std::getline(in, line) || line != k.topo) return false;
+
+  std::string full;
+  while (std::getline(in, line) && line != "--") full += line + "\n";
+  if (exact && full != k.full) return false;
+
+  while (std::getline(in, line)) {
+    auto parts = util::split(line, '\t');
+    if (parts.size() < 2) return false;
+    (*ord)[{parts[0], parts[1]}].assign(parts.begin() + 2, parts.end());
+  }
+
+  return true;
+}
+
+// _____________________________________________________________________________
+void ILPCache::write(const std::string& path, const ILPCacheKey& k,
+                     const OptOrderCfg& cfg) const {
+  // write to a temporary file first, so that concurrent readers never see a
+  // partially written file. the name is unique per process and write, as
+  // other threads or processes may write the same entry at the same time
+  static std::atomic<size_t> tmpCount(0);
+  std::string tmpPath = path + "." + std::to_string(getpid()) + "." +
+                        std::to_string(tmpCount++) + ".tmp";
+
+  {
+    std::ofstream out(tmpPath);
+    out << k.topo << "\n" << k.full << "--\n";
+
+    for (size_t eid = 0; eid < cfg.numEdgs(); eid++) {
+      auto e = cfg.getEdg(eid);
+      out << ndKey(e->getFrom()) << "\t" << ndKey(e->getTo());
+      for (size_t p = 0; p < cfg.size(eid); p++) {
+        out << "\t" << cfg.lineOcc(eid, cfg.at(eid, p)).line->id();
+      }
+      out << "\n";
+    }
+
+    if (!out.good()) {
+      LOG(WARN) << "Could not write ILP cache file " << tmpPath;
+      return;
+    }
+  }
+
+  if (std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+    LOG(WARN) << "Could not write ILP cache file " << path;
+    std::remove(tmpPath.c_str());
+  }
+}
+
+// _____________________________________________________________________________
+std::string ILPCache::getPath(const std::string& key,
+                              const std::string& ext) const {
+  return _dir + "/" + hash(key) + ext;
+}
+
+// _____________________________________________________________________________
+std::string ILPCache::ndKey(const OptNode* n) {
+  std::stringstream ss;
+  ss << std::fixed << std::setprecision(3) << n->pl().p.getX() << ","
+     << n->pl().p.getY();
+  return ss.str();
+}
+
+// _____________________________________________________________________________
+std::string ILPCache::lnKey(const OptLO& lo) {
+  std::stringstream ss;
+  ss << lo.line->id() << "@";
+  if (lo.dir) {
+    ss << std::fixed << std::setprecision(3) << lo.dir->pl().getGeom()->getX()
+       << "," << lo.dir->pl().getGeom()->getY();
+  } else {
+    ss << "*";
+  }
+  return ss.str();
+}
@@ -0,0 +1,76 @@
+// Copyright 2016, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+// Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
+
+#ifndef LOOM_OPTIM_ILPCACHE_H_
+#define LOOM_OPTIM_ILPCACHE_H_
+
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+#include "loom/optim/OptGraph.h"
+#include "loom/optim/OptGraphScorer.h"
+#include "loom/optim/OptOrderCfg.h"
+
+namespace loom {
+namespace optim {
+
+// canonical description of an optimization graph component
+struct ILPCacheKey {
+  // everything the ILP of the component depends on: penalties, node
+  // positions, their circular edge orderings and the lines on each edge.
+  // empty if the component has no canonical description.
+  std::string full;
+
+  // the node positions only
+  std::string topo;
+};
+
+// On-disk cache of line orderings computed by the ILP optimizers.
+//
+// The ordering of a component is stored in a file named after a hash of the
+// component's full key, an exact hit can be used in place of solving the
+// ILP. The most recent ordering for a component footprint is additionally
+// stored under a hash of the topo key. Such a near hit may have different
+// lines or penalties and is only used as a starting solution.
+class ILPCache {
+ public:
+  ILPCache(const std::string& dir, const OptGraphScorer& scorer)
+      : _dir(dir), _scorer(scorer) {}
+
+  ILPCacheKey getKey(const std::set<OptNode*>& g) const;
+
+  // write the ordering stored for key k into cfg, which must hold the
+  // component k was built from. false if there is no such ordering.
+  bool get(const ILPCacheKey& k, OptOrderCfg* cfg) const;
+
+  // write the ordering stored for the footprint of k into cfg, adapted to the
+  // lines of cfg. false if there is no such ordering.
+  bool getNear(const ILPCacheKey& k, OptOrderCfg* cfg) const;
+
+  void put(const ILPCacheKey& k, const OptOrderCfg& cfg) const;
+
+ private:
+  typedef std::map<std::pair<std::string, std::string>,
+                   std::vector<std::string>>
+      StoredOrdering;
+
+  std::string _dir;
+  const OptGraphScorer& _scorer;
+
+  bool read(const std::string& path, const ILPCacheKey& k, bool exact,
+            StoredOrdering* ord) const;
+  void write(const std::string& path, const ILPCacheKey& k,
+             const OptOrderCfg& cfg) const;
+
+  std::string getPath(const std::string& key, const std::string& ext) const;
+
+  static std::string ndKey(const OptNode* n);
+  static std::string lnKey(const OptLO& lo);
+};
+}  // namespace optim
+}  // namespace loom
+
+#endif  // LOOM_OPTIM_ILPCACHE_H_
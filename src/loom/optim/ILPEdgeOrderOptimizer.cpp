@@ -12,76 +12,74 @@
 
 using namespace loom;
 using namespace optim;
+using shared::linegraph::Line;
 using shared::optim::ILPSolver;
-using shared::rendergraph::HierarOrderCfg;
+using shared::optim::StarterSol;
 
 // _____________________________________________________________________________
 void ILPEdgeOrderOptimizer::getConfigurationFromSolution(
-    ILPSolver* lp, HierarOrderCfg* hc, const std::set<OptNode*>& g) const {
-  for (OptNode* n : g) {
-    for (OptEdge* e : n->getAdjList()) {
-      if (e->getFrom() != n) continue;
+    ILPSolver* lp, const ILPVarIdx& vars, OptOrderCfg* cfg) const {
+  for (size_t eid = 0; eid < cfg->numEdgs(); eid++) {
+    const OptEdge* e = cfg->getEdg(eid);
+    const auto& lines = e->pl().getLines();
+    std::vector<size_t> order(cfg->size(eid));
 
-      for (auto lnEdgPart : e->pl().lnEdgParts) {
-        if (lnEdgPart.wasCut) continue;
-        for (size_t tp = 0; tp < e->pl().getCardinality(); tp++) {
-          bool found = false;
+    for (size_t tp = 0; tp < e->pl().getCardinality(); tp++) {
+      bool found = false;
 
-          for (auto ro : e->pl().getLines()) {
-            // check if this route (r) switches from 0 to 1 at tp-1 and tp
-            double valPrev = 0;
-            std::stringstream varName;
+      for (size_t k = 0; k < lines.size(); k++) {
+        // check if this route (r) switches from 0 to 1 at tp-1 and tp
+        double valPrev = 0;
 
-            if (tp > 0) {
-              varName << "x_(" << e->pl().getStrRepr() << ",l=" << ro.line
-                      << ",p<=" << tp - 1 << ")";
+        if (tp > 0) {
+          valPrev = lp->getVarVal(getILPVar(vars, e, lines[k].line, tp - 1));
+        }
 
-              valPrev = lp->getVarVal(varName.str());
-            }
+        double val = lp->getVarVal(getILPVar(vars, e, lines[k].line, tp));
 
-            varName.str("");
-            varName << "x_(" << e->pl().getStrRepr() << ",l=" << ro.line
-                    << ",p<=" << tp << ")";
+        if (valPrev < 0.5 && val > 0.5) {
+          // first time p is eq/greater, so it is this p
+          order[tp] = k;
 
-            double val = lp->getVarVal(varName.str());
+          assert(!found);  // should be assured by ILP constraints
+          found = true;
+        }
+      }
 
-            if (valPrev < 0.5 && val > 0.5) {
-              // first time p is eq/greater, so it is this p
-              // TODO: the latter dir is checking the 'main' direction here,
-              // put this into a method in the pl()! (there, the [0] lnEdgeP is
-              // already taken as a ref). THIS IS A POTENTIAL BUG HERE
+      assert(found);
+    }
 
-              for (auto rel : ro.relatives) {
-                // retrieve the original route pos
-                size_t p = lnEdgPart.lnEdg->pl().linePos(rel);
+    cfg->setOrder(eid, order);
+  }
+}
 
-                if (!(lnEdgPart.dir ^ e->pl().lnEdgParts.front().dir)) {
-                  (*hc)[lnEdgPart.lnEdg][lnEdgPart.order].insert(
-                      (*hc)[lnEdgPart.lnEdg][lnEdgPart.order].begin(), p);
-                } else {
-                  (*hc)[lnEdgPart.lnEdg][lnEdgPart.order].push_back(p);
-                }
-              }
+// _____________________________________________________________________________
+StarterSol ILPEdgeOrderOptimizer::getStarter(const OptOrderCfg& cfg,
+                                             const ILPVarIdx& vars) const {
+  StarterSol sol;
 
-              assert(!found);  // should be assured by ILP constraints
-              found = true;
-            }
-          }
+  for (size_t eid = 0; eid < cfg.numEdgs(); eid++) {
+    const OptEdge* e = cfg.getEdg(eid);
+    const auto& lines = e->pl().getLines();
 
-          assert(found);
-        }
+    // x_(e,r,p) is 1 iff r is at position p or before
+    for (size_t k = 0; k < lines.size(); k++) {
+      for (size_t p = 0; p < e->pl().getCardinality(); p++) {
+        sol[getILPVar(vars, e, lines[k].line, p)] = cfg.pos(eid, k) <= p;
       }
     }
   }
+
+  return sol;
 }
 
 // _____________________________________________________________________________
-ILPSolver* ILPEdgeOrderOptimizer::createProblem(
-    OptGraph* og, const std::set<OptNode*>& g) const {
+ILPSolver* ILPEdgeOrderOptimizer::createProblem(OptGraph* og,
+                                                const std::set<OptNode*>& g,
+                                                ILPVarIdx* vars) const {
   UNUSED(og);
   ILPSolver* lp = shared::optim::getSolver(_cfg->ilpSolver, shared::optim::MIN);
-
-  std::set<OptEdge*> processed;
+  lp->setNamed(_cfg->MPSOutputPath.size());
 
   for (OptNode* n : g) {
     for (OptEdge* e : n->getAdjList()) {
@@ -90,28 +88,41 @@ ILPSolver* ILPEdgeOrderOptimizer::createProblem(
       // must be p+1
 
       size_t rowA = lp->getNumConstrs();
+      (*vars)[e].pos = lp->getNumVars();
+
       for (size_t p = 0; p < e->pl().getCardinality(); p++) {
-        std::stringstream rowName;
-        rowName << "sum(" << e->pl().getStrRepr() << ",<=" << p << ")";
-        lp->addRow(rowName.str(), p + 1, shared::optim::FIX);
+        int row = lp->addRow(p + 1, shared::optim::FIX);
+
+        if (lp->isNamed()) {
+          std::stringstream rowName;
+          rowName << "sum(" << e->pl().getStrRepr() << ",<=" << p << ")";
+          lp->setRowName(row, rowName.str());
+        }
       }
 
       for (auto r : e->pl().getLines()) {
         for (size_t p = 0; p < e->pl().getCardinality(); p++) {
-          std::stringstream varName;
-          varName << "x_(" << e->pl().getStrRepr() << ",l=" << r.line
-                  << ",p<=" << p << ")";
-          int curCol = lp->addCol(varName.str(), shared::optim::BIN, 0);
+          int curCol = lp->addCol(shared::optim::BIN, 0);
+
+          if (lp->isNamed()) {
+            std::stringstream varName;
+            varName << "x_(" << e->pl().getStrRepr() << ",l=" << r.line
+                    << ",p<=" << p << ")";
+            lp->setColName(curCol, varName.str());
+          }
 
           // coefficients for constraint from above
           lp->addColToRow(rowA + p, curCol, 1);
 
           if (p > 0) {
-            std::stringstream rowName;
-            rowName << "sum(" << e->pl().getStrRepr() << ",r=" << r.line
-                    << ",p<=" << p << ")";
+            int row = lp->addRow(0, shared::optim::LO);
 
-            int row = lp->addRow(rowName.str(), 0, shared::optim::LO);
+            if (lp->isNamed()) {
+              std::stringstream rowName;
+              rowName << "sum(" << e->pl().getStrRepr() << ",r=" << r.line
+                      << ",p<=" << p << ")";
+              lp->setRowName(row, rowName.str());
+            }
 
             lp->addColToRow(row, curCol, 1);
             lp->addColToRow(row, curCol - 1, -1);
@@ -121,16 +132,15 @@ ILPSolver* ILPEdgeOrderOptimizer::createProblem(
     }
   }
 
-  lp->update();
-
-  writeCrossingOracle(g, lp);
-  writeDiffSegConstraintsImpr(g, lp);
+  writeCrossingOracle(g, vars, lp);
+  writeDiffSegConstraintsImpr(g, *vars, lp);
 
   return lp;
 }
 
 // _____________________________________________________________________________
 void ILPEdgeOrderOptimizer::writeCrossingOracle(const std::set<OptNode*>& g,
+                                                ILPVarIdx* vars,
                                                 ILPSolver* lp) const {
   // do everything iteratively, otherwise it would be unreadable
 
@@ -146,73 +156,85 @@ void ILPEdgeOrderOptimizer::writeCrossingOracle(const std::set<OptNode*>& g,
 
       size_t rowDistanceRangeKeeper = 0;
       size_t c = segment->pl().getCardinality();
+      auto& segVars = (*vars)[segment];
+      segVars.smaller.assign(c * c, -1);
+      segVars.near.assign(c * c, -1);
+
       // constraint is only needed for segments with more than 2 lines
       if (separationOpt() && c > 2) {
-        std::stringstream rowName;
-        rowName << "sum_distancorRangeKeeper(e=" << segment->pl().getStrRepr()
-                << ")";
-
         size_t max = getLinePairs(segment).size() - (2 * c - 2);
         assert(max % 2 == 0);
         max = max / 2;
 
-        rowDistanceRangeKeeper =
-            lp->addRow(rowName.str(), max, shared::optim::UP);
+        rowDistanceRangeKeeper = lp->addRow(max, shared::optim::UP);
+
+        if (lp->isNamed()) {
+          std::stringstream rowName;
+          rowName << "sum_distancorRangeKeeper(e="
+                  << segment->pl().getStrRepr() << ")";
+          lp->setRowName(rowDistanceRangeKeeper, rowName.str());
+        }
       }
 
       // iterate over all possible line pairs in this segment
       for (LinePair linepair : getLinePairs(segment)) {
         // variable to check if position of line A (first) is < than
         // position of line B (second) in segment
-        std::stringstream ss;
-        ss << "x_(" << segment->pl().getStrRepr() << "," << linepair.first.line
-           << "<" << linepair.second.line << ")";
+        int col = lp->addCol(shared::optim::BIN, 0);
+        segVars.smaller[lineIdx(segment, linepair.first.line) * c +
+                        lineIdx(segment, linepair.second.line)] = col;
 
-        lp->addCol(ss.str(), shared::optim::BIN, 0);
+        if (lp->isNamed()) {
+          std::stringstream ss;
+          ss << "x_(" << segment->pl().getStrRepr() << ","
+             << linepair.first.line << "<" << linepair.second.line << ")";
+          lp->setColName(col, ss.str());
+        }
       }
 
       // iterate over all possible line pairs in this segment
       for (LinePair linepair : getLinePairs(segment, true)) {
         if (separationOpt() && c > 2) {
-          std::stringstream ss;
           // variable to check if distance between position of A and position
           // of B is > 1
-          ss << "x_(" << segment->pl().getStrRepr() << ","
-             << linepair.first.line << "<T>" << linepair.second.line << ")";
+          int dist1Var = lp->addCol(shared::optim::BIN, 0);
+          size_t a = lineIdx(segment, linepair.first.line);
+          size_t b = lineIdx(segment, linepair.second.line);
+          segVars.near[a * c + b] = dist1Var;
+          segVars.near[b * c + a] = dist1Var;
+
+          if (lp->isNamed()) {
+            std::stringstream ss;
+            ss << "x_(" << segment->pl().getStrRepr() << ","
+               << linepair.first.line << "<T>" << linepair.second.line << ")";
+            lp->setColName(dist1Var, ss.str());
+          }
 
-          size_t dist1Var = lp->addCol(ss.str(), shared::optim::BIN, 0);
           lp->addColToRow(rowDistanceRangeKeeper, dist1Var, 1);
         }
       }
     }
   }
 
-  lp->update();
-
   // write constraints for the A>B variable, both can never be 1...
   for (OptNode* node : g) {
     for (OptEdge* segment : node->getAdjList()) {
       if (segment->getFrom() != node) continue;
       // iterate over all possible line pairs in this segment
       for (LinePair linepair : getLinePairs(segment)) {
-        std::stringstream ss;
-        ss << "x_(" << segment->pl().getStrRepr() << "," << linepair.first.line
-           << "<" << linepair.second.line << ")";
-
-        int smaller = lp->getVarByName(ss.str());
-        assert(smaller > -1);
+        int smaller = getSmallerVar(*vars, segment, linepair.first.line,
+                                    linepair.second.line);
+        int bigger = getSmallerVar(*vars, segment, linepair.second.line,
+                                   linepair.first.line);
 
-        std::stringstream ss2;
-        ss2 << "x_(" << segment->pl().getStrRepr() << ","
-            << linepair.second.line << "<" << linepair.first.line << ")";
+        int row = lp->addRow(1, shared::optim::FIX);
 
-        int bigger = lp->getVarByName(ss2.str());
-        assert(bigger > -1);
-
-        std::stringstream rowName;
-        rowName << "sum(" << ss.str() << "," << ss2.str() << ")";
-
-        int row = lp->addRow(rowName.str(), 1, shared::optim::FIX);
+        if (lp->isNamed()) {
+          std::stringstream rowName;
+          rowName << "sum(" << lp->getColName(smaller) << ","
+                  << lp->getColName(bigger) << ")";
+          lp->setRowName(row, rowName.str());
+        }
 
         lp->addColToRow(row, smaller, 1);
         lp->addColToRow(row, bigger, 1);
@@ -225,35 +247,24 @@ void ILPEdgeOrderOptimizer::writeCrossingOracle(const std::set<OptNode*>& g,
     for (OptEdge* segment : node->getAdjList()) {
       if (segment->getFrom() != node) continue;
       for (LinePair linepair : getLinePairs(segment)) {
-        std::stringstream rowName;
-        rowName << "sum_crossor(e=" << segment->pl().getStrRepr()
-                << ",A=" << linepair.first.line << ",B=" << linepair.second.line
-                << ")";
-        int rowSmallerThan = lp->addRow(rowName.str(), 0, shared::optim::LO);
+        int rowSmallerThan = lp->addRow(0, shared::optim::LO);
 
-        std::stringstream ss;
-        ss << "x_(" << segment->pl().getStrRepr() << "," << linepair.first.line
-           << "<" << linepair.second.line << ")";
+        if (lp->isNamed()) {
+          std::stringstream rowName;
+          rowName << "sum_crossor(e=" << segment->pl().getStrRepr()
+                  << ",A=" << linepair.first.line
+                  << ",B=" << linepair.second.line << ")";
+          lp->setRowName(rowSmallerThan, rowName.str());
+        }
 
-        int decVar = lp->getVarByName(ss.str());
-        assert(decVar > -1);
+        int decVar = getSmallerVar(*vars, segment, linepair.first.line,
+                                   linepair.second.line);
 
         lp->addColToRow(rowSmallerThan, decVar, m);
 
         for (size_t p = 0; p < segment->pl().getCardinality(); ++p) {
-          std::stringstream ss;
-          ss << "x_(" << segment->pl().getStrRepr()
-             << ",l=" << linepair.first.line << ",p<=" << p << ")";
-
-          int first = lp->getVarByName(ss.str());
-          assert(first > -1);
-
-          std::stringstream ss2;
-          ss2 << "x_(" << segment->pl().getStrRepr()
-              << ",l=" << linepair.second.line << ",p<=" << p << ")";
-
-          int second = lp->getVarByName(ss2.str());
-          assert(second > -1);
+          int first = getILPVar(*vars, segment, linepair.first.line, p);
+          int second = getILPVar(*vars, segment, linepair.second.line, p);
 
           lp->addColToRow(rowSmallerThan, first, 1);
           lp->addColToRow(rowSmallerThan, second, -1);
@@ -267,49 +278,35 @@ void ILPEdgeOrderOptimizer::writeCrossingOracle(const std::set<OptNode*>& g,
     for (OptEdge* segment : node->getAdjList()) {
       if (segment->getFrom() != node) continue;
       for (LinePair linepair : getLinePairs(segment, true)) {
-        std::stringstream rowName;
-
         int rowDistance1 = 0;
         int rowDistance2 = 0;
         if (separationOpt() && segment->pl().getCardinality() > 2) {
-          rowName.str("");
-          rowName << "sum_distancor1(e=" << segment->pl().getStrRepr()
-                  << ",A=" << linepair.first.line
-                  << ",B=" << linepair.second.line << ")";
-
-          rowDistance1 = lp->addRow(rowName.str(), 1, shared::optim::UP);
-
-          rowName.str("");
-          rowName << "sum_distancor2(e=" << segment->pl().getStrRepr()
-                  << ",A=" << linepair.first.line
-                  << ",B=" << linepair.second.line << ")";
+          rowDistance1 = lp->addRow(1, shared::optim::UP);
+          rowDistance2 = lp->addRow(1, shared::optim::UP);
 
-          rowDistance2 = lp->addRow(rowName.str(), 1, shared::optim::UP);
-
-          std::stringstream sss;
-          sss << "x_(" << segment->pl().getStrRepr() << ","
-              << linepair.first.line << "<T>" << linepair.second.line << ")";
+          if (lp->isNamed()) {
+            std::stringstream rowName;
+            rowName << "sum_distancor1(e=" << segment->pl().getStrRepr()
+                    << ",A=" << linepair.first.line
+                    << ",B=" << linepair.second.line << ")";
+            lp->setRowName(rowDistance1, rowName.str());
+
+            rowName.str("");
+            rowName << "sum_distancor2(e=" << segment->pl().getStrRepr()
+                    << ",A=" << linepair.first.line
+                    << ",B=" << linepair.second.line << ")";
+            lp->setRowName(rowDistance2, rowName.str());
+          }
 
-          int decVarDistance = lp->getVarByName(sss.str());
-          assert(decVarDistance > -1);
+          int decVarDistance = getNearVar(*vars, segment, linepair.first.line,
+                                          linepair.second.line);
 
           lp->addColToRow(rowDistance1, decVarDistance, -static_cast<int>(m));
           lp->addColToRow(rowDistance2, decVarDistance, -static_cast<int>(m));
 
           for (size_t p = 0; p < segment->pl().getCardinality(); ++p) {
-            std::stringstream ss;
-            ss << "x_(" << segment->pl().getStrRepr()
-               << ",l=" << linepair.first.line << ",p<=" << p << ")";
-
-            int first = lp->getVarByName(ss.str());
-            assert(first > -1);
-
-            std::stringstream ss2;
-            ss2 << "x_(" << segment->pl().getStrRepr()
-                << ",l=" << linepair.second.line << ",p<=" << p << ")";
-
-            int second = lp->getVarByName(ss2.str());
-            assert(second > -1);
+            int first = getILPVar(*vars, segment, linepair.first.line, p);
+            int second = getILPVar(*vars, segment, linepair.second.line, p);
 
             lp->addColToRow(rowDistance1, first, 1);
             lp->addColToRow(rowDistance1, second, -1);
@@ -338,60 +335,48 @@ void ILPEdgeOrderOptimizer::writeCrossingOracle(const std::set<OptNode*>& g,
           if (processed.find(segmentB) != processed.end()) continue;
 
           // introduce dec var
-          std::stringstream ss;
-          ss << "x_dec(" << segmentA->pl().getStrRepr() << ","
-             << segmentA->pl().getStrRepr() << segmentB->pl().getStrRepr()
-             << "," << linepair.first.line << "(" << linepair.first.line->id()
-             << ")," << linepair.second.line << "("
-             << linepair.second.line->id() << ")," << node << ")";
-
           int decisionVar = lp->addCol(
-              ss.str(), shared::optim::BIN,
+              shared::optim::BIN,
               getCrossingPenaltySameSeg(node)
                   // multiply the penalty with the number of collapsed lines!
                   * (linepair.first.relatives.size()) *
                   (linepair.second.relatives.size()));
 
-          int aSmallerBinL1 = 0;
-          int aSmallerBinL2 = 0;
-          int bSmallerAinL2 = 0;
-
-          std::stringstream aSmBStr;
-          aSmBStr << "x_(" << segmentA->pl().getStrRepr() << ","
-                  << linepair.first.line << "<" << linepair.second.line << ")";
-          aSmallerBinL1 = lp->getVarByName(aSmBStr.str());
-
-          assert(aSmallerBinL1 > -1);
-
-          std::stringstream aBgBStr;
-          aBgBStr << "x_(" << segmentB->pl().getStrRepr() << ","
-                  << linepair.first.line << "<" << linepair.second.line << ")";
-          aSmallerBinL2 = lp->getVarByName(aBgBStr.str());
-
-          assert(aSmallerBinL2 > -1);
-
-          std::stringstream bBgAStr;
-          bBgAStr << "x_(" << segmentB->pl().getStrRepr() << ","
-                  << linepair.second.line << "<" << linepair.first.line << ")";
-          bSmallerAinL2 = lp->getVarByName(bBgAStr.str());
-
-          assert(bSmallerAinL2 > -1);
-
-          std::stringstream rowName;
-          rowName << "sum_dec(e1=" << segmentA->pl().getStrRepr()
-                  << ",e2=" << segmentB->pl().getStrRepr()
-                  << ",A=" << linepair.first.line
-                  << ",B=" << linepair.second.line << ",n=" << node << ")";
+          if (lp->isNamed()) {
+            std::stringstream ss;
+            ss << "x_dec(" << segmentA->pl().getStrRepr() << ","
+               << segmentA->pl().getStrRepr() << segmentB->pl().getStrRepr()
+               << "," << linepair.first.line << "("
+               << linepair.first.line->id() << ")," << linepair.second.line
+               << "(" << linepair.second.line->id() << ")," << node << ")";
+            lp->setColName(decisionVar, ss.str());
+          }
 
-          int row = lp->addRow(rowName.str(), 0, shared::optim::LO);
+          int aSmallerBinL1 = getSmallerVar(*vars, segmentA, linepair.first.line,
+                                            linepair.second.line);
+          int aSmallerBinL2 = getSmallerVar(*vars, segmentB, linepair.first.line,
+                                            linepair.second.line);
+          int bSmallerAinL2 = getSmallerVar(
+              *vars, segmentB, linepair.second.line, linepair.first.line);
 
-          std::stringstream rowName2;
-          rowName2 << "sum_dec2(e1=" << segmentA->pl().getStrRepr()
-                   << ",e2=" << segmentB->pl().getStrRepr()
-                   << ",A=" << linepair.first.line
-                   << ",B=" << linepair.second.line << ",n=" << node << ")";
+          int row = lp->addRow(0, shared::optim::LO);
+          int row2 = lp->addRow(0, shared::optim::LO);
 
-          int row2 = lp->addRow(rowName2.str(), 0, shared::optim::LO);
+          if (lp->isNamed()) {
+            std::stringstream rowName;
+            rowName << "sum_dec(e1=" << segmentA->pl().getStrRepr()
+                    << ",e2=" << segmentB->pl().getStrRepr()
+                    << ",A=" << linepair.first.line
+                    << ",B=" << linepair.second.line << ",n=" << node << ")";
+            lp->setRowName(row, rowName.str());
+
+            std::stringstream rowName2;
+            rowName2 << "sum_dec2(e1=" << segmentA->pl().getStrRepr()
+                     << ",e2=" << segmentB->pl().getStrRepr()
+                     << ",A=" << linepair.first.line
+                     << ",B=" << linepair.second.line << ",n=" << node << ")";
+            lp->setRowName(row2, rowName2.str());
+          }
 
           bool otherWayA = (segmentA->getFrom() != node) ^
                            segmentA->pl().lnEdgParts.front().dir;
@@ -430,49 +415,45 @@ void ILPEdgeOrderOptimizer::writeCrossingOracle(const std::set<OptNode*>& g,
               // segment A to segment B and the cardinality of both A and B
               // is > 2 (that is, it is possible in A or B that the two lines
               // won't be together)
-              std::stringstream sss;
-              sss << "x_decT(" << segmentA->pl().getStrRepr() << ","
-                  << segmentA->pl().getStrRepr() << segmentB->pl().getStrRepr()
-                  << "," << linepair.first.line << "("
-                  << linepair.first.line->id() << ")," << linepair.second.line
-                  << "(" << linepair.second.line->id() << ")," << node << ")";
-
-              int decisionVarDist1Change = lp->addCol(
-                  sss.str(), shared::optim::BIN, getSeparationPenalty(node));
-
-              int aNearBinL1 = 0;
-              int aNearBinL2 = 0;
-
-              std::stringstream aNearBL1Str;
-              aNearBL1Str << "x_(" << segmentA->pl().getStrRepr() << ","
-                          << linepair.first.line << "<T>"
-                          << linepair.second.line << ")";
-              aNearBinL1 = lp->getVarByName(aNearBL1Str.str());
-              assert(aNearBinL1 > -1);
-
-              std::stringstream aNearBL2Str;
-              aNearBL2Str << "x_(" << segmentB->pl().getStrRepr() << ","
-                          << linepair.first.line << "<T>"
-                          << linepair.second.line << ")";
-              aNearBinL2 = lp->getVarByName(aNearBL2Str.str());
-              assert(aNearBinL2 > -1);
-
-              std::stringstream rowTName;
-              rowTName << "sum_decT(e1=" << segmentA->pl().getStrRepr()
-                       << ",e2=" << segmentB->pl().getStrRepr()
-                       << ",A=" << linepair.first.line
-                       << ",B=" << linepair.second.line << ",n=" << node << ")";
-
-              int rowT = lp->addRow(rowTName.str(), 0, shared::optim::LO);
-
-              std::stringstream rowTName2;
-              rowTName2 << "sum_decT2(e1=" << segmentA->pl().getStrRepr()
-                        << ",e2=" << segmentB->pl().getStrRepr()
-                        << ",A=" << linepair.first.line
-                        << ",B=" << linepair.second.line << ",n=" << node
-                        << ")";
-
-              int rowT2 = lp->addRow(rowTName2.str(), 0, shared::optim::LO);
+              int decisionVarDist1Change =
+                  lp->addCol(shared::optim::BIN, getSeparationPenalty(node));
+
+              if (lp->isNamed()) {
+                std::stringstream sss;
+                sss << "x_decT(" << segmentA->pl().getStrRepr() << ","
+                    << segmentA->pl().getStrRepr()
+                    << segmentB->pl().getStrRepr() << "," << linepair.first.line
+                    << "(" << linepair.first.line->id() << "),"
+                    << linepair.second.line << "("
+                    << linepair.second.line->id() << ")," << node << ")";
+                lp->setColName(decisionVarDist1Change, sss.str());
+              }
+
+              int aNearBinL1 = getNearVar(*vars, segmentA, linepair.first.line,
+                                          linepair.second.line);
+              int aNearBinL2 = getNearVar(*vars, segmentB, linepair.first.line,
+                                          linepair.second.line);
+
+              int rowT = lp->addRow(0, shared::optim::LO);
+              int rowT2 = lp->addRow(0, shared::optim::LO);
+
+              if (lp->isNamed()) {
+                std::stringstream rowTName;
+                rowTName << "sum_decT(e1=" << segmentA->pl().getStrRepr()
+                         << ",e2=" << segmentB->pl().getStrRepr()
+                         << ",A=" << linepair.first.line
+                         << ",B=" << linepair.second.line << ",n=" << node
+                         << ")";
+                lp->setRowName(rowT, rowTName.str());
+
+                std::stringstream rowTName2;
+                rowTName2 << "sum_decT2(e1=" << segmentA->pl().getStrRepr()
+                          << ",e2=" << segmentB->pl().getStrRepr()
+                          << ",A=" << linepair.first.line
+                          << ",B=" << linepair.second.line << ",n=" << node
+                          << ")";
+                lp->setRowName(rowT2, rowTName2.str());
+              }
 
               lp->addColToRow(rowT, aNearBinL1, -1);
               lp->addColToRow(rowT, aNearBinL2, 1);
@@ -489,12 +470,9 @@ void ILPEdgeOrderOptimizer::writeCrossingOracle(const std::set<OptNode*>& g,
               OptEdge* segment =
                   segmentA->pl().getCardinality() != 2 ? segmentA : segmentB;
 
-              std::stringstream aNearBStr;
-              aNearBStr << "x_(" << segment->pl().getStrRepr() << ","
-                        << linepair.first.line << "<T>" << linepair.second.line
-                        << ")";
-
-              lp->setObjCoef(aNearBStr.str(), getSeparationPenalty(node));
+              lp->setObjCoef(getNearVar(*vars, segment, linepair.first.line,
+                                        linepair.second.line),
+                             getSeparationPenalty(node));
             }
           }
         }
@@ -505,7 +483,7 @@ void ILPEdgeOrderOptimizer::writeCrossingOracle(const std::set<OptNode*>& g,
 
 // _____________________________________________________________________________
 void ILPEdgeOrderOptimizer::writeDiffSegConstraintsImpr(
-    const std::set<OptNode*>& g, ILPSolver* lp) const {
+    const std::set<OptNode*>& g, const ILPVarIdx& vars, ILPSolver* lp) const {
   // go into nodes and build crossing constraints for adjacent
   for (OptNode* node : g) {
     std::set<OptEdge*> processed;
@@ -518,48 +496,48 @@ void ILPEdgeOrderOptimizer::writeDiffSegConstraintsImpr(
           // try all position combinations
 
           // introduce dec var
-          std::stringstream ss;
-          ss << "x_dec(" << segmentA->pl().getStrRepr() << ","
-             << segments.first->pl().getStrRepr()
-             << segments.second->pl().getStrRepr() << "," << linepair.first.line
-             << "(" << linepair.first.line->id() << ")," << linepair.second.line
-             << "(" << linepair.second.line->id() << ")," << node << ")";
-
           int decisionVar = lp->addCol(
-              ss.str(), shared::optim::BIN,
+              shared::optim::BIN,
               getCrossingPenaltyDiffSeg(node)
                   // multiply the penalty with the number of collapsed lines!
                   * (linepair.first.relatives.size()) *
                   (linepair.second.relatives.size()));
 
+          if (lp->isNamed()) {
+            std::stringstream ss;
+            ss << "x_dec(" << segmentA->pl().getStrRepr() << ","
+               << segments.first->pl().getStrRepr()
+               << segments.second->pl().getStrRepr() << ","
+               << linepair.first.line << "(" << linepair.first.line->id()
+               << ")," << linepair.second.line << "("
+               << linepair.second.line->id() << ")," << node << ")";
+            lp->setColName(decisionVar, ss.str());
+          }
+
           for (PosCom poscomb : getPositionCombinations(segmentA)) {
             if (crosses(node, segmentA, segments, poscomb)) {
               int testVar = 0;
 
               if (poscomb.first > poscomb.second) {
-                std::stringstream bBgAStr;
-                bBgAStr << "x_(" << segmentA->pl().getStrRepr() << ","
-                        << linepair.first.line << "<" << linepair.second.line
-                        << ")";
-                testVar = lp->getVarByName(bBgAStr.str());
+                testVar = getSmallerVar(vars, segmentA, linepair.first.line,
+                                        linepair.second.line);
               } else {
-                std::stringstream bBgAStr;
-                bBgAStr << "x_(" << segmentA->pl().getStrRepr() << ","
-                        << linepair.second.line << "<" << linepair.first.line
-                        << ")";
-                testVar = lp->getVarByName(bBgAStr.str());
+                testVar = getSmallerVar(vars, segmentA, linepair.second.line,
+                                        linepair.first.line);
               }
 
-              assert(testVar);
-              std::stringstream ss;
-              ss << "dec_sum(" << segmentA->pl().getStrRepr() << ","
-                 << segments.first->pl().getStrRepr()
-                 << segments.second->pl().getStrRepr() << ","
-                 << linepair.first.line << "," << linepair.second.line
-                 << "pa=" << poscomb.first << ",pb=" << poscomb.second
-                 << ",n=" << node << ")";
-
-              int row = lp->addRow(ss.str(), 0, shared::optim::FIX);
+              int row = lp->addRow(0, shared::optim::FIX);
+
+              if (lp->isNamed()) {
+                std::stringstream ss;
+                ss << "dec_sum(" << segmentA->pl().getStrRepr() << ","
+                   << segments.first->pl().getStrRepr()
+                   << segments.second->pl().getStrRepr() << ","
+                   << linepair.first.line << "," << linepair.second.line
+                   << "pa=" << poscomb.first << ",pb=" << poscomb.second
+                   << ",n=" << node << ")";
+                lp->setRowName(row, ss.str());
+              }
 
               lp->addColToRow(row, testVar, 1);
               lp->addColToRow(row, decisionVar, -1);
@@ -573,3 +551,24 @@ void ILPEdgeOrderOptimizer::writeDiffSegConstraintsImpr(
     }
   }
 }
+
+// _____________________________________________________________________________
+int ILPEdgeOrderOptimizer::getSmallerVar(const ILPVarIdx& vars,
+                                         const OptEdge* e, const Line* a,
+                                         const Line* b) {
+  int ret = vars.find(e)->second.smaller[lineIdx(e, a) *
+                                             e->pl().getCardinality() +
+                                         lineIdx(e, b)];
+  assert(ret > -1);
+  return ret;
+}
+
+// _____________________________________________________________________________
+int ILPEdgeOrderOptimizer::getNearVar(const ILPVarIdx& vars, const OptEdge* e,
+                                      const Line* a, const Line* b) {
+  int ret =
+      vars.find(e)->second.near[lineIdx(e, a) * e->pl().getCardinality() +
+                                lineIdx(e, b)];
+  assert(ret > -1);
+  return ret;
+}
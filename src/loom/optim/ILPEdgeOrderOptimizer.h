@@ -26,17 +26,31 @@ class ILPEdgeOrderOptimizer : public ILPOptimizer {
 
  private:
   virtual shared::optim::ILPSolver* createProblem(
-      OptGraph* og, const std::set<OptNode*>& g) const;
+      OptGraph* og, const std::set<OptNode*>& g, ILPVarIdx* vars) const;
 
-  virtual void getConfigurationFromSolution(
-      shared::optim::ILPSolver* lp, shared::rendergraph::HierarOrderCfg* c,
-      const std::set<OptNode*>& g) const;
+  virtual void getConfigurationFromSolution(shared::optim::ILPSolver* lp,
+                                            const ILPVarIdx& vars,
+                                            OptOrderCfg* cfg) const;
 
-  void writeCrossingOracle(const std::set<OptNode*>& g,
+  virtual shared::optim::StarterSol getStarter(const OptOrderCfg& cfg,
+                                               const ILPVarIdx& vars) const;
+
+  void writeCrossingOracle(const std::set<OptNode*>& g, ILPVarIdx* vars,
                            shared::optim::ILPSolver* lp) const;
 
   void writeDiffSegConstraintsImpr(const std::set<OptNode*>& g,
+                                   const ILPVarIdx& vars,
                                    shared::optim::ILPSolver* lp) const;
+
+  // column handle of the variable x_(e,A<B)
+  static int getSmallerVar(const ILPVarIdx& vars, const OptEdge* e,
+                           const shared::linegraph::Line* a,
+                           const shared::linegraph::Line* b);
+
+  // column handle of the variable x_(e,A<T>B)
+  static int getNearVar(const ILPVarIdx& vars, const OptEdge* e,
+                        const shared::linegraph::Line* a,
+                        const shared::linegraph::Line* b);
 };
 }  // namespace optim
 }  // namespace loom
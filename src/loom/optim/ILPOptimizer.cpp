@@ -5,7 +5,9 @@
 #include <chrono>
 #include <cstdio>
 #include <fstream>
+#include <mutex>
 #include <thread>
+#include "loom/optim/HillClimbOptimizer.h"
 #include "loom/optim/ILPOptimizer.h"
 #include "loom/optim/OptGraph.h"
 #include "shared/optim/ILPSolvProv.h"
@@ -19,6 +21,7 @@ using namespace loom;
 using namespace optim;
 using shared::linegraph::Line;
 using shared::optim::ILPSolver;
+using shared::optim::StarterSol;
 using shared::rendergraph::HierarOrderCfg;
 
 // _____________________________________________________________________________
@@ -31,9 +34,47 @@ double ILPOptimizer::optimizeComp(OptGraph* og, const std::set<OptNode*>& g,
     return _exhausOpt.optimizeComp(og, g, hc, depth + 1, stats);
   }
 
+  OptOrderCfg cfg(g);
+  ILPCacheKey cacheKey;
+  bool nearHit = false;
+
+  if (_cfg->ilpCacheDir.size()) {
+    T_START(cache);
+    cacheKey = _cache.getKey(g);
+
+    if (_cache.get(cacheKey, &cfg)) {
+      stats.ilpCacheHits++;
+      writeHierarch(cfg, hc);
+      LOGTO(DEBUG, std::cerr) << "Reused cached ILP solution";
+      return T_STOP(cache);
+    }
+
+    nearHit = _cache.getNear(cacheKey, &cfg);
+    if (nearHit) {
+      stats.ilpCacheNearHits++;
+    } else {
+      stats.ilpCacheMisses++;
+    }
+  }
+
+  // a heuristic ordering, improved from the cached one on a near hit, is
+  // given to the solver as its first incumbent
+  T_START(heur);
+  HillClimbOptimizer hillc(_cfg, _scorer.getPens(), false);
+  if (nearHit) {
+    hillc.climb(g, &cfg);
+  } else {
+    hillc.getFlatConfig(g, &cfg);
+  }
+  double heurT = T_STOP(heur);
+  LOGTO(DEBUG, std::cerr) << "Heuristic starting ordering has score "
+                          << _scorer.getTotalScore(g, cfg) << " (took "
+                          << heurT << " ms)";
+
   LOGTO(DEBUG, std::cerr) << "Creating ILP problem... ";
   T_START(build);
-  auto lp = createProblem(og, g);
+  ILPVarIdx vars;
+  auto lp = createProblem(og, g, &vars);
   double buildT = T_STOP(build);
   LOGTO(DEBUG, std::cerr) << " .. done";
 
@@ -42,6 +83,14 @@ double ILPOptimizer::optimizeComp(OptGraph* og, const std::set<OptNode*>& g,
   if (lp->getNumConstrs() > static_cast<int>(stats.maxNumRowsPerComp))
     stats.maxNumRowsPerComp = lp->getNumConstrs();
 
+  // the remaining variables follow from the line positions
+  auto starter = lp->completeStarter(getStarter(cfg, vars));
+  if (starter.empty()) {
+    LOGTO(DEBUG, std::cerr) << "Heuristic ordering is not a feasible ILP "
+                               "solution, solving without a starter";
+  }
+  lp->setStarter(starter);
+
   if (_cfg->MPSOutputPath.size()) {
     lp->writeMps(_cfg->MPSOutputPath);
   }
@@ -51,16 +100,27 @@ double ILPOptimizer::optimizeComp(OptGraph* og, const std::set<OptNode*>& g,
 
   LOGTO(DEBUG, std::cerr) << "Solving ILP problem...";
 
-  T_START(solve);
-
-  auto status = lp->solve();
-
-  double solveT = T_STOP(solve);
+  // every component builds its own problem, but the solver libraries are not
+  // guaranteed to be re-entrant, so components optimized in parallel are
+  // solved one at a time
+  static std::mutex solveMut;
+  shared::optim::SolveType status;
+  double solveT;
+
+  {
+    std::lock_guard<std::mutex> lock(solveMut);
+    T_START(solve);
+    status = lp->solve();
+    solveT = T_STOP(solve);
+  }
 
   if (status == shared::optim::SolveType::INF) {
     LOG(WARN)
         << "No solution found for ILP problem (most likely because of a time "
            "limit)!";
+
+    // fall back to the heuristic ordering
+    writeHierarch(cfg, hc);
   } else {
     LOGTO(INFO, std::cerr) << "(stats) ILP obj = " << lp->getObjVal();
     LOGTO(INFO, std::cerr) << "(stats) ILP build time = " << buildT << " ms";
@@ -68,7 +128,12 @@ double ILPOptimizer::optimizeComp(OptGraph* og, const std::set<OptNode*>& g,
     if (status == shared::optim::SolveType::OPTIM)
       LOGTO(INFO, std::cerr) << "(stats) (which is optimal)";
 
-    getConfigurationFromSolution(lp, hc, g);
+    getConfigurationFromSolution(lp, vars, &cfg);
+    writeHierarch(cfg, hc);
+
+    // only optimal solutions are reused as they are
+    if (status == shared::optim::SolveType::OPTIM && cacheKey.full.size())
+      _cache.put(cacheKey, cfg);
   }
 
   delete lp;
@@ -93,91 +158,103 @@ int ILPOptimizer::getSeparationPenalty(const OptNode* n) const {
 }
 
 // _____________________________________________________________________________
-void ILPOptimizer::getConfigurationFromSolution(
-    ILPSolver* lp, HierarOrderCfg* hc, const std::set<OptNode*>& g) const {
-  // build name index for faster lookup
+void ILPOptimizer::getConfigurationFromSolution(ILPSolver* lp,
+                                                const ILPVarIdx& vars,
+                                                OptOrderCfg* cfg) const {
+  for (size_t eid = 0; eid < cfg->numEdgs(); eid++) {
+    const OptEdge* e = cfg->getEdg(eid);
+    const auto& lines = e->pl().getLines();
+    std::vector<size_t> order(cfg->size(eid));
+
+    for (size_t tp = 0; tp < e->pl().getCardinality(); tp++) {
+      bool found = false;
+      for (size_t k = 0; k < lines.size(); k++) {
+        double val = lp->getVarVal(getILPVar(vars, e, lines[k].line, tp));
+
+        if (val > 0.5) {
+          order[tp] = k;
+          assert(!found);  // should be assured by ILP constraints
+          found = true;
+        }
+      }
+      assert(found);
+    }
 
-  for (OptNode* n : g) {
-    for (OptEdge* e : n->getAdjList()) {
-      if (e->getFrom() != n) continue;
-      for (auto lnEdgPart : e->pl().lnEdgParts) {
-        if (lnEdgPart.wasCut) continue;
-        for (size_t tp = 0; tp < e->pl().getCardinality(); tp++) {
-          bool found = false;
-          for (auto lo : e->pl().getLines()) {
-            std::string varName = getILPVarName(e, lo.line, tp);
-
-            double val = lp->getVarVal(varName);
-
-            if (val > 0.5) {
-              for (auto rel : lo.relatives) {
-                // retrieve the original route pos
-                size_t p = lnEdgPart.lnEdg->pl().linePos(rel);
-
-                if (!(lnEdgPart.dir ^ e->pl().lnEdgParts.front().dir)) {
-                  (*hc)[lnEdgPart.lnEdg][lnEdgPart.order].insert(
-                      (*hc)[lnEdgPart.lnEdg][lnEdgPart.order].begin(), p);
-                } else {
-                  (*hc)[lnEdgPart.lnEdg][lnEdgPart.order].push_back(p);
-                }
-              }
+    cfg->setOrder(eid, order);
+  }
+}
 
-              assert(!found);  // should be assured by ILP constraints
-              found = true;
-            }
-          }
-          assert(found);
-        }
+// _____________________________________________________________________________
+StarterSol ILPOptimizer::getStarter(const OptOrderCfg& cfg,
+                                    const ILPVarIdx& vars) const {
+  StarterSol sol;
+
+  for (size_t eid = 0; eid < cfg.numEdgs(); eid++) {
+    const OptEdge* e = cfg.getEdg(eid);
+    const auto& lines = e->pl().getLines();
+
+    // x_(e,r,p) is 1 iff r is at position p
+    for (size_t k = 0; k < lines.size(); k++) {
+      for (size_t p = 0; p < e->pl().getCardinality(); p++) {
+        sol[getILPVar(vars, e, lines[k].line, p)] = cfg.pos(eid, k) == p;
       }
     }
   }
+
+  return sol;
 }
 
 // _____________________________________________________________________________
 ILPSolver* ILPOptimizer::createProblem(OptGraph* og,
-                                       const std::set<OptNode*>& g) const {
+                                       const std::set<OptNode*>& g,
+                                       ILPVarIdx* vars) const {
   ILPSolver* lp = shared::optim::getSolver(_cfg->ilpSolver, shared::optim::MIN);
 
+  // names are only needed for MPS output
+  lp->setNamed(_cfg->MPSOutputPath.size());
+
   // for every segment s, we define |L(s)|^2 decision variables x_slp
   for (OptNode* n : g) {
     for (OptEdge* e : n->getAdjList()) {
       if (e->getFrom() != n) continue;
       // get string repr of lineedge part
 
-      size_t i = 0;
       int rowA = lp->getNumConstrs();
+      (*vars)[e].pos = lp->getNumVars();
 
       for (size_t p = 0; p < e->pl().getCardinality(); p++) {
-        std::stringstream rowName;
+        int row = lp->addRow(1, shared::optim::FIX);
 
-        rowName << "sum(" << e->pl().getStrRepr() << ",p=" << p << ")";
-        lp->addRow(rowName.str(), 1, shared::optim::FIX);
+        if (lp->isNamed()) {
+          std::stringstream rowName;
+          rowName << "sum(" << e->pl().getStrRepr() << ",p=" << p << ")";
+          lp->setRowName(row, rowName.str());
+        }
       }
 
       for (auto l : e->pl().getLines()) {
         // constraint: the sum of all x_slp over p must be 1 for equal sl
-        std::stringstream rowName;
-        rowName << "sum(" << e->pl().getStrRepr() << ",l=" << l.line << ")";
+        int row = lp->addRow(1, shared::optim::FIX);
 
-        int row = lp->addRow(rowName.str(), 1, shared::optim::FIX);
+        if (lp->isNamed()) {
+          std::stringstream rowName;
+          rowName << "sum(" << e->pl().getStrRepr() << ",l=" << l.line << ")";
+          lp->setRowName(row, rowName.str());
+        }
 
         for (size_t p = 0; p < e->pl().getCardinality(); p++) {
-          std::string varName = getILPVarName(e, l.line, p);
-          int curCol = lp->addCol(varName, shared::optim::BIN, 0);
+          int curCol = lp->addCol(shared::optim::BIN, 0);
+          if (lp->isNamed()) lp->setColName(curCol, getILPVarName(e, l.line, p));
 
           lp->addColToRow(row, curCol, 1);
           lp->addColToRow(rowA + p, curCol, 1);
-
-          i++;
         }
       }
     }
   }
 
-  lp->update();
-
-  writeSameSegConstraints(og, g, lp);
-  writeDiffSegConstraints(og, g, lp);
+  writeSameSegConstraints(og, g, *vars, lp);
+  writeDiffSegConstraints(og, g, *vars, lp);
 
   return lp;
 }
@@ -185,6 +262,7 @@ ILPSolver* ILPOptimizer::createProblem(OptGraph* og,
 // _____________________________________________________________________________
 void ILPOptimizer::writeSameSegConstraints(OptGraph* og,
                                            const std::set<OptNode*>& g,
+                                           const ILPVarIdx& vars,
                                            ILPSolver* lp) const {
   UNUSED(og);
   // go into nodes and build crossing constraints for adjacent
@@ -203,59 +281,65 @@ void ILPOptimizer::writeSameSegConstraints(OptGraph* og,
           // try all position combinations
 
           // introduce dec var
-          std::stringstream ss;
-          ss << "x_dec(" << segmentA->pl().getStrRepr() << ","
-             << segmentB->pl().getStrRepr() << "," << linepair.first.line << "("
-             << linepair.first.line->id() << ")," << linepair.second.line << "("
-             << linepair.second.line->id() << ")," << node << ")";
-
           int decisionVar = lp->addCol(
-              ss.str(), shared::optim::BIN,
+              shared::optim::BIN,
               getCrossingPenaltySameSeg(node)
                   // multiply the penalty with the number of collapsed lines!
                   * (linepair.first.relatives.size()) *
                   (linepair.second.relatives.size()));
 
-          // introduce dec var for sep
-          std::stringstream sss;
-          sss << "x||_dec(" << segmentA->pl().getStrRepr() << ","
-              << segmentB->pl().getStrRepr() << "," << linepair.first.line
-              << "(" << linepair.first.line->id() << "),"
-              << linepair.second.line << "(" << linepair.second.line->id()
-              << ")," << node << ")";
+          if (lp->isNamed()) {
+            std::stringstream ss;
+            ss << "x_dec(" << segmentA->pl().getStrRepr() << ","
+               << segmentB->pl().getStrRepr() << "," << linepair.first.line
+               << "(" << linepair.first.line->id() << "),"
+               << linepair.second.line << "(" << linepair.second.line->id()
+               << ")," << node << ")";
+            lp->setColName(decisionVar, ss.str());
+          }
 
+          // introduce dec var for sep
           int decisionVarSep = 0;
           if (separationOpt()) {
-            decisionVarSep = lp->addCol(sss.str(), shared::optim::BIN,
-                                        getSeparationPenalty(node));
+            decisionVarSep =
+                lp->addCol(shared::optim::BIN, getSeparationPenalty(node));
+
+            if (lp->isNamed()) {
+              std::stringstream sss;
+              sss << "x||_dec(" << segmentA->pl().getStrRepr() << ","
+                  << segmentB->pl().getStrRepr() << "," << linepair.first.line
+                  << "(" << linepair.first.line->id() << "),"
+                  << linepair.second.line << "(" << linepair.second.line->id()
+                  << ")," << node << ")";
+              lp->setColName(decisionVarSep, sss.str());
+            }
           }
 
           for (PosComPair poscomb :
                getPositionCombinations(segmentA, segmentB)) {
             if (crosses(node, segmentA, segmentB, poscomb)) {
-              int lineAinAatP = lp->getVarByName(getILPVarName(
-                  segmentA, linepair.first.line, poscomb.first.first));
-              int lineBinAatP = lp->getVarByName(getILPVarName(
-                  segmentA, linepair.second.line, poscomb.second.first));
-              int lineAinBatP = lp->getVarByName(getILPVarName(
-                  segmentB, linepair.first.line, poscomb.first.second));
-              int lineBinBatP = lp->getVarByName(getILPVarName(
-                  segmentB, linepair.second.line, poscomb.second.second));
-
-              assert(lineAinAatP > -1);
-              assert(lineAinBatP > -1);
-              assert(lineBinAatP > -1);
-              assert(lineBinBatP > -1);
-
-              std::stringstream ss;
-              ss << "dec_sum(" << segmentA->pl().getStrRepr() << ","
-                 << segmentB->pl().getStrRepr() << "," << linepair.first.line
-                 << "," << linepair.second.line << "pa=" << poscomb.first.first
-                 << ",pb=" << poscomb.second.first
-                 << ",pa'=" << poscomb.first.second
-                 << ",pb'=" << poscomb.second.second << ",n=" << node << ")";
-
-              int row = lp->addRow(ss.str(), 3, shared::optim::UP);
+              int lineAinAatP = getILPVar(vars, segmentA, linepair.first.line,
+                                          poscomb.first.first);
+              int lineBinAatP = getILPVar(vars, segmentA, linepair.second.line,
+                                          poscomb.second.first);
+              int lineAinBatP = getILPVar(vars, segmentB, linepair.first.line,
+                                          poscomb.first.second);
+              int lineBinBatP = getILPVar(vars, segmentB, linepair.second.line,
+                                          poscomb.second.second);
+
+              int row = lp->addRow(3, shared::optim::UP);
+
+              if (lp->isNamed()) {
+                std::stringstream ss;
+                ss << "dec_sum(" << segmentA->pl().getStrRepr() << ","
+                   << segmentB->pl().getStrRepr() << "," << linepair.first.line
+                   << "," << linepair.second.line
+                   << "pa=" << poscomb.first.first
+                   << ",pb=" << poscomb.second.first
+                   << ",pa'=" << poscomb.first.second
+                   << ",pb'=" << poscomb.second.second << ",n=" << node << ")";
+                lp->setRowName(row, ss.str());
+              }
 
               lp->addColToRow(row, lineAinAatP, 1);
               lp->addColToRow(row, lineBinAatP, 1);
@@ -265,29 +349,28 @@ void ILPOptimizer::writeSameSegConstraints(OptGraph* og,
             }
 
             if (separationOpt() && separates(poscomb)) {
-              int lineAinAatP = lp->getVarByName(getILPVarName(
-                  segmentA, linepair.first.line, poscomb.first.first));
-              int lineBinAatP = lp->getVarByName(getILPVarName(
-                  segmentA, linepair.second.line, poscomb.second.first));
-              int lineAinBatP = lp->getVarByName(getILPVarName(
-                  segmentB, linepair.first.line, poscomb.first.second));
-              int lineBinBatP = lp->getVarByName(getILPVarName(
-                  segmentB, linepair.second.line, poscomb.second.second));
-
-              assert(lineAinAatP > -1);
-              assert(lineAinBatP > -1);
-              assert(lineBinAatP > -1);
-              assert(lineBinBatP > -1);
-
-              std::stringstream ss;
-              ss << "dec_sum_sep(" << segmentA->pl().getStrRepr() << ","
-                 << segmentB->pl().getStrRepr() << "," << linepair.first.line
-                 << "," << linepair.second.line << "pa=" << poscomb.first.first
-                 << ",pb=" << poscomb.second.first
-                 << ",pa'=" << poscomb.first.second
-                 << ",pb'=" << poscomb.second.second << ",n=" << node << ")";
-
-              int row = lp->addRow(ss.str(), 3, shared::optim::UP);
+              int lineAinAatP = getILPVar(vars, segmentA, linepair.first.line,
+                                          poscomb.first.first);
+              int lineBinAatP = getILPVar(vars, segmentA, linepair.second.line,
+                                          poscomb.second.first);
+              int lineAinBatP = getILPVar(vars, segmentB, linepair.first.line,
+                                          poscomb.first.second);
+              int lineBinBatP = getILPVar(vars, segmentB, linepair.second.line,
+                                          poscomb.second.second);
+
+              int row = lp->addRow(3, shared::optim::UP);
+
+              if (lp->isNamed()) {
+                std::stringstream ss;
+                ss << "dec_sum_sep(" << segmentA->pl().getStrRepr() << ","
+                   << segmentB->pl().getStrRepr() << "," << linepair.first.line
+                   << "," << linepair.second.line
+                   << "pa=" << poscomb.first.first
+                   << ",pb=" << poscomb.second.first
+                   << ",pa'=" << poscomb.first.second
+                   << ",pb'=" << poscomb.second.second << ",n=" << node << ")";
+                lp->setRowName(row, ss.str());
+              }
 
               lp->addColToRow(row, lineAinAatP, 1);
               lp->addColToRow(row, lineBinAatP, 1);
@@ -305,6 +388,7 @@ void ILPOptimizer::writeSameSegConstraints(OptGraph* og,
 // _____________________________________________________________________________
 void ILPOptimizer::writeDiffSegConstraints(OptGraph* og,
                                            const std::set<OptNode*>& g,
+                                           const ILPVarIdx& vars,
                                            ILPSolver* lp) const {
   UNUSED(og);
   // go into nodes and build crossing constraints for adjacent
@@ -319,39 +403,43 @@ void ILPOptimizer::writeDiffSegConstraints(OptGraph* og,
           // try all position combinations
 
           // introduce dec var
-          std::stringstream ss;
-          ss << "x_dec(" << segmentA->pl().getStrRepr() << ","
-             << segments.first->pl().getStrRepr()
-             << segments.second->pl().getStrRepr() << "," << linepair.first.line
-             << "(" << linepair.first.line->id() << ")," << linepair.second.line
-             << "(" << linepair.second.line->id() << ")," << node << ")";
-
           int decisionVar = lp->addCol(
-              ss.str(), shared::optim::BIN,
+              shared::optim::BIN,
               getCrossingPenaltyDiffSeg(node)
                   // multiply the penalty with the number of collapsed lines!
                   * (linepair.first.relatives.size()) *
                   (linepair.second.relatives.size()));
 
+          if (lp->isNamed()) {
+            std::stringstream ss;
+            ss << "x_dec(" << segmentA->pl().getStrRepr() << ","
+               << segments.first->pl().getStrRepr()
+               << segments.second->pl().getStrRepr() << ","
+               << linepair.first.line << "(" << linepair.first.line->id()
+               << ")," << linepair.second.line << "("
+               << linepair.second.line->id() << ")," << node << ")";
+            lp->setColName(decisionVar, ss.str());
+          }
+
           for (PosCom poscomb : getPositionCombinations(segmentA)) {
             if (crosses(node, segmentA, segments, poscomb)) {
-              int lineAinAatP = lp->getVarByName(
-                  getILPVarName(segmentA, linepair.first.line, poscomb.first));
-              int lineBinAatP = lp->getVarByName(getILPVarName(
-                  segmentA, linepair.second.line, poscomb.second));
-
-              assert(lineAinAatP > -1);
-              assert(lineBinAatP > -1);
-
-              std::stringstream ss;
-              ss << "dec_sum(" << segmentA->pl().getStrRepr() << ","
-                 << segments.first->pl().getStrRepr()
-                 << segments.second->pl().getStrRepr() << ","
-                 << linepair.first.line << "," << linepair.second.line
-                 << "pa=" << poscomb.first << ",pb=" << poscomb.second
-                 << ",n=" << node << ")";
-
-              int row = lp->addRow(ss.str(), 1, shared::optim::UP);
+              int lineAinAatP =
+                  getILPVar(vars, segmentA, linepair.first.line, poscomb.first);
+              int lineBinAatP = getILPVar(vars, segmentA, linepair.second.line,
+                                          poscomb.second);
+
+              int row = lp->addRow(1, shared::optim::UP);
+
+              if (lp->isNamed()) {
+                std::stringstream ss;
+                ss << "dec_sum(" << segmentA->pl().getStrRepr() << ","
+                   << segments.first->pl().getStrRepr()
+                   << segments.second->pl().getStrRepr() << ","
+                   << linepair.first.line << "," << linepair.second.line
+                   << "pa=" << poscomb.first << ",pb=" << poscomb.second
+                   << ",n=" << node << ")";
+                lp->setRowName(row, ss.str());
+              }
 
               lp->addColToRow(row, lineAinAatP, 1);
               lp->addColToRow(row, lineBinAatP, 1);
@@ -412,5 +500,22 @@ std::string ILPOptimizer::getILPVarName(OptEdge* seg, const Line* r,
   return varName.str();
 }
 
+// _____________________________________________________________________________
+size_t ILPOptimizer::lineIdx(const OptEdge* e, const Line* r) {
+  const auto& lines = e->pl().getLines();
+  for (size_t k = 0; k < lines.size(); k++) {
+    if (lines[k].line == r) return k;
+  }
+  assert(false);
+  return 0;
+}
+
+// _____________________________________________________________________________
+int ILPOptimizer::getILPVar(const ILPVarIdx& vars, const OptEdge* e,
+                            const Line* r, size_t p) {
+  return vars.find(e)->second.pos + lineIdx(e, r) * e->pl().getCardinality() +
+         p;
+}
+
 // _____________________________________________________________________________
 bool ILPOptimizer::separationOpt() const { return _scorer.optimizeSep(); }
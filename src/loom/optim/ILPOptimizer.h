@@ -5,9 +5,13 @@
 #ifndef LOOM_OPTIM_ILPOPTIMIZER_H_
 #define LOOM_OPTIM_ILPOPTIMIZER_H_
 
+#include <unordered_map>
+#include <vector>
 #include "loom/optim/ExhaustiveOptimizer.h"
 #include "loom/config/LoomConfig.h"
+#include "loom/optim/ILPCache.h"
 #include "loom/optim/OptGraph.h"
+#include "loom/optim/OptOrderCfg.h"
 #include "loom/optim/Optimizer.h"
 #include "shared/linegraph/Line.h"
 #include "shared/optim/ILPSolver.h"
@@ -16,11 +20,27 @@
 namespace loom {
 namespace optim {
 
+// column handles of the ILP variables belonging to an edge
+struct ILPEdgeVars {
+  // first position variable, the variable for line occurrence k at position
+  // p is at pos + k * cardinality + p
+  int pos;
+
+  // pairwise line variables, indexed by a * cardinality + b for line
+  // occurrences a and b, -1 if not present
+  std::vector<int> smaller;
+  std::vector<int> near;
+};
+
+typedef std::unordered_map<const OptEdge*, ILPEdgeVars> ILPVarIdx;
+
 class ILPOptimizer : public Optimizer {
  public:
   ILPOptimizer(const config::Config* cfg,
                const shared::rendergraph::Penalties& pens)
-      : Optimizer(cfg, pens), _exhausOpt(cfg, pens) {};
+      : Optimizer(cfg, pens),
+        _exhausOpt(cfg, pens),
+        _cache(cfg->ilpCacheDir, _scorer) {};
 
   virtual double optimizeComp(OptGraph* og, const std::set<OptNode*>& g,
                               shared::rendergraph::HierarOrderCfg* c,
@@ -28,20 +48,36 @@ class ILPOptimizer : public Optimizer {
 
  protected:
   const loom::optim::ExhaustiveOptimizer _exhausOpt;
+  const ILPCache _cache;
+
   virtual shared::optim::ILPSolver* createProblem(
-      OptGraph* og, const std::set<OptNode*>& g) const;
+      OptGraph* og, const std::set<OptNode*>& g, ILPVarIdx* vars) const;
+
+  // write the line orderings of a solved problem into cfg
+  virtual void getConfigurationFromSolution(shared::optim::ILPSolver* lp,
+                                            const ILPVarIdx& vars,
+                                            OptOrderCfg* cfg) const;
 
-  virtual void getConfigurationFromSolution(
-      shared::optim::ILPSolver* lp, shared::rendergraph::HierarOrderCfg* c,
-      const std::set<OptNode*>& g) const;
+  // the values of the position variables for the orderings in cfg
+  virtual shared::optim::StarterSol getStarter(const OptOrderCfg& cfg,
+                                               const ILPVarIdx& vars) const;
 
   std::string getILPVarName(OptEdge* e, const shared::linegraph::Line* r,
                             size_t p) const;
 
+  // column handle of the position variable of line r at position p on e
+  static int getILPVar(const ILPVarIdx& vars, const OptEdge* e,
+                       const shared::linegraph::Line* r, size_t p);
+
+  // index of line r into the line occurrences of e
+  static size_t lineIdx(const OptEdge* e, const shared::linegraph::Line* r);
+
   void writeSameSegConstraints(OptGraph* og, const std::set<OptNode*>& g,
+                               const ILPVarIdx& vars,
                                shared::optim::ILPSolver* lp) const;
 
   void writeDiffSegConstraints(OptGraph* og, const std::set<OptNode*>& g,
+                               const ILPVarIdx& vars,
                                shared::optim::ILPSolver* lp) const;
 
   std::vector<PosComPair> getPositionCombinations(OptEdge* a, OptEdge* b) const;
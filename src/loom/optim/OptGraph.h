@@ -25,10 +25,6 @@ class OptGraphScorer;
 typedef util::graph::Node<OptNodePL, OptEdgePL> OptNode;
 typedef util::graph::Edge<OptNodePL, OptEdgePL> OptEdge;
 
-typedef std::map<const loom::optim::OptEdge*,
-                 std::vector<const shared::linegraph::Line*>>
-    OptOrderCfg;
-
 struct OptLO {
   OptLO() : line(0), dir(0) {}
   OptLO(const shared::linegraph::Line* r,
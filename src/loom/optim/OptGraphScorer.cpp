@@ -2,7 +2,6 @@
 // Chair of Algorithms and Data Structures.
 // Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
 
-#include <map>
 #include "loom/optim/OptGraph.h"
 #include "loom/optim/OptGraphScorer.h"
 #include "loom/optim/Optimizer.h"
@@ -83,6 +82,43 @@ double OptGraphScorer::getTotalScore(const std::set<OptNode*>& g,
   return ret;
 }
 
+// _____________________________________________________________________________
+double OptGraphScorer::initNodeScores(const std::set<OptNode*>& g,
+                                      const OptOrderCfg& c,
+                                      OptNodeScores* scores) const {
+  double ret = 0;
+
+  for (auto n : g) {
+    double s = getTotalScore(n, c);
+    (*scores)[n] = s;
+    ret += s;
+  }
+
+  return ret;
+}
+
+// _____________________________________________________________________________
+double OptGraphScorer::getScoreDelta(OptEdge* e, const OptOrderCfg& c,
+                                     const OptNodeScores& scores) const {
+  return getTotalScore(e->getFrom(), c) - scores.find(e->getFrom())->second +
+         getTotalScore(e->getTo(), c) - scores.find(e->getTo())->second;
+}
+
+// _____________________________________________________________________________
+double OptGraphScorer::updateNodeScores(OptEdge* e, const OptOrderCfg& c,
+                                        OptNodeScores* scores) const {
+  double ret = 0;
+
+  for (auto n : {e->getFrom(), e->getTo()}) {
+    double& cached = (*scores)[n];
+    double s = getTotalScore(n, c);
+    ret += s - cached;
+    cached = s;
+  }
+
+  return ret;
+}
+
 // _____________________________________________________________________________
 double OptGraphScorer::getTotalScore(OptEdge* e, const OptOrderCfg& c) const {
   return getTotalScore(e->getFrom(), c) + getTotalScore(e->getTo(), c);
@@ -181,42 +217,36 @@ std::pair<std::pair<size_t, size_t>, size_t> OptGraphScorer::getNumCrossSeps(
 // _____________________________________________________________________________
 size_t OptGraphScorer::getNumCrossDiffSeg(OptNode* n, OptEdge* ea,
                                           const OptOrderCfg& c) const {
-  std::map<const Line*, size_t> ordering;
-
   bool revA = (ea->getFrom() != n) ^ ea->pl().lnEdgParts.front().dir;
 
-  const auto& cea = c.at(ea);
-
-  for (size_t i = 0; i < cea.size(); i++) {
-    const auto& l = cea[i];
-    ordering[l] = revA ? cea.size() - 1 - i : i;
-  }
+  size_t a = c.id(ea);
+  size_t sizeA = c.size(a);
+  const auto* adjA = OptGraph::getAdjEdg(ea, n);
 
   std::vector<size_t> relOrderCross;
 
   for (const auto& eb : OptGraph::clockwEdges(ea, n)) {
-    const auto& ceb = c.at(eb);
+    size_t b = c.id(eb);
+    size_t sizeB = c.size(b);
     bool revB = (eb->getFrom() != n) ^ eb->pl().lnEdgParts.front().dir;
+    const auto* adjB = OptGraph::getAdjEdg(eb, n);
 
-    for (size_t i = 0; i < ceb.size(); i++) {
-      const auto& thisLine = ceb[!revB ? ceb.size() - 1 - i : i];
+    for (size_t i = 0; i < sizeB; i++) {
+      size_t kb = c.at(b, !revB ? sizeB - 1 - i : i);
+      size_t ka = c.find(a, c.lineId(b, kb));
+      if (ka == OptOrderCfg::NPOS) continue;
 
-      auto otherIt = ordering.find(thisLine);
-      if (otherIt == ordering.end()) continue;
+      size_t pos = c.pos(a, ka);
 
-      const auto* eaLo = ea->pl().getLineOcc(otherIt->first);
-      const auto* ebLo = eb->pl().getLineOcc(thisLine);
-
-      assert(eaLo);
-      assert(ebLo);
+      const auto* eaLo = &c.lineOcc(a, ka);
+      const auto* ebLo = &c.lineOcc(b, kb);
 
       if ((eaLo->dir == 0 || ebLo->dir == 0 ||
            (eaLo->dir == n->pl().node && ebLo->dir != n->pl().node) ||
            (eaLo->dir != n->pl().node && ebLo->dir == n->pl().node)) &&
-          (n->pl().node->pl().connOccurs(eaLo->line, OptGraph::getAdjEdg(ea, n),
-                                         OptGraph::getAdjEdg(eb, n)))) {
+          (n->pl().node->pl().connOccurs(eaLo->line, adjA, adjB))) {
         // connection occurs, consider for crossings
-        relOrderCross.push_back(otherIt->second);
+        relOrderCross.push_back(revA ? sizeA - 1 - pos : pos);
       }
     }
   }
@@ -229,46 +259,44 @@ std::pair<std::pair<size_t, size_t>, size_t> OptGraphScorer::getNumCrossSeps(
     OptNode* n, OptEdge* ea, OptEdge* eb, const OptOrderCfg& c) const {
   std::pair<std::pair<size_t, size_t>, size_t> ret{{0, 0}, 0};
 
-  std::map<const Line*, size_t> ordering;
-
   bool revA = (ea->getFrom() != n) ^ ea->pl().lnEdgParts.front().dir;
   bool revB = (eb->getFrom() != n) ^ eb->pl().lnEdgParts.front().dir;
 
   bool rev = !(revA ^ revB);
 
-  const auto& cea = c.at(ea);
-  const auto& ceb = c.at(eb);
-
-  for (size_t i = 0; i < cea.size(); i++) {
-    ordering[cea[i]] = rev ? cea.size() - 1 - i : i;
-  }
+  size_t a = c.id(ea);
+  size_t b = c.id(eb);
+  size_t sizeA = c.size(a);
+  size_t sizeB = c.size(b);
+  const auto* adjA = OptGraph::getAdjEdg(ea, n);
+  const auto* adjB = OptGraph::getAdjEdg(eb, n);
 
   std::vector<size_t> relOrderCross, relOrderSep;
+  relOrderCross.reserve(sizeB);
+  relOrderSep.reserve(sizeB);
 
-  for (size_t i = 0; i < ceb.size(); i++) {
-    const auto& thisLine = ceb[i];
-
-    auto otherIt = ordering.find(thisLine);
-    if (otherIt == ordering.end()) {
+  for (size_t i = 0; i < sizeB; i++) {
+    size_t kb = c.at(b, i);
+    size_t ka = c.find(a, c.lineId(b, kb));
+    if (ka == OptOrderCfg::NPOS) {
       // insert a placeholder for separations, otherwise ignore
       relOrderSep.push_back(std::numeric_limits<size_t>::max());
       continue;
     }
 
-    const auto* eaLo = ea->pl().getLineOcc(otherIt->first);
-    const auto* ebLo = eb->pl().getLineOcc(thisLine);
+    size_t pos = c.pos(a, ka);
+    if (rev) pos = sizeA - 1 - pos;
 
-    assert(eaLo);
-    assert(ebLo);
+    const auto* eaLo = &c.lineOcc(a, ka);
+    const auto* ebLo = &c.lineOcc(b, kb);
 
     if ((eaLo->dir == 0 || ebLo->dir == 0 ||
          (eaLo->dir == n->pl().node && ebLo->dir != n->pl().node) ||
          (eaLo->dir != n->pl().node && ebLo->dir == n->pl().node)) &&
-        (n->pl().node->pl().connOccurs(eaLo->line, OptGraph::getAdjEdg(ea, n),
-                                       OptGraph::getAdjEdg(eb, n)))) {
+        (n->pl().node->pl().connOccurs(eaLo->line, adjA, adjB))) {
       // connection occurs, consider for crossings
-      relOrderCross.push_back(otherIt->second);
-      relOrderSep.push_back(otherIt->second);
+      relOrderCross.push_back(pos);
+      relOrderSep.push_back(pos);
     } else {
       // otherwise insert a placeholder
       relOrderSep.push_back(std::numeric_limits<size_t>::max());
@@ -5,12 +5,17 @@
 #define LOOM_OPTIM_OPTGRAPHSCORER_H_
 
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include "loom/optim/OptGraph.h"
+#include "loom/optim/OptOrderCfg.h"
 
 namespace loom {
 namespace optim {
 
+// cached per-node scores of an ordering configuration
+typedef std::unordered_map<const OptNode*, double> OptNodeScores;
+
 class OptGraphScorer {
  public:
   OptGraphScorer(const shared::rendergraph::Penalties& pens) : _pens(pens) {}
@@ -28,6 +33,23 @@ class OptGraphScorer {
 
   double getSeparationScore(const OptGraph* g, const OptOrderCfg& c) const;
 
+  // incremental scoring: the score of a node only depends on the orderings of
+  // its adjacent edges, so after a change to the ordering of a single edge,
+  // only its two endpoints have to be re-evaluated
+
+  // write the score of each node in g under c to scores, return the total
+  double initNodeScores(const std::set<OptNode*>& g, const OptOrderCfg& c,
+                        OptNodeScores* scores) const;
+
+  // change of the total score after a change to the ordering of e in c,
+  // relative to the cached scores
+  double getScoreDelta(OptEdge* e, const OptOrderCfg& c,
+                       const OptNodeScores& scores) const;
+
+  // same as above, but also update the cached scores
+  double updateNodeScores(OptEdge* e, const OptOrderCfg& c,
+                          OptNodeScores* scores) const;
+
   double getSeparationScore(OptEdge* e, const OptOrderCfg& c) const;
 
   double getSeparationScore(const std::set<OptNode*>& g,
@@ -0,0 +1,100 @@
+// Copyright 2016, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+// Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
+
+#include <algorithm>
+#include <cassert>
+#include <unordered_map>
+#include "loom/optim/OptOrderCfg.h"
+
+using loom::optim::OptOrderCfg;
+using shared::linegraph::Line;
+
+const size_t OptOrderCfg::NPOS;
+
+// _____________________________________________________________________________
+OptOrderCfg::OptOrderCfg(const std::set<OptNode*>& g) : _off(1, 0) {
+  std::unordered_map<const Line*, size_t> lids;
+
+  for (auto n : g) {
+    for (auto e : n->getAdjList()) {
+      if (e->getFrom() != n) continue;
+      _eids[e] = _edgs.size();
+      _edgs.push_back(e);
+
+      const auto& lines = e->pl().getLines();
+      for (size_t k = 0; k < lines.size(); k++) {
+        auto i = lids.insert({lines[k].line, lids.size()});
+        _lids.push_back(i.first->second);
+        _ord.push_back(k);
+        _pos.push_back(k);
+      }
+
+      _off.push_back(_ord.size());
+    }
+  }
+}
+
+// _____________________________________________________________________________
+size_t OptOrderCfg::find(size_t eid, size_t lid) const {
+  // orderings are short, a linear search is faster than a map here
+  for (size_t i = _off[eid]; i < _off[eid + 1]; i++) {
+    if (_lids[i] == lid) return i - _off[eid];
+  }
+  return NPOS;
+}
+
+// _____________________________________________________________________________
+size_t OptOrderCfg::find(size_t eid, const Line* l) const {
+  const auto& lines = _edgs[eid]->pl().getLines();
+  for (size_t k = 0; k < lines.size(); k++) {
+    if (lines[k].line == l) return k;
+  }
+  return NPOS;
+}
+
+// _____________________________________________________________________________
+std::vector<const Line*> OptOrderCfg::getLines(size_t eid) const {
+  std::vector<const Line*> ret;
+  for (size_t p = 0; p < size(eid); p++) {
+    ret.push_back(lineOcc(eid, at(eid, p)).line);
+  }
+  return ret;
+}
+
+// _____________________________________________________________________________
+void OptOrderCfg::setOrder(size_t eid, const std::vector<size_t>& order) {
+  assert(order.size() == size(eid));
+  std::copy(order.begin(), order.end(), _ord.begin() + _off[eid]);
+  updatePos(eid);
+}
+
+// _____________________________________________________________________________
+void OptOrderCfg::swap(size_t eid, size_t p1, size_t p2) {
+  size_t a = _off[eid] + p1;
+  size_t b = _off[eid] + p2;
+  std::swap(_ord[a], _ord[b]);
+  _pos[_off[eid] + _ord[a]] = p1;
+  _pos[_off[eid] + _ord[b]] = p2;
+}
+
+// _____________________________________________________________________________
+bool OptOrderCfg::nextPermutation(size_t eid) {
+  bool ret = std::next_permutation(_ord.begin() + _off[eid],
+                                   _ord.begin() + _off[eid + 1]);
+  updatePos(eid);
+  return ret;
+}
+
+// _____________________________________________________________________________
+void OptOrderCfg::shuffle(size_t eid, std::mt19937* rng) {
+  std::shuffle(_ord.begin() + _off[eid], _ord.begin() + _off[eid + 1], *rng);
+  updatePos(eid);
+}
+
+// _____________________________________________________________________________
+void OptOrderCfg::updatePos(size_t eid) {
+  for (size_t i = _off[eid]; i < _off[eid + 1]; i++) {
+    _pos[_off[eid] + _ord[i]] = i - _off[eid];
+  }
+}
@@ -0,0 +1,95 @@
+// Copyright 2016, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+// Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
+
+#ifndef LOOM_OPTIM_OPTORDERCFG_H_
+#define LOOM_OPTIM_OPTORDERCFG_H_
+
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <set>
+#include <unordered_map>
+#include <vector>
+#include "loom/optim/OptGraph.h"
+
+namespace loom {
+namespace optim {
+
+// Line orderings of the edges of an optimization graph component.
+//
+// The edges of the component are numbered with dense ids 0..numEdgs()-1,
+// see id(). The lines of each edge are identified by their
+// index into the edge's line occurrences. All orderings are stored in one
+// contiguous array, with an offset per edge, together with the inverse
+// position of each line occurrence. Lines are additionally numbered with
+// dense ids per component to find the same line on different edges.
+class OptOrderCfg {
+ public:
+  static const size_t NPOS = std::numeric_limits<size_t>::max();
+
+  OptOrderCfg() : _off(1, 0) {}
+
+  // build the identity ordering for all edges in component g
+  explicit OptOrderCfg(const std::set<OptNode*>& g);
+
+  size_t numEdgs() const { return _edgs.size(); }
+  OptEdge* getEdg(size_t eid) const { return _edgs[eid]; }
+  size_t id(const OptEdge* e) const { return _eids.find(e)->second; }
+
+  // number of lines on edge eid
+  size_t size(size_t eid) const { return _off[eid + 1] - _off[eid]; }
+
+  // line occurrence at position p on edge eid
+  size_t at(size_t eid, size_t p) const { return _ord[_off[eid] + p]; }
+
+  // position of line occurrence k on edge eid
+  size_t pos(size_t eid, size_t k) const { return _pos[_off[eid] + k]; }
+
+  // component line id of line occurrence k on edge eid
+  size_t lineId(size_t eid, size_t k) const { return _lids[_off[eid] + k]; }
+
+  const OptLO& lineOcc(size_t eid, size_t k) const {
+    return _edgs[eid]->pl().getLines()[k];
+  }
+
+  // line occurrence of component line lid on edge eid, NPOS if the line
+  // does not occur on eid
+  size_t find(size_t eid, size_t lid) const;
+  size_t find(size_t eid, const shared::linegraph::Line* l) const;
+
+  // the ordering of edge eid as a list of lines
+  std::vector<const shared::linegraph::Line*> getLines(size_t eid) const;
+
+  void setOrder(size_t eid, const std::vector<size_t>& order);
+  void swap(size_t eid, size_t p1, size_t p2);
+  bool nextPermutation(size_t eid);
+  void shuffle(size_t eid, std::mt19937* rng);
+
+  // sort the ordering of edge eid by a comparator on line occurrences
+  template <typename C>
+  void sort(size_t eid, C cmp);
+
+ private:
+  std::vector<OptEdge*> _edgs;
+  std::unordered_map<const OptEdge*, size_t> _eids;
+  std::vector<size_t> _off;
+  std::vector<size_t> _lids;
+
+  std::vector<size_t> _ord;
+  std::vector<size_t> _pos;
+
+  void updatePos(size_t eid);
+};
+
+// _____________________________________________________________________________
+template <typename C>
+void OptOrderCfg::sort(size_t eid, C cmp) {
+  std::sort(_ord.begin() + _off[eid], _ord.begin() + _off[eid + 1], cmp);
+  updatePos(eid);
+}
+
+}  // namespace optim
+}  // namespace loom
+
+#endif  // LOOM_OPTIM_OPTORDERCFG_H_
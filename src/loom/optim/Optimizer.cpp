@@ -2,8 +2,11 @@
 // Chair of Algorithms and Data Structures.
 // Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
 
+#include <algorithm>
+#include <exception>
 #include <fstream>
 #include <numeric>
+#include <sstream>
 #include "loom/optim/NullOptimizer.h"
 #include "loom/optim/OptGraph.h"
 #include "loom/optim/OptGraphScorer.h"
@@ -12,6 +15,12 @@
 #include "util/geo/output/GeoGraphJsonOutput.h"
 #include "util/graph/Algorithm.h"
 #include "util/log/Log.h"
+#ifdef _OPENMP
+#include <omp.h>
+#else
+#define omp_get_thread_num() 0
+#define omp_get_num_procs() 1
+#endif
 
 using loom::optim::EdgePair;
 using loom::optim::LinePair;
@@ -117,13 +126,29 @@ OptResStats Optimizer::optimize(RenderGraph* rg) const {
 
   size_t nonTrivialComponents = 0;
 
-  for (const auto& nds : comps) {
-    optResStats.solutionSpaceSize += solutionSpaceSize(nds);
+  std::vector<double> compSolSp(comps.size());
+
+  for (size_t i = 0; i < comps.size(); i++) {
+    compSolSp[i] = solutionSpaceSize(comps[i]);
+    optResStats.solutionSpaceSize += compSolSp[i];
     // skip trivial components
-    if (nds.size() < 3) continue;
+    if (comps[i].size() < 3) continue;
     nonTrivialComponents++;
   }
 
+  // components are dispatched largest solution space first, to avoid a large
+  // component being started last
+  std::vector<size_t> compOrder(comps.size());
+  std::iota(compOrder.begin(), compOrder.end(), 0);
+  std::stable_sort(compOrder.begin(), compOrder.end(),
+                   [&compSolSp](size_t a, size_t b) {
+                     return compSolSp[a] > compSolSp[b];
+                   });
+
+  size_t jobs = _cfg->numThreads;
+  if (jobs == 0) jobs = omp_get_num_procs();
+  jobs = std::max<size_t>(1, std::min(jobs, comps.size()));
+
   if (_cfg->outputStats) {
     LOGTO(INFO, std::cerr) << "(stats) Stats for <optim> graph of '" << rg
                            << "'";
@@ -153,6 +178,11 @@ OptResStats Optimizer::optimize(RenderGraph* rg) const {
   double bestScore = std::numeric_limits<double>::infinity();
   OrderCfg bestCfg;
 
+  optResStats.ilpCacheHits = 0;
+  optResStats.ilpCacheNearHits = 0;
+  optResStats.ilpCacheMisses = 0;
+  optResStats.numSearchNds = 0;
+
   for (size_t run = 0; run < runs; run++) {
     OrderCfg c;
     HierarOrderCfg hc;
@@ -166,6 +196,7 @@ OptResStats Optimizer::optimize(RenderGraph* rg) const {
 
     optResStats.maxNumRowsPerComp = 0;
     optResStats.maxNumColsPerComp = 0;
+    optResStats.multiStartScores.clear();
 
     for (const auto& nds : comps) {
       if (_cfg->outputStats) {
@@ -186,17 +217,68 @@ OptResStats Optimizer::optimize(RenderGraph* rg) const {
               << " and solution space size = " << solSp;
         }
       }
+    }
 
-      // this is the implementation of the single edge pruning described in the
-      // publication - simple skip such components
-      // we also skip components with only single edges
-      if (maxC > 1 && nds.size() > 2) {
-        t += optimizeComp(&g, nds, &hc, optResStats);
-      } else {
-        t += nullOpt.optimizeComp(&g, nds, &hc, 0, optResStats);
+    // each worker writes into its own configuration shard and stats
+    std::vector<HierarOrderCfg> hcs(jobs);
+    std::vector<OptResStats> jobStats(jobs, optResStats);
+    for (auto& js : jobStats) {
+      js.ilpCacheHits = 0;
+      js.ilpCacheNearHits = 0;
+      js.ilpCacheMisses = 0;
+      js.numSearchNds = 0;
+    }
+    std::exception_ptr exc;
+
+    // components are optimized in parallel, report the wall time
+    T_START(optim);
+
+#pragma omp parallel for num_threads(jobs) schedule(dynamic, 1)
+    for (size_t i = 0; i < compOrder.size(); i++) {
+      const auto& nds = comps[compOrder[i]];
+      size_t job = omp_get_thread_num();
+
+      try {
+        // this is the implementation of the single edge pruning described in
+        // the publication - simple skip such components
+        // we also skip components with only single edges
+        if (maxC > 1 && nds.size() > 2) {
+          optimizeComp(&g, nds, &hcs[job], jobStats[job]);
+        } else {
+          nullOpt.optimizeComp(&g, nds, &hcs[job], 0, jobStats[job]);
+        }
+      } catch (...) {
+#pragma omp critical
+        {
+          if (!exc) exc = std::current_exception();
+        }
       }
     }
 
+    t = T_STOP(optim);
+
+    if (exc) std::rethrow_exception(exc);
+
+    // merge the shards
+    for (size_t job = 0; job < jobs; job++) {
+      for (const auto& kv : hcs[job]) {
+        for (const auto& o : kv.second) hc[kv.first][o.first] = o.second;
+      }
+      optResStats.maxNumRowsPerComp = std::max(
+          optResStats.maxNumRowsPerComp, jobStats[job].maxNumRowsPerComp);
+      optResStats.maxNumColsPerComp = std::max(
+          optResStats.maxNumColsPerComp, jobStats[job].maxNumColsPerComp);
+      optResStats.ilpCacheHits += jobStats[job].ilpCacheHits;
+      optResStats.ilpCacheNearHits += jobStats[job].ilpCacheNearHits;
+      optResStats.ilpCacheMisses += jobStats[job].ilpCacheMisses;
+      optResStats.numSearchNds += jobStats[job].numSearchNds;
+
+      auto& scores = optResStats.multiStartScores;
+      const auto& jobScores = jobStats[job].multiStartScores;
+      if (scores.size() < jobScores.size()) scores.resize(jobScores.size(), 0);
+      for (size_t i = 0; i < jobScores.size(); i++) scores[i] += jobScores[i];
+    }
+
     optResStats.nonTrivialComponents = nonTrivialComponents;
     optResStats.numCompsSolSpaceOne = numM1Comps;
     optResStats.maxNumNodesPerComp = maxNumNodes;
@@ -298,6 +380,19 @@ OptResStats Optimizer::optimize(RenderGraph* rg) const {
                            << " diff)";
     LOGTO(INFO, std::cerr) << "(stats) avg num separations: -- "
                            << optResStats.avgSeps << " --";
+    if (_cfg->ilpCacheDir.size()) {
+      LOGTO(INFO, std::cerr) << "(stats) ILP cache: "
+                             << optResStats.ilpCacheHits << " hits, "
+                             << optResStats.ilpCacheNearHits << " near hits, "
+                             << optResStats.ilpCacheMisses << " misses";
+    }
+    if (optResStats.multiStartScores.size() > 1) {
+      std::stringstream ss;
+      for (size_t i = 0; i < optResStats.multiStartScores.size(); i++) {
+        ss << (i ? ", " : "") << optResStats.multiStartScores[i];
+      }
+      LOGTO(INFO, std::cerr) << "(stats) multi-start scores: " << ss.str();
+    }
     LOGTO(INFO, std::cerr) << "";
   }
 
@@ -486,11 +581,38 @@ double Optimizer::optimizeComp(OptGraph* g, const std::set<OptNode*>& cmp,
   return optimizeComp(g, cmp, c, 0, stats);
 }
 
+// _____________________________________________________________________________
+void Optimizer::writeHierarch(const OptOrderCfg& cfg,
+                              HierarOrderCfg* hc) {
+  for (size_t i = 0; i < cfg.numEdgs(); i++) {
+    auto e = cfg.getEdg(i);
+
+    for (auto lnEdgPart : e->pl().lnEdgParts) {
+      if (lnEdgPart.wasCut) continue;
+      for (size_t j = 0; j < cfg.size(i); j++) {
+        // the corresponding route occurance in the opt graph edge
+        const OptLO& optRO = cfg.lineOcc(i, cfg.at(i, j));
+
+        for (auto rel : optRO.relatives) {
+          // retrieve the original line pos
+          size_t p = lnEdgPart.lnEdg->pl().linePos(rel);
+          if (!(lnEdgPart.dir ^ e->pl().lnEdgParts.front().dir)) {
+            (*hc)[lnEdgPart.lnEdg][lnEdgPart.order].insert(
+                (*hc)[lnEdgPart.lnEdg][lnEdgPart.order].begin(), p);
+          } else {
+            (*hc)[lnEdgPart.lnEdg][lnEdgPart.order].push_back(p);
+          }
+        }
+      }
+    }
+  }
+}
+
 // _____________________________________________________________________________
 OptOrderCfg Optimizer::getOptOrderCfg(
     const shared::rendergraph::OrderCfg& cfg,
     const std::map<const LineNode*, OptNode*>& ndMap, const OptGraph* g) {
-  OptOrderCfg ret;
+  OptOrderCfg ret(g->getNds());
   for (auto i : cfg) {
     auto e = i.first;
     auto order = i.second;
@@ -498,11 +620,15 @@ OptOrderCfg Optimizer::getOptOrderCfg(
     auto opNdFr = ndMap.find(e->getFrom())->second;
     auto opNdTo = ndMap.find(e->getTo())->second;
     auto opEdg = g->getEdg(opNdFr, opNdTo);
+    size_t eid = ret.id(opEdg);
 
+    std::vector<size_t> opOrder;
     for (auto pos = order.rbegin(); pos != order.rend(); pos++) {
       auto lo = e->pl().lineOccAtPos(*pos);
-      ret[opEdg].push_back(lo.line);
+      opOrder.push_back(ret.find(eid, lo.line));
     }
+
+    ret.setOrder(eid, opOrder);
   }
 
   return ret;
@@ -23,6 +23,16 @@ struct OptResStats {
   size_t numNodesOrig, numStationsOrig, numEdgesOrig, maxLineCardOrig, numLinesOrig, maxDegOrig;
   size_t numStations, numNodes, numEdges, maxLineCard, nonTrivialComponents, numCompsSolSpaceOne, maxNumNodesPerComp, maxNumEdgesPerComp, maxCardPerComp, numCompsOrig, maxNumRowsPerComp, maxNumColsPerComp;
   size_t runs;
+
+  // ILP solution cache lookups, summed over all runs
+  size_t ilpCacheHits, ilpCacheNearHits, ilpCacheMisses;
+
+  // search nodes visited by the exhaustive and branch-and-bound optimizers,
+  // summed over all runs
+  size_t numSearchNds;
+
+  // final score of each multi-start trajectory, summed over all components
+  std::vector<double> multiStartScores;
   double avgSolveTime, avgIterations, avgScore, avgCross, avgSameSegCross, avgDiffSegCross, avgSeps, solutionSpaceSize, solutionSpaceSizeOrig, maxCompSolSpace, simplificationTime;
 
   // best score for multiple runs
@@ -76,6 +86,10 @@ class Optimizer {
 
   static std::string prefix(size_t depth);
 
+  // write the line orderings of cfg into hc
+  static void writeHierarch(const OptOrderCfg& cfg,
+                            shared::rendergraph::HierarOrderCfg* hc);
+
  private:
   static OptOrderCfg getOptOrderCfg(
       const shared::rendergraph::OrderCfg&,
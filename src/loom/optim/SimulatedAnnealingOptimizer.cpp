@@ -3,6 +3,8 @@
 // Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
 
 #include <algorithm>
+#include <cmath>
+#include <random>
 #include <unordered_map>
 #include "loom/optim/GreedyOptimizer.h"
 #include "loom/optim/SimulatedAnnealingOptimizer.h"
@@ -17,78 +19,77 @@ using shared::rendergraph::OrderCfg;
 using shared::rendergraph::RenderGraph;
 
 // _____________________________________________________________________________
-double SimulatedAnnealingOptimizer::optimizeComp(OptGraph* og,
-                                              const std::set<OptNode*>& g,
-                                              HierarOrderCfg* hc, size_t depth,
-                                              OptResStats& stats) const {
-  T_START(1);
-  UNUSED(depth);
-  UNUSED(stats);
-  OptOrderCfg cur;
-
-  // fixed order list of optim graph edges
-  std::vector<OptEdge*> edges;
-
-  for (auto n : g)
-    for (auto e : n->getAdjList())
-      if (n == e->getFrom()) edges.push_back(e);
-
-  if (_randomStart) {
-    // this is the starting ordering, which is random
-    initialConfig(g, &cur, false);
-  } else {
-    // take the greedy optimized ordering as a starting point
-    GreedyOptimizer greedy(_cfg, _scorer.getPens(), true);
-    greedy.getFlatConfig(g, &cur);
-  }
-
-  size_t iters = 0;
-
-  size_t k = 0;
+double SimulatedAnnealingOptimizer::getTemp(const Trajectory& t) {
+  return t.tempFac * 1000.0 / t.iters;
+}
 
+// _____________________________________________________________________________
+bool SimulatedAnnealingOptimizer::step(Trajectory* t) const {
   size_t ABORT_AFTER_UNCH = 5;
 
-  while (true) {
-    iters++;
-
-    double temp = 1000.0 / iters;
-
-    for (size_t i = 0; i < edges.size(); i++) {
-      double oldScore = getScore(og, edges[i], cur);
-
-      for (size_t p1 = 0; p1 < cur[edges[i]].size(); p1++) {
-        for (size_t p2 = p1; p2 < cur[edges[i]].size(); p2++) {
-          // switch p1 and p2
-          auto tmp = cur[edges[i]][p1];
-          cur[edges[i]][p1] = cur[edges[i]][p2];
-          cur[edges[i]][p2] = tmp;
-
-          double s = getScore(og, edges[i], cur);
-
-          double r = rand() / (RAND_MAX + 1.0);
-          double e = exp(-(1.0 * (s - oldScore)) / temp);
-
-          if (s < oldScore) {
-            // found a better solution, keep it, update score
-            oldScore = s;
-            k = iters;
-          } else if (s != oldScore && e > r) {
-            // keep solution, despite not bringing any local gain, update score
-            oldScore = s;
-            k = iters;
-          } else {
-            // switch back
-            tmp = cur[edges[i]][p1];
-            cur[edges[i]][p1] = cur[edges[i]][p2];
-            cur[edges[i]][p2] = tmp;
-          }
+  t->iters++;
+
+  double temp = getTemp(*t);
+  std::uniform_real_distribution<double> dist(0, 1);
+  auto& cur = t->cur;
+
+  for (size_t i = 0; i < cur.numEdgs(); i++) {
+    OptEdge* e = cur.getEdg(i);
+    for (size_t p1 = 0; p1 < cur.size(i); p1++) {
+      for (size_t p2 = p1; p2 < cur.size(i); p2++) {
+        // switch p1 and p2
+        cur.swap(i, p1, p2);
+
+        double delta = _optScorer.getScoreDelta(e, cur, t->scores);
+
+        double r = dist(t->rng);
+        double acc = exp(-(1.0 * delta) / temp);
+
+        if (delta < 0) {
+          // found a better solution, keep it, update score
+          t->score += _optScorer.updateNodeScores(e, cur, &t->scores);
+          t->lastChange = t->iters;
+        } else if (delta != 0 && acc > r) {
+          // keep solution, despite not bringing any local gain, update score
+          t->score += _optScorer.updateNodeScores(e, cur, &t->scores);
+          t->lastChange = t->iters;
+        } else {
+          // switch back
+          cur.swap(i, p1, p2);
         }
       }
     }
+  }
 
-    if (iters - k > ABORT_AFTER_UNCH) break;
+  return t->iters - t->lastChange <= ABORT_AFTER_UNCH;
+}
+
+// _____________________________________________________________________________
+void SimulatedAnnealingOptimizer::exchange(std::vector<Trajectory>* ts,
+                                           bool improved) const {
+  UNUSED(improved);
+
+  // the hotter trajectories only feed the coldest one, which would take much
+  // longer to freeze themselves. exchanges do not count as changes, otherwise
+  // the coldest trajectory would never freeze either.
+  if (ts->front().done) {
+    for (auto& t : *ts) t.done = true;
+    return;
   }
 
-  writeHierarch(&cur, hc);
-  return T_STOP(1);
+  std::uniform_real_distribution<double> dist(0, 1);
+
+  for (size_t i = 0; i + 1 < ts->size(); i++) {
+    auto& a = (*ts)[i];
+    auto& b = (*ts)[i + 1];
+    if (a.done || b.done || a.score == b.score) continue;
+
+    // metropolis criterion for exchanging the states of two temperatures
+    double d = (a.score - b.score) * (1 / getTemp(a) - 1 / getTemp(b));
+    if (d < 0 && dist(a.rng) >= exp(d)) continue;
+
+    std::swap(a.cur, b.cur);
+    std::swap(a.scores, b.scores);
+    std::swap(a.score, b.score);
+  }
 }
@@ -24,9 +24,16 @@ class SimulatedAnnealingOptimizer : public HillClimbOptimizer {
                               bool randomStart)
       : HillClimbOptimizer(cfg, pens, randomStart){};
 
-  virtual double optimizeComp(OptGraph* og, const std::set<OptNode*>& g,
-                           shared::rendergraph::HierarOrderCfg* c,
-                           size_t depth, OptResStats& stats) const;
+ protected:
+  // one annealing sweep over all line swaps
+  virtual bool step(Trajectory* t) const;
+
+  // parallel tempering: neighboring trajectories on the temperature ladder
+  // swap their current orderings
+  virtual void exchange(std::vector<Trajectory>* ts, bool improved) const;
+
+ private:
+  static double getTemp(const Trajectory& t);
 };
 }  // namespace optim
 }  // namespace loom
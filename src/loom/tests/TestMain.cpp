@@ -2,10 +2,19 @@
 // Author: Patrick Brosi
 //
 
+#include <dirent.h>
+#include <unistd.h>
+#include <cstdlib>
+#include <thread>
 #include <vector>
 
 #include "loom/config/LoomConfig.h"
+#include "loom/optim/BranchBoundOptimizer.h"
 #include "loom/optim/CombOptimizer.h"
+#include "loom/optim/HillClimbOptimizer.h"
+#include "loom/optim/ILPCache.h"
+#include "loom/optim/SimulatedAnnealingOptimizer.h"
+#include "util/graph/Algorithm.h"
 #include "shared/optim/ILPSolvProv.h"
 #include "shared/rendergraph/RenderGraph.h"
 
@@ -443,12 +452,14 @@ int main(int argc, char** argv) {
 
   for (const auto& cfg : configs) {
     loom::optim::ExhaustiveOptimizer exhausOptim(&cfg, pens);
+    loom::optim::BranchBoundOptimizer bnbOptim(&cfg, pens);
     loom::optim::ILPOptimizer ilpOptim(&cfg, pens);
     loom::optim::ILPEdgeOrderOptimizer ilpImprOptim(&cfg, pens);
     loom::optim::CombOptimizer combOptim(&cfg, pens, true);
 
     std::vector<loom::optim::Optimizer*> optimizers;
     optimizers.push_back(&exhausOptim);
+    optimizers.push_back(&bnbOptim);
     optimizers.push_back(&ilpOptim);
     optimizers.push_back(&ilpImprOptim);
     optimizers.push_back(&combOptim);
@@ -487,12 +498,14 @@ int main(int argc, char** argv) {
   // miscellaneous
   for (const auto& cfg : configs) {
     loom::optim::ExhaustiveOptimizer exhausOptim(&cfg, pens);
+    loom::optim::BranchBoundOptimizer bnbOptim(&cfg, pens);
     loom::optim::ILPOptimizer ilpOptim(&cfg, pens);
     loom::optim::ILPEdgeOrderOptimizer ilpImprOptim(&cfg, pens);
     loom::optim::CombOptimizer combOptim(&cfg, pens, true);
 
     std::vector<loom::optim::Optimizer*> optimizers;
     optimizers.push_back(&exhausOptim);
+    optimizers.push_back(&bnbOptim);
     optimizers.push_back(&ilpOptim);
     optimizers.push_back(&ilpImprOptim);
     optimizers.push_back(&combOptim);
@@ -534,12 +547,14 @@ int main(int argc, char** argv) {
 
     for (const auto& cfg : configs) {
       loom::optim::ExhaustiveOptimizer exhausOptim(&cfg, pensLoc);
+      loom::optim::BranchBoundOptimizer bnbOptim(&cfg, pensLoc);
       loom::optim::ILPOptimizer ilpOptim(&cfg, pensLoc);
       loom::optim::ILPEdgeOrderOptimizer ilpImprOptim(&cfg, pensLoc);
       loom::optim::CombOptimizer combOptim(&cfg, pensLoc, true);
 
       std::vector<loom::optim::Optimizer*> optimizers;
       optimizers.push_back(&exhausOptim);
+      optimizers.push_back(&bnbOptim);
       optimizers.push_back(&ilpOptim);
       optimizers.push_back(&ilpImprOptim);
       optimizers.push_back(&combOptim);
@@ -585,12 +600,14 @@ int main(int argc, char** argv) {
 
     for (const auto& cfg : configs) {
       loom::optim::ExhaustiveOptimizer exhausOptim(&cfg, pensLoc);
+      loom::optim::BranchBoundOptimizer bnbOptim(&cfg, pensLoc);
       loom::optim::ILPOptimizer ilpOptim(&cfg, pensLoc);
       loom::optim::ILPEdgeOrderOptimizer ilpImprOptim(&cfg, pensLoc);
       loom::optim::CombOptimizer combOptim(&cfg, pensLoc, true);
 
       std::vector<loom::optim::Optimizer*> optimizers;
       optimizers.push_back(&exhausOptim);
+      optimizers.push_back(&bnbOptim);
       optimizers.push_back(&ilpOptim);
       optimizers.push_back(&ilpImprOptim);
       optimizers.push_back(&combOptim);
@@ -634,12 +651,14 @@ int main(int argc, char** argv) {
 
   for (const auto& cfg : configs) {
     loom::optim::ExhaustiveOptimizer exhausOptim(&cfg, pens);
+    loom::optim::BranchBoundOptimizer bnbOptim(&cfg, pens);
     loom::optim::ILPOptimizer ilpOptim(&cfg, pens);
     loom::optim::ILPEdgeOrderOptimizer ilpImprOptim(&cfg, pens);
     loom::optim::CombOptimizer combOptim(&cfg, pens, true);
 
     std::vector<loom::optim::Optimizer*> optimizers;
     optimizers.push_back(&exhausOptim);
+    optimizers.push_back(&bnbOptim);
     optimizers.push_back(&ilpOptim);
     optimizers.push_back(&ilpImprOptim);
     optimizers.push_back(&combOptim);
@@ -688,12 +707,14 @@ int main(int argc, char** argv) {
 
     for (const auto& cfg : configs) {
       loom::optim::ExhaustiveOptimizer exhausOptim(&cfg, pensLoc);
+      loom::optim::BranchBoundOptimizer bnbOptim(&cfg, pensLoc);
       loom::optim::ILPOptimizer ilpOptim(&cfg, pensLoc);
       loom::optim::ILPEdgeOrderOptimizer ilpImprOptim(&cfg, pensLoc);
       loom::optim::CombOptimizer combOptim(&cfg, pensLoc, true);
 
       std::vector<loom::optim::Optimizer*> optimizers;
       optimizers.push_back(&exhausOptim);
+      optimizers.push_back(&bnbOptim);
       optimizers.push_back(&ilpOptim);
       optimizers.push_back(&ilpImprOptim);
       optimizers.push_back(&combOptim);
@@ -727,4 +748,207 @@ int main(int argc, char** argv) {
       }
     }
   }
+
+  {
+    // branch-and-bound against exhaustive search: both must find the same
+    // optimum, the node throughput of both is reported
+    for (const auto& cfg : configs) {
+      loom::optim::ExhaustiveOptimizer exhausOptim(&cfg, pens);
+      loom::optim::BranchBoundOptimizer bnbOptim(&cfg, pens);
+
+      double exhausNds = 0, exhausT = 0, bnbNds = 0, bnbT = 0;
+
+      for (const auto& test : fileTests) {
+        shared::rendergraph::RenderGraph g(5, 5), g2(5, 5);
+
+        std::ifstream input;
+        input.open(test.fname);
+        g.readFromJson(&input, 3);
+
+        if (g.searchSpaceSize() > 50000) continue;
+
+        std::ifstream input2;
+        input2.open(test.fname);
+        g2.readFromJson(&input2, 3);
+
+        auto exhausRes = exhausOptim.optimize(&g);
+        auto bnbRes = bnbOptim.optimize(&g2);
+
+        TEST(bnbRes.score, ==, exhausRes.score);
+
+        exhausNds += exhausRes.numSearchNds;
+        exhausT += exhausRes.avgSolveTime;
+        bnbNds += bnbRes.numSearchNds;
+        bnbT += bnbRes.avgSolveTime;
+      }
+
+      LOG(INFO) << "Exhaustive search: " << exhausNds << " nodes in "
+                << exhausT << " ms (" << exhausNds / (exhausT / 1000)
+                << " nodes/s)";
+      LOG(INFO) << "Branch-and-bound: " << bnbNds << " nodes in " << bnbT
+                << " ms (" << bnbNds / (bnbT / 1000) << " nodes/s)";
+    }
+  }
+
+  {
+    // multi-start hill climbing and annealing: the first trajectory starts
+    // from the same greedy ordering as a single-start run, so the best
+    // trajectory can never be worse
+    auto cfg = configs.front();
+    cfg.multiStarts = 4;
+    cfg.exchangeInterval = 2;
+
+    loom::config::Config single = cfg;
+    single.multiStarts = 1;
+
+    for (const auto& test : fileTests) {
+      for (size_t anneal = 0; anneal < 2; anneal++) {
+        shared::rendergraph::RenderGraph g(5, 5), g2(5, 5);
+
+        std::ifstream input;
+        input.open(test.fname);
+        g.readFromJson(&input, 3);
+
+        if (anneal && g.searchSpaceSize() > 1000) continue;
+
+        std::ifstream input2;
+        input2.open(test.fname);
+        g2.readFromJson(&input2, 3);
+
+        loom::optim::OptResStats res, singleRes;
+        if (anneal) {
+          res = loom::optim::SimulatedAnnealingOptimizer(&cfg, pens, false)
+                    .optimize(&g);
+          singleRes =
+              loom::optim::SimulatedAnnealingOptimizer(&single, pens, false)
+                  .optimize(&g2);
+        } else {
+          res = loom::optim::HillClimbOptimizer(&cfg, pens, false).optimize(&g);
+          singleRes = loom::optim::HillClimbOptimizer(&single, pens, false)
+                          .optimize(&g2);
+        }
+
+        // graphs without non-trivial components are never searched
+        if (singleRes.multiStartScores.empty()) continue;
+
+        TEST(singleRes.multiStartScores.size(), ==, 1);
+        TEST(res.multiStartScores.size(), ==, 4);
+        if (!anneal) {
+          TEST(res.multiStartScores[0], <=, singleRes.multiStartScores[0]);
+        } else {
+          // the search spaces annealed here are small enough for the
+          // trajectories to find the optimum
+          TEST(res.sameSegCrossings, ==, test.sameSegCrossings);
+          TEST(res.diffSegCrossings, ==, test.diffSegCrossings);
+          TEST(res.separations, ==, test.separations);
+        }
+      }
+    }
+
+    // a trajectory stopped by the time limit still yields a valid ordering
+    cfg.multiStartTimeLimit = 0;
+    shared::rendergraph::RenderGraph g(5, 5);
+    std::ifstream input;
+    input.open("../src/loom/tests/datasets/freiburg-tram.json");
+    g.readFromJson(&input, 3);
+    auto res = loom::optim::HillClimbOptimizer(&cfg, pens, false).optimize(&g);
+    TEST(res.multiStartScores.size(), ==, 4);
+  }
+
+  {
+    // ilp solution cache
+    shared::rendergraph::RenderGraph rg(5, 5);
+
+    std::ifstream input;
+    input.open("../src/loom/tests/datasets/freiburg-tram.json");
+    rg.readFromJson(&input, 3);
+
+    loom::optim::OptGraphScorer scorer(pens);
+    loom::optim::OptGraph og(&scorer);
+    og.build(&rg);
+
+    std::set<loom::optim::OptNode*> comp;
+    for (const auto& nds : util::graph::Algorithm::connectedComponents(og)) {
+      if (nds.size() > comp.size()) comp = nds;
+    }
+
+    char dir[] = "/tmp/loomtestXXXXXX";
+    TEST(mkdtemp(dir) != 0);
+
+    loom::optim::ILPCache cache(dir, scorer);
+    auto key = cache.getKey(comp);
+    TEST(key.full.size() > 0);
+    TEST(key.full, ==, cache.getKey(comp).full);
+
+    loom::optim::OptOrderCfg cfg(comp);
+    TEST(!cache.get(key, &cfg));
+    TEST(!cache.getNear(key, &cfg));
+
+    // store a reversed ordering for every edge
+    size_t numOrdered = 0;
+    for (size_t eid = 0; eid < cfg.numEdgs(); eid++) {
+      std::vector<size_t> order;
+      for (size_t k = cfg.size(eid); k > 0; k--) order.push_back(k - 1);
+      cfg.setOrder(eid, order);
+      if (cfg.size(eid) > 1) numOrdered++;
+    }
+    TEST(numOrdered > 0);
+    cache.put(key, cfg);
+
+    loom::optim::OptOrderCfg hit(comp);
+    TEST(cache.get(key, &hit));
+    for (size_t eid = 0; eid < hit.numEdgs(); eid++) {
+      TEST(hit.getLines(eid) == cfg.getLines(eid));
+    }
+
+    // different penalties only give a near hit
+    shared::rendergraph::Penalties pensB = pens;
+    pensB.sameSegCrossPen = 7;
+    loom::optim::OptGraphScorer scorerB(pensB);
+    loom::optim::ILPCache cacheB(dir, scorerB);
+    auto keyB = cacheB.getKey(comp);
+    TEST(keyB.full != key.full);
+    TEST(keyB.topo, ==, key.topo);
+
+    loom::optim::OptOrderCfg near(comp);
+    TEST(!cacheB.get(keyB, &near));
+    TEST(cacheB.getNear(keyB, &near));
+    for (size_t eid = 0; eid < near.numEdgs(); eid++) {
+      TEST(near.getLines(eid) == cfg.getLines(eid));
+    }
+
+    // concurrent writers of the same entry don't clobber each other's
+    // temporary files
+    std::vector<std::thread> writers;
+    for (size_t i = 0; i < 8; i++) {
+      writers.push_back(std::thread([&cache, &key, &cfg]() {
+        for (size_t j = 0; j < 20; j++) cache.put(key, cfg);
+      }));
+    }
+    for (auto& w : writers) w.join();
+
+    loom::optim::OptOrderCfg hitB(comp);
+    TEST(cache.get(key, &hitB));
+    for (size_t eid = 0; eid < hitB.numEdgs(); eid++) {
+      TEST(hitB.getLines(eid) == cfg.getLines(eid));
+    }
+
+    // no temporary files are left over
+    size_t numFiles = 0;
+    DIR* d = opendir(dir);
+    while (struct dirent* ent = readdir(d)) {
+      std::string f = ent->d_name;
+      if (f != "." && f != "..") numFiles++;
+    }
+    closedir(d);
+    TEST(numFiles, ==, (size_t)2);
+
+    d = opendir(dir);
+    while (struct dirent* ent = readdir(d)) {
+      std::string f = ent->d_name;
+      if (f != "." && f != "..") unlink((std::string(dir) + "/" + f).c_str());
+    }
+    closedir(d);
+    rmdir(dir);
+  }
 }
@@ -7,17 +7,21 @@
 #include <fstream>
 #include <iostream>
 #include <set>
+#include <sstream>
+#include <stdexcept>
 #include "3rdparty/json.hpp"
 #include "octi/Enlarger.h"
 #include "octi/Octilinearizer.h"
 #include "octi/basegraph/BaseGraph.h"
 #include "octi/combgraph/CombGraph.h"
 #include "octi/config/ConfigReader.h"
+#include "shared/linegraph/BinGraph.h"
 #include "shared/linegraph/LineGraph.h"
 #include "util/Misc.h"
 #include "util/geo/Geo.h"
 #include "util/geo/output/GeoGraphJsonOutput.h"
 #include "util/graph/BiDijkstra.h"
+#include "util/http/Server.h"
 #include "util/json/Writer.h"
 #include "util/log/Log.h"
 #ifdef _OPENMP
@@ -91,36 +95,21 @@ std::vector<DPolygon> readObstacleFile(const std::string& p) {
 }
 
 // _____________________________________________________________________________
-int main(int argc, char** argv) {
-  // disable output buffering for standard output
-  setbuf(stdout, NULL);
-
-  // initialize randomness
-  srand(time(NULL) + rand());
-
-  config::Config cfg;
-
-  config::ConfigReader cr;
-  cr.read(&cfg, argc, argv);
-
+void schematize(const config::Config& cfg, std::istream* in, std::ostream* os) {
   util::geo::output::GeoGraphJsonOutput out;
 
-  if (cfg.obstaclePath.size()) {
-    LOGTO(DEBUG, std::cerr) << "Reading obstacle file...";
-    cfg.obstacles = readObstacleFile(cfg.obstaclePath);
-    LOGTO(DEBUG, std::cerr) << "Done. (" << cfg.obstacles.size() << " obst.)";
-  }
-
   LOGTO(DEBUG, std::cerr) << "Reading graph file...";
   T_START(read);
   LineGraph tg;
-  BaseGraph* gg;
+  BaseGraph* gg = 0;
   Drawing d;
 
   if (cfg.fromDot)
-    tg.readFromDot(&(std::cin), 0);
+    tg.readFromDot(in, 0);
+  else if (cfg.fromBin)
+    tg.readFromBin(in, 0);
   else
-    tg.readFromJson(&(std::cin), 0);
+    tg.readFromJson(in, 0);
 
   LOGTO(DEBUG, std::cerr) << "Done. (" << T_STOP(read) << "ms)";
 
@@ -132,7 +121,8 @@ int main(int argc, char** argv) {
   double avgDist = avgStatDist(tg);
   LOGTO(DEBUG, std::cerr) << "Average adj. node distance is " << avgDist;
 
-  Octilinearizer oct(cfg.baseGraphType);
+  Octilinearizer oct(cfg.baseGraphType, cfg.baseGraphLayout,
+                     cfg.heurNumThreads);
   LineGraph res;
 
   double gridSize;
@@ -194,16 +184,11 @@ int main(int argc, char** argv) {
         << "Schematized using ILP in " << time << " ms, score " << sc.full;
   } else if ((cfg.optMode == "heur")) {
     T_START(octi);
-    try {
-      sc = oct.draw(cg, box, &res, &gg, &d, cfg.pens, gridSize, cfg.borderRad,
-                    cfg.maxGrDist, cfg.orderMethod, cfg.restrLocSearch,
-                    cfg.enfGeoPen, cfg.hananIters, cfg.obstacles,
-                    cfg.heurLocSearchIters, cfg.abortAfter);
-      time = T_STOP(octi);
-    } catch (const NoEmbeddingFoundExc& exc) {
-      LOG(ERROR) << exc.what();
-      exit(1);
-    }
+    sc = oct.draw(cg, box, &res, &gg, &d, cfg.pens, gridSize, cfg.borderRad,
+                  cfg.maxGrDist, cfg.orderMethod, cfg.restrLocSearch,
+                  cfg.enfGeoPen, cfg.hananIters, cfg.obstacles,
+                  cfg.heurLocSearchIters, cfg.abortAfter);
+    time = T_STOP(octi);
     LOGTO(DEBUG, std::cerr) << "Schematized using heur approach in " << time
                             << " ms, score " << sc.full;
   }
@@ -264,6 +249,8 @@ int main(int argc, char** argv) {
         {"time-ms", time},
         {"iterations", sc.iters},
         {"procs", omp_get_num_procs()},
+        {"threads", cfg.heurNumThreads ? cfg.heurNumThreads
+                                       : omp_get_num_procs()},
         {"peak-memory", util::readableSize(maxRss)},
         {"peak-memory-bytes", maxRss},
         {"timestamp", util::json::Int(std::time(0))}};
@@ -279,16 +266,98 @@ int main(int argc, char** argv) {
 
   if (cfg.printMode == "gridgraph") {
     if (cfg.writeStats) {
-      out.print(*gg, std::cout, util::json::Dict{{"statistics", jsonScore}});
+      out.print(*gg, *os, util::json::Dict{{"statistics", jsonScore}});
     } else {
-      out.print(*gg, std::cout);
+      out.print(*gg, *os);
     }
+  } else if (cfg.toBin) {
+    shared::linegraph::BinGraphWriter().print(res, *os);
   } else {
     if (cfg.writeStats) {
-      out.print(res, std::cout, util::json::Dict{{"statistics", jsonScore}});
+      out.print(res, *os, util::json::Dict{{"statistics", jsonScore}});
     } else {
-      out.print(res, std::cout);
+      out.print(res, *os);
+    }
+  }
+
+  delete gg;
+}
+
+// _____________________________________________________________________________
+class OctiHandler : public util::http::Handler {
+ public:
+  explicit OctiHandler(const config::Config* cfg) : _cfg(cfg) {}
+
+  util::http::Answer handle(const util::http::Req& req, int con) const {
+    UNUSED(con);
+    if (req.cmd != "POST") throw util::http::HttpErr("405 Method Not Allowed");
+
+    std::stringstream in(req.payload);
+    std::stringstream out;
+
+    // the ILP solver may not run longer than the request timeout
+    config::Config cfg(*_cfg);
+    if (cfg.serveTimeout) {
+      int lim = cfg.serveTimeout;
+      if (cfg.ilpTimeLimit < 0 || cfg.ilpTimeLimit > lim)
+        cfg.ilpTimeLimit = lim;
+    }
+
+    try {
+      schematize(cfg, &in, &out);
+    } catch (const NoEmbeddingFoundExc& exc) {
+      return util::http::Answer("422 Unprocessable Entity", exc.what());
+    } catch (const nlohmann::json::exception& exc) {
+      return util::http::Answer("400 Bad Request", exc.what());
+    } catch (const std::runtime_error& exc) {
+      // thrown on malformed binary graphs
+      return util::http::Answer("400 Bad Request", exc.what());
+    }
+
+    util::http::Answer answ("200 OK", out.str());
+    answ.params["Content-Type"] = "application/json";
+    return answ;
+  }
+
+ private:
+  const config::Config* _cfg;
+};
+
+// _____________________________________________________________________________
+int main(int argc, char** argv) {
+  // initialize randomness
+  srand(time(NULL) + rand());
+
+  config::Config cfg;
+
+  config::ConfigReader cr;
+  cr.read(&cfg, argc, argv);
+
+  if (cfg.obstaclePath.size()) {
+    LOGTO(DEBUG, std::cerr) << "Reading obstacle file...";
+    cfg.obstacles = readObstacleFile(cfg.obstaclePath);
+    LOGTO(DEBUG, std::cerr) << "Done. (" << cfg.obstacles.size() << " obst.)";
+  }
+
+  if (cfg.servePort > -1) {
+    LOGTO(INFO, std::cerr) << "Listening on port " << cfg.servePort << "...";
+    OctiHandler h(&cfg);
+    try {
+      util::http::HttpServer serv(cfg.servePort, &h, cfg.serveThreads,
+                                  cfg.serveTimeout);
+      serv.run();
+    } catch (const std::runtime_error& err) {
+      LOG(ERROR) << err.what();
+      exit(1);
     }
+    return 0;
+  }
+
+  try {
+    schematize(cfg, &std::cin, &std::cout);
+  } catch (const NoEmbeddingFoundExc& exc) {
+    LOG(ERROR) << exc.what();
+    exit(1);
   }
 
   return 0;
@@ -23,6 +23,12 @@
 #include "util/graph/BiDijkstra.h"
 #include "util/graph/Dijkstra.h"
 #include "util/log/Log.h"
+#ifdef _OPENMP
+#include <omp.h>
+#else
+#define omp_get_thread_num() 0
+#define omp_get_num_procs() 1
+#endif
 
 using namespace octi;
 using namespace basegraph;
@@ -68,7 +74,10 @@ Score Octilinearizer::drawILP(
     auto score = draw(cg, box, &tmpOutTg, &gg, &drawing, pensCpy, gridSize,
                       borderRad, maxGrDist, orderMethod, true, enfGeoPen,
                       hananIters, {}, 100, std::numeric_limits<size_t>::max());
-    if (score.violations) throw NoEmbeddingFoundExc();
+    if (score.violations) {
+      delete gg;
+      throw NoEmbeddingFoundExc();
+    }
     LOGTO(DEBUG, std::cerr) << "Presolving finished.";
   } catch (const NoEmbeddingFoundExc& exc) {
     LOGTO(DEBUG, std::cerr) << "Presolve was not successful.";
@@ -125,15 +134,21 @@ Score Octilinearizer::draw(const CombGraph& cg, const DBox& box,
                            double enfGeoPen, size_t hananIters,
                            const std::vector<Polygon<double>>& obstacles,
                            size_t locSearchIters, size_t abortAfter) {
-  size_t jobs = 4;
+  size_t jobs = _numThreads;
+  if (jobs == 0) jobs = omp_get_num_procs();
+  _routers.resize(jobs);
   std::vector<BaseGraph*> ggs(jobs);
 
   LOGTO(DEBUG, std::cerr) << "Creating grid graphs... ";
   T_START(ggraph);
-#pragma omp parallel for
-  for (size_t i = 0; i < jobs; i++) {
+  ggs[0] = newBaseGraph(box, cg, gridSize, borderRad, hananIters, pens);
+  ggs[0]->init();
+
+  // the worker replicas are copied from the first grid graph
+#pragma omp parallel for num_threads(jobs)
+  for (size_t i = 1; i < jobs; i++) {
     ggs[i] = newBaseGraph(box, cg, gridSize, borderRad, hananIters, pens);
-    ggs[i]->init();
+    ggs[i]->initFrom(ggs[0]);
   }
 
   LOGTO(DEBUG, std::cerr) << "Done. (" << T_STOP(ggraph) << "ms)";
@@ -182,47 +197,63 @@ Score Octilinearizer::draw(const CombGraph& cg, const DBox& box,
     methods = {orderMethod};
   }
 
-  std::vector<std::vector<OrderMethod>> batches(jobs);
-  for (size_t i = 0; i < methods.size(); i++) {
-    batches[i % jobs].push_back(methods[i]);
-  }
-
   LOGTO(DEBUG, std::cerr) << "Searching initial drawing... ";
 
-#pragma omp parallel for
-  for (size_t btch = 0; btch < jobs; btch++) {
-    for (OrderMethod meth : batches[btch]) {
-      T_START(draw);
-      Drawing drawingCp(ggs[btch]);
+  // scores of the finished ordering methods, infinity if not (yet) drawn
+  std::vector<double> methScores(methods.size(),
+                                 std::numeric_limits<double>::infinity());
+  size_t bestMeth = methods.size();
 
-      // get a randomized ordering
-      std::vector<CombEdge*> iterOrder = getOrdering(cg, meth);
+  // ordering methods are dynamically scheduled over the workers, each worker
+  // uses its own grid graph replica, indexed by the thread id. Among equal
+  // scores, the method that comes first wins, independent of the schedule.
+#pragma omp parallel for num_threads(jobs) schedule(dynamic, 1)
+  for (size_t i = 0; i < methods.size(); i++) {
+    OrderMethod meth = methods[i];
+    BaseGraph* gg = ggs[omp_get_thread_num()];
+    T_START(draw);
+    Drawing drawingCp(gg);
 
-      double bestScoreSoFar = 0;
+    // get a randomized ordering
+    std::vector<CombEdge*> iterOrder = getOrdering(cg, meth);
+
+    // only methods which come first may cut off this one, a later method
+    // with the same score would otherwise prune it depending on the timing
+    double bestScoreSoFar = std::numeric_limits<double>::infinity();
 
 #pragma omp critical
-      { bestScoreSoFar = drawing.score(); }
+    {
+      for (size_t j = 0; j < i; j++)
+        bestScoreSoFar = std::min(bestScoreSoFar, methScores[j]);
+    }
 
-      auto status = draw(iterOrder, ggs[btch], &drawingCp, bestScoreSoFar,
-                         maxGrDist, geoPens, abortAfter);
+    auto status = draw(iterOrder, gg, &drawingCp, bestScoreSoFar, maxGrDist,
+                       geoPens, abortAfter);
 
-      drawingCp.eraseFromGrid(ggs[btch]);
+    drawingCp.eraseFromGrid(gg);
 
-      statLine(status, std::string("Try ") + std::to_string(meth), drawingCp,
-               T_STOP(draw), "*");
+    statLine(status, std::string("Try ") + std::to_string(meth), drawingCp,
+             T_STOP(draw), "*");
 
 #pragma omp critical
-      {
-        if (status == DRAWN && drawingCp.score() < drawing.score()) {
-          drawing = drawingCp;
-        } else {
-          drawingCp.crumble();
-        }
+    {
+      if (status == DRAWN) methScores[i] = drawingCp.score();
+
+      if (status == DRAWN &&
+          (drawingCp.score() < drawing.score() ||
+           (drawingCp.score() == drawing.score() && i < bestMeth))) {
+        drawing = drawingCp;
+        bestMeth = i;
+      } else {
+        drawingCp.crumble();
       }
     }
   }
 
-  if (drawing.score() == INF) throw NoEmbeddingFoundExc();
+  if (drawing.score() == INF) {
+    for (auto gg : ggs) delete gg;
+    throw NoEmbeddingFoundExc();
+  }
 
   LOGTO(DEBUG, std::cerr) << "Done.";
 
@@ -237,85 +268,126 @@ Score Octilinearizer::draw(const CombGraph& cg, const DBox& box,
   // dont use local search if abortAfter is set
   if (abortAfter != std::numeric_limits<size_t>::max()) LOCAL_SEARCH_ITERS = 0;
 
-  std::vector<std::vector<CombNode*>> batchesLoc(jobs);
-  size_t c = 0;
+  // candidate nodes for the local search, highest degree first so that the
+  // most expensive candidates are taken early and cheap ones fill the gaps
+  std::vector<CombNode*> locNds;
   for (auto nd : cg.getNds()) {
     if (nd->getDeg() == 0) continue;
-    batchesLoc[c % jobs].push_back(nd);
-    c++;
+    locNds.push_back(nd);
   }
+  std::stable_sort(locNds.begin(), locNds.end(),
+                   [](const CombNode* a, const CombNode* b) {
+                     return a->getDeg() > b->getDeg();
+                   });
 
   for (; iters < LOCAL_SEARCH_ITERS; iters++) {
     T_START(iter);
     std::vector<Drawing> bestFrIters(jobs);
 
-#pragma omp parallel for
-    for (size_t btch = 0; btch < jobs; btch++) {
-      for (auto a : batchesLoc[btch]) {
-        Drawing drawingCp = drawing;
+    // the candidate (node index, position) each worker's best drawing came
+    // from, ties between equal scores are broken by the lowest candidate
+    std::vector<std::pair<size_t, size_t>> bestCands(
+        jobs, {locNds.size(), 0});
 
-        // use the batches grid graph
-        drawingCp.setBaseGraph(ggs[btch]);
+    // best score found for each candidate node, infinity if not yet done
+    std::vector<double> ndScores(locNds.size(),
+                                 std::numeric_limits<double>::infinity());
 
-        // reverting a
-        std::vector<CombEdge*> test;
-        for (auto ce : a->getAdjList()) {
-          test.push_back(ce);
+#pragma omp parallel for num_threads(jobs) schedule(dynamic, 1)
+    for (size_t ndIdx = 0; ndIdx < locNds.size(); ndIdx++) {
+      auto a = locNds[ndIdx];
+      size_t btch = omp_get_thread_num();
 
-          drawingCp.eraseFromGrid(ce, ggs[btch]);
-          drawingCp.erase(ce);
-        }
+      // as for the initial drawing, only candidates which come first may
+      // cut off the search for this node
+      double cutoff = std::numeric_limits<double>::infinity();
+#pragma omp critical
+      {
+        for (size_t j = 0; j < ndIdx; j++)
+          cutoff = std::min(cutoff, ndScores[j]);
+      }
+      double ndBest = std::numeric_limits<double>::infinity();
 
-        drawingCp.erase(a);
-        ggs[btch]->unSettleNd(a);
+      Drawing drawingCp = drawing;
 
-        for (size_t pos = 0; pos < ggs[btch]->maxDeg() + 1; pos++) {
-          SettledPos p;
+      // use the workers grid graph
+      drawingCp.setBaseGraph(ggs[btch]);
 
-          auto n = ggs[btch]->neigh(drawing.getGrNd(a), pos);
-          if (!n) continue;
+      // reverting a
+      std::vector<CombEdge*> test;
+      for (auto ce : a->getAdjList()) {
+        test.push_back(ce);
 
-          p[a] = n;
+        drawingCp.eraseFromGrid(ce, ggs[btch]);
+        drawingCp.erase(ce);
+      }
 
-          if (restrLocSearch) {
-            // dont try positions outside the move radius for consistency with
-            // ILP approach
-            double gridD = dist(*a->pl().getGeom(), *n->pl().getGeom());
-            double maxDis = ggs[btch]->getCellSize() * maxGrDist;
-            if (gridD >= maxDis) continue;
-          }
+      drawingCp.erase(a);
+      ggs[btch]->unSettleNd(a);
 
-          Drawing run = drawingCp;
+      // candidate positions are drawn directly into drawingCp, which is rolled
+      // back to this state afterwards, to avoid copying the full drawing
+      drawingCp.checkpoint();
 
-          // we can use bestFromIter.score() as the limit for the shortest
-          // path computation, as we can already do at least as good.
-          auto error =
-              draw(test, p, ggs[btch], &run, bestFrIters[btch].score(),
-                   maxGrDist, geoPens, std::numeric_limits<size_t>::max());
+      for (size_t pos = 0; pos < ggs[btch]->maxDeg() + 1; pos++) {
+        SettledPos p;
 
-          if (!error && bestFrIters[btch].score() > run.score()) {
-            bestFrIters[btch] = run;
-          }
+        auto n = ggs[btch]->neigh(drawing.getGrNd(a), pos);
+        if (!n) continue;
 
-          // reset grid
-          for (auto ce : a->getAdjList()) run.eraseFromGrid(ce, ggs[btch]);
-          if (ggs[btch]->isSettled(a)) ggs[btch]->unSettleNd(a);
+        p[a] = n;
+
+        if (restrLocSearch) {
+          // dont try positions outside the move radius for consistency with
+          // ILP approach
+          double gridD = dist(*a->pl().getGeom(), *n->pl().getGeom());
+          double maxDis = ggs[btch]->getCellSize() * maxGrDist;
+          if (gridD >= maxDis) continue;
         }
 
-        ggs[btch]->settleNd(const_cast<GridNode*>(ggs[btch]->getGrNdById(
-                                drawing.getGrNd(a)->pl().getId())),
-                            a);
+        // we can use the best score of the candidates before this one as
+        // the limit for the shortest path computation, as we can already do
+        // at least as good.
+        auto error = draw(test, p, ggs[btch], &drawingCp,
+                          std::min(cutoff, ndBest), maxGrDist, geoPens,
+                          std::numeric_limits<size_t>::max());
+
+        if (!error) {
+          ndBest = std::min(ndBest, drawingCp.score());
+
+          std::pair<size_t, size_t> cand(ndIdx, pos);
+          if (drawingCp.score() < bestFrIters[btch].score() ||
+              (drawingCp.score() == bestFrIters[btch].score() &&
+               cand < bestCands[btch])) {
+            bestFrIters[btch] = drawingCp;
+            bestFrIters[btch].commit();
+            bestCands[btch] = cand;
+          }
+        }
+
+        // reset grid
+        for (auto ce : a->getAdjList()) drawingCp.eraseFromGrid(ce, ggs[btch]);
+        if (ggs[btch]->isSettled(a)) ggs[btch]->unSettleNd(a);
 
-        // re-settle edges
-        for (auto ce : a->getAdjList()) drawing.applyToGrid(ce, ggs[btch]);
+        drawingCp.rollback();
       }
+
+      ggs[btch]->settleNd(const_cast<GridNode*>(ggs[btch]->getGrNdById(
+                              drawing.getGrNd(a)->pl().getId())),
+                          a);
+
+      // re-settle edges
+      for (auto ce : a->getAdjList()) drawing.applyToGrid(ce, ggs[btch]);
+
+#pragma omp critical
+      { ndScores[ndIdx] = ndBest; }
     }
 
-    size_t bestCore;
-    double bestScore = std::numeric_limits<double>::infinity();
-    for (size_t i = 0; i < jobs; i++) {
-      if (bestFrIters[i].score() < bestScore) {
-        bestScore = bestFrIters[i].score();
+    size_t bestCore = 0;
+    for (size_t i = 1; i < jobs; i++) {
+      if (bestFrIters[i].score() < bestFrIters[bestCore].score() ||
+          (bestFrIters[i].score() == bestFrIters[bestCore].score() &&
+           bestCands[i] < bestCands[bestCore])) {
         bestCore = i;
       }
     }
@@ -349,6 +421,9 @@ Score Octilinearizer::draw(const CombGraph& cg, const DBox& box,
   // the drawing might still have another internal grid graph, make sure they
   // match (this is important for drawILP)
   dOut->setBaseGraph(ggs[0]);
+
+  for (size_t i = 1; i < jobs; i++) delete ggs[i];
+
   fullScore.iters = iters;
   return fullScore;
 }
@@ -479,16 +554,20 @@ Undrawable Octilinearizer::draw(const std::vector<CombEdge*>& ord,
     GridNode* frGrNd = 0;
 
     auto heur = gg->getHeur(toGrNds);
+    const util::graph::HeurFunc<GridNodePL, GridEdgePL, float>& h = *heur;
+    auto& router = _routers[omp_get_thread_num()];
 
     if (geoPensMap) {
       // init cost function with geo distance penalties
-      auto cost = GridCostGeoPen(cutoff + costOffsetTo + costOffsetFrom,
+      auto cost = GridCostGeoPen(&gg->getFlat(),
+                                 cutoff + costOffsetTo + costOffsetFrom,
                                  &geoPensMap->find(cmbEdg)->second);
-      Dijkstra::shortestPath(frGrNds, toGrNds, cost, *heur, &eL, &nL);
+      router.route(gg, frGrNds, toGrNds, cost, h, &eL, &nL);
     } else {
-      auto cost = GridCost(cutoff + costOffsetTo + costOffsetFrom);
+      auto cost =
+          GridCost(&gg->getFlat(), cutoff + costOffsetTo + costOffsetFrom);
 
-      Dijkstra::shortestPath(frGrNds, toGrNds, cost, *heur, &eL, &nL);
+      router.route(gg, frGrNds, toGrNds, cost, h, &eL, &nL);
     }
 
     delete heur;
@@ -505,8 +584,9 @@ Undrawable Octilinearizer::draw(const std::vector<CombEdge*>& ord,
     frGrNd = nL.back();
 
     // remove the cost offsets to not distort final costs
-    eL.front()->pl().setCost(eL.front()->pl().cost() - costOffsetTo);
-    eL.back()->pl().setCost(eL.back()->pl().cost() - costOffsetFrom);
+    auto& fg = gg->getFlat();
+    fg.setCost(eL.front(), fg.cost(eL.front()) - costOffsetTo);
+    fg.setCost(eL.back(), fg.cost(eL.back()) - costOffsetFrom);
 
     // draw
     drawing->draw(cmbEdg, eL, rev);
@@ -629,27 +709,39 @@ BaseGraph* Octilinearizer::newBaseGraph(const DBox& bbox, const CombGraph& cg,
                                         double cellSize, double spacer,
                                         size_t hananIters,
                                         const Penalties& pens) const {
+  BaseGraph* ret = 0;
+
   switch (_baseGraphType) {
     case OCTIGRID:
-      return new OctiGridGraph(bbox, cellSize, spacer, pens);
+      ret = new OctiGridGraph(bbox, cellSize, spacer, pens);
+      break;
     case CONVEXHULLOCTIGRID:
-      return new ConvexHullOctiGridGraph(hull(cg), bbox, cellSize, spacer,
-                                         pens);
+      ret = new ConvexHullOctiGridGraph(hull(cg), bbox, cellSize, spacer, pens);
+      break;
     case GRID:
-      return new GridGraph(bbox, cellSize, spacer, pens);
+      ret = new GridGraph(bbox, cellSize, spacer, pens);
+      break;
     case ORTHORADIAL:
-      return new OrthoRadialGraph(bbox, cellSize, spacer, pens);
+      ret = new OrthoRadialGraph(bbox, cellSize, spacer, pens);
+      break;
     case PSEUDOORTHORADIAL:
-      return new PseudoOrthoRadialGraph(bbox, cellSize, spacer, pens);
+      ret = new PseudoOrthoRadialGraph(bbox, cellSize, spacer, pens);
+      break;
     case OCTIHANANGRID:
-      return new OctiHananGraph(bbox, cg, cellSize, spacer, hananIters, pens);
+      ret = new OctiHananGraph(bbox, cg, cellSize, spacer, hananIters, pens);
+      break;
     case OCTIQUADTREE:
-      return new OctiQuadTree(bbox, cg, cellSize, spacer, pens);
+      ret = new OctiQuadTree(bbox, cg, cellSize, spacer, pens);
+      break;
     case HEXGRID:
-      return new HexGridGraph(bbox, cellSize, spacer, pens);
+      ret = new HexGridGraph(bbox, cellSize, spacer, pens);
+      break;
     default:
       return 0;
   }
+
+  ret->setLayout(_baseGraphLayout);
+  return ret;
 }
 
 // _____________________________________________________________________________
@@ -10,6 +10,7 @@
 #include "ilp/ILPGridOptimizer.h"
 #include "octi/basegraph/BaseGraph.h"
 #include "octi/basegraph/GridGraph.h"
+#include "octi/basegraph/GridRouter.h"
 #include "octi/combgraph/CombGraph.h"
 #include "octi/combgraph/Drawing.h"
 #include "octi/config/OctiConfig.h"
@@ -129,42 +130,45 @@ struct GraphMeasures {
   size_t maxDeg;
 };
 
-struct GridCost
-    : public util::graph::Dijkstra::CostFunc<GridNodePL, GridEdgePL, float> {
-  GridCost(float inf) : _inf(inf) {}
-  virtual float operator()(const GridNode* from, const GridEdge* e,
-                           const GridNode* to) const {
+// grid edge costs, called by the GridRouter with node and edge ids
+struct GridCost final {
+  GridCost(const basegraph::FlatGrid* fg, float inf) : _fg(fg), _inf(inf) {}
+  float operator()(size_t from, size_t e, size_t to) const {
     UNUSED(from);
     UNUSED(to);
-    return e->pl().cost();
+    return _fg->cost(e);
   }
 
+  const basegraph::FlatGrid* _fg;
   float _inf;
 
-  virtual float inf() const { return _inf; }
+  float inf() const { return _inf; }
 };
 
-struct GridCostGeoPen
-    : public Dijkstra::CostFunc<GridNodePL, GridEdgePL, float> {
-  GridCostGeoPen(float inf, const GeoPens* geoPens)
-      : _inf(inf), _geoPens(geoPens) {}
-  virtual float operator()(const GridNode* from, const GridEdge* e,
-                           const GridNode* to) const {
-    UNUSED(from);
-    UNUSED(to);
-    return e->pl().cost() + (*_geoPens)[e->pl().getId()];
+struct GridCostGeoPen final {
+  GridCostGeoPen(const basegraph::FlatGrid* fg, float inf,
+                 const GeoPens* geoPens)
+      : _fg(fg), _inf(inf), _geoPens(geoPens) {}
+  float operator()(size_t from, size_t e, size_t to) const {
+    // only edges between grid cells are penalized
+    if (_fg->parent(from) == _fg->parent(to)) return _fg->cost(e);
+    return _fg->cost(e) + _geoPens->get(_fg->nd(from), _fg->nd(to), _inf);
   }
 
+  const basegraph::FlatGrid* _fg;
   float _inf;
   const GeoPens* _geoPens;
 
-  virtual float inf() const { return _inf; }
+  float inf() const { return _inf; }
 };
 
 class Octilinearizer {
  public:
-  Octilinearizer(basegraph::BaseGraphType baseGraphType)
-      : _baseGraphType(baseGraphType) {}
+  Octilinearizer(basegraph::BaseGraphType baseGraphType,
+                 basegraph::BaseGraphLayout baseGraphLayout, size_t numThreads)
+      : _baseGraphType(baseGraphType),
+        _baseGraphLayout(baseGraphLayout),
+        _numThreads(numThreads) {}
 
   Score draw(const CombGraph& cg, const util::geo::DBox& box, LineGraph* out,
              basegraph::BaseGraph** gg, Drawing* d, const Penalties& pens,
@@ -187,6 +191,14 @@ class Octilinearizer {
 
  private:
   basegraph::BaseGraphType _baseGraphType;
+  basegraph::BaseGraphLayout _baseGraphLayout;
+
+  // number of workers used by the heuristic approach, 0 means number of
+  // available processors. Each worker holds a full base graph replica.
+  size_t _numThreads;
+
+  // one grid router per worker
+  std::vector<basegraph::GridRouter> _routers;
 
   basegraph::BaseGraph* newBaseGraph(const util::geo::DBox& bbox,
                                      const CombGraph& cg, double cellSize,
@@ -7,6 +7,8 @@
 #include <queue>
 #include <set>
 #include <unordered_map>
+#include "octi/basegraph/FlatGrid.h"
+#include "octi/basegraph/GeoPens.h"
 #include "octi/basegraph/GridEdgePL.h"
 #include "octi/basegraph/GridNodePL.h"
 #include "octi/basegraph/NodeCost.h"
@@ -28,10 +30,6 @@ using octi::combgraph::CombNode;
 namespace octi {
 namespace basegraph {
 
-const static double INF = std::numeric_limits<double>::infinity();
-
-const static double SOFT_INF = 100000;
-
 enum BaseGraphType {
   HEXGRID,
   OCTIGRID,
@@ -43,15 +41,16 @@ enum BaseGraphType {
   OCTIQUADTREE
 };
 
+// adjacency layout used by the router, the node and edge state is always
+// held in the FlatGrid
+enum BaseGraphLayout { ADJLIST, CSR };
+
 typedef util::graph::Node<GridNodePL, GridEdgePL> GridNode;
 typedef util::graph::Edge<GridNodePL, GridEdgePL> GridEdge;
 
 typedef std::pair<const GridEdge*, const GridEdge*> EdgPair;
 typedef std::vector<std::pair<EdgPair, EdgPair>> CrossEdgPairs;
 
-typedef std::vector<double> GeoPens;
-typedef std::map<const CombEdge*, GeoPens> GeoPensMap;
-
 struct Candidate {
   Candidate(GridNode* n, double d) : n(n), d(d){};
 
@@ -78,8 +77,17 @@ class BaseGraph : public DirGraph<GridNodePL, GridEdgePL> {
   BaseGraph(){};
 
   virtual void init() = 0;
+  // initialize as a copy of the already initialized graph tmpl, which must
+  // be of the same type and constructed with the same parameters
+  virtual void initFrom(const BaseGraph* tmpl) = 0;
   virtual double getCellSize() const = 0;
 
+  // must be set before init()
+  virtual void setLayout(BaseGraphLayout layout) = 0;
+
+  virtual const FlatGrid& getFlat() const = 0;
+  virtual FlatGrid& getFlat() = 0;
+
   virtual NodeCost nodeBendPen(GridNode* n, CombNode* origNode,
                                CombEdge* e) = 0;
   virtual NodeCost topoBlockPen(GridNode* n, CombNode* origNode,
@@ -133,6 +141,8 @@ class BaseGraph : public DirGraph<GridNodePL, GridEdgePL> {
 
   virtual double getBendPen(size_t origI, size_t targetI) const = 0;
   virtual GridNode* getGrNdById(size_t id) const = 0;
+  // upper bound (exclusive) for grid node ids
+  virtual size_t getGrNdIdBound() const = 0;
   virtual const GridEdge* getGrEdgById(std::pair<size_t, size_t> id) const = 0;
   virtual void addResEdg(GridEdge* ge, CombEdge* cg) = 0;
   virtual std::set<CombEdge*> getResEdgs(const GridEdge* ge) const = 0;
@@ -42,9 +42,7 @@ void ConvexHullOctiGridGraph::init() {
         GridNode* toN = neigh(x, y, p);
         if (frN && toN) {
           GridNode* to = toN->pl().getPort((p + maxDeg() / 2) % maxDeg());
-          auto e = addEdg(frN, to, GridEdgePL(9, false, false));
-          e->pl().setId(_edgeCount);
-          _edgeCount++;
+          addGrEdg(frN, to, 9, false);
         }
       }
     }
@@ -52,6 +50,13 @@ void ConvexHullOctiGridGraph::init() {
 
   writeInitialCosts();
   prunePorts();
+  finishInit();
+}
+
+// _____________________________________________________________________________
+void ConvexHullOctiGridGraph::initFrom(const BaseGraph* tmplGraph) {
+  GridGraph::initFrom(tmplGraph);
+  _ndIdx = dynamic_cast<const ConvexHullOctiGridGraph*>(tmplGraph)->_ndIdx;
 }
 
 // _____________________________________________________________________________
@@ -74,14 +79,10 @@ GridNode* ConvexHullOctiGridGraph::writeNd(size_t x, size_t y) {
   double xPos = _bbox.getLowerLeft().getX() + x * _cellSize;
   double yPos = _bbox.getLowerLeft().getY() + y * _cellSize;
 
-  GridNode* n = addNd(DPoint(xPos, yPos));
-  n->pl().setId(_nds.size());
-  _nds.push_back(n);
+  GridNode* n = addGrNd(DPoint(xPos, yPos));
   _ndIdx[x * _grid.getYHeight() + y] = _nds.size();
-  n->pl().setSink();
   _grid.add(x, y, n);
   n->pl().setXY(x, y);
-  n->pl().setParent(n);
 
   for (int i = 0; i < 8; i++) {
     int xi = (4 - (i % 8)) % 4;
@@ -89,19 +90,12 @@ GridNode* ConvexHullOctiGridGraph::writeNd(size_t x, size_t y) {
     int yi = (4 - ((i + 2) % 8)) % 4;
     yi /= abs(abs(yi) - 1) + 1;
 
-    GridNode* nn = addNd(DPoint(xPos + xi * _spacer, yPos + yi * _spacer));
-    nn->pl().setId(_nds.size());
-    _nds.push_back(nn);
-    nn->pl().setParent(n);
-    n->pl().setPort(i, nn);
+    GridNode* nn = addGrNd(DPoint(xPos + xi * _spacer, yPos + yi * _spacer));
+    nn->pl().setXY(x, y);
 
-    auto e = addEdg(n, nn, GridEdgePL(INF, true, true));
-    e->pl().setId(_edgeCount);
-    _edgeCount++;
+    addGrEdg(n, nn, INF, true);
 
-    e = addEdg(nn, n, GridEdgePL(INF, true, true));
-    e->pl().setId(_edgeCount);
-    _edgeCount++;
+    addGrEdg(nn, n, INF, true);
   }
 
   // in-node connections
@@ -115,15 +109,9 @@ GridNode* ConvexHullOctiGridGraph::writeNd(size_t x, size_t y) {
       if (y == _grid.getYHeight() - 1 && (i == 3 || i == 4 || i == 5))
         pen = INF;
 
-      auto e = addEdg(n->pl().getPort(i), n->pl().getPort(j),
-                            GridEdgePL(pen, true, false));
-      e->pl().setId(_edgeCount);
-      _edgeCount++;
+      addGrEdg(n->pl().getPort(i), n->pl().getPort(j), pen, true);
 
-      e = addEdg(n->pl().getPort(j), n->pl().getPort(i),
-                       GridEdgePL(pen, true, false));
-      e->pl().setId(_edgeCount);
-      _edgeCount++;
+      addGrEdg(n->pl().getPort(j), n->pl().getPort(i), pen, true);
     }
   }
 
@@ -0,0 +1,89 @@
+// Copyright 2017, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+// Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
+
+#include <cassert>
+#include "octi/basegraph/FlatGrid.h"
+
+using octi::basegraph::FlatGrid;
+
+// _____________________________________________________________________________
+void FlatGrid::setNds(const std::vector<GridNode*>* nds, size_t stride) {
+  _nds = nds;
+  _stride = stride;
+}
+
+// _____________________________________________________________________________
+size_t FlatGrid::addEdg(double c) {
+  _costs.push_back(c);
+  _closed.push_back(false);
+  _softClosed.push_back(false);
+  _blocked.push_back(false);
+  return _costs.size() - 1;
+}
+
+// _____________________________________________________________________________
+void FlatGrid::close(const GridEdge* e) {
+  _closed[e->pl().getId()] = true;
+  _softClosed[e->pl().getId()] = false;
+}
+
+// _____________________________________________________________________________
+void FlatGrid::softClose(const GridEdge* e) {
+  if (!_closed[e->pl().getId()]) _softClosed[e->pl().getId()] = true;
+  _closed[e->pl().getId()] = true;
+}
+
+// _____________________________________________________________________________
+void FlatGrid::open(const GridEdge* e) {
+  _closed[e->pl().getId()] = false;
+  _softClosed[e->pl().getId()] = false;
+}
+
+// _____________________________________________________________________________
+void FlatGrid::reset(const std::vector<float>& costs) {
+  _closed.assign(_closed.size(), false);
+  if (costs.size()) _costs = costs;
+}
+
+// _____________________________________________________________________________
+void FlatGrid::pack() {
+  std::vector<float> costs;
+  std::vector<bool> closed, softClosed, blocked;
+
+  for (auto n : *_nds) {
+    if (!n) continue;
+    for (auto e : n->getAdjListOut()) {
+      size_t id = e->pl().getId();
+      costs.push_back(_costs[id]);
+      closed.push_back(_closed[id]);
+      softClosed.push_back(_softClosed[id]);
+      blocked.push_back(_blocked[id]);
+      e->pl().setId(costs.size() - 1);
+    }
+  }
+
+  _costs.swap(costs);
+  _closed.swap(closed);
+  _softClosed.swap(softClosed);
+  _blocked.swap(blocked);
+}
+
+// _____________________________________________________________________________
+void FlatGrid::buildAdj() {
+  _adjOff.clear();
+  _adjTo.clear();
+  _adjOff.reserve(_nds->size() + 1);
+  _adjTo.reserve(_costs.size());
+
+  for (auto n : *_nds) {
+    _adjOff.push_back(_adjTo.size());
+    if (!n) continue;
+    for (auto e : n->getAdjListOut()) {
+      assert(e->pl().getId() == _adjTo.size());
+      _adjTo.push_back(e->getTo()->pl().getId());
+    }
+  }
+
+  _adjOff.push_back(_adjTo.size());
+}
@@ -0,0 +1,108 @@
+// Copyright 2017, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+// Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
+
+#ifndef OCTI_BASEGRAPH_FLATGRID_H_
+#define OCTI_BASEGRAPH_FLATGRID_H_
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include "octi/basegraph/GridEdgePL.h"
+#include "octi/basegraph/GridNodePL.h"
+
+namespace octi {
+namespace basegraph {
+
+const static double INF = std::numeric_limits<double>::infinity();
+
+const static double SOFT_INF = 100000;
+
+// Array-backed state of a grid graph.
+//
+// The nodes of a grid cell occupy maxDeg() + 1 consecutive ids, the cell's
+// sink node first, followed by its ports in port order. The sink node of a
+// grid node and the ports of a cell are found by index arithmetic.
+//
+// Edge costs are held in a contiguous array, the closed, soft-closed and
+// blocked state of the edges in bitsets, all indexed by edge id. After
+// pack(), the outgoing edges of each node occupy a contiguous id range, in
+// node id order. If the CSR index is built, the outgoing edges of node n are
+// [adjBegin(n), adjEnd(n)), and the head of edge e is adjTo(e).
+class FlatGrid {
+ public:
+  FlatGrid() : _nds(0), _stride(1) {}
+
+  // use nds as the node table, indexed by node id, with cells of stride ids
+  void setNds(const std::vector<GridNode*>* nds, size_t stride);
+
+  // node with the given id, 0 if it was pruned
+  GridNode* nd(size_t id) const { return (*_nds)[id]; }
+
+  // id of the sink node of the cell node id belongs to
+  size_t parent(size_t id) const { return id - id % _stride; }
+
+  // id of port p of the cell node id belongs to
+  size_t port(size_t id, size_t p) const { return parent(id) + 1 + p; }
+
+  bool isSink(size_t id) const { return id % _stride == 0; }
+
+  // add a new edge with cost c, returns its id
+  size_t addEdg(double c);
+  size_t numEdgs() const { return _costs.size(); }
+
+  double cost(size_t e) const {
+    // testing relaxed constraints for diagonal intersections
+    if (_softClosed[e] || _blocked[e]) return SOFT_INF + _costs[e];
+    if (_closed[e]) return INF;
+    return _costs[e];
+  }
+
+  double cost(const GridEdge* e) const { return cost(e->pl().getId()); }
+  double rawCost(const GridEdge* e) const { return _costs[e->pl().getId()]; }
+  void setCost(const GridEdge* e, double c) { _costs[e->pl().getId()] = c; }
+
+  bool closed(const GridEdge* e) const { return _closed[e->pl().getId()]; }
+
+  void close(const GridEdge* e);
+  void softClose(const GridEdge* e);
+  void open(const GridEdge* e);
+  void block(const GridEdge* e) { _blocked[e->pl().getId()] = true; }
+  void unblock(const GridEdge* e) { _blocked[e->pl().getId()] = false; }
+
+  // reopen all closed edges and restore the edge costs to costs, if given
+  void reset(const std::vector<float>& costs);
+
+  // re-assign edge ids in node id and out adjacency order, dropping the
+  // state of deleted edges
+  void pack();
+
+  // CSR out adjacency, requires a packed graph
+  void buildAdj();
+  bool hasAdj() const { return _adjOff.size() != 0; }
+  size_t adjBegin(size_t n) const { return _adjOff[n]; }
+  size_t adjEnd(size_t n) const { return _adjOff[n + 1]; }
+  size_t adjTo(size_t e) const { return _adjTo[e]; }
+
+  const std::vector<float>& getCosts() const { return _costs; }
+
+ private:
+  const std::vector<GridNode*>* _nds;
+  size_t _stride;
+
+  // grids may hold hundreds of millions of edges, costs are stored in single
+  // precision, which is also what the router computes with
+  std::vector<float> _costs;
+  std::vector<bool> _closed;
+  std::vector<bool> _softClosed;
+
+  // edges are blocked if they would cross a settled edge
+  std::vector<bool> _blocked;
+
+  std::vector<uint32_t> _adjOff;
+  std::vector<uint32_t> _adjTo;
+};
+}  // namespace basegraph
+}  // namespace octi
+
+#endif  // OCTI_BASEGRAPH_FLATGRID_H_
@@ -0,0 +1,74 @@
+// Copyright 2017, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+// Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
+
+#include <cmath>
+#include "octi/basegraph/GeoPens.h"
+
+using octi::basegraph::GeoPens;
+using util::geo::DBox;
+using util::geo::DPoint;
+
+namespace {
+// _____________________________________________________________________________
+double boxDist(const DBox& b, const DPoint& p) {
+  double dx = fmax(fmax(b.getLowerLeft().getX() - p.getX(), 0),
+                   p.getX() - b.getUpperRight().getX());
+  double dy = fmax(fmax(b.getLowerLeft().getY() - p.getY(), 0),
+                   p.getY() - b.getUpperRight().getY());
+  return sqrt(dx * dx + dy * dy);
+}
+}  // namespace
+
+// _____________________________________________________________________________
+GeoPens::GeoPens(const combgraph::CombEdge* ce, double cellSize, double pen)
+    : _cellSize(cellSize), _pen(pen) {
+  for (auto orE : ce->pl().getChilds()) {
+    _geoms.push_back(orE->pl().getGeom());
+    _boxes.push_back(util::geo::getBoundingBox(*orE->pl().getGeom()));
+  }
+}
+
+// _____________________________________________________________________________
+double GeoPens::get(const GridEdge* e) const {
+  // only edges between grid cells are penalized
+  if (e->pl().isSecondary()) return 0;
+  return get(e->getFrom(), e->getTo());
+}
+
+// _____________________________________________________________________________
+double GeoPens::get(const GridNode* a, const GridNode* b) const {
+  double d = std::numeric_limits<double>::infinity();
+
+  for (auto geom : _geoms) {
+    double dLoc = fmax(dist(*geom, *a->pl().getGeom()) / _cellSize,
+                       dist(*geom, *b->pl().getGeom()) / _cellSize);
+
+    if (dLoc < d) d = dLoc;
+  }
+
+  return _pen * d * d;
+}
+
+// _____________________________________________________________________________
+double GeoPens::get(const GridNode* a, const GridNode* b,
+                    double cutoff) const {
+  double lb = lowerBound(a, b);
+  if (lb >= cutoff) return lb;
+
+  return get(a, b);
+}
+
+// _____________________________________________________________________________
+double GeoPens::lowerBound(const GridNode* a, const GridNode* b) const {
+  double d = std::numeric_limits<double>::infinity();
+
+  for (const auto& box : _boxes) {
+    double dLoc = fmax(boxDist(box, *a->pl().getGeom()) / _cellSize,
+                       boxDist(box, *b->pl().getGeom()) / _cellSize);
+
+    if (dLoc < d) d = dLoc;
+  }
+
+  return _pen * d * d;
+}
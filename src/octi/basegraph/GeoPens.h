@@ -0,0 +1,53 @@
+// Copyright 2017, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+// Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
+
+#ifndef OCTI_BASEGRAPH_GEOPENS_H_
+#define OCTI_BASEGRAPH_GEOPENS_H_
+
+#include <map>
+#include <vector>
+#include "octi/basegraph/GridEdgePL.h"
+#include "octi/basegraph/GridNodePL.h"
+#include "octi/combgraph/CombGraph.h"
+#include "util/geo/Geo.h"
+
+namespace octi {
+namespace basegraph {
+
+// Penalties for deviating from the input geo course of a single comb edge.
+// Penalties are not precomputed for the entire grid, but evaluated on demand
+// for the grid edges actually looked at. A cheap lower bound based on the
+// bounding boxes of the input geometries allows to skip the exact
+// computation for edges outside of the corridor the current cutoff permits.
+class GeoPens {
+ public:
+  GeoPens() : _cellSize(1), _pen(0) {}
+  GeoPens(const combgraph::CombEdge* ce, double cellSize, double pen);
+
+  // geo course penalty for grid edge e
+  double get(const GridEdge* e) const;
+
+  // geo course penalty for the grid edge between cells a and b
+  double get(const GridNode* a, const GridNode* b) const;
+
+  // geo course penalty for the grid edge between cells a and b, or a value
+  // >= cutoff if the penalty will be >= cutoff
+  double get(const GridNode* a, const GridNode* b, double cutoff) const;
+
+ private:
+  std::vector<const util::geo::Line<double>*> _geoms;
+  std::vector<util::geo::Box<double>> _boxes;
+
+  double _cellSize;
+  double _pen;
+
+  double lowerBound(const GridNode* a, const GridNode* b) const;
+};
+
+typedef std::map<const combgraph::CombEdge*, GeoPens> GeoPensMap;
+
+}  // namespace basegraph
+}  // namespace octi
+
+#endif  // OCTI_BASEGRAPH_GEOPENS_H_
@@ -18,51 +18,25 @@ namespace basegraph {
 
 class GridEdgePL : util::geograph::GeoEdgePL<double> {
  public:
-  GridEdgePL(double c, bool secondar, bool sink);
+  explicit GridEdgePL(bool secondary);
 
   const util::geo::Line<double>* getGeom() const;
   util::json::Dict getAttrs() const;
 
-  void setCost(double c);
-  double cost() const;
-  double rawCost() const;
   bool isSecondary() const;
 
-  void close();
-  void softClose();
-  void open();
-  bool closed() const;
-
-  size_t resEdgs() const;
-
-  void block();
-  void unblock();
-
-  void reset();
-
-  void delResEdg();
-  void addResEdge();
-
   void setId(size_t id);
   size_t getId() const;
 
   void setRndrOrder(size_t order);
 
  private:
-  double _c;
-
-  bool _isSecondary;
-  bool _isSink;
-
-  bool _closed;
-  bool _softClosed;
-
-  // edges are blocked if they would cross a settled edge
-  bool _blocked;
+  // grids may hold hundreds of millions of edges, keep this compact. Costs
+  // and closed states are held by the graph's FlatGrid, indexed by _id.
+  uint32_t _id;
 
-  uint8_t _resEdgs;
-  size_t _rndrOrder;
-  size_t _id;
+  uint32_t _rndrOrder : 31;
+  uint32_t _isSecondary : 1;
 };
 }
 }
@@ -33,7 +33,7 @@ GridGraph::GridGraph(const DBox& bbox, double cellSize, double spacer,
       _grid(cellSize, cellSize, bbox, false),
       _cellSize(cellSize),
       _spacer(spacer),
-      _edgeCount(0) {
+      _layout(ADJLIST) {
   assert(_c.p_0 <= _c.p_135);
   assert(_c.p_135 <= _c.p_90);
   assert(_c.p_90 <= _c.p_45);
@@ -66,9 +66,7 @@ void GridGraph::init() {
         GridNode* toN = neigh(x, y, p);
         if (frN && toN) {
           GridNode* to = toN->pl().getPort((p + maxDeg() / 2) % maxDeg());
-          auto e = addEdg(frN, to, GridEdgePL(9, false, false));
-          e->pl().setId(_edgeCount);
-          _edgeCount++;
+          addGrEdg(frN, to, 9, false);
         }
       }
     }
@@ -76,6 +74,64 @@ void GridGraph::init() {
 
   writeInitialCosts();
   prunePorts();
+  finishInit();
+}
+
+// _____________________________________________________________________________
+void GridGraph::initFrom(const BaseGraph* tmplGraph) {
+  auto tmpl = dynamic_cast<const GridGraph*>(tmplGraph);
+  assert(tmpl);
+  assert(getNds().size() == 0);
+
+  _bbox = tmpl->_bbox;
+  _obstacles = tmpl->_obstacles;
+  _initCosts = tmpl->_initCosts;
+  _layout = tmpl->_layout;
+  _flat = tmpl->_flat;
+  _flat.setNds(&_nds, maxDeg() + 1);
+
+  // nodes, in id order. Pruned ports leave holes in the id range.
+  _nds.resize(tmpl->_nds.size(), 0);
+  for (size_t i = 0; i < tmpl->_nds.size(); i++) {
+    if (!tmpl->_nds[i]) continue;
+    _nds[i] = addNd(tmpl->_nds[i]->pl());
+    _nds[i]->pl().setFlat(&_flat);
+  }
+
+  // edges, in id order. The template is packed, so this yields the same
+  // out adjacency list orderings. The template has no duplicate edges, so
+  // addEdg()'s existence check can be skipped.
+  std::vector<GridEdge*> edgs(_flat.numEdgs(), 0);
+  for (auto n : tmpl->_nds) {
+    if (!n) continue;
+    for (auto e : n->getAdjListOut()) {
+      auto f = new GridEdge(_nds[e->getFrom()->pl().getId()],
+                            _nds[e->getTo()->pl().getId()], e->pl());
+      f->getFrom()->addEdge(f);
+      f->getTo()->addEdge(f);
+      edgs[e->pl().getId()] = f;
+    }
+  }
+
+  // spatial index, may have been rebuilt by the template's init()
+  _grid = Grid<GridNode*, Point, double>(tmpl->_grid.getCellWidth(),
+                                         tmpl->_grid.getCellHeight(),
+                                         tmpl->_grid.getBBox(), false);
+  for (size_t x = 0; x < _grid.getXWidth(); x++) {
+    for (size_t y = 0; y < _grid.getYHeight(); y++) {
+      std::set<GridNode*> cell;
+      tmpl->_grid.get(x, y, &cell);
+      for (auto n : cell) _grid.add(x, y, _nds[n->pl().getId()]);
+    }
+  }
+
+  for (const auto& s : tmpl->_settled) {
+    _settled[s.first] = _nds[s.second->pl().getId()];
+  }
+
+  for (const auto& r : tmpl->_resEdgs) {
+    _resEdgs[edgs[r.first->pl().getId()]] = r.second;
+  }
 }
 
 // _____________________________________________________________________________
@@ -132,9 +188,6 @@ void GridGraph::unSettleEdg(CombEdge* ce, GridNode* a, GridNode* b) {
   assert(ge);
   assert(gf);
 
-  ge->pl().delResEdg();
-  gf->pl().delResEdg();
-
   _resEdgs[ge].erase(ce);
   _resEdgs[gf].erase(ce);
 
@@ -172,7 +225,7 @@ void GridGraph::writeObstacleCost(const util::geo::Polygon<double>& obst) {
             contains(LineSegment<double>(*ge->getFrom()->pl().getGeom(),
                                          *ge->getTo()->pl().getGeom()),
                      obst)) {
-          ge->pl().setCost(std::numeric_limits<double>::infinity());
+          _flat.setCost(ge, std::numeric_limits<double>::infinity());
         }
       }
     }
@@ -182,36 +235,7 @@ void GridGraph::writeObstacleCost(const util::geo::Polygon<double>& obst) {
 // _____________________________________________________________________________
 void GridGraph::writeGeoCoursePens(const CombEdge* ce, GeoPensMap* target,
                                    double pen) {
-  (*target)[ce].resize(_edgeCount);
-  for (size_t x = 0; x < _grid.getXWidth(); x++) {
-    for (size_t y = 0; y < _grid.getYHeight(); y++) {
-      auto grNdA = getNode(x, y);
-
-      for (size_t i = 0; i < maxDeg(); i++) {
-        auto grNeigh = neigh(x, y, i);
-        if (!grNeigh) continue;
-        auto ge = getNEdg(grNdA, grNeigh);
-
-        double d = std::numeric_limits<double>::infinity();
-
-        for (auto orE : ce->pl().getChilds()) {
-          double dLoc = fmax(fmax(
-              dist(*orE->pl().getGeom(), *ge->getFrom()->pl().getGeom()) /
-              getCellSize(),
-              dist(*orE->pl().getGeom(), util::geo::centroid(util::geo::MultiPoint<double>{*ge->getFrom()->pl().getGeom(), *ge->getFrom()->pl().getGeom()})) /
-              getCellSize()),
-              dist(*orE->pl().getGeom(), *ge->getTo()->pl().getGeom()) /
-              getCellSize());
-
-          if (dLoc < d) d = dLoc;
-        }
-
-        d *= pen * d;
-
-        (*target)[ce][ge->pl().getId()] = d;
-      }
-    }
-  }
+  (*target)[ce] = GeoPens(ce, getCellSize(), pen);
 }
 
 // _____________________________________________________________________________
@@ -244,14 +268,8 @@ bool GridGraph::unused(const GridNode* gnd) const {
     auto e = getNEdg(gnd, neighbor);
     auto f = getNEdg(neighbor, gnd);
     auto a = _resEdgs.find(const_cast<GridEdge*>(e));
-
-
-    if (a != _resEdgs.end()) {
-      assert(a->second.size() == e->pl().resEdgs());
-    }
     if (a != _resEdgs.end() && a->second.size() != 0) return false;
     a = _resEdgs.find(const_cast<GridEdge*>(f));
-    if (a != _resEdgs.end()) assert(a->second.size() == f->pl().resEdgs());
     if (a != _resEdgs.end() && a->second.size() != 0) return false;
   }
   return true;
@@ -259,9 +277,7 @@ bool GridGraph::unused(const GridNode* gnd) const {
 
 // _____________________________________________________________________________
 void GridGraph::addResEdg(GridEdge* ge, CombEdge* ce) {
-  ge->pl().addResEdge();
   _resEdgs[ge].insert(ce);
-  assert(_resEdgs[ge].size() == ge->pl().resEdgs());
 }
 
 // _____________________________________________________________________________
@@ -485,12 +501,15 @@ void GridGraph::addCostVec(GridNode* n, const NodeCost& addC) {
 
     if (!p) continue;
 
+    auto e = getEdg(p, n);
+    auto f = getEdg(n, p);
+
     if (addC[i] < -1) {
-      getEdg(p, n)->pl().softClose();
-      getEdg(n, p)->pl().softClose();
+      _flat.softClose(e);
+      _flat.softClose(f);
     } else {
-      getEdg(p, n)->pl().setCost(getEdg(p, n)->pl().rawCost() + addC[i]);
-      getEdg(n, p)->pl().setCost(getEdg(n, p)->pl().rawCost() + addC[i]);
+      _flat.setCost(e, _flat.rawCost(e) + addC[i]);
+      _flat.setCost(f, _flat.rawCost(f) + addC[i]);
     }
   }
 }
@@ -510,9 +529,9 @@ void GridGraph::writeInitialCosts() {
         auto e = getEdg(port, oPort);
 
         if (i % 2 == 0) {
-          e->pl().setCost(_c.verticalPen);
+          _flat.setCost(e, _c.verticalPen);
         } else {
-          e->pl().setCost(_c.horizontalPen);
+          _flat.setCost(e, _c.horizontalPen);
         }
       }
     }
@@ -591,8 +610,8 @@ void GridGraph::openTurns(GridNode* n) {
       auto e = getEdg(portA, portB);
       auto f = getEdg(portB, portA);
 
-      e->pl().open();
-      f->pl().open();
+      _flat.open(e);
+      _flat.open(f);
     }
   }
 
@@ -613,8 +632,8 @@ void GridGraph::closeTurns(GridNode* n) {
       auto e = getEdg(portA, portB);
       auto f = getEdg(portB, portA);
 
-      e->pl().softClose();
-      f->pl().softClose();
+      _flat.softClose(e);
+      _flat.softClose(f);
     }
   }
 
@@ -625,8 +644,9 @@ void GridGraph::closeTurns(GridNode* n) {
 void GridGraph::openSinkTo(GridNode* n, double cost) {
   for (size_t i = 0; i < maxDeg(); i++) {
     if (!n->pl().getPort(i)) continue;
-    getEdg(n->pl().getPort(i), n)->pl().open();
-    getEdg(n->pl().getPort(i), n)->pl().setCost(cost);
+    auto e = getEdg(n->pl().getPort(i), n);
+    _flat.open(e);
+    _flat.setCost(e, cost);
   }
 }
 
@@ -634,8 +654,9 @@ void GridGraph::openSinkTo(GridNode* n, double cost) {
 void GridGraph::closeSinkTo(GridNode* n) {
   for (size_t i = 0; i < maxDeg(); i++) {
     if (!n->pl().getPort(i)) continue;
-    getEdg(n->pl().getPort(i), n)->pl().close();
-    getEdg(n->pl().getPort(i), n)->pl().setCost(INF);
+    auto e = getEdg(n->pl().getPort(i), n);
+    _flat.close(e);
+    _flat.setCost(e, INF);
   }
 }
 
@@ -643,8 +664,9 @@ void GridGraph::closeSinkTo(GridNode* n) {
 void GridGraph::openSinkFr(GridNode* n, double cost) {
   for (size_t i = 0; i < maxDeg(); i++) {
     if (!n->pl().getPort(i)) continue;
-    getEdg(n, n->pl().getPort(i))->pl().open();
-    getEdg(n, n->pl().getPort(i))->pl().setCost(cost);
+    auto e = getEdg(n, n->pl().getPort(i));
+    _flat.open(e);
+    _flat.setCost(e, cost);
   }
 }
 
@@ -652,8 +674,9 @@ void GridGraph::openSinkFr(GridNode* n, double cost) {
 void GridGraph::closeSinkFr(GridNode* n) {
   for (size_t i = 0; i < maxDeg(); i++) {
     if (!n->pl().getPort(i)) continue;
-    getEdg(n, n->pl().getPort(i))->pl().close();
-    getEdg(n, n->pl().getPort(i))->pl().setCost(INF);
+    auto e = getEdg(n, n->pl().getPort(i));
+    _flat.close(e);
+    _flat.setCost(e, INF);
   }
 }
 
@@ -705,6 +728,9 @@ bool GridGraph::isSettled(const CombNode* cn) {
 // _____________________________________________________________________________
 GridNode* GridGraph::getGrNdById(size_t id) const { return _nds[id]; }
 
+// _____________________________________________________________________________
+size_t GridGraph::getGrNdIdBound() const { return _nds.size(); }
+
 // _____________________________________________________________________________
 const GridEdge* GridGraph::getGrEdgById(std::pair<size_t, size_t> id) const {
   assert(_nds.size() > id.first);
@@ -717,13 +743,9 @@ GridNode* GridGraph::writeNd(size_t x, size_t y) {
   double xPos = _bbox.getLowerLeft().getX() + x * _cellSize;
   double yPos = _bbox.getLowerLeft().getY() + y * _cellSize;
 
-  GridNode* n = addNd(DPoint(xPos, yPos));
-  n->pl().setId(_nds.size());
-  _nds.push_back(n);
-  n->pl().setSink();
+  GridNode* n = addGrNd(DPoint(xPos, yPos));
   _grid.add(x, y, n);
   n->pl().setXY(x, y);
-  n->pl().setParent(n);
 
   for (int i = 0; i < 4; i++) {
     int xi = 0;
@@ -742,19 +764,12 @@ GridNode* GridGraph::writeNd(size_t x, size_t y) {
       xi = -1;
     }
 
-    GridNode* nn = addNd(DPoint(xPos + xi * _spacer, yPos + yi * _spacer));
-    nn->pl().setId(_nds.size());
-    _nds.push_back(nn);
-    nn->pl().setParent(n);
-    n->pl().setPort(i, nn);
+    GridNode* nn = addGrNd(DPoint(xPos + xi * _spacer, yPos + yi * _spacer));
+    nn->pl().setXY(x, y);
 
-    auto e = addEdg(n, nn, GridEdgePL(INF, true, true));
-    e->pl().setId(_edgeCount);
-    _edgeCount++;
+    addGrEdg(n, nn, INF, true);
 
-    e = addEdg(nn, n, GridEdgePL(INF, true, true));
-    e->pl().setId(_edgeCount);
-    _edgeCount++;
+    addGrEdg(nn, n, INF, true);
   }
 
   // in-node connections
@@ -767,15 +782,9 @@ GridNode* GridGraph::writeNd(size_t x, size_t y) {
       if (x == _grid.getXWidth() - 1 && i == 1) pen = INF;
       if (y == _grid.getYHeight() - 1 && i == 2) pen = INF;
 
-      auto e = addEdg(n->pl().getPort(i), n->pl().getPort(j),
-                            GridEdgePL(pen, true, false));
-      e->pl().setId(_edgeCount);
-      _edgeCount++;
+      addGrEdg(n->pl().getPort(i), n->pl().getPort(j), pen, true);
 
-      e = addEdg(n->pl().getPort(j), n->pl().getPort(i),
-                       GridEdgePL(pen, true, false));
-      e->pl().setId(_edgeCount);
-      _edgeCount++;
+      addGrEdg(n->pl().getPort(j), n->pl().getPort(i), pen, true);
     }
   }
 
@@ -809,18 +818,46 @@ double GridGraph::ndMovePen(const CombNode* cbNd, const GridNode* grNd) const {
 void GridGraph::reset() {
   _settled.clear();
   _resEdgs.clear();
-  for (auto n : getNds()) {
-    for (auto e : n->getAdjListOut()) e->pl().reset();
-    if (!n->pl().isSink()) continue;
+  _flat.reset(_initCosts);
+
+  for (auto n : _nds) {
+    if (!n || !n->pl().isSink()) continue;
     openTurns(n);
     closeSinkFr(n);
     closeSinkTo(n);
   }
 
-  writeInitialCosts();
+  if (!_initCosts.size()) writeInitialCosts();
   reWriteObstCosts();
 }
 
+// _____________________________________________________________________________
+void GridGraph::finishInit() {
+  _flat.pack();
+  _initCosts = _flat.getCosts();
+  if (_layout == CSR) _flat.buildAdj();
+}
+
+// _____________________________________________________________________________
+GridNode* GridGraph::addGrNd(const DPoint& pos) {
+  // cells of maxDeg() + 1 ids, maxDeg() is not available in the constructor
+  if (_nds.empty()) _flat.setNds(&_nds, maxDeg() + 1);
+
+  GridNode* n = addNd(pos);
+  n->pl().setId(_nds.size());
+  n->pl().setFlat(&_flat);
+  _nds.push_back(n);
+  return n;
+}
+
+// _____________________________________________________________________________
+void GridGraph::addGrEdg(GridNode* a, GridNode* b, double cost,
+                         bool secondary) {
+  // existing edges keep their state
+  if (getEdg(a, b)) return;
+  addEdg(a, b, GridEdgePL(secondary))->pl().setId(_flat.addEdg(cost));
+}
+
 // _____________________________________________________________________________
 void GridGraph::reWriteObstCosts() {
   for (const auto& obst : _obstacles) writeObstacleCost(obst);
@@ -866,6 +903,15 @@ PolyLine<double> GridGraph::geomFromPath(
 // _____________________________________________________________________________
 double GridGraph::getCellSize() const { return _cellSize; }
 
+// _____________________________________________________________________________
+void GridGraph::setLayout(BaseGraphLayout layout) { _layout = layout; }
+
+// _____________________________________________________________________________
+const FlatGrid& GridGraph::getFlat() const { return _flat; }
+
+// _____________________________________________________________________________
+FlatGrid& GridGraph::getFlat() { return _flat; }
+
 // _____________________________________________________________________________
 size_t GridGraph::getGrNdDeg(const CombNode* nd, size_t x, size_t y) const {
   auto grNd = getNode(x, y);
@@ -905,15 +951,14 @@ void GridGraph::prunePorts() {
   std::vector<GridNode*> toDel;
 
   for (auto grNd : getNds()) {
-    if (grNd->pl().getParent() != grNd) continue;
+    if (!grNd->pl().isSink()) continue;
     for (size_t p = 0; p < maxDeg(); p++) {
       auto port = grNd->pl().getPort(p);
-      if (port && port->getDeg() == maxDeg()) {
-        toDel.push_back(port);
-        grNd->pl().setPort(p, 0);
-      }
+      if (port && port->getDeg() == maxDeg()) toDel.push_back(port);
     }
   }
 
+  for (auto grNd : toDel) _nds[grNd->pl().getId()] = 0;
+
   for (auto grNd : toDel) delNd(grNd);
 }
@@ -37,6 +37,11 @@ class GridGraph : public BaseGraph {
 
   virtual double getCellSize() const;
 
+  virtual void setLayout(BaseGraphLayout layout);
+
+  virtual const FlatGrid& getFlat() const;
+  virtual FlatGrid& getFlat();
+
   virtual NodeCost nodeBendPen(GridNode* n, CombNode* origNd, CombEdge* e);
   virtual NodeCost topoBlockPen(GridNode* n, CombNode* origNode, CombEdge* e);
   virtual NodeCost spacingPen(GridNode* n, CombNode* origNode, CombEdge* e);
@@ -73,6 +78,7 @@ class GridGraph : public BaseGraph {
 
   virtual GridEdge* getNEdg(const GridNode* a, const GridNode* b) const;
   virtual void init();
+  virtual void initFrom(const BaseGraph* tmpl);
   virtual void reset();
 
   virtual GridNode* getSettled(const CombNode* cnd) const;
@@ -80,6 +86,7 @@ class GridGraph : public BaseGraph {
   virtual double ndMovePen(const CombNode* cbNd, const GridNode* grNd) const;
 
   virtual GridNode* getGrNdById(size_t id) const;
+  virtual size_t getGrNdIdBound() const;
   virtual const GridEdge* getGrEdgById(std::pair<size_t, size_t> id) const;
   virtual void addResEdg(GridEdge* ge, CombEdge* cg);
   virtual std::set<CombEdge*> getResEdgs(const GridEdge* ge) const;
@@ -113,14 +120,24 @@ class GridGraph : public BaseGraph {
   // encoding portable IDs for each node
   std::vector<GridNode*> _nds;
 
-  // edge id counter
-  size_t _edgeCount;
+  // edge costs and states, parent and port lookups by node id
+  FlatGrid _flat;
+  BaseGraphLayout _layout;
 
   std::vector<util::geo::Polygon<double>> _obstacles;
 
   // may be multiple resident edges if hard constraints are relaxed
   std::unordered_map<GridEdge*, std::set<CombEdge*>> _resEdgs;
 
+  // edge costs after initialization, indexed by edge id
+  std::vector<float> _initCosts;
+
+  GridNode* addGrNd(const util::geo::DPoint& pos);
+  void addGrEdg(GridNode* a, GridNode* b, double cost, bool secondary);
+
+  // pack the edge ids, store the initial edge costs and build the layout
+  void finishInit();
+
   const Grid<GridNode*, Point, double>& getGrid() const;
 
   virtual void writeInitialCosts();
@@ -147,22 +164,6 @@ class GridGraph : public BaseGraph {
   double _bendCosts[2];
 };
 
-struct GridCost
-    : public util::graph::Dijkstra::CostFunc<GridNodePL, GridEdgePL, float> {
-  GridCost(float inf) : _inf(inf) {}
-  virtual float operator()(const GridNode* from, const GridEdge* e,
-                           const GridNode* to) const {
-    UNUSED(from);
-    UNUSED(to);
-    // const_cast<GridNode*>(from)->pl().visited = true;
-    return e->pl().cost();
-  }
-
-  float _inf;
-
-  virtual float inf() const { return _inf; }
-};
-
 struct GridGraphHeur
     : public util::graph::Dijkstra::HeurFunc<GridNodePL, GridEdgePL, float> {
   GridGraphHeur(const basegraph::GridGraph* g, const std::set<GridNode*>& to)
@@ -170,11 +171,11 @@ struct GridGraphHeur
     cheapestSink = std::numeric_limits<float>::infinity();
 
     for (auto n : to) {
-      assert(n->pl().getParent() == n);
+      assert(n->pl().isSink());
       size_t i = 0;
       for (; i < g->maxDeg(); i++) {
         if (!n->pl().getPort(i)) continue;
-        float sinkCost = g->getEdg(n->pl().getPort(i), n)->pl().cost();
+        float sinkCost = g->getFlat().cost(g->getEdg(n->pl().getPort(i), n));
         if (sinkCost < cheapestSink) cheapestSink = sinkCost;
         auto neigh = g->neigh(n, i);
         if (neigh && to.find(neigh) == to.end()) {
@@ -185,7 +186,7 @@ struct GridGraphHeur
       }
       for (size_t j = i; j < g->maxDeg(); j++) {
         if (!n->pl().getPort(j)) continue;
-        float sinkCost = g->getEdg(n->pl().getPort(j), n)->pl().cost();
+        float sinkCost = g->getFlat().cost(g->getEdg(n->pl().getPort(j), n));
         if (sinkCost < cheapestSink) cheapestSink = sinkCost;
       }
     }
@@ -197,8 +198,7 @@ struct GridGraphHeur
     float ret = std::numeric_limits<float>::infinity();
 
     for (size_t i = 0; i < hull.size(); i += 2) {
-      float tmp = g->heurCost(from->pl().getParent()->pl().getX(),
-                              from->pl().getParent()->pl().getY(), hull[i],
+      float tmp = g->heurCost(from->pl().getX(), from->pl().getY(), hull[i],
                               hull[i + 1]);
       if (tmp < ret) ret = tmp;
     }
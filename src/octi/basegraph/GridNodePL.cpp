@@ -2,6 +2,7 @@
 // Chair of Algorithms and Data Structures.
 // Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
 
+#include "octi/basegraph/FlatGrid.h"
 #include "octi/basegraph/GridNodePL.h"
 
 using util::geo::Point;
@@ -10,12 +11,14 @@ using namespace octi::basegraph;
 // _____________________________________________________________________________
 GridNodePL::GridNodePL(Point<double> pos)
     : visited(false),
-      _pos(pos),
-      _parent(0),
       _closed(false),
-      _sink(false),
       _station(false),
-      _settled(false) {}
+      _settled(false),
+      _x(0),
+      _y(0),
+      _id(0),
+      _pos(pos),
+      _flat(0) {}
 
 // _____________________________________________________________________________
 const Point<double>* GridNodePL::getGeom() const { return &_pos; }
@@ -35,16 +38,17 @@ util::json::Dict GridNodePL::getAttrs() const {
 }
 
 // _____________________________________________________________________________
-GridNode* GridNodePL::getParent() const { return _parent; }
-
-// _____________________________________________________________________________
-void GridNodePL::setParent(GridNode* n) { _parent = n; }
+void GridNodePL::setFlat(const FlatGrid* flat) { _flat = flat; }
 
 // _____________________________________________________________________________
-GridNode* GridNodePL::getPort(size_t i) const { return _ports[i]; }
+GridNode* GridNodePL::getParent() const {
+  return _flat->nd(_flat->parent(_id));
+}
 
 // _____________________________________________________________________________
-void GridNodePL::setPort(size_t p, GridNode* n) { _ports[p] = n; }
+GridNode* GridNodePL::getPort(size_t i) const {
+  return _flat->nd(_flat->port(_id, i));
+}
 
 // _____________________________________________________________________________
 void GridNodePL::setXY(size_t x, size_t y) {
@@ -59,10 +63,10 @@ void GridNodePL::setId(size_t id) { _id = id; }
 size_t GridNodePL::getId() const { return _id; }
 
 // _____________________________________________________________________________
-size_t GridNodePL::getX() const { return _parent->pl()._x; }
+size_t GridNodePL::getX() const { return _x; }
 
 // _____________________________________________________________________________
-size_t GridNodePL::getY() const { return _parent->pl()._y; }
+size_t GridNodePL::getY() const { return _y; }
 
 // _____________________________________________________________________________
 void GridNodePL::setClosed(bool c) { _closed = c; }
@@ -77,10 +81,7 @@ void GridNodePL::setSettled(bool c) { _settled = c; }
 bool GridNodePL::isSettled() const { return _settled; }
 
 // _____________________________________________________________________________
-void GridNodePL::setSink() { _sink = true; }
-
-// _____________________________________________________________________________
-bool GridNodePL::isSink() const { return _sink; }
+bool GridNodePL::isSink() const { return _flat->isSink(_id); }
 
 // _____________________________________________________________________________
 void GridNodePL::setStation() { _station = true; }
@@ -16,6 +16,7 @@ using util::graph::Node;
 namespace octi {
 namespace basegraph {
 
+class FlatGrid;
 class GridNodePL;
 typedef util::graph::Node<GridNodePL, GridEdgePL> GridNode;
 typedef util::graph::Edge<GridNodePL, GridEdgePL> GridEdge;
@@ -28,11 +29,11 @@ class GridNodePL : util::geograph::GeoNodePL<double> {
   const Point<double>* getGeom() const;
   util::json::Dict getAttrs() const;
 
-  GridNode* getParent() const;
-  void setParent(GridNode* n);
+  // parent and ports are resolved by id through the grid's node table
+  void setFlat(const FlatGrid* flat);
 
+  GridNode* getParent() const;
   GridNode* getPort(size_t i) const;
-  void setPort(size_t p, GridNode* n);
 
   void setXY(size_t x, size_t y);
   size_t getX() const;
@@ -42,7 +43,6 @@ class GridNodePL : util::geograph::GeoNodePL<double> {
   void setClosed(bool c);
 
   bool isSink() const;
-  void setSink();
 
   bool isSettled() const;
   void setSettled(bool c);
@@ -52,17 +52,20 @@ class GridNodePL : util::geograph::GeoNodePL<double> {
   void setId(size_t id);
   size_t getId() const;
 
-  bool visited;
+  bool visited : 1;
 
  private:
-  Point<double> _pos;
+  bool _closed : 1;
+  bool _station : 1;
+  bool _settled : 1;
 
-  GridNode* _parent;
-  GridNode* _ports[8];
+  // grids may hold tens of millions of nodes, keep this compact
+  uint32_t _x, _y;
+  uint32_t _id;
+
+  Point<double> _pos;
 
-  size_t _x, _y;
-  size_t _id;
-  bool _closed, _sink, _station, _settled;
+  const FlatGrid* _flat;
 };
 }
 }
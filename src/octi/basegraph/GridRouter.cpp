@@ -0,0 +1,43 @@
+// Copyright 2017, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+// Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
+
+#include "octi/basegraph/GridRouter.h"
+
+using octi::basegraph::GridRouter;
+
+// _____________________________________________________________________________
+void GridRouter::nextGen(const BaseGraph* g, const std::set<GridNode*>& to) {
+  if (_st.size() < g->getGrNdIdBound()) {
+    _st.resize(g->getGrNdIdBound(), NdState{0, 0, 0, 0, 0, 0, 0});
+  }
+
+  _gen++;
+
+  if (_gen == 0) {
+    // generation counter overflow, reset all stamps
+    for (auto& s : _st) s = NdState{0, 0, 0, 0, 0, 0, 0};
+    _gen = 1;
+  }
+
+  for (auto n : to) st(n).target = _gen;
+}
+
+// _____________________________________________________________________________
+void GridRouter::buildPath(
+    const BaseGraph* g, size_t n,
+    util::graph::EList<GridNodePL, GridEdgePL>* resEdges,
+    util::graph::NList<GridNodePL, GridEdgePL>* resNodes) {
+  const FlatGrid& fg = g->getFlat();
+
+  while (resNodes || resEdges) {
+    const auto& s = _st[n];
+    if (resNodes) resNodes->push_back(fg.nd(n));
+    if (s.parNd == std::numeric_limits<uint32_t>::max()) break;
+    if (resEdges) {
+      resEdges->push_back(
+          const_cast<GridEdge*>(g->getEdg(fg.nd(s.parNd), fg.nd(n))));
+    }
+    n = s.parNd;
+  }
+}
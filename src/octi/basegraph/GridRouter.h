@@ -0,0 +1,184 @@
+// Copyright 2017, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+// Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
+
+#ifndef OCTI_BASEGRAPH_GRIDROUTER_H_
+#define OCTI_BASEGRAPH_GRIDROUTER_H_
+
+#include <limits>
+#include <set>
+#include <vector>
+#include "octi/basegraph/BaseGraph.h"
+#include "util/graph/ShortestPath.h"
+#include "util/graph/radix_heap.h"
+
+namespace octi {
+namespace basegraph {
+
+// A* router specialized for the grid base graphs. All per-node state is
+// held in dense arrays indexed by the grid node ids. Instead of clearing
+// these arrays between queries, entries are stamped with the current query
+// generation and considered unset if the stamp is outdated.
+//
+// Heuristic values are cached per grid cell: all base graph heuristics only
+// depend on the parent node of a grid node.
+//
+// If the base graph holds a CSR index, adjacent nodes and edge costs are read
+// from the FlatGrid arrays without touching the node and edge objects.
+// Cost functions are called with the ids of the tail node, the edge and the
+// head node.
+//
+// A router may be reused for any number of queries (and for different base
+// graphs), but must not be shared between threads.
+class GridRouter {
+ public:
+  GridRouter() : _gen(0) {}
+
+  // route from any node in from to any node in to on base graph g, write the
+  // resulting edges and nodes (starting at the target) to resEdges and
+  // resNodes
+  template <typename C, typename H>
+  float route(const BaseGraph* g, const std::set<GridNode*>& from,
+              const std::set<GridNode*>& to, const C& costFunc,
+              const H& heurFunc,
+              util::graph::EList<GridNodePL, GridEdgePL>* resEdges,
+              util::graph::NList<GridNodePL, GridEdgePL>* resNodes);
+
+ private:
+  struct NdState {
+    // generation in which d and parNd were written
+    uint32_t gen;
+    // generation in which the node was settled with cost d
+    uint32_t settled;
+    // generation in which the node was marked as a target
+    uint32_t target;
+    // generation in which h was written, only used for parent nodes
+    uint32_t hGen;
+
+    float d;
+    float h;
+    uint32_t parNd;
+  };
+
+  typedef radix_heap::pair_radix_heap<float, std::pair<uint32_t, float>> PQ;
+
+  std::vector<NdState> _st;
+  PQ _pq;
+  uint32_t _gen;
+
+  void nextGen(const BaseGraph* g, const std::set<GridNode*>& to);
+  NdState& st(const GridNode* n) { return _st[n->pl().getId()]; }
+
+  template <typename H>
+  float heur(const FlatGrid& fg, size_t n, const std::set<GridNode*>& to,
+             const H& heurFunc);
+
+  void buildPath(const BaseGraph* g, size_t n,
+                 util::graph::EList<GridNodePL, GridEdgePL>* resEdges,
+                 util::graph::NList<GridNodePL, GridEdgePL>* resNodes);
+};
+
+// _____________________________________________________________________________
+template <typename C, typename H>
+float GridRouter::route(const BaseGraph* g, const std::set<GridNode*>& from,
+                        const std::set<GridNode*>& to, const C& costFunc,
+                        const H& heurFunc,
+                        util::graph::EList<GridNodePL, GridEdgePL>* resEdges,
+                        util::graph::NList<GridNodePL, GridEdgePL>* resNodes) {
+  nextGen(g, to);
+
+  const float inf = costFunc.inf();
+  const FlatGrid& fg = g->getFlat();
+
+  // sentinel parent for start nodes, grid node ids are < getGrNdIdBound()
+  const uint32_t none = std::numeric_limits<uint32_t>::max();
+
+  for (auto n : from) {
+    auto& s = st(n);
+    s.gen = _gen;
+    s.d = 0;
+    s.parNd = none;
+    _pq.emplace(0, n->pl().getId(), 0);
+  }
+
+  size_t found = none;
+
+  // relax edge e from node cur, settled with cost d, to node to
+  auto relax = [&](size_t cur, float d, size_t e, size_t to_) {
+    float newC = d + costFunc(cur, e, to_);
+    if (newC < d) return;  // cost overflow!
+    if (inf <= newC) return;
+
+    auto& ts = _st[to_];
+    if (ts.gen == _gen && ts.d <= newC) return;
+
+    float h = heur(fg, to_, to, heurFunc);
+    if (inf <= h) return;
+
+    float newH = newC + h;
+    if (newH < newC) return;  // cost overflow!
+
+    ts.gen = _gen;
+    ts.d = newC;
+    ts.parNd = cur;
+
+    // a settled node may be re-opened for non-consistent heuristics
+    if (ts.settled == _gen) ts.settled = 0;
+
+    _pq.emplace(newH, to_, newC);
+  };
+
+  while (!_pq.empty()) {
+    if (inf <= _pq.topKey()) break;
+
+    uint32_t cur = _pq.topVal().first;
+    float d = _pq.topVal().second;
+    _pq.pop();
+
+    auto& s = _st[cur];
+
+    // outdated entry, or already settled with this cost
+    if (d > s.d || s.settled == _gen) continue;
+    s.settled = _gen;
+
+    if (s.target == _gen) {
+      found = cur;
+      break;
+    }
+
+    if (fg.hasAdj()) {
+      for (size_t e = fg.adjBegin(cur); e < fg.adjEnd(cur); e++) {
+        relax(cur, d, e, fg.adjTo(e));
+      }
+    } else {
+      for (auto e : fg.nd(cur)->getAdjListOut()) {
+        relax(cur, d, e->pl().getId(), e->getTo()->pl().getId());
+      }
+    }
+  }
+
+  _pq.clear();
+
+  if (found == none) return inf;
+
+  buildPath(g, found, resEdges, resNodes);
+
+  return _st[found].d;
+}
+
+// _____________________________________________________________________________
+template <typename H>
+float GridRouter::heur(const FlatGrid& fg, size_t n,
+                       const std::set<GridNode*>& to, const H& heurFunc) {
+  auto& s = _st[fg.parent(n)];
+  if (s.hGen != _gen) {
+    s.hGen = _gen;
+    s.h = heurFunc(fg.nd(n), to);
+  }
+  return s.h;
+}
+
+}  // namespace basegraph
+}  // namespace octi
+
+#endif  // OCTI_BASEGRAPH_GRIDROUTER_H_
@@ -36,9 +36,7 @@ void HexGridGraph::init() {
         GridNode* toN = neigh(x, y, p);
         if (frN && toN) {
           GridNode* to = toN->pl().getPort((p + maxDeg() / 2) % maxDeg());
-          auto e = addEdg(frN, to, GridEdgePL(9, false, false));
-          e->pl().setId(_edgeCount);
-          _edgeCount++;
+          addGrEdg(frN, to, 9, false);
         }
       }
     }
@@ -46,6 +44,7 @@ void HexGridGraph::init() {
 
   writeInitialCosts();
   prunePorts();
+  finishInit();
 }
 
 // _____________________________________________________________________________
@@ -166,9 +165,9 @@ void HexGridGraph::writeInitialCosts() {
         auto e = getEdg(port, oPort);
 
         if (i == 1 || i == 4) {
-          e->pl().setCost(_c.horizontalPen);
+          _flat.setCost(e, _c.horizontalPen);
         } else {
-          e->pl().setCost(_c.diagonalPen);
+          _flat.setCost(e, _c.diagonalPen);
         }
       }
     }
@@ -183,16 +182,12 @@ GridNode* HexGridGraph::writeNd(size_t x, size_t y) {
   if (y % 2) xPos += _a / 2;
 
   auto pos = DPoint(xPos, yPos);
-  GridNode* n = addNd(pos);
-  n->pl().setId(_nds.size());
-  _nds.push_back(n);
-  n->pl().setSink();
+  GridNode* n = addGrNd(pos);
 
   // we are using the raw position here, as grid cells do not reflect the
   // positions in the grid graph as in the octilinear case
   _grid.add(pos, n);
   n->pl().setXY(x, y);
-  n->pl().setParent(n);
 
   for (int i = 0; i < 6; i++) {
     double xi = 0;
@@ -221,19 +216,12 @@ GridNode* HexGridGraph::writeNd(size_t x, size_t y) {
       yi = A;
     }
 
-    GridNode* nn = addNd(DPoint(xPos + xi * _spacer, yPos + yi * _spacer));
-    nn->pl().setId(_nds.size());
-    _nds.push_back(nn);
-    nn->pl().setParent(n);
-    n->pl().setPort(i, nn);
+    GridNode* nn = addGrNd(DPoint(xPos + xi * _spacer, yPos + yi * _spacer));
+    nn->pl().setXY(x, y);
 
-    auto e = addEdg(n, nn, GridEdgePL(INF, true, true));
-    e->pl().setId(_edgeCount);
-    _edgeCount++;
+    addGrEdg(n, nn, INF, true);
 
-    e = addEdg(nn, n, GridEdgePL(INF, true, true));
-    e->pl().setId(_edgeCount);
-    _edgeCount++;
+    addGrEdg(nn, n, INF, true);
   }
 
   // in-node connections
@@ -246,15 +234,9 @@ GridNode* HexGridGraph::writeNd(size_t x, size_t y) {
       if (x == _grid.getXWidth() - 1 && i == 1) pen = INF;
       if (y == _grid.getYHeight() - 1 && i == 2) pen = INF;
 
-      auto e = addEdg(n->pl().getPort(i), n->pl().getPort(j),
-                            GridEdgePL(pen, true, false));
-      e->pl().setId(_edgeCount);
-      _edgeCount++;
+      addGrEdg(n->pl().getPort(i), n->pl().getPort(j), pen, true);
 
-      e = addEdg(n->pl().getPort(j), n->pl().getPort(i),
-                       GridEdgePL(pen, true, false));
-      e->pl().setId(_edgeCount);
-      _edgeCount++;
+      addGrEdg(n->pl().getPort(j), n->pl().getPort(i), pen, true);
     }
   }
 
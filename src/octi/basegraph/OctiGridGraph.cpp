@@ -43,9 +43,6 @@ void OctiGridGraph::unSettleEdg(CombEdge* ce, GridNode* a, GridNode* b) {
   assert(ge);
   assert(gf);
 
-  ge->pl().delResEdg();
-  gf->pl().delResEdg();
-
   _resEdgs[ge].erase(ce);
   _resEdgs[gf].erase(ce);
 
@@ -67,8 +64,8 @@ void OctiGridGraph::unSettleEdg(CombEdge* ce, GridNode* a, GridNode* b) {
       auto e = getNEdg(na, nb);
       auto f = getNEdg(nb, na);
 
-      e->pl().unblock();
-      f->pl().unblock();
+      _flat.unblock(e);
+      _flat.unblock(f);
     }
   }
 }
@@ -119,8 +116,8 @@ void OctiGridGraph::settleEdg(GridNode* a, GridNode* b, CombEdge* e,
       auto e = getNEdg(na, nb);
       auto f = getNEdg(nb, na);
 
-      e->pl().block();
-      f->pl().block();
+      _flat.block(e);
+      _flat.block(f);
     }
   }
 }
@@ -206,11 +203,11 @@ void OctiGridGraph::writeInitialCosts() {
         auto e = getEdg(port, oPort);
 
         if (i % 4 == 0) {
-          e->pl().setCost(_c.verticalPen);
+          _flat.setCost(e, _c.verticalPen);
         } else if ((i + 2) % 4 == 0) {
-          e->pl().setCost(_c.horizontalPen);
+          _flat.setCost(e, _c.horizontalPen);
         } else if (i % 2) {
-          e->pl().setCost(_c.diagonalPen);
+          _flat.setCost(e, _c.diagonalPen);
         }
       }
     }
@@ -238,13 +235,9 @@ GridNode* OctiGridGraph::writeNd(size_t x, size_t y) {
   double xPos = _bbox.getLowerLeft().getX() + x * _cellSize;
   double yPos = _bbox.getLowerLeft().getY() + y * _cellSize;
 
-  GridNode* n = addNd(DPoint(xPos, yPos));
-  n->pl().setId(_nds.size());
-  _nds.push_back(n);
-  n->pl().setSink();
+  GridNode* n = addGrNd(DPoint(xPos, yPos));
   _grid.add(x, y, n);
   n->pl().setXY(x, y);
-  n->pl().setParent(n);
 
   for (int i = 0; i < 8; i++) {
     int xi = (4 - (i % 8)) % 4;
@@ -252,19 +245,12 @@ GridNode* OctiGridGraph::writeNd(size_t x, size_t y) {
     int yi = (4 - ((i + 2) % 8)) % 4;
     yi /= abs(abs(yi) - 1) + 1;
 
-    GridNode* nn = addNd(DPoint(xPos + xi * _spacer, yPos + yi * _spacer));
-    nn->pl().setId(_nds.size());
-    _nds.push_back(nn);
-    nn->pl().setParent(n);
-    n->pl().setPort(i, nn);
+    GridNode* nn = addGrNd(DPoint(xPos + xi * _spacer, yPos + yi * _spacer));
+    nn->pl().setXY(x, y);
 
-    auto e = addEdg(n, nn, GridEdgePL(INF, true, true));
-    e->pl().setId(_edgeCount);
-    _edgeCount++;
+    addGrEdg(n, nn, INF, true);
 
-    e = addEdg(nn, n, GridEdgePL(INF, true, true));
-    e->pl().setId(_edgeCount);
-    _edgeCount++;
+    addGrEdg(nn, n, INF, true);
   }
 
   // in-node connections
@@ -278,15 +264,9 @@ GridNode* OctiGridGraph::writeNd(size_t x, size_t y) {
       if (y == _grid.getYHeight() - 1 && (i == 3 || i == 4 || i == 5))
         pen = INF;
 
-      auto e = addEdg(n->pl().getPort(i), n->pl().getPort(j),
-                            GridEdgePL(pen, true, false));
-      e->pl().setId(_edgeCount);
-      _edgeCount++;
+      addGrEdg(n->pl().getPort(i), n->pl().getPort(j), pen, true);
 
-      e = addEdg(n->pl().getPort(j), n->pl().getPort(i),
-                       GridEdgePL(pen, true, false));
-      e->pl().setId(_edgeCount);
-      _edgeCount++;
+      addGrEdg(n->pl().getPort(j), n->pl().getPort(i), pen, true);
     }
   }
 
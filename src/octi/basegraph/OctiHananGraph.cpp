@@ -38,9 +38,6 @@ void OctiHananGraph::unSettleEdg(CombEdge* ce, GridNode* a, GridNode* b) {
   assert(ge);
   assert(gf);
 
-  ge->pl().delResEdg();
-  gf->pl().delResEdg();
-
   _resEdgs[ge].erase(ce);
   _resEdgs[gf].erase(ce);
 
@@ -54,8 +51,8 @@ void OctiHananGraph::unSettleEdg(CombEdge* ce, GridNode* a, GridNode* b) {
     auto pairs = _edgePairs.find(ge);
     if (pairs == _edgePairs.end()) return;
     for (auto p : pairs->second) {
-      p.first->pl().unblock();
-      p.second->pl().unblock();
+      _flat.unblock(p.first);
+      _flat.unblock(p.second);
     }
   }
 }
@@ -103,8 +100,8 @@ void OctiHananGraph::settleEdg(GridNode* a, GridNode* b, CombEdge* e,
     auto pairs = _edgePairs.find(ge);
     if (pairs == _edgePairs.end()) return;
     for (auto p : pairs->second) {
-      p.first->pl().block();
-      p.second->pl().block();
+      _flat.block(p.first);
+      _flat.block(p.second);
     }
   }
 }
@@ -350,6 +347,35 @@ void OctiHananGraph::init() {
 
   prunePorts();
   writeInitialCosts();
+  finishInit();
+}
+
+// _____________________________________________________________________________
+void OctiHananGraph::initFrom(const BaseGraph* tmplGraph) {
+  GridGraph::initFrom(tmplGraph);
+  auto tmpl = dynamic_cast<const OctiHananGraph*>(tmplGraph);
+
+  _ndIdx = tmpl->_ndIdx;
+
+  _neighs.resize(tmpl->_neighs.size(), 0);
+  for (size_t i = 0; i < tmpl->_neighs.size(); i++) {
+    if (tmpl->_neighs[i]) _neighs[i] = _nds[tmpl->_neighs[i]->pl().getId()];
+  }
+
+  // map template edges to their copies, the template may hold null edges
+  // for nodes that were not connected
+  auto cp = [this](const GridEdge* e) -> GridEdge* {
+    if (!e) return 0;
+    return getEdg(_nds[e->getFrom()->pl().getId()],
+                  _nds[e->getTo()->pl().getId()]);
+  };
+
+  for (const auto& ep : tmpl->_edgePairs) {
+    auto& pairs = _edgePairs[cp(ep.first)];
+    for (const auto& p : ep.second) {
+      pairs.push_back({cp(p.first), cp(p.second)});
+    }
+  }
 }
 
 // _____________________________________________________________________________
@@ -360,16 +386,12 @@ void OctiHananGraph::connectNodes(GridNode* grNdFr, GridNode* grNdTo,
   GridNode* fr = grNdFr->pl().getPort(p);
   GridNode* to = grNdTo->pl().getPort((p + maxDeg() / 2) % maxDeg());
 
-  auto e = addEdg(fr, to, GridEdgePL(9, false, false));
-  e->pl().setId(_edgeCount);
-  _edgeCount++;
+  addGrEdg(fr, to, 9, false);
 
   _neighs[grNdFr->pl().getId() + p] = grNdTo;
   _neighs[grNdTo->pl().getId() + (p + maxDeg() / 2) % maxDeg()] = grNdFr;
 
-  auto f = addEdg(to, fr, GridEdgePL(9, false, false));
-  f->pl().setId(_edgeCount);
-  _edgeCount++;
+  addGrEdg(to, fr, 9, false);
 }
 
 // _____________________________________________________________________________
@@ -397,7 +419,7 @@ void OctiHananGraph::writeInitialCosts() {
         else if (p % 2)
           cost = (_c.diagonalPen + _heurHopCost) * yDist - _heurHopCost;
 
-        e->pl().setCost(cost);
+        _flat.setCost(e, cost);
       }
     }
 }
@@ -407,14 +429,10 @@ GridNode* OctiHananGraph::writeNd(size_t x, size_t y) {
   double xPos = _bbox.getLowerLeft().getX() + x * _cellSize;
   double yPos = _bbox.getLowerLeft().getY() + y * _cellSize;
 
-  GridNode* n = addNd(DPoint(xPos, yPos));
-  n->pl().setId(_nds.size());
-  _nds.push_back(n);
+  GridNode* n = addGrNd(DPoint(xPos, yPos));
   _ndIdx[x * _grid.getYHeight() + y] = _nds.size();
-  n->pl().setSink();
   _grid.add(x, y, n);
   n->pl().setXY(x, y);
-  n->pl().setParent(n);
 
   for (int i = 0; i < 8; i++) {
     int xi = (4 - (i % 8)) % 4;
@@ -422,19 +440,12 @@ GridNode* OctiHananGraph::writeNd(size_t x, size_t y) {
     int yi = (4 - ((i + 2) % 8)) % 4;
     yi /= abs(abs(yi) - 1) + 1;
 
-    GridNode* nn = addNd(DPoint(xPos + xi * _spacer, yPos + yi * _spacer));
-    nn->pl().setId(_nds.size());
-    _nds.push_back(nn);
-    nn->pl().setParent(n);
-    n->pl().setPort(i, nn);
+    GridNode* nn = addGrNd(DPoint(xPos + xi * _spacer, yPos + yi * _spacer));
+    nn->pl().setXY(x, y);
 
-    auto e = addEdg(n, nn, GridEdgePL(INF, true, true));
-    e->pl().setId(_edgeCount);
-    _edgeCount++;
+    addGrEdg(n, nn, INF, true);
 
-    e = addEdg(nn, n, GridEdgePL(INF, true, true));
-    e->pl().setId(_edgeCount);
-    _edgeCount++;
+    addGrEdg(nn, n, INF, true);
   }
 
   // in-node connections
@@ -448,15 +459,9 @@ GridNode* OctiHananGraph::writeNd(size_t x, size_t y) {
       if (y == _grid.getYHeight() - 1 && (i == 3 || i == 4 || i == 5))
         pen = INF;
 
-      auto e = addEdg(n->pl().getPort(i), n->pl().getPort(j),
-                            GridEdgePL(pen, true, false));
-      e->pl().setId(_edgeCount);
-      _edgeCount++;
+      addGrEdg(n->pl().getPort(i), n->pl().getPort(j), pen, true);
 
-      e = addEdg(n->pl().getPort(j), n->pl().getPort(i),
-                       GridEdgePL(pen, true, false));
-      e->pl().setId(_edgeCount);
-      _edgeCount++;
+      addGrEdg(n->pl().getPort(j), n->pl().getPort(i), pen, true);
     }
   }
 
@@ -25,6 +25,7 @@ class OctiHananGraph : public OctiGridGraph {
   virtual size_t maxDeg() const;
   virtual double ndMovePen(const CombNode* cbNd, const GridNode* grNd) const;
   virtual void init();
+  virtual void initFrom(const BaseGraph* tmpl);
 
  protected:
   virtual GridNode* writeNd(size_t x, size_t y);
@@ -33,9 +33,6 @@ void OctiQuadTree::unSettleEdg(CombEdge* ce, GridNode* a, GridNode* b) {
   assert(ge);
   assert(gf);
 
-  ge->pl().delResEdg();
-  gf->pl().delResEdg();
-
   _resEdgs[ge].erase(ce);
   _resEdgs[gf].erase(ce);
 
@@ -72,8 +69,8 @@ void OctiQuadTree::unSettleEdg(CombEdge* ce, GridNode* a, GridNode* b) {
     auto e = getNEdg(aa, bb);
     auto f = getNEdg(bb, aa);
     if (e && f) {
-      e->pl().unblock();
-      f->pl().unblock();
+      _flat.unblock(e);
+      _flat.unblock(f);
     }
   }
 }
@@ -125,8 +122,8 @@ void OctiQuadTree::settleEdg(GridNode* a, GridNode* b, CombEdge* e,
     auto f = getNEdg(bb, aa);
 
     if (e && f) {
-      e->pl().block();
-      f->pl().block();
+      _flat.block(e);
+      _flat.block(f);
     }
   }
 }
@@ -292,6 +289,7 @@ struct SplitFunc : util::geo::SplitFunc<const CombNode*, double> {
 
   prunePorts();
   writeInitialCosts();
+  finishInit();
 }
 
 // _____________________________________________________________________________
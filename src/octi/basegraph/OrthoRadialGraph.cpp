@@ -43,15 +43,14 @@ void OrthoRadialGraph::init() {
         if (from != 0 && toN != 0) {
           GridNode* to = toN->pl().getPort((p + maxDeg() / 2) % maxDeg());
           if (!to) continue;
-          auto e = addEdg(from, to, GridEdgePL(9, false, false));
-          e->pl().setId(_edgeCount);
-          _edgeCount++;
+          addGrEdg(from, to, 9, false);
         }
       }
     }
   }
 
   writeInitialCosts();
+  finishInit();
 }
 
 // _____________________________________________________________________________
@@ -128,10 +127,10 @@ void OrthoRadialGraph::writeInitialCosts() {
         // represent the map lengths exactly
         if (i % 2 == 0) {
           // vertical hops always have the same length
-          e->pl().setCost((_c.verticalPen));
+          _flat.setCost(e, (_c.verticalPen));
         } else {
           // horizontal hops get bigger with higher y (= higher radius)
-          e->pl().setCost((_c.horizontalPen + c_0) * sX - c_0);
+          _flat.setCost(e, (_c.horizontalPen + c_0) * sX - c_0);
         }
       }
     }
@@ -187,13 +186,9 @@ GridNode* OrthoRadialGraph::writeNd(size_t x, size_t y) {
   double c_0 = _c.p_45 - _c.p_135;
   double c_90 = _c.p_45 - _c.p_135 + _c.p_90;
 
-  GridNode* n = addNd(pos);
-  n->pl().setId(_nds.size());
-  _nds.push_back(n);
-  n->pl().setSink();
+  GridNode* n = addGrNd(pos);
   _grid.add(pos, n);
   n->pl().setXY(x, y);
-  n->pl().setParent(n);
 
   for (int i = 0; i < 4; i++) {
     int xi = 0;
@@ -204,19 +199,12 @@ GridNode* OrthoRadialGraph::writeNd(size_t x, size_t y) {
     if (i == 2) yi = -1;
     if (i == 3) xi = -1;
 
-    GridNode* nn = addNd(DPoint(xPos + xi * _spacer, yPos + yi * _spacer));
-    nn->pl().setId(_nds.size());
-    _nds.push_back(nn);
-    nn->pl().setParent(n);
-    n->pl().setPort(i, nn);
+    GridNode* nn = addGrNd(DPoint(xPos + xi * _spacer, yPos + yi * _spacer));
+    nn->pl().setXY(x, y);
 
-    auto e = addEdg(n, nn, GridEdgePL(INF, true, false));
-    e->pl().setId(_edgeCount);
-    _edgeCount++;
+    addGrEdg(n, nn, INF, true);
 
-    e = addEdg(nn, n, GridEdgePL(INF, true, false));
-    e->pl().setId(_edgeCount);
-    _edgeCount++;
+    addGrEdg(nn, n, INF, true);
   }
 
   // in-node connections
@@ -233,15 +221,9 @@ GridNode* OrthoRadialGraph::writeNd(size_t x, size_t y) {
       if (y == 1 && j == 2) pen = INF;
       if (y == _grid.getYHeight() / 2 && i == 0) pen = INF;
 
-      auto e = addEdg(n->pl().getPort(i), n->pl().getPort(j),
-                            GridEdgePL(pen, true, false));
-      e->pl().setId(_edgeCount);
-      _edgeCount++;
+      addGrEdg(n->pl().getPort(i), n->pl().getPort(j), pen, true);
 
-      e = addEdg(n->pl().getPort(j), n->pl().getPort(i),
-                       GridEdgePL(pen, true, false));
-      e->pl().setId(_edgeCount);
-      _edgeCount++;
+      addGrEdg(n->pl().getPort(j), n->pl().getPort(i), pen, true);
     }
   }
 
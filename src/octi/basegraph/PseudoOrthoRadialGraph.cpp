@@ -48,52 +48,13 @@ void PseudoOrthoRadialGraph::writeObstacleCost(
                 util::geo::LineSegment<double>(*ge->getFrom()->pl().getGeom(),
                                                *ge->getTo()->pl().getGeom()),
                 obst)) {
-          ge->pl().setCost(std::numeric_limits<double>::infinity());
+          _flat.setCost(ge, std::numeric_limits<double>::infinity());
         }
       }
     }
   }
 }
 
-// _____________________________________________________________________________
-void PseudoOrthoRadialGraph::writeGeoCoursePens(const CombEdge* ce,
-                                                GeoPensMap* target,
-                                                double pen) {
-  (*target)[ce].resize(_edgeCount);
-  for (size_t y = 1; y < _grid.getYHeight() / 2; y++) {
-    for (size_t x = 0; x < _numBeams * multi(y); x++) {
-      auto grNdA = getNode(x, y);
-
-      for (size_t i = 0; i < maxDeg(); i++) {
-        auto grNeigh = neigh(x, y, i);
-        if (!grNeigh) continue;
-        auto ge = getNEdg(grNdA, grNeigh);
-
-        double d = std::numeric_limits<double>::infinity();
-
-        for (auto orE : ce->pl().getChilds()) {
-          double dLoc = fmax(
-              fmax(dist(*orE->pl().getGeom(), *ge->getFrom()->pl().getGeom()) /
-                       getCellSize(),
-                   dist(*orE->pl().getGeom(),
-                        util::geo::centroid(util::geo::MultiPoint<double>{
-                            *ge->getFrom()->pl().getGeom(),
-                            *ge->getFrom()->pl().getGeom()})) /
-                       getCellSize()),
-              dist(*orE->pl().getGeom(), *ge->getTo()->pl().getGeom()) /
-                  getCellSize());
-
-          if (dLoc < d) d = dLoc;
-        }
-
-        d *= pen * d;
-
-        (*target)[ce][ge->pl().getId()] = d;
-      }
-    }
-  }
-}
-
 // _____________________________________________________________________________
 void PseudoOrthoRadialGraph::init() {
   // write nodes
@@ -122,9 +83,7 @@ void PseudoOrthoRadialGraph::init() {
           if (y == 0) to = toN->pl().getPort(2);
           if (toN->pl().getY() == 0) to = toN->pl().getPort(x / 2);
           if (!to) continue;
-          auto e = addEdg(from, to, GridEdgePL(9, false, false));
-          e->pl().setId(_edgeCount);
-          _edgeCount++;
+          addGrEdg(from, to, 9, false);
         }
       }
     }
@@ -132,6 +91,7 @@ void PseudoOrthoRadialGraph::init() {
 
   writeInitialCosts();
   prunePorts();
+  finishInit();
 }
 
 // _____________________________________________________________________________
@@ -293,12 +253,12 @@ void PseudoOrthoRadialGraph::writeInitialCosts() {
         // represent the map lengths exactly
         if (i % 2 == 0) {
           // vertical hops always have the same length
-          e->pl().setCost(_c.verticalPen);
-          assert(e->pl().cost() >= 0);
+          _flat.setCost(e, _c.verticalPen);
+          assert(_flat.cost(e) >= 0);
         } else {
           // horizontal hops get bigger with higher y (= higher radius)
-          e->pl().setCost((_c.horizontalPen + c_0) * sX - c_0);
-          assert(e->pl().cost() >= 0);
+          _flat.setCost(e, (_c.horizontalPen + c_0) * sX - c_0);
+          assert(_flat.cost(e) >= 0);
         }
       }
     }
@@ -354,16 +314,12 @@ GridNode* PseudoOrthoRadialGraph::writeNd(size_t x, size_t y) {
   double c_0 = _c.p_45 - _c.p_135;
   double c_90 = _c.p_45 - _c.p_135 + _c.p_90;
 
-  GridNode* n = addNd(pos);
-  n->pl().setId(_nds.size());
-  _nds.push_back(n);
-  n->pl().setSink();
+  GridNode* n = addGrNd(pos);
 
   // we are using the raw position here, as grid cells do not reflect the
   // positions in the grid graph as in the octilinear case
   _grid.add(pos, n);
   n->pl().setXY(x, y);
-  n->pl().setParent(n);
 
   for (int i = 0; i < 4; i++) {
     int xi = 0;
@@ -374,19 +330,12 @@ GridNode* PseudoOrthoRadialGraph::writeNd(size_t x, size_t y) {
     if (i == 2) yi = -1;
     if (i == 3) xi = -1;
 
-    GridNode* nn = addNd(DPoint(xPos + xi * _spacer, yPos + yi * _spacer));
-    nn->pl().setId(_nds.size());
-    _nds.push_back(nn);
-    nn->pl().setParent(n);
-    n->pl().setPort(i, nn);
+    GridNode* nn = addGrNd(DPoint(xPos + xi * _spacer, yPos + yi * _spacer));
+    nn->pl().setXY(x, y);
 
-    auto e = addEdg(n, nn, GridEdgePL(INF, true, false));
-    e->pl().setId(_edgeCount);
-    _edgeCount++;
+    addGrEdg(n, nn, INF, true);
 
-    e = addEdg(nn, n, GridEdgePL(INF, true, false));
-    e->pl().setId(_edgeCount);
-    _edgeCount++;
+    addGrEdg(nn, n, INF, true);
   }
 
   // in-node connections
@@ -403,15 +352,9 @@ GridNode* PseudoOrthoRadialGraph::writeNd(size_t x, size_t y) {
       if (y == 1 && x % 2 && j == 2) pen = INF;
       if (y == _grid.getYHeight() / 2 && i == 0) pen = INF;
 
-      auto e = addEdg(n->pl().getPort(i), n->pl().getPort(j),
-                      GridEdgePL(pen, true, false));
-      e->pl().setId(_edgeCount);
-      _edgeCount++;
+      addGrEdg(n->pl().getPort(i), n->pl().getPort(j), pen, true);
 
-      e = addEdg(n->pl().getPort(j), n->pl().getPort(i),
-                 GridEdgePL(pen, true, false));
-      e->pl().setId(_edgeCount);
-      _edgeCount++;
+      addGrEdg(n->pl().getPort(j), n->pl().getPort(i), pen, true);
     }
   }
 
@@ -32,8 +32,6 @@ class PseudoOrthoRadialGraph : public GridGraph {
   virtual PolyLine<double> geomFromPath(
       const std::vector<std::pair<size_t, size_t>>& res) const;
   virtual double ndMovePen(const CombNode* cbNd, const GridNode* grNd) const;
-  virtual void writeGeoCoursePens(const CombEdge* ce, GeoPensMap* target,
-                                  double pen);
 
  protected:
   virtual void writeInitialCosts();
@@ -58,11 +56,11 @@ struct PseudoOrthoRadialGraphHeur
     cheapestSink = std::numeric_limits<float>::infinity();
 
     for (auto n : to) {
-      assert(n->pl().getParent() == n);
+      assert(n->pl().isSink());
       size_t i = 0;
       for (; i < g->maxDeg(); i++) {
         if (!n->pl().getPort(i)) continue;
-        float sinkCost = g->getEdg(n->pl().getPort(i), n)->pl().cost();
+        float sinkCost = g->getFlat().cost(g->getEdg(n->pl().getPort(i), n));
         if (sinkCost < cheapestSink) cheapestSink = sinkCost;
         auto neigh = g->neigh(n, i);
         if (neigh && to.find(neigh) == to.end()) {
@@ -73,7 +71,7 @@ struct PseudoOrthoRadialGraphHeur
       }
       for (size_t j = i; j < g->maxDeg(); j++) {
         if (!n->pl().getPort(j)) continue;
-        float sinkCost = g->getEdg(n->pl().getPort(j), n)->pl().cost();
+        float sinkCost = g->getFlat().cost(g->getEdg(n->pl().getPort(j), n));
         if (sinkCost < cheapestSink) cheapestSink = sinkCost;
       }
     }
@@ -85,8 +83,7 @@ struct PseudoOrthoRadialGraphHeur
     float ret = std::numeric_limits<float>::infinity();
 
     for (size_t i = 0; i < hull.size(); i += 2) {
-      float tmp = g->heurCost(from->pl().getParent()->pl().getX(),
-                              from->pl().getParent()->pl().getY(), hull[i],
+      float tmp = g->heurCost(from->pl().getX(), from->pl().getY(), hull[i],
                               hull[i + 1]);
       if (tmp < ret) ret = tmp;
     }
@@ -55,6 +55,10 @@ Score Drawing::fullScore() const {
 
 // _____________________________________________________________________________
 void Drawing::draw(CombEdge* ce, const GrEdgList& ges, bool rev) {
+  backup(ce);
+  backup(ce->getFrom());
+  backup(ce->getTo());
+
   if (_c == std::numeric_limits<double>::infinity()) _c = 0;
   if (_edgs.count(ce)) _edgs[ce].clear();
 
@@ -86,7 +90,7 @@ void Drawing::draw(CombEdge* ce, const GrEdgList& ges, bool rev) {
     //  d) edge costs, which can also be safely removed if a settled edge is
     //     unsettled
 
-    double edgeCost = ge->pl().cost();
+    double edgeCost = _gg->getFlat().cost(ge);
     if (edgeCost >= basegraph::SOFT_INF) {
       int vios = edgeCost / basegraph::SOFT_INF;
       edgeCost -= vios * basegraph::SOFT_INF;
@@ -462,6 +466,9 @@ void Drawing::getLineGraph(LineGraph* target) const {
 }
 // _____________________________________________________________________________
 void Drawing::crumble() {
+  // a crumbled drawing cannot be rolled back
+  commit();
+
   _c = std::numeric_limits<double>::infinity();
   _violations = 0;
   _nds.clear();
@@ -544,6 +551,10 @@ const std::map<const CombEdge*, GrPath>& Drawing::getEdgPaths() const {
 
 // _____________________________________________________________________________
 void Drawing::erase(CombEdge* ce) {
+  backup(ce);
+  backup(ce->getFrom());
+  backup(ce->getTo());
+
   _edgs.erase(ce);
   _c -= _edgCosts[ce];
   _edgCosts.erase(ce);
@@ -567,6 +578,8 @@ void Drawing::erase(CombEdge* ce) {
 
 // _____________________________________________________________________________
 void Drawing::erase(CombNode* cn) {
+  backup(cn);
+
   _nds.erase(cn);
   _c -= _ndReachCosts[cn];
   _c -= _ndBndCosts[cn];
@@ -640,3 +653,132 @@ double Drawing::getNdReachCost(const CombNode* n) const {
   if (_ndReachCosts.count(n)) return _ndReachCosts.find(n)->second;
   return 0;
 }
+
+// _____________________________________________________________________________
+void Drawing::checkpoint() {
+  _logging = true;
+  _logC = _c;
+  _logViolations = _violations;
+  _ndLog.clear();
+  _edgLog.clear();
+}
+
+// _____________________________________________________________________________
+void Drawing::commit() {
+  _logging = false;
+  _ndLog.clear();
+  _edgLog.clear();
+}
+
+// _____________________________________________________________________________
+void Drawing::rollback() {
+  assert(_logging);
+
+  for (const auto& b : _ndLog) {
+    if (b.hasGrNd)
+      _nds[b.nd] = b.grNd;
+    else
+      _nds.erase(b.nd);
+    if (b.hasReachCost)
+      _ndReachCosts[b.nd] = b.reachCost;
+    else
+      _ndReachCosts.erase(b.nd);
+    if (b.hasBndCost)
+      _ndBndCosts[b.nd] = b.bndCost;
+    else
+      _ndBndCosts.erase(b.nd);
+  }
+
+  for (auto& b : _edgLog) {
+    if (b.hasPath)
+      _edgs[b.edg].swap(b.path);
+    else
+      _edgs.erase(b.edg);
+    if (b.hasCost)
+      _edgCosts[b.edg] = b.cost;
+    else
+      _edgCosts.erase(b.edg);
+    if (b.hasVios)
+      _vios[b.edg] = b.vios;
+    else
+      _vios.erase(b.edg);
+    if (b.hasSpringCost)
+      _springCosts[b.edg] = b.springCost;
+    else
+      _springCosts.erase(b.edg);
+  }
+
+  _c = _logC;
+  _violations = _logViolations;
+
+  // keep recording, relative to the restored state
+  _ndLog.clear();
+  _edgLog.clear();
+}
+
+// _____________________________________________________________________________
+void Drawing::backup(const CombNode* nd) {
+  if (!_logging) return;
+
+  // only the first state since the checkpoint is of interest
+  for (const auto& b : _ndLog)
+    if (b.nd == nd) return;
+
+  NdBackup b{nd, false, false, false, 0, 0, 0};
+
+  auto ndIt = _nds.find(nd);
+  if (ndIt != _nds.end()) {
+    b.hasGrNd = true;
+    b.grNd = ndIt->second;
+  }
+
+  auto reachIt = _ndReachCosts.find(nd);
+  if (reachIt != _ndReachCosts.end()) {
+    b.hasReachCost = true;
+    b.reachCost = reachIt->second;
+  }
+
+  auto bndIt = _ndBndCosts.find(nd);
+  if (bndIt != _ndBndCosts.end()) {
+    b.hasBndCost = true;
+    b.bndCost = bndIt->second;
+  }
+
+  _ndLog.push_back(b);
+}
+
+// _____________________________________________________________________________
+void Drawing::backup(const CombEdge* e) {
+  if (!_logging) return;
+
+  // only the first state since the checkpoint is of interest
+  for (const auto& b : _edgLog)
+    if (b.edg == e) return;
+
+  _edgLog.push_back({e, false, false, false, false, {}, 0, 0, 0});
+  auto& b = _edgLog.back();
+
+  auto pathIt = _edgs.find(e);
+  if (pathIt != _edgs.end()) {
+    b.hasPath = true;
+    b.path = pathIt->second;
+  }
+
+  auto costIt = _edgCosts.find(e);
+  if (costIt != _edgCosts.end()) {
+    b.hasCost = true;
+    b.cost = costIt->second;
+  }
+
+  auto viosIt = _vios.find(e);
+  if (viosIt != _vios.end()) {
+    b.hasVios = true;
+    b.vios = viosIt->second;
+  }
+
+  auto springIt = _springCosts.find(e);
+  if (springIt != _springCosts.end()) {
+    b.hasSpringCost = true;
+    b.springCost = springIt->second;
+  }
+}
@@ -67,6 +67,25 @@ struct Segment {
   std::set<CombEdge*> combEdges;
 };
 
+// snapshot of all drawing entries belonging to a single comb node, used
+// for rolling back changes
+struct NdBackup {
+  const CombNode* nd;
+  bool hasGrNd, hasReachCost, hasBndCost;
+  size_t grNd;
+  double reachCost, bndCost;
+};
+
+// snapshot of all drawing entries belonging to a single comb edge, used
+// for rolling back changes
+struct EdgBackup {
+  const CombEdge* edg;
+  bool hasPath, hasCost, hasVios, hasSpringCost;
+  GrPath path;
+  double cost, springCost;
+  int vios;
+};
+
 class Drawing {
  public:
   Drawing(const BaseGraph* gg)
@@ -80,6 +99,13 @@ class Drawing {
   Score fullScore() const;
   void crumble();
 
+  // start recording changes, after this, rollback() restores the drawing to
+  // its current state in O(#changed nodes and edges)
+  void checkpoint();
+  void rollback();
+  // stop recording changes and keep the current state
+  void commit();
+
   void draw(CombEdge* ce, const GrEdgList& ge, bool rev);
   void erase(CombEdge* ce);
   void erase(CombNode* ce);
@@ -120,6 +146,16 @@ class Drawing {
 
   size_t _violations;
 
+  // undo log
+  bool _logging = false;
+  double _logC;
+  size_t _logViolations;
+  std::vector<NdBackup> _ndLog;
+  std::vector<EdgBackup> _edgLog;
+
+  void backup(const CombNode* nd);
+  void backup(const CombEdge* e);
+
   double recalcBends(const CombNode* nd);
 };
 }  // namespace combgraph
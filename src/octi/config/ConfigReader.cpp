@@ -14,6 +14,7 @@
 
 using octi::config::ConfigReader;
 
+using octi::basegraph::BaseGraphLayout;
 using octi::basegraph::BaseGraphType;
 using octi::config::OrderMethod;
 using std::exception;
@@ -50,12 +51,29 @@ void ConfigReader::help(const char* bin) const {
             << std::setw(36) << " " << " percentage of input adjacent station distance\n"
             << std::setw(36) << "  -b [ -base-graph ] arg (=octilinear)"
             << "base graph, either ortholinear, octilinear,\n"
-            << std::setw(36) << " " << " orthoradial, quadtree, octihanan\n\n"
+            << std::setw(36) << " " << " orthoradial, quadtree, octihanan\n"
+            << std::setw(36) << "  --base-graph-layout arg (=csr)"
+            << "adjacency layout of the base graph used for\n"
+            << std::setw(36) << " " << " routing, either adjlist or csr\n\n"
+            << "Server:\n"
+            << std::setw(36) << "  --serve arg"
+            << "run as HTTP server on port arg, input graphs\n"
+            << std::setw(36) << " " << " are read from POST requests\n"
+            << std::setw(36) << "  --serve-threads arg (=1)"
+            << "max number of requests handled in parallel\n"
+            << std::setw(36) << "  --serve-timeout arg (=60)"
+            << "socket read/write timeout (seconds), also\n"
+            << std::setw(36) << " "
+            << " caps the ILP time limit, 0 to disable\n\n"
             << "Misc:\n"
             << std::setw(36) << "  --ilp-num-threads arg (=0)"
-            << "number of threads to use by ILP solver,\n"
+            << "number of threads to use by ILP solver and\n"
+            << std::setw(36) << " "
+            << " for building the ILP, 0 means solver default\n"
+            << std::setw(36) << "  --threads arg (=4)"
+            << "number of threads used by heuristic approach,\n"
             << std::setw(36) << " "
-            << " 0 means solver default\n"
+            << " 0 means number of available processors\n"
             << std::setw(36) << "  --hanan-iters arg (=1)"
             << "number of Hanan grid iterations\n"
             << std::setw(36) << "  --loc-search-max-iters arg (=100)"
@@ -74,6 +92,10 @@ void ConfigReader::help(const char* bin) const {
             << "write stats to output graph\n"
             << std::setw(36) << "  -D [ --from-dot ]"
             << "input is in dot format\n"
+            << std::setw(36) << "  --from-bin"
+            << "input is in binary line graph format\n"
+            << std::setw(36) << "  --to-bin"
+            << "write output in binary line graph format\n"
             << std::setw(36) << "  --no-deg2-heur"
             << "don't contract degree 2 nodes\n"
             << std::setw(36) << "  --geo-pen arg (=0)"
@@ -110,6 +132,7 @@ void ConfigReader::help(const char* bin) const {
 void ConfigReader::read(Config* cfg, int argc, char** argv) const {
   std::string VERSION_STR = " - unversioned - ";
   std::string baseGraphStr = "octilinear";
+  std::string baseGraphLayoutStr = "csr";
   std::string edgeOrderMethod = "all";
 
   struct option ops[] = {
@@ -143,6 +166,13 @@ void ConfigReader::read(Config* cfg, int argc, char** argv) const {
                          {"pen-45", required_argument, 0, 23},
                          {"nd-move-pen", required_argument, 0, 24},
                          {"abort-after", required_argument, 0, 'a'},
+                         {"threads", required_argument, 0, 25},
+                         {"serve", required_argument, 0, 26},
+                         {"serve-threads", required_argument, 0, 27},
+                         {"serve-timeout", required_argument, 0, 28},
+                         {"from-bin", no_argument, 0, 29},
+                         {"to-bin", no_argument, 0, 30},
+                         {"base-graph-layout", required_argument, 0, 31},
                          {0, 0, 0, 0}};
 
   char c;
@@ -231,6 +261,27 @@ void ConfigReader::read(Config* cfg, int argc, char** argv) const {
       case 24:
         cfg->pens.ndMovePen= atof(optarg);
         break;
+      case 25:
+        cfg->heurNumThreads = atoi(optarg);
+        break;
+      case 26:
+        cfg->servePort = atoi(optarg);
+        break;
+      case 27:
+        cfg->serveThreads = atoi(optarg);
+        break;
+      case 28:
+        cfg->serveTimeout = atoi(optarg);
+        break;
+      case 29:
+        cfg->fromBin = true;
+        break;
+      case 30:
+        cfg->toBin = true;
+        break;
+      case 31:
+        baseGraphLayoutStr = optarg;
+        break;
       case 'g':
         cfg->gridSize = optarg;
         break;
@@ -301,4 +352,14 @@ void ConfigReader::read(Config* cfg, int argc, char** argv) const {
     LOG(ERROR) << "Unknown base graph type " << baseGraphStr << std::endl;
     exit(0);
   }
+
+  if (baseGraphLayoutStr == "adjlist") {
+    cfg->baseGraphLayout = BaseGraphLayout::ADJLIST;
+  } else if (baseGraphLayoutStr == "csr") {
+    cfg->baseGraphLayout = BaseGraphLayout::CSR;
+  } else {
+    LOG(ERROR) << "Unknown base graph layout " << baseGraphLayoutStr
+               << std::endl;
+    exit(0);
+  }
 }
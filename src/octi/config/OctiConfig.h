@@ -31,6 +31,8 @@ struct Config {
   std::string optMode = "heur";
   std::string ilpPath;
   bool fromDot = false;
+  bool fromBin = false;
+  bool toBin = false;
   bool deg2Heur = true;
   bool restrLocSearch = false;
   double enfGeoPen = 0;
@@ -44,18 +46,24 @@ struct Config {
   double maxGrDist = 3;
 
   int heurLocSearchIters = 100;
+  size_t heurNumThreads = 4;
 
   size_t abortAfter = -1;
 
   size_t hananIters = 1;
   bool writeStats = false;
 
+  int servePort = -1;
+  size_t serveThreads = 1;
+  size_t serveTimeout = 60;
+
   OrderMethod orderMethod;
 
   std::string obstaclePath;
   std::vector<util::geo::DPolygon> obstacles;
 
   octi::basegraph::BaseGraphType baseGraphType;
+  octi::basegraph::BaseGraphLayout baseGraphLayout;
 
   octi::basegraph::Penalties pens;
 };
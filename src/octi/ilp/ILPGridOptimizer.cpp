@@ -2,23 +2,59 @@
 // Chair of Algorithms and Data Structures.
 // Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
 
+#include <algorithm>
 #include <fstream>
+#include <set>
+#include <sstream>
 #include "octi/basegraph/BaseGraph.h"
 #include "octi/ilp/ILPGridOptimizer.h"
 #include "shared/optim/ILPSolvProv.h"
 #include "util/geo/output/GeoGraphJsonOutput.h"
 #include "util/log/Log.h"
 
+#ifdef _OPENMP
+#include <omp.h>
+#else
+#define omp_get_num_procs() 1
+#endif
+
 using octi::basegraph::BaseGraph;
 using octi::basegraph::GeoPensMap;
 using octi::basegraph::GridEdge;
 using octi::basegraph::GridNode;
 using octi::combgraph::Drawing;
 using octi::ilp::ILPGridOptimizer;
+using octi::ilp::ILPGridSol;
+using octi::ilp::ILPGridVars;
 using octi::ilp::ILPStats;
+using shared::optim::ILPRowBuffer;
 using shared::optim::ILPSolver;
 using shared::optim::StarterSol;
 
+namespace {
+// _____________________________________________________________________________
+template <typename F>
+void addRowsPar(ILPSolver* lp, size_t n, size_t jobs, F f) {
+  // call f(i, buf) for i in [0, n) on several threads, every chunk of items
+  // writes into its own row buffer. the buffers are appended in item order,
+  // so the resulting model does not depend on the number of threads.
+  size_t chunks = std::max<size_t>(1, std::min(n, jobs * 4));
+  std::vector<ILPRowBuffer> bufs(chunks, ILPRowBuffer(lp->isNamed()));
+
+#pragma omp parallel for num_threads(jobs) schedule(dynamic, 1)
+  for (size_t c = 0; c < chunks; c++) {
+    for (size_t i = c * n / chunks; i < (c + 1) * n / chunks; i++) {
+      f(i, &bufs[c]);
+    }
+  }
+
+  for (auto& buf : bufs) {
+    lp->addRows(buf);
+    buf = ILPRowBuffer(lp->isNamed());
+  }
+}
+}  // namespace
+
 // _____________________________________________________________________________
 ILPStats ILPGridOptimizer::optimize(BaseGraph* gg, const CombGraph& cg,
                                     combgraph::Drawing* d, double maxGrDist,
@@ -30,14 +66,14 @@ ILPStats ILPGridOptimizer::optimize(BaseGraph* gg, const CombGraph& cg,
                                     const std::string& path) const {
   // extract first feasible solution from gridgraph
   ILPStats s{std::numeric_limits<double>::infinity(), 0, 0, 0, 0};
-  StarterSol sol = extractFeasibleSol(d, gg, cg, maxGrDist);
+  ILPGridSol feasSol = extractFeasibleSol(d, gg, cg, maxGrDist);
   gg->reset();
 
   for (auto nd : gg->getNds()) {
     // if we presolve, some edges may be blocked
     for (auto e : nd->getAdjList()) {
-      e->pl().open();
-      e->pl().unblock();
+      gg->getFlat().open(e);
+      gg->getFlat().unblock(e);
     }
     if (!nd->pl().isSink()) continue;
     gg->openTurns(nd);
@@ -48,11 +84,15 @@ ILPStats ILPGridOptimizer::optimize(BaseGraph* gg, const CombGraph& cg,
   // clear drawing
   d->crumble();
 
-  auto lp = createProblem(gg, cg, geoPensMap, maxGrDist, solverStr);
+  // only generate variable names if we write the problem to a file
+  ILPGridVars vars;
+  auto lp = createProblem(gg, cg, geoPensMap, maxGrDist, solverStr,
+                          path.size(), numThreads, &vars);
 
   s.cols = lp->getNumVars();
   s.rows = lp->getNumConstrs();
 
+  StarterSol sol = getStarter(feasSol, vars);
   lp->setStarter(sol);
 
   if (path.size()) {
@@ -84,7 +124,7 @@ ILPStats ILPGridOptimizer::optimize(BaseGraph* gg, const CombGraph& cg,
           "limit)!");
     }
 
-    extractSolution(lp, gg, cg, d);
+    extractSolution(lp, vars, gg, cg, d);
     shared::linegraph::LineGraph tg;
     d->getLineGraph(&tg);
 
@@ -102,23 +142,37 @@ ILPStats ILPGridOptimizer::optimize(BaseGraph* gg, const CombGraph& cg,
 ILPSolver* ILPGridOptimizer::createProblem(BaseGraph* gg, const CombGraph& cg,
                                            const GeoPensMap* geoPensMap,
                                            double maxGrDist,
-                                           const std::string& solverStr) const {
+                                           const std::string& solverStr,
+                                           bool named, int numThreads,
+                                           ILPGridVars* vars) const {
   ILPSolver* lp = shared::optim::getSolver(solverStr, shared::optim::MIN);
+  lp->setNamed(named);
+
+  size_t jobs = numThreads;
+  if (jobs == 0) jobs = omp_get_num_procs();
+
+  std::vector<const CombNode*> cmbNds(cg.getNds().begin(), cg.getNds().end());
+  std::vector<const GridNode*> grNds(gg->getNds().begin(), gg->getNds().end());
+
+  // the comb edges, in the order in which their variables are added
+  std::vector<const CombEdge*> cmbEdgs;
+  for (auto nd : cmbNds) {
+    for (auto edg : nd->getAdjList()) {
+      if (edg->getFrom() == nd) cmbEdgs.push_back(edg);
+    }
+  }
 
   // grid nodes that may potentially be a position for an
   // input station
-  std::map<const CombNode*, std::set<const GridNode*>> cands;
+  std::vector<std::vector<const GridNode*>> candLists(cmbNds.size());
+  double maxDis = gg->getCellSize() * maxGrDist;
 
-  for (auto nd : cg.getNds()) {
+#pragma omp parallel for num_threads(jobs) schedule(dynamic, 1)
+  for (size_t i = 0; i < cmbNds.size(); i++) {
+    auto nd = cmbNds[i];
     if (nd->getDeg() == 0) continue;
-    std::stringstream oneAssignment;
-    // must sum up to 1
-    oneAssignment << "oneass(" << nd << ")";
-    int rowStat = lp->addRow(oneAssignment.str(), 1, shared::optim::FIX);
 
-    size_t i = 0;
-
-    for (const GridNode* n : gg->getNds()) {
+    for (const GridNode* n : grNds) {
       if (!n->pl().isSink()) continue;
 
       // don't use nodes as candidates which cannot hold the comb node due to
@@ -127,232 +181,269 @@ ILPSolver* ILPGridOptimizer::createProblem(BaseGraph* gg, const CombGraph& cg,
         continue;
       }
 
-      double gridD = dist(*n->pl().getGeom(), *nd->pl().getGeom());
-
       // threshold for speedup
-      double maxDis = gg->getCellSize() * maxGrDist;
+      double gridD = dist(*n->pl().getGeom(), *nd->pl().getGeom());
       if (gridD >= maxDis) {
         continue;
       }
 
+      candLists[i].push_back(n);
+    }
+  }
+
+  std::map<const CombNode*, std::set<const GridNode*>> cands;
+
+  for (size_t i = 0; i < cmbNds.size(); i++) {
+    auto nd = cmbNds[i];
+    if (nd->getDeg() == 0) continue;
+    // must sum up to 1
+    int rowStat = lp->addRow(1, shared::optim::FIX);
+
+    if (lp->isNamed()) {
+      std::stringstream oneAssignment;
+      oneAssignment << "oneass(" << nd << ")";
+      lp->setRowName(rowStat, oneAssignment.str());
+    }
+
+    for (const GridNode* n : candLists[i]) {
       cands[nd].insert(n);
 
       gg->openSinkFr(const_cast<GridNode*>(n), 0);
       gg->openSinkTo(const_cast<GridNode*>(n), 0);
 
-      auto varName = getStatPosVar(n, nd);
-
-      int col = lp->addCol(varName, shared::optim::BIN, gg->ndMovePen(nd, n));
+      int col = lp->addCol(shared::optim::BIN, gg->ndMovePen(nd, n));
+      vars->statPos[nd][n] = col;
+      if (lp->isNamed()) lp->setColName(col, getStatPosVarName(n, nd));
 
       lp->addColToRow(rowStat, col, 1);
-
-      i++;
     }
   }
 
+  auto isCand = [&cands](const CombNode* nd, const GridNode* n) {
+    auto i = cands.find(nd);
+    return i != cands.end() && i->second.count(n);
+  };
+
   // for every edge, we define a binary variable telling us whether this edge
   // is used in a path for the original edge
-  for (auto nd : cg.getNds()) {
-    for (auto edg : nd->getAdjList()) {
-      if (edg->getFrom() != nd) continue;
-      for (const GridNode* n : gg->getNds()) {
-        for (const GridEdge* e : n->getAdjList()) {
-          if (e->getFrom() != n) continue;
-          if (e->pl().cost() >= basegraph::SOFT_INF) {
-            // skip infinite edges, we cannot use them.
-            // this also skips sink edges of nodes not used as
-            // candidates
-            continue;
-          }
-
-          if (e->getFrom()->pl().isSink() &&
-              !cands[edg->getFrom()].count(e->getFrom())) {
-            continue;
-          }
+  std::vector<std::vector<std::pair<const GridEdge*, double>>> edgCols(
+      cmbEdgs.size());
+
+#pragma omp parallel for num_threads(jobs) schedule(dynamic, 1)
+  for (size_t i = 0; i < cmbEdgs.size(); i++) {
+    auto edg = cmbEdgs[i];
+    for (const GridNode* n : grNds) {
+      for (const GridEdge* e : n->getAdjList()) {
+        if (e->getFrom() != n) continue;
+        if (gg->getFlat().cost(e) >= basegraph::SOFT_INF) {
+          // skip infinite edges, we cannot use them.
+          // this also skips sink edges of nodes not used as
+          // candidates
+          continue;
+        }
 
-          if (e->getTo()->pl().isSink() &&
-              !cands[edg->getTo()].count(e->getTo())) {
-            continue;
-          }
+        if (e->getFrom()->pl().isSink() &&
+            !isCand(edg->getFrom(), e->getFrom())) {
+          continue;
+        }
 
-          auto edgeVarName = getEdgUseVar(e, edg);
+        if (e->getTo()->pl().isSink() && !isCand(edg->getTo(), e->getTo())) {
+          continue;
+        }
 
-          double coef;
-          if (geoPensMap && !e->pl().isSecondary()) {
-            // add geo pen
-            coef = e->pl().cost() +
-                   (*geoPensMap).find(edg)->second[e->pl().getId()];
-          } else {
-            coef = e->pl().cost();
-          }
-          lp->addCol(edgeVarName, shared::optim::BIN, coef);
+        double coef;
+        if (geoPensMap && !e->pl().isSecondary()) {
+          // add geo pen
+          coef = gg->getFlat().cost(e) + geoPensMap->find(edg)->second.get(e);
+        } else {
+          coef = gg->getFlat().cost(e);
         }
+        edgCols[i].push_back({e, coef});
       }
     }
   }
 
-  lp->update();
+  for (size_t i = 0; i < cmbEdgs.size(); i++) {
+    auto edg = cmbEdgs[i];
+    for (const auto& ec : edgCols[i]) {
+      int col = lp->addCol(shared::optim::BIN, ec.second);
+      vars->edgUse[edg][ec.first] = col;
+      if (lp->isNamed()) lp->setColName(col, getEdgUseVarName(ec.first, edg));
+    }
+  }
+
+  // from here on, vars is only read, and the constraints over the grid are
+  // generated into per-thread row buffers
 
   // an edge can only be used a single time
+  std::vector<std::pair<const GridEdge*, const GridEdge*>> useOnce;
   std::set<const GridEdge*> proced;
-  for (const GridNode* n : gg->getNds()) {
+  for (const GridNode* n : grNds) {
     for (const GridEdge* e : n->getAdjList()) {
       if (e->pl().isSecondary()) continue;
       if (proced.count(e)) continue;
       auto f = gg->getEdg(e->getTo(), e->getFrom());
       proced.insert(e);
       proced.insert(f);
+      useOnce.push_back({e, f});
+    }
+  }
 
+  addRowsPar(lp, useOnce.size(), jobs, [&](size_t i, ILPRowBuffer* buf) {
+    auto e = useOnce[i].first;
+    auto f = useOnce[i].second;
+
+    int row;
+
+    if (buf->isNamed()) {
       std::stringstream constName;
       constName << "ue(" << e->getFrom()->pl().getId() << ","
                 << e->getTo()->pl().getId() << ")";
-      int row = lp->addRow(constName.str(), 1, shared::optim::UP);
-
-      for (auto nd : cg.getNds()) {
-        for (auto edg : nd->getAdjList()) {
-          if (edg->getFrom() != nd) continue;
-          if (e->pl().cost() >= basegraph::SOFT_INF) continue;
+      row = buf->addRow(constName.str(), 1, shared::optim::UP);
+    } else {
+      row = buf->addRow(1, shared::optim::UP);
+    }
 
-          auto eVarName = getEdgUseVar(e, edg);
-          auto fVarName = getEdgUseVar(f, edg);
+    if (gg->getFlat().cost(e) >= basegraph::SOFT_INF) return;
 
-          int eCol = lp->getVarByName(eVarName);
-          if (eCol > -1) lp->addColToRow(row, eCol, 1);
-          int fCol = lp->getVarByName(fVarName);
-          if (fCol > -1) lp->addColToRow(row, fCol, 1);
-        }
-      }
+    for (auto edg : cmbEdgs) {
+      int eCol = getEdgUseVar(*vars, e, edg);
+      if (eCol > -1) buf->addColToRow(row, eCol, 1);
+      int fCol = getEdgUseVar(*vars, f, edg);
+      if (fCol > -1) buf->addColToRow(row, fCol, 1);
     }
-  }
+  });
 
   // for every node, the number of outgoing and incoming used edges must be
   // the same, except for the start and end node
-  for (const GridNode* n : gg->getNds()) {
-    if (nonInfDeg(n) == 0) continue;
+  addRowsPar(lp, grNds.size(), jobs, [&](size_t i, ILPRowBuffer* buf) {
+    auto n = grNds[i];
+    if (nonInfDeg(gg, n) == 0) return;
 
-    for (auto nd : cg.getNds()) {
-      for (auto edg : nd->getAdjList()) {
-        if (edg->getFrom() != nd) continue;
+    for (auto edg : cmbEdgs) {
+      // an upper bound is enough here
+      int row;
+
+      if (buf->isNamed()) {
         std::stringstream constName;
         constName << "as(" << n->pl().getId() << "," << edg << ")";
+        row = buf->addRow(constName.str(), 0, shared::optim::UP);
+      } else {
+        row = buf->addRow(0, shared::optim::UP);
+      }
 
-        // an upper bound is enough here
-        int row = lp->addRow(constName.str(), 0, shared::optim::UP);
-
-        // normally, we count an incoming edge as 1 and an outgoing edge as -1
-        // later on, we make sure that each node has a some of all out and in
-        // edges of 0
-        int inCost = -1;
-        int outCost = 1;
-
-        // for sink nodes, we apply a trick: an outgoing edge counts as 2 here.
-        // this means that a sink node cannot make up for an outgoing edge
-        // with an incoming edge - it would need 2 incoming edges to achieve
-        // that.
-        // however, this would mean (as sink nodes are never adjacent) that 2
-        // ports
-        // have outgoing edges - which would mean the path "split" somewhere
-        // before
-        // the ports, which is impossible and forbidden by our other
-        // constraints.
-        // the only way a sink node can make up for in outgoin edge
-        // is thus if we add -2 if the sink is marked as the start station of
-        // this edge
-        if (n->pl().isSink()) {
-          // subtract the variable for this start node and edge, if used
-          // as a candidate
-          int ndColFrom = lp->getVarByName(getStatPosVar(n, edg->getFrom()));
-          if (ndColFrom > -1) lp->addColToRow(row, ndColFrom, -2);
-
-          // add the variable for this end node and edge, if used
-          // as a candidate
-          int ndColTo = lp->getVarByName(getStatPosVar(n, edg->getTo()));
-          if (ndColTo > -1) lp->addColToRow(row, ndColTo, 1);
-
-          outCost = 2;
-        }
+      // normally, we count an incoming edge as 1 and an outgoing edge as -1
+      // later on, we make sure that each node has a some of all out and in
+      // edges of 0
+      int inCost = -1;
+      int outCost = 1;
+
+      // for sink nodes, we apply a trick: an outgoing edge counts as 2 here.
+      // this means that a sink node cannot make up for an outgoing edge
+      // with an incoming edge - it would need 2 incoming edges to achieve
+      // that.
+      // however, this would mean (as sink nodes are never adjacent) that 2
+      // ports
+      // have outgoing edges - which would mean the path "split" somewhere
+      // before
+      // the ports, which is impossible and forbidden by our other
+      // constraints.
+      // the only way a sink node can make up for in outgoin edge
+      // is thus if we add -2 if the sink is marked as the start station of
+      // this edge
+      if (n->pl().isSink()) {
+        // subtract the variable for this start node and edge, if used
+        // as a candidate
+        int ndColFrom = getStatPosVar(*vars, n, edg->getFrom());
+        if (ndColFrom > -1) buf->addColToRow(row, ndColFrom, -2);
+
+        // add the variable for this end node and edge, if used
+        // as a candidate
+        int ndColTo = getStatPosVar(*vars, n, edg->getTo());
+        if (ndColTo > -1) buf->addColToRow(row, ndColTo, 1);
+
+        outCost = 2;
+      }
 
-        for (auto e : n->getAdjListIn()) {
-          int edgCol = lp->getVarByName(getEdgUseVar(e, edg));
-          if (edgCol < 0) continue;
-          lp->addColToRow(row, edgCol, inCost);
-        }
+      for (auto e : n->getAdjListIn()) {
+        int edgCol = getEdgUseVar(*vars, e, edg);
+        if (edgCol < 0) continue;
+        buf->addColToRow(row, edgCol, inCost);
+      }
 
-        for (auto e : n->getAdjListOut()) {
-          int edgCol = lp->getVarByName(getEdgUseVar(e, edg));
-          if (edgCol < 0) continue;
-          lp->addColToRow(row, edgCol, outCost);
-        }
+      for (auto e : n->getAdjListOut()) {
+        int edgCol = getEdgUseVar(*vars, e, edg);
+        if (edgCol < 0) continue;
+        buf->addColToRow(row, edgCol, outCost);
       }
     }
-  }
-
-  lp->update();
+  });
 
   // only a single sink edge can be activated per input edge and settled grid
   // node
   // THIS RULE IS REDUNDANT AND IMPLICITELY ENFORCED BY OTHER RULES,
   // BUT SEEMS TO LEAD TO FASTER SOLUTION TIMES
-  for (GridNode* n : gg->getNds()) {
-    if (!n->pl().isSink()) continue;
+  addRowsPar(lp, grNds.size(), jobs, [&](size_t i, ILPRowBuffer* buf) {
+    auto n = grNds[i];
+    if (!n->pl().isSink()) return;
 
-    for (auto nd : cg.getNds()) {
-      for (auto e : nd->getAdjList()) {
-        if (e->getFrom() != nd) continue;
+    for (auto e : cmbEdgs) {
+      int row;
 
+      if (buf->isNamed()) {
         std::stringstream constName;
         constName << "ss(" << n->pl().getId() << "," << e << ")";
+        row = buf->addRow(constName.str(), 0, shared::optim::FIX);
+      } else {
+        row = buf->addRow(0, shared::optim::FIX);
+      }
 
-        int row = lp->addRow(constName.str(), 0, shared::optim::FIX);
-
-        if (!cands[e->getFrom()].count(n) && !cands[e->getTo()].count(n)) {
-          // node does not appear as start or end cand, so the number of
-          // sink edges for this node is 0
-
-        } else {
-          if (cands[e->getTo()].count(n)) {
-            int ndColTo = lp->getVarByName(getStatPosVar(n, e->getTo()));
-            if (ndColTo > -1) lp->addColToRow(row, ndColTo, -1);
-          }
-
-          if (cands[e->getFrom()].count(n)) {
-            int ndColFr = lp->getVarByName(getStatPosVar(n, e->getFrom()));
-            if (ndColFr > -1) lp->addColToRow(row, ndColFr, -1);
-          }
-        };
+      // if the node does not appear as start or end cand, the number of
+      // sink edges for this node is 0
+      if (isCand(e->getTo(), n)) {
+        int ndColTo = getStatPosVar(*vars, n, e->getTo());
+        if (ndColTo > -1) buf->addColToRow(row, ndColTo, -1);
+      }
 
-        for (size_t p = 0; p < gg->maxDeg(); p++) {
-          auto portNd = n->pl().getPort(p);
-          if (!portNd) continue;
-          auto varSinkTo = getEdgUseVar(gg->getEdg(portNd, n), e);
-          auto varSinkFr = getEdgUseVar(gg->getEdg(n, portNd), e);
+      if (isCand(e->getFrom(), n)) {
+        int ndColFr = getStatPosVar(*vars, n, e->getFrom());
+        if (ndColFr > -1) buf->addColToRow(row, ndColFr, -1);
+      }
 
-          int ndColTo = lp->getVarByName(varSinkTo);
-          if (ndColTo > -1) lp->addColToRow(row, ndColTo, 1);
+      for (size_t p = 0; p < gg->maxDeg(); p++) {
+        auto portNd = n->pl().getPort(p);
+        if (!portNd) continue;
+        int ndColTo = getEdgUseVar(*vars, gg->getEdg(portNd, n), e);
+        if (ndColTo > -1) buf->addColToRow(row, ndColTo, 1);
 
-          int ndColFr = lp->getVarByName(varSinkFr);
-          if (ndColFr > -1) lp->addColToRow(row, ndColFr, 1);
-        }
+        int ndColFr = getEdgUseVar(*vars, gg->getEdg(n, portNd), e);
+        if (ndColFr > -1) buf->addColToRow(row, ndColFr, 1);
       }
     }
-  }
+  });
 
   // a grid node can either be an activated sink, or a single pass through
   // edge is used
-  for (GridNode* n : gg->getNds()) {
-    if (!n->pl().isSink()) continue;
+  addRowsPar(lp, grNds.size(), jobs, [&](size_t i, ILPRowBuffer* buf) {
+    auto n = grNds[i];
+    if (!n->pl().isSink()) return;
 
-    std::stringstream constName;
-    constName << "iu(" << n->pl().getId() << ")";
+    int row;
 
-    int row = lp->addRow(constName.str(), 1, shared::optim::UP);
+    if (buf->isNamed()) {
+      std::stringstream constName;
+      constName << "iu(" << n->pl().getId() << ")";
+      row = buf->addRow(constName.str(), 1, shared::optim::UP);
+    } else {
+      row = buf->addRow(1, shared::optim::UP);
+    }
 
     // a meta grid node can either be a sink for a single input node, or
     // a pass-through
 
-    for (auto nd : cg.getNds()) {
-      int ndcolto = lp->getVarByName(getStatPosVar(n, nd).c_str());
-      if (ndcolto > -1) lp->addColToRow(row, ndcolto, 1);
+    for (auto nd : cmbNds) {
+      int ndcolto = getStatPosVar(*vars, n, nd);
+      if (ndcolto > -1) buf->addColToRow(row, ndcolto, 1);
     }
 
     // go over all ports
@@ -364,65 +455,64 @@ ILPSolver* ILPGridOptimizer::createProblem(BaseGraph* gg, const CombGraph& cg,
         if (!to || from == to) continue;
 
         auto innerE = gg->getEdg(from, to);
-        for (auto nd : cg.getNds()) {
-          for (auto edg : nd->getAdjList()) {
-            if (edg->getFrom() != nd) continue;
-
-            int edgCol = lp->getVarByName(getEdgUseVar(innerE, edg));
-            if (edgCol < 0) continue;
-            lp->addColToRow(row, edgCol, 1);
-          }
+        for (auto edg : cmbEdgs) {
+          int edgCol = getEdgUseVar(*vars, innerE, edg);
+          if (edgCol < 0) continue;
+          buf->addColToRow(row, edgCol, 1);
         }
       }
     }
-  }
-
-  lp->update();
+  });
 
   // dont allow crossing edges
-  size_t rowId = 0;
-  for (auto edgPair : gg->getCrossEdgPairs()) {
-    std::stringstream constName;
-    constName << "nc(" << rowId << ")";
-    rowId++;
+  auto crossPairs = gg->getCrossEdgPairs();
+  addRowsPar(lp, crossPairs.size(), jobs, [&](size_t i, ILPRowBuffer* buf) {
+    const auto& edgPair = crossPairs[i];
 
-    int row = lp->addRow(constName.str(), 1, shared::optim::UP);
+    int row;
 
-    for (auto nd : cg.getNds()) {
-      for (auto edg : nd->getAdjList()) {
-        if (edg->getFrom() != nd) continue;
+    if (buf->isNamed()) {
+      std::stringstream constName;
+      constName << "nc(" << i << ")";
+      row = buf->addRow(constName.str(), 1, shared::optim::UP);
+    } else {
+      row = buf->addRow(1, shared::optim::UP);
+    }
 
-        int col = lp->getVarByName(getEdgUseVar(edgPair.first.first, edg));
-        if (col > -1) lp->addColToRow(row, col, 1);
+    for (auto edg : cmbEdgs) {
+      int col = getEdgUseVar(*vars, edgPair.first.first, edg);
+      if (col > -1) buf->addColToRow(row, col, 1);
 
-        col = lp->getVarByName(getEdgUseVar(edgPair.first.second, edg));
-        if (col > -1) lp->addColToRow(row, col, 1);
+      col = getEdgUseVar(*vars, edgPair.first.second, edg);
+      if (col > -1) buf->addColToRow(row, col, 1);
 
-        col = lp->getVarByName(getEdgUseVar(edgPair.second.first, edg));
-        if (col > -1) lp->addColToRow(row, col, 1);
+      col = getEdgUseVar(*vars, edgPair.second.first, edg);
+      if (col > -1) buf->addColToRow(row, col, 1);
 
-        col = lp->getVarByName(getEdgUseVar(edgPair.second.second, edg));
-        if (col > -1) lp->addColToRow(row, col, 1);
-      }
+      col = getEdgUseVar(*vars, edgPair.second.second, edg);
+      if (col > -1) buf->addColToRow(row, col, 1);
     }
-  }
-
-  lp->update();
+  });
 
   // for each input node N, define a var x_dirNE which tells the direction of
   // E at N
   for (auto nd : cg.getNds()) {
     if (nd->getDeg() < 2) continue;  // we don't need this for deg 1 nodes
     for (auto edg : nd->getAdjList()) {
-      std::stringstream dirName;
-      dirName << "d(" << nd << "," << edg << ")";
-      int col =
-          lp->addCol(dirName.str(), shared::optim::INT, 0, 0, gg->maxDeg() - 1);
+      int col = lp->addCol(shared::optim::INT, 0, 0, gg->maxDeg() - 1);
+      vars->dir[{nd, edg}] = col;
 
-      std::stringstream constName;
-      constName << "dc(" << nd << "," << edg << ")";
+      int row = lp->addRow(0, shared::optim::FIX);
+
+      if (lp->isNamed()) {
+        std::stringstream dirName;
+        dirName << "d(" << nd << "," << edg << ")";
+        lp->setColName(col, dirName.str());
 
-      int row = lp->addRow(constName.str(), 0, shared::optim::FIX);
+        std::stringstream constName;
+        constName << "dc(" << nd << "," << edg << ")";
+        lp->setRowName(row, constName.str());
+      }
 
       lp->addColToRow(row, col, -1);
 
@@ -431,7 +521,7 @@ ILPSolver* ILPGridOptimizer::createProblem(BaseGraph* gg, const CombGraph& cg,
 
         // check if this grid node is used as a candidate for comb node
         // if not, we don't have to add the constraints
-        int ndColFrom = lp->getVarByName(getStatPosVar(n, nd));
+        int ndColFrom = getStatPosVar(*vars, n, nd);
         if (ndColFrom == -1) continue;
 
         if (edg->getFrom() == nd) {
@@ -440,7 +530,7 @@ ILPSolver* ILPGridOptimizer::createProblem(BaseGraph* gg, const CombGraph& cg,
             auto portNd = n->pl().getPort(i);
             if (!portNd) continue;
             auto e = gg->getEdg(n, portNd);
-            int col = lp->getVarByName(getEdgUseVar(e, edg));
+            int col = getEdgUseVar(*vars, e, edg);
             if (col > -1) lp->addColToRow(row, col, i);
           }
         } else {
@@ -449,7 +539,7 @@ ILPSolver* ILPGridOptimizer::createProblem(BaseGraph* gg, const CombGraph& cg,
             auto portNd = n->pl().getPort(i);
             if (!portNd) continue;
             auto e = gg->getEdg(portNd, n);
-            int col = lp->getVarByName(getEdgUseVar(e, edg));
+            int col = getEdgUseVar(*vars, e, edg);
             if (col > -1) lp->addColToRow(row, col, i);
           }
         }
@@ -457,8 +547,6 @@ ILPSolver* ILPGridOptimizer::createProblem(BaseGraph* gg, const CombGraph& cg,
     }
   }
 
-  lp->update();
-
   // for each input node N, make sure that the circular ordering of the final
   // drawing matches the input ordering
   int M = gg->maxDeg();
@@ -466,22 +554,31 @@ ILPSolver* ILPGridOptimizer::createProblem(BaseGraph* gg, const CombGraph& cg,
     // for degree < 3, the circular ordering cannot be violated
     if (nd->getDeg() < 3) continue;
 
-    std::stringstream vulnConstName;
-    vulnConstName << "vc(" << nd << ")";
     // an upper bound would also work here, at most one
     // of the vuln vars may be 1
+    int vulnRow = lp->addRow(1, shared::optim::FIX);
+
+    if (lp->isNamed()) {
+      std::stringstream vulnConstName;
+      vulnConstName << "vc(" << nd << ")";
+      lp->setRowName(vulnRow, vulnConstName.str());
+    }
 
-    int vulnRow = lp->addRow(vulnConstName.str(), 1, shared::optim::FIX);
+    std::vector<int> vulnCols;
 
     for (size_t i = 0; i < nd->getDeg(); i++) {
-      std::stringstream n;
-      n << "vuln(" << nd << "," << i << ")";
-      int col = lp->addCol(n.str(), shared::optim::BIN, 0);
+      int col = lp->addCol(shared::optim::BIN, 0);
+      vulnCols.push_back(col);
+
+      if (lp->isNamed()) {
+        std::stringstream n;
+        n << "vuln(" << nd << "," << i << ")";
+        lp->setColName(col, n.str());
+      }
+
       lp->addColToRow(vulnRow, col, 1);
     }
 
-    lp->update();
-
     auto order = nd->pl().getEdgeOrdering().getOrderedSet();
     assert(order.size() > 2);
     for (size_t i = 0; i < order.size(); i++) {
@@ -495,24 +592,18 @@ ILPSolver* ILPGridOptimizer::createProblem(BaseGraph* gg, const CombGraph& cg,
 
       assert(edgA != edgB);
 
-      std::stringstream colNameA;
-      colNameA << "d(" << nd << "," << edgA << ")";
-      int colA = lp->getVarByName(colNameA.str());
-      assert(colA > -1);
+      int colA = vars->dir[{nd, edgA}];
+      int colB = vars->dir[{nd, edgB}];
 
-      std::stringstream colNameB;
-      colNameB << "d(" << nd << "," << edgB << ")";
-      int colB = lp->getVarByName(colNameB.str());
-      assert(colB > -1);
+      int row = lp->addRow(1, shared::optim::LO);
 
-      std::stringstream constName;
-      constName << "oc(" << nd << "," << i << ")";
-      int row = lp->addRow(constName.str(), 1, shared::optim::LO);
+      if (lp->isNamed()) {
+        std::stringstream constName;
+        constName << "oc(" << nd << "," << i << ")";
+        lp->setRowName(row, constName.str());
+      }
 
-      std::stringstream vulnColName;
-      vulnColName << "vuln(" << nd << "," << i << ")";
-      int vulnCol = lp->getVarByName(vulnColName.str());
-      assert(vulnCol > -1);
+      int vulnCol = vulnCols[i];
 
       lp->addColToRow(row, colB, 1);
       lp->addColToRow(row, colA, -1);
@@ -520,8 +611,6 @@ ILPSolver* ILPGridOptimizer::createProblem(BaseGraph* gg, const CombGraph& cg,
     }
   }
 
-  lp->update();
-
   std::vector<double> pens = gg->getCosts();
 
   // for each adjacent edge pair, add variables telling the accuteness of the
@@ -547,65 +636,68 @@ ILPSolver* ILPGridOptimizer::createProblem(BaseGraph* gg, const CombGraph& cg,
 
         if (!sharedLines) continue;
 
-        std::stringstream negVar;
-        negVar << "negdist(" << edgA << "," << edgB << ")";
-
-        int colNeg = lp->addCol(negVar.str(), shared::optim::BIN, 0);
+        int colNeg = lp->addCol(shared::optim::BIN, 0);
 
-        std::stringstream constName;
-        constName << "nc(" << edgA << "," << edgB << ")";
+        int row1 = lp->addRow(0, shared::optim::LO);
+        int row2 = lp->addRow(gg->maxDeg() - 1, shared::optim::UP);
 
-        int row1 = lp->addRow(constName.str() + "lo", 0, shared::optim::LO);
-        int row2 = lp->addRow(constName.str() + "up", gg->maxDeg() - 1,
-                              shared::optim::UP);
+        if (lp->isNamed()) {
+          std::stringstream negVar;
+          negVar << "negdist(" << edgA << "," << edgB << ")";
+          lp->setColName(colNeg, negVar.str());
 
-        std::stringstream dirNameA;
-        dirNameA << "d(" << nd << "," << edgA << ")";
-        std::stringstream dirNameB;
-        dirNameB << "d(" << nd << "," << edgB << ")";
+          std::stringstream constName;
+          constName << "nc(" << edgA << "," << edgB << ")";
+          lp->setRowName(row1, constName.str() + "lo");
+          lp->setRowName(row2, constName.str() + "up");
+        }
 
-        int colA = lp->getVarByName(dirNameA.str());
-        assert(colA > -1);
+        int colA = vars->dir[{nd, edgA}];
         lp->addColToRow(row1, colA, 1);
         lp->addColToRow(row2, colA, 1);
 
-        int colB = lp->getVarByName(dirNameB.str());
-        assert(colB > -1);
+        int colB = vars->dir[{nd, edgB}];
         lp->addColToRow(row1, colB, -1);
         lp->addColToRow(row2, colB, -1);
 
         lp->addColToRow(row1, colNeg, gg->maxDeg());
         lp->addColToRow(row2, colNeg, gg->maxDeg());
 
-        std::stringstream angConst;
-        angConst << "ac(" << edgA << "," << edgB << ")";
-        int rowAng = lp->addRow(angConst.str(), 0, shared::optim::FIX);
+        int rowAng = lp->addRow(0, shared::optim::FIX);
 
         lp->addColToRow(rowAng, colA, 1);
         lp->addColToRow(rowAng, colB, -1);
         lp->addColToRow(rowAng, colNeg, gg->maxDeg());
 
-        std::stringstream sumConst;
-        sumConst << "asc(" << edgA << "," << edgB << ")";
+        int rowSum = lp->addRow(1, shared::optim::UP);
 
-        int rowSum = lp->addRow(sumConst.str(), 1, shared::optim::UP);
+        if (lp->isNamed()) {
+          std::stringstream angConst;
+          angConst << "ac(" << edgA << "," << edgB << ")";
+          lp->setRowName(rowAng, angConst.str());
+
+          std::stringstream sumConst;
+          sumConst << "asc(" << edgA << "," << edgB << ")";
+          lp->setRowName(rowSum, sumConst.str());
+        }
 
         int N = gg->maxDeg() - 1;
         int M = pens.size();
 
         for (int k = 0; k < N; k++) {
-          std::stringstream var;
           size_t pp = pens.size() - 1 - k;
-          if (k >= M) {
-            pp = k + 1 - pens.size();
-            var << "d" << pp << "'(" << edgA << "," << edgB << ")";
-          } else {
-            var << "d" << pp << "(" << edgA << "," << edgB << ")";
-          }
+          if (k >= M) pp = k + 1 - pens.size();
 
           // TODO: maybe multiply per shared lines - but this actually
           // makes the drawings look worse.
-          int col = lp->addCol(var.str(), shared::optim::BIN, pens[pp]);
+          int col = lp->addCol(shared::optim::BIN, pens[pp]);
+
+          if (lp->isNamed()) {
+            std::stringstream var;
+            var << "d" << pp << (k >= M ? "'(" : "(") << edgA << "," << edgB
+                << ")";
+            lp->setColName(col, var.str());
+          }
 
           lp->addColToRow(rowAng, col, -(k + 1));
           lp->addColToRow(rowSum, col, 1);
@@ -614,14 +706,12 @@ ILPSolver* ILPGridOptimizer::createProblem(BaseGraph* gg, const CombGraph& cg,
     }
   }
 
-  lp->update();
-
   return lp;
 }
 
 // _____________________________________________________________________________
-std::string ILPGridOptimizer::getEdgUseVar(const GridEdge* e,
-                                           const CombEdge* cg) const {
+std::string ILPGridOptimizer::getEdgUseVarName(const GridEdge* e,
+                                               const CombEdge* cg) const {
   std::stringstream varName;
   varName << "edg(" << e->getFrom()->pl().getId() << ","
           << e->getTo()->pl().getId() << "," << cg << ")";
@@ -630,8 +720,8 @@ std::string ILPGridOptimizer::getEdgUseVar(const GridEdge* e,
 }
 
 // _____________________________________________________________________________
-std::string ILPGridOptimizer::getStatPosVar(const GridNode* n,
-                                            const CombNode* nd) const {
+std::string ILPGridOptimizer::getStatPosVarName(const GridNode* n,
+                                                const CombNode* nd) const {
   std::stringstream varName;
   varName << "sp(" << n->pl().getId() << "," << nd << ")";
 
@@ -639,8 +729,28 @@ std::string ILPGridOptimizer::getStatPosVar(const GridNode* n,
 }
 
 // _____________________________________________________________________________
-void ILPGridOptimizer::extractSolution(ILPSolver* lp, BaseGraph* gg,
-                                       const CombGraph& cg,
+int ILPGridOptimizer::getEdgUseVar(const ILPGridVars& vars, const GridEdge* e,
+                                   const CombEdge* cg) const {
+  auto i = vars.edgUse.find(cg);
+  if (i == vars.edgUse.end()) return -1;
+  auto j = i->second.find(e);
+  if (j == i->second.end()) return -1;
+  return j->second;
+}
+
+// _____________________________________________________________________________
+int ILPGridOptimizer::getStatPosVar(const ILPGridVars& vars, const GridNode* n,
+                                    const CombNode* nd) const {
+  auto i = vars.statPos.find(nd);
+  if (i == vars.statPos.end()) return -1;
+  auto j = i->second.find(n);
+  if (j == i->second.end()) return -1;
+  return j->second;
+}
+
+// _____________________________________________________________________________
+void ILPGridOptimizer::extractSolution(ILPSolver* lp, const ILPGridVars& vars,
+                                       BaseGraph* gg, const CombGraph& cg,
                                        combgraph::Drawing* d) const {
   std::map<const CombNode*, const GridNode*> gridNds;
   std::map<const CombEdge*, std::set<const GridEdge*>> gridEdgs;
@@ -653,9 +763,7 @@ void ILPGridOptimizer::extractSolution(ILPSolver* lp, BaseGraph* gg,
       for (auto nd : cg.getNds()) {
         for (auto edg : nd->getAdjList()) {
           if (edg->getFrom() != nd) continue;
-          auto varName = getEdgUseVar(e, edg);
-
-          int i = lp->getVarByName(varName);
+          int i = getEdgUseVar(vars, e, edg);
           if (i > -1) {
             double val = lp->getVarVal(i);
             if (val > 0.5) {
@@ -671,9 +779,7 @@ void ILPGridOptimizer::extractSolution(ILPSolver* lp, BaseGraph* gg,
   for (GridNode* n : gg->getNds()) {
     if (!n->pl().isSink()) continue;
     for (auto nd : cg.getNds()) {
-      auto varName = getStatPosVar(n, nd);
-
-      int i = lp->getVarByName(varName);
+      int i = getStatPosVar(vars, n, nd);
       if (i > -1) {
         double val = lp->getVarVal(i);
         if (val > 0.5) {
@@ -698,7 +804,6 @@ void ILPGridOptimizer::extractSolution(ILPSolver* lp, BaseGraph* gg,
       auto grStart = gridNds[edg->getFrom()];
       auto grEnd = gridNds[edg->getTo()];
 
-
       assert(grStart);
       assert(grEnd);
 
@@ -735,20 +840,21 @@ void ILPGridOptimizer::extractSolution(ILPSolver* lp, BaseGraph* gg,
 }
 
 // _____________________________________________________________________________
-size_t ILPGridOptimizer::nonInfDeg(const GridNode* g) const {
+size_t ILPGridOptimizer::nonInfDeg(const BaseGraph* gg,
+                                   const GridNode* g) const {
   size_t ret = 0;
   for (auto e : g->getAdjList()) {
-    if (e->pl().cost() < basegraph::SOFT_INF) ret++;
+    if (gg->getFlat().cost(e) < basegraph::SOFT_INF) ret++;
   }
 
   return ret;
 }
 
 // _____________________________________________________________________________
-StarterSol ILPGridOptimizer::extractFeasibleSol(Drawing* d, BaseGraph* gg,
+ILPGridSol ILPGridOptimizer::extractFeasibleSol(Drawing* d, BaseGraph* gg,
                                                 const CombGraph& cg,
                                                 double maxGrDist) const {
-  StarterSol sol;
+  ILPGridSol sol;
 
   for (auto nd : cg.getNds()) {
     if (nd->getDeg() == 0) continue;
@@ -762,9 +868,8 @@ StarterSol ILPGridOptimizer::extractFeasibleSol(Drawing* d, BaseGraph* gg,
       double maxDis = gg->getCellSize() * maxGrDist;
       if (gridD >= maxDis) continue;
 
-      auto varName = getStatPosVar(gnd, nd);
       if (gnd == settled) {
-        sol[varName] = 1;
+        sol.statPos[{gnd, nd}] = 1;
 
         // if settled, all bend edges are unused
         for (size_t p = 0; p < gg->maxDeg(); p++) {
@@ -774,13 +879,12 @@ StarterSol ILPGridOptimizer::extractFeasibleSol(Drawing* d, BaseGraph* gg,
             if (!bendEdg->pl().isSecondary()) continue;
             for (auto cEdg : nd->getAdjList()) {
               if (cEdg->getFrom() != nd) continue;
-              auto varName = getEdgUseVar(bendEdg, cEdg);
-              sol[varName] = 0;
+              sol.edgUse[{bendEdg, cEdg}] = 0;
             }
           }
         }
       } else {
-        sol[varName] = 0;
+        sol.statPos[{gnd, nd}] = 0;
 
         // if not settled, all sink edges are unused
         // for all input edges
@@ -788,8 +892,7 @@ StarterSol ILPGridOptimizer::extractFeasibleSol(Drawing* d, BaseGraph* gg,
           assert(sinkEdg->pl().isSecondary());
           for (auto cEdg : nd->getAdjList()) {
             if (cEdg->getFrom() != nd) continue;
-            auto varName = getEdgUseVar(sinkEdg, cEdg);
-            sol[varName] = 0;
+            sol.edgUse[{sinkEdg, cEdg}] = 0;
           }
         }
       }
@@ -804,8 +907,7 @@ StarterSol ILPGridOptimizer::extractFeasibleSol(Drawing* d, BaseGraph* gg,
       for (auto cNd : cg.getNds()) {
         for (auto cEdg : cNd->getAdjList()) {
           if (cEdg->getFrom() != cNd) continue;
-          auto varName = getEdgUseVar(grEdg, cEdg);
-          sol[varName] = 0;
+          sol.edgUse[{grEdg, cEdg}] = 0;
         }
       }
     }
@@ -817,8 +919,7 @@ StarterSol ILPGridOptimizer::extractFeasibleSol(Drawing* d, BaseGraph* gg,
     const auto& grEdgList = a.second;
     for (auto xy : grEdgList) {
       auto grEdg = gg->getGrEdgById(xy);
-      auto varName = getEdgUseVar(grEdg, cEdg);
-      sol[varName] = 1;
+      sol.edgUse[{grEdg, cEdg}] = 1;
     }
   }
 
@@ -826,3 +927,22 @@ StarterSol ILPGridOptimizer::extractFeasibleSol(Drawing* d, BaseGraph* gg,
   // typically be filled by the solver using the information given above
   return sol;
 }
+
+// _____________________________________________________________________________
+StarterSol ILPGridOptimizer::getStarter(const ILPGridSol& sol,
+                                        const ILPGridVars& vars) const {
+  StarterSol ret;
+
+  // variables which are not part of the problem are skipped
+  for (const auto& v : sol.edgUse) {
+    int col = getEdgUseVar(vars, v.first.first, v.first.second);
+    if (col > -1) ret[col] = v.second;
+  }
+
+  for (const auto& v : sol.statPos) {
+    int col = getStatPosVar(vars, v.first.first, v.first.second);
+    if (col > -1) ret[col] = v.second;
+  }
+
+  return ret;
+}
@@ -5,6 +5,10 @@
 #ifndef OCTI_ILP_ILPGRIDOPTIMIZER_H_
 #define OCTI_ILP_ILPGRIDOPTIMIZER_H_
 
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 #include "octi/basegraph/BaseGraph.h"
 #include "octi/combgraph/CombGraph.h"
@@ -22,6 +26,26 @@ using octi::combgraph::CombNode;
 namespace octi {
 namespace ilp {
 
+// column handles of the ILP variables
+struct ILPGridVars {
+  // edg(e,cg): grid edge e is used by comb edge cg
+  std::unordered_map<const CombEdge*, std::unordered_map<const GridEdge*, int>>
+      edgUse;
+
+  // sp(n,nd): grid node n is the position of comb node nd
+  std::unordered_map<const CombNode*, std::unordered_map<const GridNode*, int>>
+      statPos;
+
+  // d(nd,edg): direction of comb edge edg at comb node nd
+  std::map<std::pair<const CombNode*, const CombEdge*>, int> dir;
+};
+
+// a feasible solution, given by the values of the edg and sp variables
+struct ILPGridSol {
+  std::map<std::pair<const GridEdge*, const CombEdge*>, int> edgUse;
+  std::map<std::pair<const GridNode*, const CombNode*>, int> statPos;
+};
+
 struct ILPStats {
   double score;
   double time;
@@ -42,23 +66,35 @@ class ILPGridOptimizer {
                     const std::string& path) const;
 
  protected:
+  // the grid constraints are generated on numThreads threads, 0 means the
+  // number of available processors
   shared::optim::ILPSolver* createProblem(
       BaseGraph* gg, const CombGraph& cg,
       const basegraph::GeoPensMap* geoPensMap, double maxGrDist,
-      const std::string& solverStr) const;
+      const std::string& solverStr, bool named, int numThreads,
+      ILPGridVars* vars) const;
+
+  std::string getEdgUseVarName(const GridEdge* e, const CombEdge* cg) const;
+  std::string getStatPosVarName(const GridNode* e, const CombNode* cg) const;
+
+  // column handles of the edg and sp variables, -1 if the variable does
+  // not exist
+  int getEdgUseVar(const ILPGridVars& vars, const GridEdge* e,
+                   const CombEdge* cg) const;
+  int getStatPosVar(const ILPGridVars& vars, const GridNode* n,
+                    const CombNode* nd) const;
 
-  std::string getEdgUseVar(const GridEdge* e, const CombEdge* cg) const;
-  std::string getStatPosVar(const GridNode* e, const CombNode* cg) const;
+  void extractSolution(shared::optim::ILPSolver* lp, const ILPGridVars& vars,
+                       BaseGraph* gg, const CombGraph& cg,
+                       combgraph::Drawing* d) const;
 
-  void extractSolution(shared::optim::ILPSolver* lp, BaseGraph* gg,
-                       const CombGraph& cg, combgraph::Drawing* d) const;
+  ILPGridSol extractFeasibleSol(combgraph::Drawing* d, BaseGraph* gg,
+                                const CombGraph& cg, double maxGrDist) const;
 
-  shared::optim::StarterSol extractFeasibleSol(combgraph::Drawing* d,
-                                               BaseGraph* gg,
-                                               const CombGraph& cg,
-                                               double maxGrDist) const;
+  shared::optim::StarterSol getStarter(const ILPGridSol& sol,
+                                       const ILPGridVars& vars) const;
 
-  size_t nonInfDeg(const GridNode* g) const;
+  size_t nonInfDeg(const BaseGraph* gg, const GridNode* g) const;
 };
 }  // namespace ilp
 }  // namespace octi
@@ -0,0 +1,290 @@
+// Copyright 2017, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+// Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "shared/linegraph/BinGraph.h"
+
+using shared::linegraph::BinGraphReader;
+using shared::linegraph::BinGraphWriter;
+using shared::linegraph::Line;
+using shared::linegraph::LineEdge;
+using shared::linegraph::LineGraph;
+using shared::linegraph::LineNode;
+
+namespace {
+// _____________________________________________________________________________
+void putU8(std::string* buf, uint8_t v) { buf->push_back(v); }
+
+// _____________________________________________________________________________
+void putU32(std::string* buf, uint32_t v) {
+  for (size_t i = 0; i < 4; i++) buf->push_back((v >> (8 * i)) & 0xFF);
+}
+
+// _____________________________________________________________________________
+void putU64(std::string* buf, uint64_t v) {
+  for (size_t i = 0; i < 8; i++) buf->push_back((v >> (8 * i)) & 0xFF);
+}
+
+// _____________________________________________________________________________
+void putF64(std::string* buf, double v) {
+  uint64_t bits;
+  memcpy(&bits, &v, sizeof(bits));
+  putU64(buf, bits);
+}
+
+// _____________________________________________________________________________
+void putSection(std::ostream& str, uint32_t tag, const std::string& body) {
+  std::string head;
+  putU32(&head, tag);
+  putU64(&head, body.size());
+  str.write(head.data(), head.size());
+  str.write(body.data(), body.size());
+}
+
+// string table which stores each distinct string once
+class StrTable {
+ public:
+  uint32_t get(const std::string& s) {
+    auto i = _idx.find(s);
+    if (i != _idx.end()) return i->second;
+    uint32_t id = _strs.size();
+    _idx[s] = id;
+    _strs.push_back(&_idx.find(s)->first);
+    return id;
+  }
+
+  std::string serialize() const {
+    std::string ret;
+    putU32(&ret, _strs.size());
+    for (auto s : _strs) {
+      putU32(&ret, s->size());
+      ret += *s;
+    }
+    return ret;
+  }
+
+ private:
+  std::unordered_map<std::string, uint32_t> _idx;
+  std::vector<const std::string*> _strs;
+};
+}  // namespace
+
+// _____________________________________________________________________________
+void BinGraphWriter::print(const LineGraph& g, std::ostream& str) const {
+  StrTable strs;
+
+  std::unordered_map<const LineNode*, uint32_t> ndIdx;
+  std::unordered_map<const LineEdge*, uint32_t> edgIdx;
+  std::unordered_map<const Line*, uint32_t> lineIdx;
+
+  std::string lines, nds, edgs, nsrv, cexc;
+  uint32_t numLines = 0, numEdgs = 0, numNsrv = 0, numCexc = 0;
+
+  auto line = [&](const Line* l) {
+    auto i = lineIdx.find(l);
+    if (i != lineIdx.end()) return i->second;
+    putU32(&lines, strs.get(l->id()));
+    putU32(&lines, strs.get(l->label()));
+    putU32(&lines, strs.get(l->color()));
+    putU32(&lines, strs.get(l->mylabel()));
+    putU32(&lines, strs.get(l->backLabel()));
+    putU32(&lines, strs.get(l->from()));
+    putU32(&lines, strs.get(l->to()));
+    lineIdx[l] = numLines;
+    return numLines++;
+  };
+
+  putU32(&nds, g.getNds().size());
+  for (auto n : g.getNds()) {
+    uint32_t id = ndIdx.size();
+    ndIdx[n] = id;
+    putF64(&nds, n->pl().getGeom()->getX());
+    putF64(&nds, n->pl().getGeom()->getY());
+    putU32(&nds, n->pl().stops().size());
+    for (const auto& s : n->pl().stops()) {
+      putU32(&nds, strs.get(s.id));
+      putU32(&nds, strs.get(s.name));
+      putF64(&nds, s.pos.getX());
+      putF64(&nds, s.pos.getY());
+    }
+  }
+
+  for (auto n : g.getNds()) {
+    for (auto e : n->getAdjList()) {
+      if (e->getFrom() != n) continue;
+      edgIdx[e] = numEdgs++;
+
+      putU32(&edgs, ndIdx[e->getFrom()]);
+      putU32(&edgs, ndIdx[e->getTo()]);
+      putU8(&edgs, e->pl().dontContract() ? BIN_EDGE_DONT_CONTRACT : 0);
+
+      const auto& pts = e->pl().getPolyline().getLine();
+      putU32(&edgs, pts.size());
+      for (const auto& p : pts) {
+        putF64(&edgs, p.getX());
+        putF64(&edgs, p.getY());
+      }
+
+      putU32(&edgs, e->pl().getLines().size());
+      for (const auto& lo : e->pl().getLines()) {
+        putU32(&edgs, line(lo.line));
+        putU32(&edgs, lo.direction ? ndIdx[lo.direction] : BIN_GRAPH_NONE);
+        if (lo.style.isNull()) {
+          putU32(&edgs, BIN_GRAPH_NONE);
+          putU32(&edgs, BIN_GRAPH_NONE);
+        } else {
+          putU32(&edgs, strs.get(lo.style.get().getCss()));
+          putU32(&edgs, strs.get(lo.style.get().getOutlineCss()));
+        }
+      }
+    }
+  }
+
+  for (auto n : g.getNds()) {
+    for (auto l : n->pl().getNotServed()) {
+      putU32(&nsrv, ndIdx[n]);
+      putU32(&nsrv, line(l));
+      numNsrv++;
+    }
+
+    for (const auto& ro : n->pl().getConnExc()) {
+      for (const auto& exFr : ro.second) {
+        auto a = edgIdx.find(exFr.first);
+        if (a == edgIdx.end()) continue;
+        for (auto exTo : exFr.second) {
+          auto b = edgIdx.find(exTo);
+          // exceptions are stored in both directions
+          if (b == edgIdx.end() || a->second > b->second) continue;
+          putU32(&cexc, ndIdx[n]);
+          putU32(&cexc, line(ro.first));
+          putU32(&cexc, a->second);
+          putU32(&cexc, b->second);
+          numCexc++;
+        }
+      }
+    }
+  }
+
+  std::string head(BIN_GRAPH_MAGIC, sizeof(BIN_GRAPH_MAGIC));
+  putU32(&head, BIN_GRAPH_VERSION);
+  str.write(head.data(), head.size());
+
+  std::string cnt;
+
+  putSection(str, BIN_STRS, strs.serialize());
+
+  putU32(&cnt, numLines);
+  putSection(str, BIN_LINE, cnt + lines);
+
+  putSection(str, BIN_NODE, nds);
+
+  cnt.clear();
+  putU32(&cnt, numEdgs);
+  putSection(str, BIN_EDGE, cnt + edgs);
+
+  cnt.clear();
+  putU32(&cnt, numNsrv);
+  putSection(str, BIN_NSRV, cnt + nsrv);
+
+  cnt.clear();
+  putU32(&cnt, numCexc);
+  putSection(str, BIN_CEXC, cnt + cexc);
+
+  str.flush();
+}
+
+// _____________________________________________________________________________
+BinGraphReader::BinGraphReader(const char* data, size_t size)
+    : _data(data), _size(size), _pos(0), _secEnd(0) {
+  if (size < sizeof(BIN_GRAPH_MAGIC) + 4 ||
+      memcmp(data, BIN_GRAPH_MAGIC, sizeof(BIN_GRAPH_MAGIC)) != 0) {
+    throw std::runtime_error("Not a binary line graph.");
+  }
+
+  _pos = sizeof(BIN_GRAPH_MAGIC);
+  _secEnd = _pos + 4;
+
+  uint32_t version = u32();
+  if (version != BIN_GRAPH_VERSION) {
+    throw std::runtime_error("Unsupported binary line graph version " +
+                             std::to_string(version) + ".");
+  }
+}
+
+// _____________________________________________________________________________
+bool BinGraphReader::nextSection(uint32_t* tag, size_t* size) {
+  _pos = _secEnd;
+  if (_pos == _size) return false;
+
+  _secEnd = _pos + 12;
+  *tag = u32();
+  uint64_t len = u32();
+  len |= static_cast<uint64_t>(u32()) << 32;
+
+  if (len > _size - _pos) {
+    throw std::runtime_error("Truncated binary line graph.");
+  }
+
+  *size = len;
+  _secEnd = _pos + len;
+  return true;
+}
+
+// _____________________________________________________________________________
+void BinGraphReader::skipSection() { _pos = _secEnd; }
+
+// _____________________________________________________________________________
+void BinGraphReader::need(size_t n) const {
+  if (n > _secEnd - _pos) {
+    throw std::runtime_error("Truncated binary line graph.");
+  }
+}
+
+// _____________________________________________________________________________
+uint8_t BinGraphReader::u8() {
+  need(1);
+  return static_cast<uint8_t>(_data[_pos++]);
+}
+
+// _____________________________________________________________________________
+uint32_t BinGraphReader::u32() {
+  need(4);
+  const unsigned char* d =
+      reinterpret_cast<const unsigned char*>(_data + _pos);
+  _pos += 4;
+  return static_cast<uint32_t>(d[0]) | (static_cast<uint32_t>(d[1]) << 8) |
+         (static_cast<uint32_t>(d[2]) << 16) |
+         (static_cast<uint32_t>(d[3]) << 24);
+}
+
+// _____________________________________________________________________________
+double BinGraphReader::f64() {
+  uint64_t bits = u32();
+  bits |= static_cast<uint64_t>(u32()) << 32;
+  double ret;
+  memcpy(&ret, &bits, sizeof(ret));
+  return ret;
+}
+
+// _____________________________________________________________________________
+uint32_t BinGraphReader::ref(size_t tableSize, bool allowNone) {
+  uint32_t ret = u32();
+  if (ret == BIN_GRAPH_NONE && allowNone) return ret;
+  if (ret >= tableSize) {
+    throw std::runtime_error("Invalid reference in binary line graph.");
+  }
+  return ret;
+}
+
+// _____________________________________________________________________________
+std::string BinGraphReader::str(size_t len) {
+  need(len);
+  std::string ret(_data + _pos, len);
+  _pos += len;
+  return ret;
+}
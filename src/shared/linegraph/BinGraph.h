@@ -0,0 +1,96 @@
+// Copyright 2017, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+// Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
+
+#ifndef SHARED_LINEGRAPH_BINGRAPH_H_
+#define SHARED_LINEGRAPH_BINGRAPH_H_
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include "shared/linegraph/LineGraph.h"
+
+namespace shared {
+namespace linegraph {
+
+// Compact binary line graph format, used between the pipeline stages
+// instead of GeoJSON.
+//
+// All numbers are little endian, doubles are IEEE 754. A file starts with
+// the 8 byte magic "LOOMLGB\0" and the uint32 format version, followed by
+// sections. Each section starts with a uint32 tag and the uint64 byte length
+// of its body, readers skip sections with unknown tags.
+//
+//  STRS  uint32 n, n x (uint32 len, len bytes)
+//  LINE  uint32 n, n x 7 strings (id, label, color, start label, back label,
+//        from, to)
+//  NODE  uint32 n, n x (double x, double y, uint32 k,
+//        k x (string id, string name, double x, double y))
+//  EDGE  uint32 n, n x (node from, node to, uint8 flags, uint32 k,
+//        k x (double x, double y), uint32 m,
+//        m x (line, node direction, string css, string outline css))
+//  NSRV  uint32 n, n x (node, line)
+//  CEXC  uint32 n, n x (node, line, edge, edge)
+//
+// Strings, lines, nodes and edges are referenced by their uint32 index in
+// their section, NONE marks a missing reference. The lines of an edge are
+// stored in their current order.
+//
+// Since no pointers or offsets have to be fixed up, a graph can be read
+// directly from a memory-mapped file.
+const char BIN_GRAPH_MAGIC[8] = {'L', 'O', 'O', 'M', 'L', 'G', 'B', 0};
+const uint32_t BIN_GRAPH_VERSION = 1;
+
+const uint32_t BIN_GRAPH_NONE = 0xFFFFFFFF;
+
+enum BinGraphSection : uint32_t {
+  BIN_STRS = 0x53525453,
+  BIN_LINE = 0x454E494C,
+  BIN_NODE = 0x45444F4E,
+  BIN_EDGE = 0x45474445,
+  BIN_NSRV = 0x5652534E,
+  BIN_CEXC = 0x43584543
+};
+
+// edge flags
+const uint8_t BIN_EDGE_DONT_CONTRACT = 1;
+
+class BinGraphWriter {
+ public:
+  void print(const LineGraph& g, std::ostream& str) const;
+};
+
+// Bounds-checked cursor over a binary graph in memory, throws a
+// std::runtime_error on malformed input.
+class BinGraphReader {
+ public:
+  BinGraphReader(const char* data, size_t size);
+
+  // read the next section header, false at the end of the data
+  bool nextSection(uint32_t* tag, size_t* size);
+
+  // skip the rest of the current section
+  void skipSection();
+
+  uint8_t u8();
+  uint32_t u32();
+  double f64();
+
+  // an index into a table of the given size, or NONE if allowed
+  uint32_t ref(size_t tableSize, bool allowNone);
+
+  std::string str(size_t len);
+
+ private:
+  const char* _data;
+  size_t _size;
+  size_t _pos;
+  size_t _secEnd;
+
+  void need(size_t n) const;
+};
+
+}  // namespace linegraph
+}  // namespace shared
+
+#endif  // SHARED_LINEGRAPH_BINGRAPH_H_
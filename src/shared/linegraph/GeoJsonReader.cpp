@@ -0,0 +1,227 @@
+// Copyright 2017, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+// Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
+
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include "shared/linegraph/GeoJsonReader.h"
+#include "util/Misc.h"
+
+using shared::linegraph::GeoJsonReader;
+
+// _____________________________________________________________________________
+std::string GeoJsonReader::read(std::istream* s) {
+  _ctx.clear();
+  _props.clear();
+  _type.clear();
+
+  // like operator>>, stop after the first value and leave the rest of s
+  nlohmann::json::sax_parse(*s, this, nlohmann::json::input_format_t::json,
+                            false);
+
+  return _type;
+}
+
+// _____________________________________________________________________________
+bool GeoJsonReader::null() {
+  value(nullptr);
+  return true;
+}
+
+// _____________________________________________________________________________
+bool GeoJsonReader::boolean(bool val) {
+  value(val);
+  return true;
+}
+
+// _____________________________________________________________________________
+bool GeoJsonReader::number_integer(number_integer_t val) {
+  if (!_ctx.empty() && _ctx.back() == COORDS) {
+    coord(val);
+  } else {
+    value(val);
+  }
+  return true;
+}
+
+// _____________________________________________________________________________
+bool GeoJsonReader::number_unsigned(number_unsigned_t val) {
+  if (!_ctx.empty() && _ctx.back() == COORDS) {
+    coord(val);
+  } else {
+    value(val);
+  }
+  return true;
+}
+
+// _____________________________________________________________________________
+bool GeoJsonReader::number_float(number_float_t val, const string_t& s) {
+  UNUSED(s);
+  if (!_ctx.empty() && _ctx.back() == COORDS) {
+    coord(val);
+  } else {
+    value(val);
+  }
+  return true;
+}
+
+// _____________________________________________________________________________
+bool GeoJsonReader::string(string_t& val) {
+  value(std::move(val));
+  return true;
+}
+
+// _____________________________________________________________________________
+bool GeoJsonReader::binary(binary_t& val) {
+  UNUSED(val);
+  value(nullptr);
+  return true;
+}
+
+// _____________________________________________________________________________
+bool GeoJsonReader::start_object(std::size_t elements) {
+  UNUSED(elements);
+  open(true, nlohmann::json::object());
+  return true;
+}
+
+// _____________________________________________________________________________
+bool GeoJsonReader::key(string_t& val) {
+  _key = std::move(val);
+  return true;
+}
+
+// _____________________________________________________________________________
+bool GeoJsonReader::end_object() {
+  close();
+  return true;
+}
+
+// _____________________________________________________________________________
+bool GeoJsonReader::start_array(std::size_t elements) {
+  UNUSED(elements);
+  open(false, nlohmann::json::array());
+  return true;
+}
+
+// _____________________________________________________________________________
+bool GeoJsonReader::end_array() {
+  close();
+  return true;
+}
+
+// _____________________________________________________________________________
+bool GeoJsonReader::parse_error(std::size_t position,
+                                const std::string& lastToken,
+                                const nlohmann::json::exception& ex) {
+  UNUSED(position);
+  UNUSED(lastToken);
+
+  // keep the exception types of the DOM parser
+  if (auto e = dynamic_cast<const nlohmann::json::parse_error*>(&ex)) throw *e;
+  if (auto e = dynamic_cast<const nlohmann::json::out_of_range*>(&ex)) throw *e;
+  throw std::runtime_error(ex.what());
+}
+
+// _____________________________________________________________________________
+void GeoJsonReader::open(bool obj, nlohmann::json val) {
+  Ctx ctx = SKIP;
+
+  if (_ctx.empty()) {
+    if (obj) ctx = TOP;
+  } else {
+    switch (_ctx.back()) {
+      case TOP:
+        if (!obj && _key == "features") ctx = FEATURES;
+        break;
+      case FEATURES:
+        if (obj) {
+          ctx = FEATURE;
+          _feature = GeoJsonFeature();
+        }
+        break;
+      case FEATURE:
+        if (_key == "geometry" && obj) ctx = GEOM;
+        if (_key == "properties") ctx = PROPS;
+        break;
+      case GEOM:
+        if (_key == "coordinates" && !obj) ctx = COORDS;
+        break;
+      case COORDS:
+        if (!obj) ctx = COORDS;
+        _coord.clear();
+        break;
+      case PROPS:
+        ctx = PROPS;
+        break;
+      default:
+        break;
+    }
+  }
+
+  if (ctx == PROPS) {
+    if (_props.empty()) {
+      _feature.props = std::move(val);
+      _props.push_back(&_feature.props);
+    } else if (_props.back()->is_array()) {
+      _props.back()->push_back(std::move(val));
+      _props.push_back(&_props.back()->back());
+    } else {
+      auto& v = (*_props.back())[_key];
+      v = std::move(val);
+      _props.push_back(&v);
+    }
+  }
+
+  _ctx.push_back(ctx);
+}
+
+// _____________________________________________________________________________
+void GeoJsonReader::close() {
+  Ctx ctx = _ctx.back();
+  _ctx.pop_back();
+
+  if (ctx == PROPS) {
+    _props.pop_back();
+  } else if (ctx == COORDS) {
+    // only the first two dimensions are used
+    if (_coord.size() > 1) {
+      _feature.geom << util::geo::DPoint(_coord[0], _coord[1]);
+    }
+    _coord.clear();
+  } else if (ctx == FEATURE) {
+    _cb(&_feature);
+  }
+}
+
+// _____________________________________________________________________________
+void GeoJsonReader::value(nlohmann::json val) {
+  if (_ctx.empty()) return;
+
+  switch (_ctx.back()) {
+    case TOP:
+      if (_key == "type" && val.is_string()) _type = val.get<std::string>();
+      break;
+    case FEATURE:
+      if (_key == "properties") _feature.props = std::move(val);
+      break;
+    case GEOM:
+      if (_key == "type" && val.is_string()) {
+        _feature.type = val.get<std::string>();
+      }
+      break;
+    case PROPS:
+      if (_props.back()->is_array()) {
+        _props.back()->push_back(std::move(val));
+      } else {
+        (*_props.back())[_key] = std::move(val);
+      }
+      break;
+    default:
+      break;
+  }
+}
+
+// _____________________________________________________________________________
+void GeoJsonReader::coord(double val) { _coord.push_back(val); }
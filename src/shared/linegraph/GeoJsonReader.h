@@ -0,0 +1,81 @@
+// Copyright 2017, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+// Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
+
+#ifndef SHARED_LINEGRAPH_GEOJSONREADER_H_
+#define SHARED_LINEGRAPH_GEOJSONREADER_H_
+
+#include <functional>
+#include <istream>
+#include <string>
+#include <vector>
+#include "3rdparty/json.hpp"
+#include "util/geo/PolyLine.h"
+
+namespace shared {
+namespace linegraph {
+
+struct GeoJsonFeature {
+  std::string type;
+  nlohmann::json props;
+  util::geo::PolyLine<double> geom;
+};
+
+// Streaming GeoJSON reader, driven by the SAX events of the JSON parser.
+//
+// The features of a FeatureCollection are handed to a callback one at a time,
+// so no DOM of the whole document is ever built. Coordinates are parsed
+// directly into the feature's polyline, only the (small) properties of a
+// feature are kept as a JSON value.
+class GeoJsonReader : public nlohmann::json_sax<nlohmann::json> {
+ public:
+  typedef std::function<void(GeoJsonFeature*)> FeatureCb;
+
+  explicit GeoJsonReader(FeatureCb cb) : _cb(cb) {}
+
+  // parse s, calling the callback for each feature, returns the type of the
+  // top-level object
+  std::string read(std::istream* s);
+
+  bool null();
+  bool boolean(bool val);
+  bool number_integer(number_integer_t val);
+  bool number_unsigned(number_unsigned_t val);
+  bool number_float(number_float_t val, const string_t& s);
+  bool string(string_t& val);
+  bool binary(binary_t& val);
+  bool start_object(std::size_t elements);
+  bool key(string_t& val);
+  bool end_object();
+  bool start_array(std::size_t elements);
+  bool end_array();
+  bool parse_error(std::size_t position, const std::string& lastToken,
+                   const nlohmann::json::exception& ex);
+
+ private:
+  enum Ctx { TOP, FEATURES, FEATURE, GEOM, COORDS, PROPS, SKIP };
+
+  FeatureCb _cb;
+
+  std::vector<Ctx> _ctx;
+  std::string _key;
+  std::string _type;
+
+  GeoJsonFeature _feature;
+
+  // numbers of the innermost coordinate array
+  std::vector<double> _coord;
+
+  // the property values currently being built
+  std::vector<nlohmann::json*> _props;
+
+  void open(bool obj, nlohmann::json val);
+  void close();
+  void value(nlohmann::json val);
+  void coord(double val);
+};
+
+}  // namespace linegraph
+}  // namespace shared
+
+#endif  // SHARED_LINEGRAPH_GEOJSONREADER_H_
@@ -72,7 +72,7 @@ class LineEdgePL : util::geograph::GeoEdgePL<double> {
   void writePermutation(const std::vector<size_t> order);
 
   void setDontContract(bool dontContract) { _dontContract = dontContract; }
-  bool dontContract() { return _dontContract; }
+  bool dontContract() const { return _dontContract; }
 
  private:
   std::map<const Line*, size_t> _lineToIdx;
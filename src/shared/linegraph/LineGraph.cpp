@@ -2,8 +2,17 @@
 // Chair of Algorithms and Data Structures.
 // Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
 
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <vector>
 #include "3rdparty/json.hpp"
 #include "dot/Parser.h"
+#include "shared/linegraph/BinGraph.h"
+#include "shared/linegraph/GeoJsonReader.h"
 #include "shared/linegraph/LineEdgePL.h"
 #include "shared/linegraph/LineGraph.h"
 #include "shared/linegraph/LineNodePL.h"
@@ -13,9 +22,11 @@
 #include "util/graph/Node.h"
 #include "util/log/Log.h"
 
+using shared::linegraph::BinGraphReader;
 using shared::linegraph::EdgeGrid;
 using shared::linegraph::EdgeOrdering;
-using shared::linegraph::ISect;
+using shared::linegraph::GeoJsonFeature;
+using shared::linegraph::GeoJsonReader;
 using shared::linegraph::Line;
 using shared::linegraph::LineEdge;
 using shared::linegraph::LineGraph;
@@ -26,6 +37,66 @@ using shared::linegraph::Partner;
 using util::geo::DPoint;
 using util::geo::Point;
 
+namespace {
+// _____________________________________________________________________________
+bool hasVal(const nlohmann::json& j, const char* key) {
+  return j.is_object() && j.contains(key) && !j[key].is_null();
+}
+
+// _____________________________________________________________________________
+std::string getStr(const nlohmann::json& j, const char* key) {
+  if (!hasVal(j, key)) return "";
+  return j[key].get<std::string>();
+}
+
+// _____________________________________________________________________________
+bool cutAt(const std::map<double, LineNode*>& cuts, double pos,
+           LineNode** nd) {
+  // checks whether an edge already cut at cuts may be cut at pos. If pos
+  // falls onto an existing cut, its node is written to nd. Positions too near
+  // to the edge ends are rejected.
+  double loPos = 0, hiPos = 1;
+  LineNode *lo = 0, *hi = 0;
+
+  auto it = cuts.lower_bound(pos);
+  if (it != cuts.end()) {
+    hiPos = it->first;
+    hi = it->second;
+  }
+  if (it != cuts.begin()) {
+    loPos = std::prev(it)->first;
+    lo = std::prev(it)->second;
+  }
+
+  double eps = 0.001 * (hiPos - loPos);
+  if (pos - loPos <= eps) {
+    *nd = lo;
+    return lo != 0;
+  }
+  if (hiPos - pos <= eps) {
+    *nd = hi;
+    return hi != 0;
+  }
+
+  return true;
+}
+
+// _____________________________________________________________________________
+bool joinedNear(const std::map<double, LineNode*>& cuts,
+                const std::set<const LineNode*>& nds, const DPoint& p,
+                double d) {
+  // checks whether an edge cut at cuts already meets an edge cut at nds in a
+  // node nearer than d to p
+  for (const auto& cut : cuts) {
+    if (nds.count(cut.second) &&
+        util::geo::dist(*cut.second->pl().getGeom(), p) < d) {
+      return true;
+    }
+  }
+  return false;
+}
+}  // namespace
+
 // _____________________________________________________________________________
 void LineGraph::readFromDot(std::istream* s, double smooth) {
   UNUSED(smooth);
@@ -155,239 +226,445 @@ void LineGraph::readFromTopoJson(nlohmann::json::array_t objects,
 }
 
 // _____________________________________________________________________________
-void LineGraph::readFromGeoJson(nlohmann::json::array_t features,
+void LineGraph::readFromGeoJson(const nlohmann::json::array_t& features,
                                 double smooth) {
   _bbox = util::geo::Box<double>();
 
   std::map<std::string, LineNode*> idMap;
 
-  for (auto feature : features) {
-    auto props = feature["properties"];
-    auto geom = feature["geometry"];
+  for (const auto& feature : features) {
+    const auto& geom = feature["geometry"];
     if (geom["type"] == "Point") {
-      std::string id = props["id"].get<std::string>();
-
-      std::vector<double> coords = geom["coordinates"];
-
-      LineNode* n = addNd(util::geo::DPoint(coords[0], coords[1]));
-      expandBBox(*n->pl().getGeom());
+      const auto& coords = geom["coordinates"];
+      addGeoJsonNd(feature["properties"],
+                   util::geo::DPoint(coords[0].get<double>(),
+                                     coords[1].get<double>()),
+                   &idMap);
+    }
+  }
 
-      Station i("", "", *n->pl().getGeom());
-      if (!props["station_id"].is_null() || !props["station_label"].is_null()) {
-        if (!props["station_id"].is_null()) {
-          if (props["station_id"].type() == nlohmann::json::value_t::string) {
-            i.id = props["station_id"].get<std::string>();
-          } else {
-            i.id = props["station_id"].get<std::string>();
-          }
-        }
-        if (!props["station_label"].is_null()) i.name = props["station_label"];
-        n->pl().addStop(i);
+  // second pass, edges
+  for (const auto& feature : features) {
+    const auto& geom = feature["geometry"];
+    if (geom["type"] == "LineString") {
+      PolyLine<double> pl;
+      for (const auto& coord : geom["coordinates"]) {
+        pl << Point<double>(coord[0].get<double>(), coord[1].get<double>());
       }
 
-      idMap[id] = n;
+      addGeoJsonEdg(feature["properties"], &pl, smooth, idMap);
     }
   }
 
-  // second pass, edges
-  for (auto feature : features) {
-    auto props = feature["properties"];
-    auto geom = feature["geometry"];
-    if (geom["type"] == "LineString") {
-      if (props["lines"].is_null() || props["lines"].size() == 0) continue;
-      std::string from = props["from"].get<std::string>();
-      std::string to = props["to"].get<std::string>();
+  // third pass, exceptions
+  for (const auto& feature : features) {
+    if (feature["geometry"]["type"] == "Point") {
+      addGeoJsonExcs(feature["properties"], idMap);
+    }
+  }
 
-      std::vector<std::vector<double>> coords = geom["coordinates"];
+  _bbox = util::geo::pad(_bbox, 100);
 
-      PolyLine<double> pl;
-      for (auto coord : coords) {
-        double x = coord[0], y = coord[1];
-        Point<double> p(x, y);
-        pl << p;
-        expandBBox(p);
-      }
+  buildGrids();
+}
 
-      pl.applyChaikinSmooth(smooth);
+// _____________________________________________________________________________
+void LineGraph::readFromJson(std::istream* s, double smooth) {
+  _bbox = util::geo::Box<double>();
 
-      LineNode* fromN = 0;
-      LineNode* toN = 0;
+  std::map<std::string, LineNode*> idMap;
 
-      if (from.size()) {
-        fromN = idMap[from];
-        if (!fromN) {
-          LOG(ERROR) << "Node \"" << from << "\" not found." << std::endl;
-          continue;
-        }
+  // edges are added in input order as soon as their end nodes are known,
+  // the others wait here until all nodes have been read
+  std::vector<GeoJsonFeature> pending;
+
+  // node exceptions reference edges and lines, they are applied last
+  std::vector<nlohmann::json> excs;
+
+  GeoJsonReader reader([&](GeoJsonFeature* f) {
+    if (f->type == "Point") {
+      if (f->geom.getLine().empty()) return;
+      addGeoJsonNd(f->props, f->geom.front(), &idMap);
+      if (hasGeoJsonExcs(f->props)) excs.push_back(std::move(f->props));
+    } else if (f->type == "LineString") {
+      if (pending.empty() && geoJsonEdgResolvable(f->props, idMap)) {
+        addGeoJsonEdg(f->props, &f->geom, smooth, idMap);
       } else {
-        fromN = addNd(pl.getLine().front());
+        pending.push_back(std::move(*f));
       }
+    }
+  });
 
-      if (to.size()) {
-        toN = idMap[to];
-        if (!fromN) {
-          LOG(ERROR) << "Node \"" << to << "\" not found." << std::endl;
-          continue;
+  if (reader.read(s) == "Topology") {
+    readFromTopoJson(nlohmann::json::array_t(), nlohmann::json::array_t(),
+                     smooth);
+  }
+
+  for (auto& f : pending) addGeoJsonEdg(f.props, &f.geom, smooth, idMap);
+  for (const auto& props : excs) addGeoJsonExcs(props, idMap);
+
+  _bbox = util::geo::pad(_bbox, 100);
+
+  buildGrids();
+}
+
+// _____________________________________________________________________________
+void LineGraph::readFromBin(std::istream* s, double smooth) {
+  if (s == &std::cin) {
+    struct stat st;
+    if (fstat(STDIN_FILENO, &st) == 0 && S_ISREG(st.st_mode) &&
+        st.st_size > 0 && lseek(STDIN_FILENO, 0, SEEK_CUR) == 0) {
+      void* data =
+          mmap(0, st.st_size, PROT_READ, MAP_PRIVATE, STDIN_FILENO, 0);
+      if (data != MAP_FAILED) {
+        try {
+          readFromBin(static_cast<const char*>(data), st.st_size, smooth);
+        } catch (...) {
+          munmap(data, st.st_size);
+          throw;
         }
-      } else {
-        fromN = addNd(pl.getLine().back());
+        munmap(data, st.st_size);
+        return;
       }
+    }
+  }
 
-      LineEdge* e = addEdg(fromN, toN, pl);
+  std::vector<char> buf;
+  char chunk[1 << 16];
+  while (s->read(chunk, sizeof(chunk)), s->gcount() > 0) {
+    buf.insert(buf.end(), chunk, chunk + s->gcount());
+  }
 
-      if (props["dontcontract"].is_number() && props["dontcontract"].get<int>())
-        e->pl().setDontContract(true);
+  readFromBin(buf.data(), buf.size(), smooth);
+}
 
-      for (auto line : props["lines"]) {
-        std::string id;
-        if (!line["id"].is_null()) {
-          id = line["id"].get<std::string>();
-        } else if (!line["label"].is_null()) {
-          id = line["label"].get<std::string>();
-        } else if (!line["color"].is_null()) {
-          id = line["color"].get<std::string>();
-        } else
-          continue;
+// _____________________________________________________________________________
+void LineGraph::readFromBin(const char* data, size_t size, double smooth) {
+  _bbox = util::geo::Box<double>();
 
-        const Line* l = getLine(id);
-        if (!l) {
-          std::string label = line["label"].is_null() ? "" : line["label"];
-          std::string color = line["color"];
+  BinGraphReader r(data, size);
 
-          std::string myLabel;
-          if(!line["startLabel"].is_null()){
-            myLabel = line["startLabel"];
-          }else{
-            myLabel = "";
-          }
+  std::vector<std::string> strs;
+  std::vector<const Line*> lines;
+  std::vector<LineNode*> nds;
+  std::vector<LineEdge*> edgs;
 
-          std::string backLabel;
-          if(!line["backLabel"].is_null()){
-            backLabel = line["backLabel"];
-          }else{
-            backLabel = "";
-          }
+  auto str = [&]() { return strs[r.ref(strs.size(), false)]; };
 
+  uint32_t tag;
+  size_t len;
 
-          l = new Line(id, label, color, myLabel, backLabel, from, to);
-          addLine(l);
+  while (r.nextSection(&tag, &len)) {
+    switch (tag) {
+      case BIN_STRS: {
+        size_t n = r.u32();
+        for (size_t i = 0; i < n; i++) strs.push_back(r.str(r.u32()));
+        break;
+      }
+      case BIN_LINE: {
+        size_t n = r.u32();
+        for (size_t i = 0; i < n; i++) {
+          std::string f[7];
+          for (size_t j = 0; j < 7; j++) f[j] = str();
+
+          const Line* l = getLine(f[0]);
+          if (!l) {
+            l = new Line(f[0], f[1], f[2], f[3], f[4], f[5], f[6]);
+            addLine(l);
+          }
+          lines.push_back(l);
+        }
+        break;
+      }
+      case BIN_NODE: {
+        size_t n = r.u32();
+        for (size_t i = 0; i < n; i++) {
+          double x = r.f64();
+          double y = r.f64();
+          LineNode* nd = addNd(DPoint(x, y));
+          expandBBox(*nd->pl().getGeom());
+
+          size_t k = r.u32();
+          for (size_t j = 0; j < k; j++) {
+            std::string id = str();
+            std::string name = str();
+            double sx = r.f64();
+            double sy = r.f64();
+            nd->pl().addStop(Station(id, name, DPoint(sx, sy)));
+          }
+          nds.push_back(nd);
         }
+        break;
+      }
+      case BIN_EDGE: {
+        size_t n = r.u32();
+        for (size_t i = 0; i < n; i++) {
+          LineNode* from = nds[r.ref(nds.size(), false)];
+          LineNode* to = nds[r.ref(nds.size(), false)];
+          uint8_t flags = r.u8();
 
-        LineNode* dir = 0;
+          PolyLine<double> pl;
+          size_t k = r.u32();
+          for (size_t j = 0; j < k; j++) {
+            double x = r.f64();
+            double y = r.f64();
+            pl << DPoint(x, y);
+            expandBBox(pl.back());
+          }
 
-        if (!line["direction"].is_null()) {
-          dir = idMap[line["direction"].get<std::string>()];
+          pl.applyChaikinSmooth(smooth);
+
+          LineEdge* e = addEdg(from, to, pl);
+          if (flags & BIN_EDGE_DONT_CONTRACT) e->pl().setDontContract(true);
+
+          size_t m = r.u32();
+          for (size_t j = 0; j < m; j++) {
+            const Line* l = lines[r.ref(lines.size(), false)];
+            uint32_t dir = r.ref(nds.size(), true);
+            uint32_t css = r.ref(strs.size(), true);
+            uint32_t outlineCss = r.ref(strs.size(), true);
+
+            LineNode* dirNd = dir == BIN_GRAPH_NONE ? 0 : nds[dir];
+
+            if (css == BIN_GRAPH_NONE) {
+              e->pl().addLine(l, dirNd);
+            } else {
+              shared::style::LineStyle ls;
+              ls.setCss(strs[css]);
+              if (outlineCss != BIN_GRAPH_NONE) {
+                ls.setOutlineCss(strs[outlineCss]);
+              }
+              e->pl().addLine(l, dirNd, ls);
+            }
+          }
+          edgs.push_back(e);
         }
+        break;
+      }
+      case BIN_NSRV: {
+        size_t n = r.u32();
+        for (size_t i = 0; i < n; i++) {
+          LineNode* nd = nds[r.ref(nds.size(), false)];
+          nd->pl().addLineNotServed(lines[r.ref(lines.size(), false)]);
+        }
+        break;
+      }
+      case BIN_CEXC: {
+        size_t n = r.u32();
+        for (size_t i = 0; i < n; i++) {
+          LineNode* nd = nds[r.ref(nds.size(), false)];
+          const Line* l = lines[r.ref(lines.size(), false)];
+          const LineEdge* a = edgs[r.ref(edgs.size(), false)];
+          const LineEdge* b = edgs[r.ref(edgs.size(), false)];
+          nd->pl().addConnExc(l, a, b);
+        }
+        break;
+      }
+      default:
+        r.skipSection();
+    }
+  }
 
-        if (!line["style"].is_null() || !line["outline-style"].is_null()) {
-          shared::style::LineStyle ls;
+  _bbox = util::geo::pad(_bbox, 100);
 
-          if (!line["style"].is_null()) ls.setCss(line["style"]);
-          if (!line["outline-style"].is_null())
-            ls.setOutlineCss(line["outline-style"]);
+  buildGrids();
+}
 
-          e->pl().addLine(l, dir, ls);
-        } else {
-          e->pl().addLine(l, dir);
-        }
+// _____________________________________________________________________________
+void LineGraph::addGeoJsonNd(const nlohmann::json& props,
+                             const util::geo::DPoint& p,
+                             std::map<std::string, LineNode*>* idMap) {
+  std::string id = props.at("id").get<std::string>();
+
+  LineNode* n = addNd(p);
+  expandBBox(*n->pl().getGeom());
+
+  Station i("", "", *n->pl().getGeom());
+  if (hasVal(props, "station_id") || hasVal(props, "station_label")) {
+    if (hasVal(props, "station_id")) {
+      if (props["station_id"].is_string()) {
+        i.id = props["station_id"].get<std::string>();
+      } else {
+        i.id = props["station_id"].dump();
       }
     }
+    if (hasVal(props, "station_label")) i.name = getStr(props, "station_label");
+    n->pl().addStop(i);
   }
 
-  // third pass, exceptions (TODO: do this in the first part, store in some
-  // data structure, add here!)
-  for (auto feature : features) {
-    auto props = feature["properties"];
-    auto geom = feature["geometry"];
-    if (geom["type"] == "Point") {
-      std::string id = props["id"].get<std::string>();
+  (*idMap)[id] = n;
+}
+
+// _____________________________________________________________________________
+bool LineGraph::geoJsonEdgResolvable(
+    const nlohmann::json& props,
+    const std::map<std::string, LineNode*>& idMap) {
+  std::string from = getStr(props, "from");
+  std::string to = getStr(props, "to");
+  return (from.empty() || idMap.count(from)) && (to.empty() || idMap.count(to));
+}
 
-      if (!idMap.count(id)) continue;
-      LineNode* n = idMap[id];
+// _____________________________________________________________________________
+void LineGraph::addGeoJsonEdg(const nlohmann::json& props,
+                              PolyLine<double>* pl, double smooth,
+                              const std::map<std::string, LineNode*>& idMap) {
+  if (!hasVal(props, "lines") || props["lines"].size() == 0) return;
+  std::string from = props.at("from").get<std::string>();
+  std::string to = props.at("to").get<std::string>();
 
-      if (!props["not_serving"].is_null()) {
-        for (auto excl : props["not_serving"]) {
-          std::string lid = excl.get<std::string>();
+  for (const auto& p : pl->getLine()) expandBBox(p);
 
-          const Line* r = getLine(lid);
+  pl->applyChaikinSmooth(smooth);
 
-          if (!r) {
-            LOG(WARN) << "line " << lid << " marked as not served in in node "
-                      << id << ", but no such line exists.";
-            continue;
-          }
+  LineNode* fromN = 0;
+  LineNode* toN = 0;
 
-          n->pl().addLineNotServed(r);
-        }
-      }
+  if (from.size()) {
+    auto i = idMap.find(from);
+    if (i == idMap.end()) {
+      LOG(ERROR) << "Node \"" << from << "\" not found." << std::endl;
+      return;
+    }
+    fromN = i->second;
+  } else {
+    fromN = addNd(pl->getLine().front());
+  }
 
-      if (!props["excluded_line_conns"].is_null()) {
-        for (auto excl : props["excluded_line_conns"]) {
-          std::string lid = excl["route"].get<std::string>();
-          std::string nid1 = excl["edge1_node"].get<std::string>();
-          std::string nid2 = excl["edge2_node"].get<std::string>();
+  if (to.size()) {
+    auto i = idMap.find(to);
+    if (i == idMap.end()) {
+      LOG(ERROR) << "Node \"" << to << "\" not found." << std::endl;
+      return;
+    }
+    toN = i->second;
+  } else {
+    toN = addNd(pl->getLine().back());
+  }
 
-          const Line* r = getLine(lid);
+  LineEdge* e = addEdg(fromN, toN, *pl);
 
-          if (!r) {
-            LOG(WARN) << "line connection exclude defined in node " << id
-                      << " for line " << lid << ", but no such line exists.";
-            continue;
-          }
+  if (hasVal(props, "dontcontract") && props["dontcontract"].is_number() &&
+      props["dontcontract"].get<int>())
+    e->pl().setDontContract(true);
 
-          if (!idMap.count(nid1)) {
-            LOG(WARN) << "line connection exclude defined in node " << id
-                      << " for edge from " << nid1
-                      << ", but no such node exists.";
-            continue;
-          }
+  for (const auto& line : props["lines"]) {
+    std::string id;
+    if (hasVal(line, "id")) {
+      id = getStr(line, "id");
+    } else if (hasVal(line, "label")) {
+      id = getStr(line, "label");
+    } else if (hasVal(line, "color")) {
+      id = getStr(line, "color");
+    } else {
+      continue;
+    }
 
-          if (!idMap.count(nid2)) {
-            LOG(WARN) << "line connection exclude defined in node " << id
-                      << " for edge from " << nid2
-                      << ", but no such node exists.";
-            continue;
-          }
+    const Line* l = getLine(id);
+    if (!l) {
+      l = new Line(id, getStr(line, "label"), getStr(line, "color"),
+                   getStr(line, "startLabel"), getStr(line, "backLabel"), from,
+                   to);
+      addLine(l);
+    }
 
-          LineNode* n1 = idMap[nid1];
-          LineNode* n2 = idMap[nid2];
+    LineNode* dir = 0;
 
-          LineEdge* a = getEdg(n, n1);
-          LineEdge* b = getEdg(n, n2);
+    if (hasVal(line, "direction")) {
+      auto i = idMap.find(getStr(line, "direction"));
+      if (i != idMap.end()) dir = i->second;
+    }
 
-          if (!a) {
-            LOG(WARN) << "line connection exclude defined in node " << id
-                      << " for edge from " << nid1
-                      << ", but no such edge exists.";
-            continue;
-          }
+    if (hasVal(line, "style") || hasVal(line, "outline-style")) {
+      shared::style::LineStyle ls;
 
-          if (!b) {
-            LOG(WARN) << "line connection exclude defined in node " << id
-                      << " for edge from " << nid2
-                      << ", but no such edge exists.";
-            continue;
-          }
+      if (hasVal(line, "style")) ls.setCss(getStr(line, "style"));
+      if (hasVal(line, "outline-style"))
+        ls.setOutlineCss(getStr(line, "outline-style"));
 
-          n->pl().addConnExc(r, a, b);
-        }
-      }
+      e->pl().addLine(l, dir, ls);
+    } else {
+      e->pl().addLine(l, dir);
     }
   }
+}
 
-  _bbox = util::geo::pad(_bbox, 100);
-
-  buildGrids();
+// _____________________________________________________________________________
+bool LineGraph::hasGeoJsonExcs(const nlohmann::json& props) {
+  return hasVal(props, "not_serving") || hasVal(props, "excluded_line_conns");
 }
 
 // _____________________________________________________________________________
-void LineGraph::readFromJson(std::istream* s, double smooth) {
-  nlohmann::json j;
-  (*s) >> j;
+void LineGraph::addGeoJsonExcs(const nlohmann::json& props,
+                               const std::map<std::string, LineNode*>& idMap) {
+  std::string id = props.at("id").get<std::string>();
+
+  auto ndIt = idMap.find(id);
+  if (ndIt == idMap.end()) return;
+  LineNode* n = ndIt->second;
+
+  if (hasVal(props, "not_serving")) {
+    for (const auto& excl : props["not_serving"]) {
+      std::string lid = excl.get<std::string>();
+
+      const Line* r = getLine(lid);
+
+      if (!r) {
+        LOG(WARN) << "line " << lid << " marked as not served in in node " << id
+                  << ", but no such line exists.";
+        continue;
+      }
+
+      n->pl().addLineNotServed(r);
+    }
+  }
+
+  if (hasVal(props, "excluded_line_conns")) {
+    for (const auto& excl : props["excluded_line_conns"]) {
+      std::string lid = excl.at("route").get<std::string>();
+      std::string nid1 = excl.at("edge1_node").get<std::string>();
+      std::string nid2 = excl.at("edge2_node").get<std::string>();
+
+      const Line* r = getLine(lid);
+
+      if (!r) {
+        LOG(WARN) << "line connection exclude defined in node " << id
+                  << " for line " << lid << ", but no such line exists.";
+        continue;
+      }
+
+      if (!idMap.count(nid1)) {
+        LOG(WARN) << "line connection exclude defined in node " << id
+                  << " for edge from " << nid1 << ", but no such node exists.";
+        continue;
+      }
+
+      if (!idMap.count(nid2)) {
+        LOG(WARN) << "line connection exclude defined in node " << id
+                  << " for edge from " << nid2 << ", but no such node exists.";
+        continue;
+      }
+
+      LineNode* n1 = idMap.find(nid1)->second;
+      LineNode* n2 = idMap.find(nid2)->second;
 
-  if (j["type"] == "FeatureCollection") readFromGeoJson(j["features"], smooth);
-  if (j["type"] == "Topology")
-    readFromTopoJson(j["objects"], j["arcs"], smooth);
+      LineEdge* a = getEdg(n, n1);
+      LineEdge* b = getEdg(n, n2);
+
+      if (!a) {
+        LOG(WARN) << "line connection exclude defined in node " << id
+                  << " for edge from " << nid1 << ", but no such edge exists.";
+        continue;
+      }
+
+      if (!b) {
+        LOG(WARN) << "line connection exclude defined in node " << id
+                  << " for edge from " << nid2 << ", but no such edge exists.";
+        continue;
+      }
+
+      n->pl().addConnExc(r, a, b);
+    }
+  }
 }
 
 // _____________________________________________________________________________
@@ -418,49 +695,110 @@ const util::geo::DBox& LineGraph::getBBox() const { return _bbox; }
 
 // _____________________________________________________________________________
 void LineGraph::topologizeIsects() {
-  proced.clear();
-  while (getNextIntersection().a) {
-    auto i = getNextIntersection();
-    auto x = addNd(i.bp.p);
+  // collect the crossings of all edge pairs in a single pass over the edge
+  // grid, then split each crossed edge once at all of its crossings
+  std::vector<LineEdge*> edgs;
+  std::vector<util::geo::DBox> boxes;
+  std::unordered_map<const LineEdge*, size_t> idx;
+
+  for (auto n : getNds()) {
+    for (auto e : n->getAdjList()) {
+      if (e->getFrom() != n) continue;
+      idx[e] = edgs.size();
+      edgs.push_back(e);
+      boxes.push_back(util::geo::getBoundingBox(*e->pl().getGeom()));
+    }
+  }
+
+  // for each edge, the nodes to be inserted at positions along it
+  std::vector<std::map<double, LineNode*>> cuts(edgs.size());
+  std::vector<std::set<const LineNode*>> cutNds(edgs.size());
+
+  for (size_t i = 0; i < edgs.size(); i++) {
+    auto a = edgs[i];
+    std::set<LineEdge*> neighbors;
+    _edgeGrid.getNeighbors(a, 0, &neighbors);
+
+    for (auto b : neighbors) {
+      auto bIt = idx.find(b);
+      if (bIt == idx.end() || bIt->second <= i) continue;
+      size_t j = bIt->second;
+
+      if (!util::geo::intersects(boxes[i], boxes[j])) continue;
+
+      auto shrdNd = sharedNode(a, b);
+
+      for (const auto& bp :
+           a->pl().getPolyline().getIntersections(b->pl().getPolyline())) {
+        // if the intersection is near a shared node, ignore. The sub-edges
+        // of a crossed pair share the node inserted at the crossing.
+        if (shrdNd && util::geo::dist(*shrdNd->pl().getGeom(), bp.p) < 100) {
+          continue;
+        }
+        if (joinedNear(cuts[i], cutNds[j], bp.p, 100)) continue;
+
+        double pa = a->pl().getPolyline().projectOn(bp.p).totalPos;
+
+        LineNode *xa = 0, *xb = 0;
+        if (!cutAt(cuts[i], pa, &xa) || !cutAt(cuts[j], bp.totalPos, &xb)) {
+          continue;
+        }
 
-    double pa = i.a->pl().getPolyline().projectOn(i.bp.p).totalPos;
+        // both edges are already cut here by other edges
+        if (xa && xb) continue;
 
-    auto ba = addEdg(i.b->getFrom(), x, i.b->pl());
-    ba->pl().setPolyline(i.b->pl().getPolyline().getSegment(0, i.bp.totalPos));
+        // if one of the edges is already cut here, the other edge is joined
+        // into the existing node
+        LineNode* x = xa ? xa : xb ? xb : addNd(bp.p);
 
-    auto bb = addEdg(x, i.b->getTo(), i.b->pl());
-    bb->pl().setPolyline(i.b->pl().getPolyline().getSegment(i.bp.totalPos, 1));
+        if (!xa) {
+          cuts[i][pa] = x;
+          cutNds[i].insert(x);
+        }
+        if (!xb) {
+          cuts[j][bp.totalPos] = x;
+          cutNds[j].insert(x);
+        }
+      }
+    }
+  }
 
-    edgeRpl(i.b->getFrom(), i.b, ba);
-    edgeRpl(i.b->getTo(), i.b, bb);
+  for (size_t i = 0; i < edgs.size(); i++) {
+    if (cuts[i].empty()) continue;
 
-    nodeRpl(ba, i.b->getTo(), x);
-    nodeRpl(bb, i.b->getFrom(), x);
+    auto e = edgs[i];
+    auto pl = e->pl().getPolyline();
+    auto frNd = e->getFrom();
+    double frPos = 0;
 
-    _edgeGrid.add(*ba->pl().getGeom(), ba);
-    _edgeGrid.add(*bb->pl().getGeom(), bb);
+    cuts[i][1] = e->getTo();
 
-    auto aa = addEdg(i.a->getFrom(), x, i.a->pl());
-    aa->pl().setPolyline(i.a->pl().getPolyline().getSegment(0, pa));
-    auto ab = addEdg(x, i.a->getTo(), i.a->pl());
-    ab->pl().setPolyline(i.a->pl().getPolyline().getSegment(pa, 1));
+    for (const auto& cut : cuts[i]) {
+      auto sub = addEdg(frNd, cut.second, e->pl());
+      sub->pl().setPolyline(pl.getSegment(frPos, cut.first));
 
-    edgeRpl(i.a->getFrom(), i.a, aa);
-    edgeRpl(i.a->getTo(), i.a, ab);
+      if (frNd == e->getFrom()) {
+        edgeRpl(frNd, e, sub);
+      } else {
+        nodeRpl(sub, e->getFrom(), frNd);
+      }
+
+      if (cut.second == e->getTo()) {
+        edgeRpl(cut.second, e, sub);
+      } else {
+        nodeRpl(sub, e->getTo(), cut.second);
+      }
 
-    nodeRpl(aa, i.b->getTo(), x);
-    nodeRpl(ab, i.b->getFrom(), x);
+      _edgeGrid.add(*sub->pl().getGeom(), sub);
 
-    _edgeGrid.add(*aa->pl().getGeom(), aa);
-    _edgeGrid.add(*ab->pl().getGeom(), ab);
+      frNd = cut.second;
+      frPos = cut.first;
+    }
 
-    _edgeGrid.remove(i.a);
-    _edgeGrid.remove(i.b);
+    _edgeGrid.remove(e);
 
-    assert(getEdg(i.a->getFrom(), i.a->getTo()));
-    assert(getEdg(i.b->getFrom(), i.b->getTo()));
-    delEdg(i.a->getFrom(), i.a->getTo());
-    delEdg(i.b->getFrom(), i.b->getTo());
+    assert(getEdg(e->getFrom(), e->getTo()));
+    delEdg(e->getFrom(), e->getTo());
   }
 }
 
@@ -473,50 +811,6 @@ std::set<LineEdge*> LineGraph::getNeighborEdges(const util::geo::DLine& line,
   return neighbors;
 }
 
-// _____________________________________________________________________________
-ISect LineGraph::getNextIntersection() {
-  for (auto n1 : getNds()) {
-    for (auto e1 : n1->getAdjList()) {
-      if (e1->getFrom() != n1) continue;
-      if (proced.find(e1) != proced.end()) continue;
-
-      std::set<LineEdge*> neighbors;
-      _edgeGrid.getNeighbors(e1, 0, &neighbors);
-
-      for (auto e2 : neighbors) {
-        if (proced.find(e2) != proced.end()) continue;
-        if (e1 != e2) {
-          auto is =
-              e1->pl().getPolyline().getIntersections(e2->pl().getPolyline());
-
-          if (is.size()) {
-            ISect ret;
-            ret.a = e1;
-            ret.b = e2;
-            ret.bp = *is.begin();
-            // if the intersection is near a shared node, ignore
-            auto shrdNd = sharedNode(e1, e2);
-            if (shrdNd &&
-                util::geo::dist(*shrdNd->pl().getGeom(), ret.bp.p) < 100) {
-              continue;
-            }
-
-            if (ret.bp.totalPos > 0.001 && 1 - ret.bp.totalPos > 0.001) {
-              return ret;
-            }
-          }
-        }
-      }
-      proced.insert(e1);
-    }
-  }
-
-  ISect ret;
-  ret.a = 0;
-  ret.b = 0;
-  return ret;
-}
-
 // _____________________________________________________________________________
 void LineGraph::addLine(const Line* l) { _lines[l->id()] = l; }
 
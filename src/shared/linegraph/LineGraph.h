@@ -24,11 +24,6 @@ typedef std::pair<LineEdge*, LineEdge*> LineEdgePair;
 typedef util::geo::Grid<LineNode*, util::geo::Point, double> NodeGrid;
 typedef util::geo::Grid<LineEdge*, util::geo::Line, double> EdgeGrid;
 
-struct ISect {
-  LineEdge *a, *b;
-  util::geo::LinePoint<double> bp;
-};
-
 struct Partner {
   Partner() : edge(0), line(0){};
   Partner(const LineEdge* e, const Line* r) : edge(e), line(r){};
@@ -44,7 +39,6 @@ class LineGraph : public util::graph::UndirGraph<LineNodePL, LineEdgePL> {
 
   LineGraph(LineGraph&& other) {
     _bbox = other._bbox;
-    proced = other.proced;
     _lines = other._lines;
     _nodeGrid = std::move(other._nodeGrid);
     _edgeGrid = std::move(other._edgeGrid);
@@ -55,7 +49,6 @@ class LineGraph : public util::graph::UndirGraph<LineNodePL, LineEdgePL> {
 
   LineGraph& operator=(LineGraph&& other) {
     _bbox = other._bbox;
-    proced = other.proced;
     _lines = other._lines;
     _nodeGrid = std::move(other._nodeGrid);
     _edgeGrid = std::move(other._edgeGrid);
@@ -66,11 +59,17 @@ class LineGraph : public util::graph::UndirGraph<LineNodePL, LineEdgePL> {
   }
 
   virtual void readFromJson(std::istream* s, double smooth);
-  virtual void readFromGeoJson(nlohmann::json::array_t, double smooth);
+  virtual void readFromGeoJson(const nlohmann::json::array_t& features,
+                               double smooth);
   virtual void readFromTopoJson(nlohmann::json::array_t objects,
                                 nlohmann::json::array_t arc, double smooth);
   virtual void readFromDot(std::istream* s, double smooth);
 
+  // read the binary format described in BinGraph.h, standard input is
+  // memory-mapped if it is a regular file
+  virtual void readFromBin(std::istream* s, double smooth);
+  virtual void readFromBin(const char* data, size_t size, double smooth);
+
   const util::geo::Box<double>& getBBox() const;
   void topologizeIsects();
 
@@ -147,12 +146,22 @@ class LineGraph : public util::graph::UndirGraph<LineNodePL, LineEdgePL> {
  private:
   util::geo::Box<double> _bbox;
 
-  ISect getNextIntersection();
-
   void buildGrids();
 
-  // TODO: remove this
-  std::set<LineEdge*> proced;
+  // building blocks of the GeoJSON readers, shared by the DOM and the
+  // streaming variant
+  void addGeoJsonNd(const nlohmann::json& props, const util::geo::DPoint& p,
+                    std::map<std::string, LineNode*>* idMap);
+  void addGeoJsonEdg(const nlohmann::json& props,
+                     util::geo::PolyLine<double>* pl, double smooth,
+                     const std::map<std::string, LineNode*>& idMap);
+  void addGeoJsonExcs(const nlohmann::json& props,
+                      const std::map<std::string, LineNode*>& idMap);
+  static bool geoJsonEdgResolvable(
+      const nlohmann::json& props,
+      const std::map<std::string, LineNode*>& idMap);
+  static bool hasGeoJsonExcs(const nlohmann::json& props);
+
   std::map<std::string, const Line*> _lines;
 
   NodeGrid _nodeGrid;
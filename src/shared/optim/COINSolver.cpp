@@ -7,9 +7,11 @@
 #include <cassert>
 #include <sstream>
 #include <stdexcept>
+#include <vector>
 
 // COIN includes
 #include "CbcSolver.hpp"
+#include "CoinPackedMatrix.hpp"
 #include "CoinPragma.hpp"
 #include "CoinWarmStart.hpp"
 #include "OsiCbcSolverInterface.hpp"
@@ -50,21 +52,14 @@ COINSolver::COINSolver(DirType dir)
       _status(INF),
       _timeLimit(std::numeric_limits<int>::max()),
       _numThreads(0),
-      _msgHandler(stderr) {
+      _msgHandler(stderr),
+      _dir(dir) {
   _solver = &_solver1;
 
   // use or own msghandler which outputs to stderr, set loglevel of CBC (=0) to
   // normal (=1)
   _msgHandler.setLogLevel(0, 1);
   _solver->passInMessageHandler(&_msgHandler);
-
-  if (dir == MAX) {
-    _model.setOptimizationDirection(-1);
-    _solver->setObjSense(-1);
-  } else {
-    _model.setOptimizationDirection(1);
-    _solver->setObjSense(1);
-  }
 }
 
 // _____________________________________________________________________________
@@ -72,99 +67,12 @@ COINSolver::~COINSolver() {
   if (_starterArr) delete[] _starterArr;
 }
 
-// _____________________________________________________________________________
-int COINSolver::addCol(const std::string& name, ColType colType,
-                       double objCoef) {
-  _model.addCol(0, NULL, NULL, -COIN_DBL_MAX, COIN_DBL_MAX, objCoef,
-                name.c_str());
-  int colId = _model.numberColumns() - 1;
-
-  switch (colType) {
-    case INT:
-      _model.setInteger(colId);
-      break;
-    case BIN:
-      _model.setInteger(colId);
-      _model.setColLower(colId, 0.0);
-      _model.setColUpper(colId, 1.0);
-      break;
-    case CONT:
-      _model.setContinuous(colId);
-      break;
-  }
-
-  return colId;
-}
-
-// _____________________________________________________________________________
-int COINSolver::addCol(const std::string& name, ColType colType, double objCoef,
-                       double lowBnd, double upBnd) {
-  _model.addCol(0, NULL, NULL, lowBnd, upBnd, objCoef, name.c_str());
-  int colId = _model.numberColumns() - 1;
-
-  switch (colType) {
-    case INT:
-      _model.setInteger(colId);
-      break;
-    case BIN:
-      _model.setInteger(colId);
-      _model.setColLower(colId, 0.0);
-      _model.setColUpper(colId, 1.0);
-      break;
-    case CONT:
-      _model.setContinuous(colId);
-      break;
-  }
-
-  return colId;
-}
-
-// _____________________________________________________________________________
-int COINSolver::addRow(const std::string& name, double bnd, RowType rowType) {
-  switch (rowType) {
-    case FIX:
-      _model.addRow(0, 0, 0, bnd, bnd, name.c_str());
-      break;
-    case UP:
-      _model.addRow(0, 0, 0, -COIN_DBL_MAX, bnd, name.c_str());
-      break;
-    case LO:
-      _model.addRow(0, 0, 0, bnd, COIN_DBL_MAX, name.c_str());
-      break;
-  }
-
-  int rowId = _model.numberRows() - 1;
-
-  return rowId;
-}
-
-// _____________________________________________________________________________
-void COINSolver::addColToRow(const std::string& rowName,
-                             const std::string& colName, double coef) {
-  addColToRow(getConstrByName(rowName), getVarByName(colName), coef);
-}
-
-// _____________________________________________________________________________
-int COINSolver::getVarByName(const std::string& name) const {
-  return _model.column(name.c_str());
-}
-
-// _____________________________________________________________________________
-int COINSolver::getConstrByName(const std::string& name) const {
-  return _model.row(name.c_str());
-}
-
-// _____________________________________________________________________________
-void COINSolver::addColToRow(int rowId, int colId, double coef) {
-  _model.setElement(rowId, colId, coef);
-}
-
 // _____________________________________________________________________________
 double COINSolver::getObjVal() const { return _solver->getObjValue(); }
 
 // _____________________________________________________________________________
 SolveType COINSolver::solve() {
-  _solver->loadFromCoinModel(_model);
+  load(&_solver1);
 
   _solver1.getModelPtr()->setMoreSpecialOptions(3);
   _cbcModel = CbcModel(_solver1);
@@ -172,6 +80,16 @@ SolveType COINSolver::solve() {
   _cbcModel.setMaximumSeconds(_timeLimit);
   _cbcModel.setUseElapsedTime(true);
 
+  if (_starterArr) delete[] _starterArr;
+  _starterArr = 0;
+
+  if (getStarter().size()) {
+    _starterArr = new double[getNumVars()]();
+    for (const auto& varVal : getStarter()) {
+      _starterArr[varVal.first] = varVal.second;
+    }
+  }
+
   // this basically follows the examle given at
   // https://github.com/coin-or/Cbc/blob/879602724a65987c5cfb0b9fbacfa192c93df42c/examples/driver6.cpp
   //
@@ -191,6 +109,13 @@ SolveType COINSolver::solve() {
 
   CbcSolverUsefulData solverData;
   CbcMain0(_cbcModel, solverData);
+
+  // CbcMain0 resets the model to the command line defaults, so the starting
+  // solution is passed afterwards. CBC checks it and computes its objective
+  // value, CbcMain1 then hands it to the branch and bound as the incumbent
+  if (_starterArr) {
+    _cbcModel.setBestSolution(_starterArr, getNumVars(), COIN_DBL_MAX, true);
+  }
   std::string numThreads = "4";
 
   if (_numThreads > 0) numThreads = std::to_string(_numThreads);
@@ -226,47 +151,73 @@ double COINSolver::getVarVal(int colId) const {
 }
 
 // _____________________________________________________________________________
-double COINSolver::getVarVal(const std::string& colName) const {
-  return getVarVal(getVarByName(colName));
+void COINSolver::setNumThreads(int n) {
+  LOGTO(INFO, std::cerr) << "Setting number of threads to " << n;
+  _numThreads = n;
 }
 
 // _____________________________________________________________________________
-void COINSolver::setObjCoef(const std::string& colName, double coef) const {
-  setObjCoef(getVarByName(colName), coef);
-}
+int COINSolver::getNumThreads() const { return _numThreads; }
 
 // _____________________________________________________________________________
-void COINSolver::setObjCoef(int colId, double coef) const {
-  _model.setObjective(colId, coef);
+void COINSolver::writeMps(const std::string& path) const {
+  OsiClpSolverInterface solver;
+  load(&solver);
+
+  // without names, COIN generates generic ones
+  std::vector<std::string> colNames, rowNames;
+  std::vector<const char*> colNamesC, rowNamesC;
+
+  if (isNamed()) {
+    for (int i = 0; i < getNumVars(); i++) colNames.push_back(getColName(i));
+    for (int i = 0; i < getNumConstrs(); i++) rowNames.push_back(getRowName(i));
+    for (const auto& n : colNames) colNamesC.push_back(n.c_str());
+    for (const auto& n : rowNames) rowNamesC.push_back(n.c_str());
+  }
+
+  solver.writeMpsNative(path.c_str(),
+                        rowNamesC.size() ? rowNamesC.data() : 0,
+                        colNamesC.size() ? colNamesC.data() : 0);
 }
 
 // _____________________________________________________________________________
-void COINSolver::update() {}
+void COINSolver::load(OsiSolverInterface* solver) const {
+  const auto& cols = getCols();
+  const auto& rows = getRows();
 
-// _____________________________________________________________________________
-int COINSolver::getNumConstrs() const { return _model.numberRows(); }
+  std::vector<double> colLb(cols.size()), colUb(cols.size()), obj(cols.size());
+  std::vector<double> rowLb(rows.size()), rowUb(rows.size());
 
-// _____________________________________________________________________________
-int COINSolver::getNumVars() const { return _model.numberColumns(); }
+  for (size_t i = 0; i < cols.size(); i++) {
+    colLb[i] = cols[i].lowBnd;
+    colUb[i] = cols[i].upBnd;
+    obj[i] = cols[i].objCoef;
+  }
 
-// _____________________________________________________________________________
-void COINSolver::setStarter(const StarterSol& starterSol) {
-  // TODO: not yet implemented
-  UNUSED(starterSol);
-}
+  for (size_t i = 0; i < rows.size(); i++) {
+    rowLb[i] = rows[i].type == UP ? -COIN_DBL_MAX : rows[i].bnd;
+    rowUb[i] = rows[i].type == LO ? COIN_DBL_MAX : rows[i].bnd;
+  }
 
-// _____________________________________________________________________________
-void COINSolver::setNumThreads(int n) {
-  LOGTO(INFO, std::cerr) << "Setting number of threads to " << n;
-  _numThreads = n;
-}
+  std::vector<int> rowBeg, colInd;
+  std::vector<double> vals;
+  getCSR(&rowBeg, &colInd, &vals);
 
-// _____________________________________________________________________________
-int COINSolver::getNumThreads() const { return _numThreads; }
+  std::vector<int> rowLen(rows.size());
+  for (size_t i = 0; i < rows.size(); i++) rowLen[i] = rowBeg[i + 1] - rowBeg[i];
 
-// _____________________________________________________________________________
-void COINSolver::writeMps(const std::string& path) const {
-  _model.writeMps(path.c_str());
+  CoinPackedMatrix mat(false, cols.size(), rows.size(), vals.size(),
+                       vals.data(), colInd.data(), rowBeg.data(),
+                       rowLen.data());
+
+  solver->loadProblem(mat, colLb.data(), colUb.data(), obj.data(),
+                      rowLb.data(), rowUb.data());
+
+  for (size_t i = 0; i < cols.size(); i++) {
+    if (cols[i].type != CONT) solver->setInteger(i);
+  }
+
+  solver->setObjSense(_dir == MAX ? -1 : 1);
 }
 
 // _____________________________________________________________________________
@@ -14,7 +14,7 @@
 #include "CbcSolver.hpp"
 #include "CoinBuild.hpp"
 #include "CoinMessageHandler.hpp"
-#include "CoinModel.hpp"
+#include "CoinPackedMatrix.hpp"
 #include "OsiCbcSolverInterface.hpp"
 #include "OsiSolverInterface.hpp"
 
@@ -26,33 +26,14 @@ class COINSolver : public ILPSolver {
   COINSolver(DirType dir);
   ~COINSolver();
 
-  int addCol(const std::string& name, ColType colType, double objCoef);
-  int addCol(const std::string& name, ColType colType, double objCoef,
-             double lowBnd, double upBnd);
-  int addRow(const std::string& name, double bnd, RowType rowType);
-
-  void addColToRow(const std::string& rowName, const std::string& colName,
-                   double coef);
-  void addColToRow(int rowId, int colId, double coef);
-
-  int getVarByName(const std::string& name) const;
-  int getConstrByName(const std::string& name) const;
-
+  using ILPSolver::getVarVal;
   double getVarVal(int colId) const;
-  double getVarVal(const std::string& name) const;
-
-  void setObjCoef(const std::string& name, double coef) const;
-  void setObjCoef(int colId, double coef) const;
 
   SolveType solve();
   SolveType getStatus() { return _status; }
-  void update();
 
   double getObjVal() const;
 
-  int getNumConstrs() const;
-  int getNumVars() const;
-
   void setTimeLim(int s);
   int getTimeLim() const;
 
@@ -65,7 +46,6 @@ class COINSolver : public ILPSolver {
   void setNumThreads(int n);
   int getNumThreads() const;
 
-  void setStarter(const StarterSol& starterSol);
   void writeMps(const std::string& path) const;
 
   double* getStarterArr() const;
@@ -81,9 +61,12 @@ class COINSolver : public ILPSolver {
 
   OsiClpSolverInterface _solver1;
   OsiSolverInterface* _solver;
-  mutable CoinModel _model;
   CbcModel _cbcModel;
-CoinMessageHandler _msgHandler;
+  CoinMessageHandler _msgHandler;
+
+  DirType _dir;
+
+  void load(OsiSolverInterface* solver) const;
 };
 
 }  // namespace optim
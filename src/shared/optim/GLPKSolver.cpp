@@ -6,8 +6,10 @@
 
 #include <glpk.h>
 #include <cassert>
+#include <limits>
 #include <sstream>
 #include <stdexcept>
+#include <vector>
 #include "shared/optim/GLPKSolver.h"
 #include "util/Misc.h"
 #include "util/String.h"
@@ -15,11 +17,11 @@
 
 using shared::optim::GLPKSolver;
 using shared::optim::SolveType;
-using shared::optim::VariableMatrix;
 
 // _____________________________________________________________________________
 GLPKSolver::GLPKSolver(DirType dir)
-    : _starterArr(0),
+    : _dir(dir),
+      _starterArr(0),
       _status(INF),
       _timeLimit(std::numeric_limits<int>::max()) {
   const char* ver = glp_version();
@@ -29,15 +31,6 @@ GLPKSolver::GLPKSolver(DirType dir)
   glp_error_hook(errorHook, this);
 
   _prob = glp_create_prob();
-
-  glp_set_prob_name(_prob, "loom_mip");
-
-  if (dir == MAX)
-    glp_set_obj_dir(_prob, GLP_MAX);
-  else
-    glp_set_obj_dir(_prob, GLP_MIN);
-
-  glp_create_index(_prob);
 }
 
 // _____________________________________________________________________________
@@ -47,126 +40,22 @@ GLPKSolver::~GLPKSolver() {
   if (_starterArr) delete[] _starterArr;
 }
 
-// _____________________________________________________________________________
-int GLPKSolver::addCol(const std::string& name, ColType colType,
-                       double objCoef) {
-  int vtype = 0;
-  switch (colType) {
-    case INT:
-      vtype = GLP_IV;
-      break;
-    case BIN:
-      vtype = GLP_BV;
-      break;
-    case CONT:
-      vtype = GLP_CV;
-      break;
-  }
-
-  int col = glp_add_cols(_prob, 1);
-  glp_set_col_name(_prob, col, name.c_str());
-  glp_set_col_kind(_prob, col, vtype);
-  glp_set_obj_coef(_prob, col, objCoef);
-
-  return col - 1;
-}
-
-// _____________________________________________________________________________
-int GLPKSolver::addCol(const std::string& name, ColType colType, double objCoef,
-                       double lowBnd, double upBnd) {
-  int rtype = 0;
-  if (lowBnd <= -std::numeric_limits<double>::max() &&
-      upBnd >= std::numeric_limits<double>::max()) {
-    rtype = GLP_FR;
-  } else if (lowBnd <= -std::numeric_limits<double>::max()) {
-    rtype = GLP_UP;
-  } else if (upBnd >= std::numeric_limits<double>::max()) {
-    rtype = GLP_LO;
-  } else if (lowBnd == upBnd) {
-    rtype = GLP_FX;
-  } else {
-    rtype = GLP_DB;
-  }
-
-  int col = addCol(name, colType, objCoef);
-  glp_set_col_bnds(_prob, col + 1, rtype, lowBnd, upBnd);
-
-  return col;
-}
-
-// _____________________________________________________________________________
-int GLPKSolver::addRow(const std::string& name, double bnd, RowType rowType) {
-  int rtype = 0;
-  switch (rowType) {
-    case FIX:
-      rtype = GLP_FX;
-      break;
-    case UP:
-      rtype = GLP_UP;
-      break;
-    case LO:
-      rtype = GLP_LO;
-      break;
-  }
-
-  int row = glp_add_rows(_prob, 1);
-  assert(row);
-  glp_set_row_name(_prob, row, name.c_str());
-  glp_set_row_bnds(_prob, row, rtype, bnd, bnd);
-
-  return row - 1;
-}
-
-// _____________________________________________________________________________
-void GLPKSolver::addColToRow(const std::string& rowName,
-                             const std::string& colName, double coef) {
-  int col = getVarByName(colName);
-  if (col < 0) {
-    LOGTO(ERROR, std::cerr) << "Could not find variable " << colName;
-  }
-  int row = getConstrByName(rowName);
-  if (row < 0) {
-    LOGTO(ERROR, std::cerr) << "Could not find constraint " << rowName;
-  }
-
-  addColToRow(col, row, coef);
-}
-
-// _____________________________________________________________________________
-int GLPKSolver::getVarByName(const std::string& name) const {
-  int ret = glp_find_col(_prob, name.c_str());
-  if (!ret) return -1;
-  return ret - 1;
-}
-
-// _____________________________________________________________________________
-int GLPKSolver::getConstrByName(const std::string& name) const {
-  int ret = glp_find_row(_prob, name.c_str());
-  if (!ret) return -1;
-  return ret - 1;
-}
-
-// _____________________________________________________________________________
-void GLPKSolver::addColToRow(int rowId, int colId, double coef) {
-  _vm.addVar(rowId + 1, colId + 1, coef);
-}
-
 // _____________________________________________________________________________
 double GLPKSolver::getObjVal() const { return glp_mip_obj_val(_prob); }
 
 // _____________________________________________________________________________
 SolveType GLPKSolver::solve() {
-  update();
-  int* ia = 0;
-  int* ja = 0;
-  double* res = 0;
-  _vm.getGLPKArrs(&ia, &ja, &res);
+  load(_prob);
 
-  glp_load_matrix(_prob, _vm.getNumVars(), ia, ja, res);
+  if (_starterArr) delete[] _starterArr;
+  _starterArr = 0;
 
-  delete[](ia);
-  delete[](ja);
-  delete[](res);
+  if (getStarter().size()) {
+    _starterArr = new double[getNumVars() + 1]();
+    for (const auto& varVal : getStarter()) {
+      _starterArr[varVal.first + 1] = varVal.second;
+    }
+  }
 
   glp_iocp params;
   glp_smcp sparams;
@@ -272,90 +161,75 @@ double GLPKSolver::getVarVal(int colId) const {
 }
 
 // _____________________________________________________________________________
-double GLPKSolver::getVarVal(const std::string& colName) const {
-  int col = getVarByName(colName);
-  if (col < 0) {
-    LOGTO(ERROR, std::cerr) << "Could not find variable " << colName;
-  }
-
-  return getVarVal(col);
-}
+void GLPKSolver::load(glp_prob* prob) const {
+  // the problem is rebuilt from the model in bulk on each call
+  glp_erase_prob(prob);
+  glp_set_prob_name(prob, "loom_mip");
+  glp_set_obj_dir(prob, _dir == MAX ? GLP_MAX : GLP_MIN);
+
+  const auto& cols = getCols();
+  const auto& rows = getRows();
+  const double inf = std::numeric_limits<double>::max();
+
+  if (cols.size()) glp_add_cols(prob, cols.size());
+  if (rows.size()) glp_add_rows(prob, rows.size());
+
+  for (size_t i = 0; i < cols.size(); i++) {
+    const auto& c = cols[i];
+    int kind = c.type == INT ? GLP_IV : (c.type == BIN ? GLP_BV : GLP_CV);
+    glp_set_col_kind(prob, i + 1, kind);
+    glp_set_obj_coef(prob, i + 1, c.objCoef);
+
+    // glp_set_col_kind already sets the bounds of binary columns
+    if (c.type != BIN) {
+      int btype = GLP_DB;
+      if (c.lowBnd <= -inf && c.upBnd >= inf)
+        btype = GLP_FR;
+      else if (c.lowBnd <= -inf)
+        btype = GLP_UP;
+      else if (c.upBnd >= inf)
+        btype = GLP_LO;
+      else if (c.lowBnd == c.upBnd)
+        btype = GLP_FX;
+      glp_set_col_bnds(prob, i + 1, btype, c.lowBnd, c.upBnd);
+    }
 
-// _____________________________________________________________________________
-void GLPKSolver::setObjCoef(const std::string& colName, double coef) const {
-  int col = getVarByName(colName);
-  if (col < 0) {
-    LOGTO(ERROR, std::cerr) << "Could not find variable " << colName;
+    if (isNamed()) glp_set_col_name(prob, i + 1, getColName(i).c_str());
   }
 
-  setObjCoef(col, coef);
-}
-
-// _____________________________________________________________________________
-void GLPKSolver::setObjCoef(int colId, double coef) const {
-  glp_set_obj_coef(_prob, colId + 1, coef);
-}
-
-// _____________________________________________________________________________
-void GLPKSolver::update() { glp_create_index(_prob); }
-
-// _____________________________________________________________________________
-int GLPKSolver::getNumConstrs() const { return glp_get_num_rows(_prob); }
-
-// _____________________________________________________________________________
-int GLPKSolver::getNumVars() const { return glp_get_num_cols(_prob); }
-
-// _____________________________________________________________________________
-void GLPKSolver::setStarter(const StarterSol& starterSol) {
-  _starterArr = new double[getNumVars() + 1];
-
-  size_t a = 0;
-
-  for (const auto& varVal : starterSol) {
-    int colId = getVarByName(varVal.first);
-    if (colId < 0) continue;
-    _starterArr[colId + 1] = varVal.second;
-    a++;
+  for (size_t i = 0; i < rows.size(); i++) {
+    const auto& r = rows[i];
+    int btype = r.type == FIX ? GLP_FX : (r.type == UP ? GLP_UP : GLP_LO);
+    glp_set_row_bnds(prob, i + 1, btype, r.bnd, r.bnd);
+    if (isNamed()) glp_set_row_name(prob, i + 1, getRowName(i).c_str());
   }
-}
 
-// _____________________________________________________________________________
-void VariableMatrix::addVar(int row, int col, double val) {
-  rowNum.push_back(row);
-  colNum.push_back(col);
-  vals.push_back(val);
-}
-
-// _____________________________________________________________________________
-void VariableMatrix::getGLPKArrs(int** ia, int** ja, double** r) const {
-  assert(rowNum.size() == colNum.size());
-  assert(colNum.size() == vals.size());
-
-  *ia = new int[rowNum.size() + 1];
-  *ja = new int[rowNum.size() + 1];
-  *r = new double[rowNum.size() + 1];
+  std::vector<int> rowBeg, colInd;
+  std::vector<double> vals;
+  getCSR(&rowBeg, &colInd, &vals);
 
   // glpk arrays always start at 1 for some reason
-  for (size_t i = 1; i <= rowNum.size(); ++i) {
-    (*ia)[i] = rowNum[i - 1];
-    (*ja)[i] = colNum[i - 1];
-    (*r)[i] = vals[i - 1];
+  std::vector<int> ia(vals.size() + 1), ja(vals.size() + 1);
+  std::vector<double> ar(vals.size() + 1);
+
+  for (size_t r = 0; r < rows.size(); r++) {
+    for (int i = rowBeg[r]; i < rowBeg[r + 1]; i++) {
+      ia[i + 1] = r + 1;
+      ja[i + 1] = colInd[i] + 1;
+      ar[i + 1] = vals[i];
+    }
   }
+
+  glp_load_matrix(prob, vals.size(), ia.data(), ja.data(), ar.data());
 }
 
 // _____________________________________________________________________________
 void GLPKSolver::writeMps(const std::string& path) const {
-  int* ia = 0;
-  int* ja = 0;
-  double* res = 0;
-  _vm.getGLPKArrs(&ia, &ja, &res);
-
-  glp_load_matrix(_prob, _vm.getNumVars(), ia, ja, res);
-  glp_write_mps(_prob, GLP_MPS_FILE, 0, path.c_str());
-
-  delete[](ia);
-  delete[](ja);
-  delete[](res);
+  // write a copy of the model, the solver's problem is left untouched
+  glp_prob* prob = glp_create_prob();
+  load(prob);
+  glp_write_mps(prob, GLP_MPS_FILE, 0, path.c_str());
+  glp_delete_prob(prob);
 }
 
 #endif
@@ -8,55 +8,25 @@
 #ifdef GLPK_FOUND
 
 #include <glpk.h>
-#include <vector>
 #include "shared/optim/ILPSolver.h"
 #include "util/Misc.h"
 
 namespace shared {
 namespace optim {
 
-struct VariableMatrix {
-  std::vector<int> rowNum;
-  std::vector<int> colNum;
-  std::vector<double> vals;
-
-  void addVar(int row, int col, double val);
-  void getGLPKArrs(int** ia, int** ja, double** r) const;
-  size_t getNumVars() const { return vals.size(); }
-};
-
 class GLPKSolver : public ILPSolver {
  public:
   GLPKSolver(DirType dir);
   ~GLPKSolver();
 
-  int addCol(const std::string& name, ColType colType, double objCoef);
-  int addCol(const std::string& name, ColType colType, double objCoef,
-             double lowBnd, double upBnd);
-  int addRow(const std::string& name, double bnd, RowType rowType);
-
-  void addColToRow(const std::string& rowName, const std::string& colName,
-                   double coef);
-  void addColToRow(int rowId, int colId, double coef);
-
-  int getVarByName(const std::string& name) const;
-  int getConstrByName(const std::string& name) const;
-
+  using ILPSolver::getVarVal;
   double getVarVal(int colId) const;
-  double getVarVal(const std::string& name) const;
-
-  void setObjCoef(const std::string& name, double coef) const;
-  void setObjCoef(int colId, double coef) const;
 
   SolveType solve();
   SolveType getStatus() { return _status; }
-  void update();
 
   double getObjVal() const;
 
-  int getNumConstrs() const;
-  int getNumVars() const;
-
   void setNumThreads(int n){UNUSED(n);};
   int getNumThreads() const {return 0;};
 
@@ -69,14 +39,13 @@ class GLPKSolver : public ILPSolver {
   void setCacheThreshold(double gb);
   double getCacheThreshold() const;
 
-  void setStarter(const StarterSol& starterSol);
   void writeMps(const std::string& path) const;
 
   double* getStarterArr() const;
 
  private:
+  DirType _dir;
   glp_prob* _prob;
-  VariableMatrix _vm;
 
   double* _starterArr;
 
@@ -86,6 +55,9 @@ class GLPKSolver : public ILPSolver {
 
   std::string _termBuf;
 
+  // build the model into prob
+  void load(glp_prob* prob) const;
+
   static void optCb(glp_tree* tree, void* solver);
   static int termHook(void* info, const char* str);
   static void errorHook(void* info);
@@ -4,8 +4,12 @@
 
 #ifdef GUROBI_FOUND
 
+#include <algorithm>
+#include <limits>
 #include <sstream>
 #include <stdexcept>
+#include <string>
+#include <vector>
 #include "gurobi_c.h"
 #include "shared/optim/GurobiSolver.h"
 #include "util/Misc.h"
@@ -17,7 +21,7 @@ using shared::optim::SolveType;
 
 // _____________________________________________________________________________
 GurobiSolver::GurobiSolver(DirType dir)
-    : _starterArr(0), _status(INF), _numVars(0), _numRows(0) {
+    : _status(INF), _numVars(0), _numRows(0) {
   int verMaj, verMin, verTech;
   GRBversion(&verMaj, &verMin, &verTech);
   LOGTO(INFO, std::cerr) << "Creating gurobi v" << verMaj << "." << verMin
@@ -67,105 +71,6 @@ GurobiSolver::GurobiSolver(DirType dir)
 GurobiSolver::~GurobiSolver() {
   GRBfreemodel(_model);
   GRBfreeenv(_env);
-  if (_starterArr) delete[] _starterArr;
-}
-
-// _____________________________________________________________________________
-int GurobiSolver::addCol(const std::string& name, ColType colType,
-                         double objCoef) {
-  return addCol(name, colType, objCoef, -GRB_INFINITY, GRB_INFINITY);
-}
-
-// _____________________________________________________________________________
-int GurobiSolver::addCol(const std::string& name, ColType colType,
-                         double objCoef, double lowBnd, double upBnd) {
-  char vtype = 0;
-  switch (colType) {
-    case INT:
-      vtype = GRB_INTEGER;
-      break;
-    case BIN:
-      vtype = GRB_BINARY;
-      break;
-    case CONT:
-      vtype = GRB_CONTINUOUS;
-      break;
-  }
-  int error =
-      GRBaddvar(_model, 0, 0, 0, objCoef, lowBnd, upBnd, vtype, name.c_str());
-  if (error) {
-    throw std::runtime_error("Could not add variable " + name);
-  }
-  _numVars++;
-  return _numVars - 1;
-}
-
-// _____________________________________________________________________________
-int GurobiSolver::addRow(const std::string& name, double bnd, RowType rowType) {
-  char rtype = 0;
-  switch (rowType) {
-    case FIX:
-      rtype = GRB_EQUAL;
-      break;
-    case UP:
-      rtype = GRB_LESS_EQUAL;
-      break;
-    case LO:
-      rtype = GRB_GREATER_EQUAL;
-      break;
-  }
-  int error = GRBaddconstr(_model, 0, 0, 0, rtype, bnd, name.c_str());
-  if (error) {
-    throw std::runtime_error("Could not add row " + name);
-  }
-
-  _numRows++;
-  return _numRows - 1;
-}
-
-// _____________________________________________________________________________
-void GurobiSolver::addColToRow(const std::string& rowName,
-                               const std::string& colName, double coef) {
-  int col = getVarByName(colName);
-  if (col < 0) {
-    LOGTO(ERROR, std::cerr) << "Could not find variable " << colName;
-  }
-  int row = getConstrByName(rowName);
-  if (row < 0) {
-    LOGTO(ERROR, std::cerr) << "Could not find constraint " << rowName;
-  }
-
-  addColToRow(col, row, coef);
-}
-
-// _____________________________________________________________________________
-int GurobiSolver::getVarByName(const std::string& name) const {
-  int ret;
-  int error = GRBgetvarbyname(_model, name.c_str(), &ret);
-  if (error) return -1;
-  return ret;
-}
-
-// _____________________________________________________________________________
-int GurobiSolver::getConstrByName(const std::string& name) const {
-  int ret;
-  int error = GRBgetconstrbyname(_model, name.c_str(), &ret);
-  if (error) return -1;
-  return ret;
-}
-
-// _____________________________________________________________________________
-void GurobiSolver::addColToRow(int rowId, int colId, double coef) {
-  int col = colId;
-  int row = rowId;
-
-  int error = GRBchgcoeffs(_model, 1, &row, &col, &coef);
-  if (error) {
-    std::stringstream ss;
-    ss << "Could not add col " << colId << " to row " << rowId << " (" << error
-       << ")";
-    throw std::runtime_error(ss.str());
-  }
 }
 
 // _____________________________________________________________________________
@@ -181,26 +86,17 @@ double GurobiSolver::getObjVal() const {
   return objVal;
 }
 
-// _____________________________________________________________________________
-void GurobiSolver::setStarter(const StarterSol& starterSol) {
-  _starterArr = new double[getNumVars()];
-  std::fill_n(_starterArr, getNumVars(), GRB_UNDEFINED);
-
-  for (const auto& varVal : starterSol) {
-    int colId = getVarByName(varVal.first);
-    if (colId < 0) continue;
-    _starterArr[colId] = varVal.second;
-  }
-}
-
 // _____________________________________________________________________________
 SolveType GurobiSolver::solve() {
-  update();
+  load();
 
   int error;
 
-  if (_starterArr) {
-    error = GRBsetdblattrarray(_model, "Start", 0, getNumVars(), _starterArr);
+  if (getStarter().size()) {
+    std::vector<double> start(getNumVars(), GRB_UNDEFINED);
+    for (const auto& varVal : getStarter()) start[varVal.first] = varVal.second;
+
+    error = GRBsetdblattrarray(_model, "Start", 0, getNumVars(), start.data());
     if (error) {
       throw std::runtime_error("Could not set start solution");
     }
@@ -362,52 +258,87 @@ double GurobiSolver::getVarVal(int colId) const {
 }
 
 // _____________________________________________________________________________
-double GurobiSolver::getVarVal(const std::string& colName) const {
-  int col = getVarByName(colName);
-  if (col < 0) {
-    LOGTO(ERROR, std::cerr) << "Could not find variable " << colName;
-  }
+void GurobiSolver::writeMps(const std::string& path) const {
+  load();
 
-  return getVarVal(col);
+  int error = GRBwrite(_model, path.c_str());
+  if (error) {
+    std::stringstream ss;
+    ss << "Could not write to " << path;
+    throw std::runtime_error(ss.str());
+  }
 }
 
 // _____________________________________________________________________________
-void GurobiSolver::setObjCoef(const std::string& colName, double coef) const {
-  int col = getVarByName(colName);
-  if (col < 0) {
-    LOGTO(ERROR, std::cerr) << "Could not find variable " << colName;
+void GurobiSolver::load() const {
+  // the model is rebuilt from scratch in bulk, parameters set on the model
+  // environment are kept
+  if (_numVars || _numRows) {
+    std::vector<int> ind(std::max(_numVars, _numRows));
+    for (size_t i = 0; i < ind.size(); i++) ind[i] = i;
+    GRBdelconstrs(_model, _numRows, ind.data());
+    GRBdelvars(_model, _numVars, ind.data());
+    GRBupdatemodel(_model);
   }
 
-  setObjCoef(col, coef);
-}
+  const auto& cols = getCols();
+  const auto& rows = getRows();
+  const double inf = std::numeric_limits<double>::max();
 
-// _____________________________________________________________________________
-void GurobiSolver::setObjCoef(int colId, double coef) const {
-  int error = GRBsetdblattrelement(_model, GRB_DBL_ATTR_OBJ, colId, coef);
-  if (error) {
-    std::stringstream ss;
-    ss << "Could not change objective value for col " << colId;
-    throw std::runtime_error(ss.str());
+  std::vector<double> obj(cols.size()), lb(cols.size()), ub(cols.size());
+  std::vector<char> vtype(cols.size());
+
+  for (size_t i = 0; i < cols.size(); i++) {
+    obj[i] = cols[i].objCoef;
+    lb[i] = cols[i].lowBnd <= -inf ? -GRB_INFINITY : cols[i].lowBnd;
+    ub[i] = cols[i].upBnd >= inf ? GRB_INFINITY : cols[i].upBnd;
+    vtype[i] = cols[i].type == INT
+                   ? GRB_INTEGER
+                   : (cols[i].type == BIN ? GRB_BINARY : GRB_CONTINUOUS);
   }
-}
 
-// _____________________________________________________________________________
-void GurobiSolver::update() { GRBupdatemodel(_model); }
+  std::vector<char> sense(rows.size());
+  std::vector<double> rhs(rows.size());
 
-// _____________________________________________________________________________
-int GurobiSolver::getNumConstrs() const { return _numRows; }
+  for (size_t i = 0; i < rows.size(); i++) {
+    rhs[i] = rows[i].bnd;
+    sense[i] = rows[i].type == FIX
+                   ? GRB_EQUAL
+                   : (rows[i].type == UP ? GRB_LESS_EQUAL : GRB_GREATER_EQUAL);
+  }
 
-// _____________________________________________________________________________
-int GurobiSolver::getNumVars() const { return _numVars; }
+  std::vector<std::string> colNames, rowNames;
+  std::vector<char*> colNamesC, rowNamesC;
 
-// _____________________________________________________________________________
-void GurobiSolver::writeMps(const std::string& path) const {
-  int error = GRBwrite(_model, path.c_str());
+  if (isNamed()) {
+    for (size_t i = 0; i < cols.size(); i++) colNames.push_back(getColName(i));
+    for (size_t i = 0; i < rows.size(); i++) rowNames.push_back(getRowName(i));
+    for (auto& n : colNames) colNamesC.push_back(&n[0]);
+    for (auto& n : rowNames) rowNamesC.push_back(&n[0]);
+  }
+
+  int error = GRBaddvars(_model, cols.size(), 0, 0, 0, 0, obj.data(),
+                         lb.data(), ub.data(), vtype.data(),
+                         colNamesC.size() ? colNamesC.data() : 0);
   if (error) {
-    std::stringstream ss;
-    ss << "Could not write to " << path;
-    throw std::runtime_error(ss.str());
+    throw std::runtime_error("Could not add variables");
   }
+
+  std::vector<int> rowBeg, colInd;
+  std::vector<double> vals;
+  getCSR(&rowBeg, &colInd, &vals);
+
+  error = GRBaddconstrs(_model, rows.size(), vals.size(), rowBeg.data(),
+                        colInd.data(), vals.data(), sense.data(), rhs.data(),
+                        rowNamesC.size() ? rowNamesC.data() : 0);
+  if (error) {
+    throw std::runtime_error("Could not add constraints");
+  }
+
+  GRBupdatemodel(_model);
+
+  _numVars = cols.size();
+  _numRows = rows.size();
 }
 
 // _____________________________________________________________________________
@@ -18,33 +18,14 @@ class GurobiSolver : public ILPSolver {
   GurobiSolver(DirType dir);
   ~GurobiSolver();
 
-  int addCol(const std::string& name, ColType colType, double objCoef);
-  int addCol(const std::string& name, ColType colType, double objCoef,
-             double lowBnd, double upBnd);
-  int addRow(const std::string& name, double bnd, RowType rowType);
-
-  void addColToRow(const std::string& rowName, const std::string& colName,
-                   double coef);
-  void addColToRow(int rowId, int colId, double coef);
-
-  int getVarByName(const std::string& name) const;
-  int getConstrByName(const std::string& name) const;
-
+  using ILPSolver::getVarVal;
   double getVarVal(int colId) const;
-  double getVarVal(const std::string& name) const;
-
-  void setObjCoef(const std::string& name, double coef) const;
-  void setObjCoef(int colId, double coef) const;
 
   SolveType solve();
   SolveType getStatus() { return _status; }
-  void update();
 
   double getObjVal() const;
 
-  int getNumConstrs() const;
-  int getNumVars() const;
-
   void setTimeLim(int ms);
   int getTimeLim() const;
 
@@ -59,20 +40,18 @@ class GurobiSolver : public ILPSolver {
 
   void writeMps(const std::string& path) const;
 
-  void setStarter(const StarterSol& starterSol);
-
  private:
   GRBenv* _env;
   GRBmodel* _model;
 
-  double* _starterArr;
-  StarterSol murr;
-
   SolveType _status;
 
-  int _numVars, _numRows;
+  // number of columns and rows currently loaded into _model
+  mutable int _numVars, _numRows;
   std::string _logBuffer;
 
+  void load() const;
+
   static int termHook(GRBmodel* mod, void* cbdata, int where, void* solver);
 };
 
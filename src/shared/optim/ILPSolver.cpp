@@ -0,0 +1,338 @@
+// Copyright 2016, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+// Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
+
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include "shared/optim/ILPSolver.h"
+
+using shared::optim::ColType;
+using shared::optim::ILPRowBuffer;
+using shared::optim::ILPSolver;
+using shared::optim::RowType;
+using shared::optim::StarterSol;
+
+// _____________________________________________________________________________
+int ILPRowBuffer::addRow(double bnd, RowType rowType) {
+  _rows.push_back({rowType, bnd});
+  return _rows.size() - 1;
+}
+
+// _____________________________________________________________________________
+int ILPRowBuffer::addRow(const std::string& name, double bnd,
+                         RowType rowType) {
+  int row = addRow(bnd, rowType);
+  _rowNames.resize(_rows.size());
+  _rowNames[row] = name;
+  return row;
+}
+
+// _____________________________________________________________________________
+void ILPRowBuffer::addColToRow(int rowId, int colId, double coef) {
+  assert(rowId >= 0 && static_cast<size_t>(rowId) < _rows.size());
+  _coefRows.push_back(rowId);
+  _coefCols.push_back(colId);
+  _coefVals.push_back(coef);
+}
+
+// _____________________________________________________________________________
+int ILPSolver::addCol(ColType colType, double objCoef) {
+  if (colType == BIN) return addCol(colType, objCoef, 0, 1);
+  return addCol(colType, objCoef, -std::numeric_limits<double>::max(),
+                std::numeric_limits<double>::max());
+}
+
+// _____________________________________________________________________________
+int ILPSolver::addCol(ColType colType, double objCoef, double lowBnd,
+                      double upBnd) {
+  _cols.push_back({colType, objCoef, lowBnd, upBnd});
+  return _cols.size() - 1;
+}
+
+// _____________________________________________________________________________
+int ILPSolver::addRow(double bnd, RowType rowType) {
+  _rows.push_back({rowType, bnd});
+  return _rows.size() - 1;
+}
+
+// _____________________________________________________________________________
+void ILPSolver::addColToRow(int rowId, int colId, double coef) {
+  assert(rowId >= 0 && rowId < getNumConstrs());
+  assert(colId >= 0 && colId < getNumVars());
+  _coefRows.push_back(rowId);
+  _coefCols.push_back(colId);
+  _coefVals.push_back(coef);
+}
+
+// _____________________________________________________________________________
+void ILPSolver::addColsToRow(int rowId, const std::vector<int>& colIds,
+                             const std::vector<double>& coefs) {
+  assert(colIds.size() == coefs.size());
+  _coefRows.insert(_coefRows.end(), colIds.size(), rowId);
+  _coefCols.insert(_coefCols.end(), colIds.begin(), colIds.end());
+  _coefVals.insert(_coefVals.end(), coefs.begin(), coefs.end());
+}
+
+// _____________________________________________________________________________
+void ILPSolver::setObjCoef(int colId, double coef) {
+  _cols[colId].objCoef = coef;
+}
+
+// _____________________________________________________________________________
+int ILPSolver::addRows(const ILPRowBuffer& buf) {
+  int off = _rows.size();
+  _rows.insert(_rows.end(), buf._rows.begin(), buf._rows.end());
+
+  _coefRows.reserve(_coefRows.size() + buf._coefRows.size());
+  for (auto r : buf._coefRows) _coefRows.push_back(off + r);
+  _coefCols.insert(_coefCols.end(), buf._coefCols.begin(),
+                   buf._coefCols.end());
+  _coefVals.insert(_coefVals.end(), buf._coefVals.begin(),
+                   buf._coefVals.end());
+
+  for (size_t i = 0; i < buf._rowNames.size(); i++) {
+    if (buf._rowNames[i].size()) setRowName(off + i, buf._rowNames[i]);
+  }
+
+  return off;
+}
+
+// _____________________________________________________________________________
+int ILPSolver::addCol(const std::string& name, ColType colType,
+                      double objCoef) {
+  int col = addCol(colType, objCoef);
+  setColName(col, name);
+  return col;
+}
+
+// _____________________________________________________________________________
+int ILPSolver::addCol(const std::string& name, ColType colType, double objCoef,
+                      double lowBnd, double upBnd) {
+  int col = addCol(colType, objCoef, lowBnd, upBnd);
+  setColName(col, name);
+  return col;
+}
+
+// _____________________________________________________________________________
+int ILPSolver::addRow(const std::string& name, double bnd, RowType rowType) {
+  int row = addRow(bnd, rowType);
+  setRowName(row, name);
+  return row;
+}
+
+// _____________________________________________________________________________
+void ILPSolver::setColName(int colId, const std::string& name) {
+  if (_colNames.size() <= static_cast<size_t>(colId))
+    _colNames.resize(colId + 1);
+  _colNames[colId] = name;
+  _colIdx[name] = colId;
+}
+
+// _____________________________________________________________________________
+void ILPSolver::setRowName(int rowId, const std::string& name) {
+  if (_rowNames.size() <= static_cast<size_t>(rowId))
+    _rowNames.resize(rowId + 1);
+  _rowNames[rowId] = name;
+  _rowIdx[name] = rowId;
+}
+
+// _____________________________________________________________________________
+std::string ILPSolver::getColName(int colId) const {
+  if (static_cast<size_t>(colId) < _colNames.size() &&
+      _colNames[colId].size())
+    return _colNames[colId];
+  return "c" + std::to_string(colId);
+}
+
+// _____________________________________________________________________________
+std::string ILPSolver::getRowName(int rowId) const {
+  if (static_cast<size_t>(rowId) < _rowNames.size() &&
+      _rowNames[rowId].size())
+    return _rowNames[rowId];
+  return "r" + std::to_string(rowId);
+}
+
+// _____________________________________________________________________________
+int ILPSolver::getVarByName(const std::string& name) const {
+  auto i = _colIdx.find(name);
+  if (i == _colIdx.end()) return -1;
+  return i->second;
+}
+
+// _____________________________________________________________________________
+int ILPSolver::getConstrByName(const std::string& name) const {
+  auto i = _rowIdx.find(name);
+  if (i == _rowIdx.end()) return -1;
+  return i->second;
+}
+
+// _____________________________________________________________________________
+void ILPSolver::setObjCoef(const std::string& name, double coef) {
+  int col = getVarByName(name);
+  if (col < 0) throw std::runtime_error("Could not find variable " + name);
+  setObjCoef(col, coef);
+}
+
+// _____________________________________________________________________________
+double ILPSolver::getVarVal(const std::string& name) const {
+  int col = getVarByName(name);
+  if (col < 0) throw std::runtime_error("Could not find variable " + name);
+  return getVarVal(col);
+}
+
+// _____________________________________________________________________________
+void ILPSolver::getCSR(std::vector<int>* rowBeg, std::vector<int>* colInd,
+                       std::vector<double>* vals) const {
+  rowBeg->assign(_rows.size() + 1, 0);
+  colInd->resize(_coefVals.size());
+  vals->resize(_coefVals.size());
+
+  // counting sort of the triplets by row
+  for (auto r : _coefRows) (*rowBeg)[r + 1]++;
+  for (size_t i = 1; i < rowBeg->size(); i++) (*rowBeg)[i] += (*rowBeg)[i - 1];
+
+  std::vector<int> next(rowBeg->begin(), rowBeg->end() - 1);
+  for (size_t i = 0; i < _coefVals.size(); i++) {
+    int p = next[_coefRows[i]]++;
+    (*colInd)[p] = _coefCols[i];
+    (*vals)[p] = _coefVals[i];
+  }
+
+  // sum up duplicate entries in each row, pos holds the position of a column
+  // in the current row, stamped with the row it was written for
+  std::vector<std::pair<int, int>> pos(_cols.size(), {-1, 0});
+  int w = 0;
+  for (size_t r = 0; r < _rows.size(); r++) {
+    int beg = (*rowBeg)[r];
+    int end = (*rowBeg)[r + 1];
+    (*rowBeg)[r] = w;
+    for (int i = beg; i < end; i++) {
+      int col = (*colInd)[i];
+      if (pos[col].first == static_cast<int>(r)) {
+        (*vals)[pos[col].second] += (*vals)[i];
+      } else {
+        pos[col] = std::make_pair(static_cast<int>(r), w);
+        (*colInd)[w] = col;
+        (*vals)[w] = (*vals)[i];
+        w++;
+      }
+    }
+  }
+
+  (*rowBeg)[_rows.size()] = w;
+  colInd->resize(w);
+  vals->resize(w);
+}
+
+// _____________________________________________________________________________
+StarterSol ILPSolver::completeStarter(const StarterSol& sol) const {
+  std::vector<int> rowBeg, colInd;
+  std::vector<double> vals;
+  getCSR(&rowBeg, &colInd, &vals);
+
+  double inf = std::numeric_limits<double>::infinity();
+
+  // the smallest value of a column, 0 for columns without a lower bound
+  auto minVal = [this](int col) {
+    double lb = _cols[col].lowBnd;
+    return lb > -std::numeric_limits<double>::max() ? lb : 0;
+  };
+
+  std::vector<double> val(_cols.size(), 0);
+  std::vector<bool> known(_cols.size(), false);
+  for (const auto& kv : sol) {
+    val[kv.first] = kv.second;
+    known[kv.first] = true;
+  }
+
+  std::vector<double> lowBnd(_cols.size(), -inf);
+  std::vector<double> fixed(_cols.size(), inf);
+  std::vector<int> pending;
+
+  while (true) {
+    for (size_t r = 0; r < _rows.size(); r++) {
+      int unset = -1;
+      double coef = 0;
+      double act = 0;
+      bool single = true;
+
+      for (int i = rowBeg[r]; i < rowBeg[r + 1]; i++) {
+        int col = colInd[i];
+        if (known[col]) {
+          act += vals[i] * val[col];
+        } else if (unset == -1) {
+          unset = col;
+          coef = vals[i];
+        } else {
+          single = false;
+          break;
+        }
+      }
+
+      if (!single || unset == -1 || coef == 0) continue;
+
+      // coef * x + act {=,<=,>=} bnd
+      double x = (_rows[r].bnd - act) / coef;
+
+      if (lowBnd[unset] == -inf && fixed[unset] == inf)
+        pending.push_back(unset);
+
+      if (_rows[r].type == FIX) {
+        fixed[unset] = x;
+      } else if ((_rows[r].type == UP) == (coef < 0)) {
+        lowBnd[unset] = std::max(lowBnd[unset], x);
+      } else {
+        // only an upper bound, the column's own lower bound is taken
+        lowBnd[unset] = std::max(lowBnd[unset], minVal(unset));
+      }
+    }
+
+    if (pending.empty()) break;
+
+    for (int col : pending) {
+      double x = fixed[col] != inf ? fixed[col] : lowBnd[col];
+      x = std::max(x, minVal(col));
+      if (_cols[col].type != CONT) x = std::ceil(x - 1e-6);
+      x = std::min(x, _cols[col].upBnd);
+      val[col] = x;
+      known[col] = true;
+      lowBnd[col] = -inf;
+      fixed[col] = inf;
+    }
+
+    pending.clear();
+  }
+
+  for (size_t col = 0; col < _cols.size(); col++) {
+    if (!known[col]) val[col] = minVal(col);
+  }
+
+  // the given values may contradict the rows, and a row may have been left
+  // with more than one unset column. solvers reject infeasible starting
+  // solutions or even misbehave on them, so none is returned in this case
+  const double EPS = 1e-6;
+
+  for (size_t col = 0; col < _cols.size(); col++) {
+    if (val[col] < _cols[col].lowBnd - EPS) return {};
+    if (val[col] > _cols[col].upBnd + EPS) return {};
+  }
+
+  for (size_t r = 0; r < _rows.size(); r++) {
+    double act = 0;
+    for (int i = rowBeg[r]; i < rowBeg[r + 1]; i++) {
+      act += vals[i] * val[colInd[i]];
+    }
+
+    if (_rows[r].type != LO && act > _rows[r].bnd + EPS) return {};
+    if (_rows[r].type != UP && act < _rows[r].bnd - EPS) return {};
+  }
+
+  StarterSol ret;
+  for (size_t col = 0; col < _cols.size(); col++) ret[col] = val[col];
+
+  return ret;
+}
@@ -8,6 +8,8 @@
 #include <fstream>
 #include <map>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace shared {
 namespace optim {
@@ -17,31 +19,122 @@ enum RowType { FIX, UP, LO };
 enum DirType { MAX, MIN };
 enum SolveType { OPTIM, INF, NON_OPTIM };
 
-typedef std::map<std::string, int> StarterSol;
+// starting solution, as column handle -> value
+typedef std::map<int, double> StarterSol;
 
+struct ILPCol {
+  ColType type;
+  double objCoef;
+  double lowBnd;
+  double upBnd;
+};
+
+struct ILPRow {
+  RowType type;
+  double bnd;
+};
+
+// Rows built independently of a solver, for example by a worker thread, to be
+// appended to it in bulk with ILPSolver::addRows(). Rows are numbered locally
+// from 0, columns are referenced by their solver handles.
+class ILPRowBuffer {
+ public:
+  explicit ILPRowBuffer(bool named) : _named(named) {}
+
+  int addRow(double bnd, RowType rowType);
+  int addRow(const std::string& name, double bnd, RowType rowType);
+  void addColToRow(int rowId, int colId, double coef);
+
+  bool isNamed() const { return _named; }
+  size_t size() const { return _rows.size(); }
+
+ private:
+  friend class ILPSolver;
+
+  bool _named;
+  std::vector<ILPRow> _rows;
+  std::vector<std::string> _rowNames;
+
+  std::vector<int> _coefRows;
+  std::vector<int> _coefCols;
+  std::vector<double> _coefVals;
+};
+
+// Base class for all ILP solver backends.
+//
+// The model is built solver-independently here, using integer handles for
+// columns and rows. Coefficients are collected as sparse (row, col, coef)
+// triplets and handed to the backend in bulk, in CSR form, when the model is
+// solved or written.
+//
+// Names are optional. They are only needed for MPS/MST output and for
+// lookups by name, model producers should only generate them if isNamed()
+// is true.
 class ILPSolver {
  public:
-  ILPSolver(){};
+  ILPSolver() : _named(false) {}
   virtual ~ILPSolver() = default;
 
-  virtual int addCol(const std::string& name, ColType colType,
-                     double objCoef) = 0;
-  virtual int addCol(const std::string& name, ColType colType, double objCoef,
-                     double lowBnd, double upBnd) = 0;
-  virtual int addRow(const std::string& name, double bnd, RowType rowType) = 0;
+  int addCol(ColType colType, double objCoef);
+  int addCol(ColType colType, double objCoef, double lowBnd, double upBnd);
+  int addRow(double bnd, RowType rowType);
+
+  void addColToRow(int rowId, int colId, double coef);
+  void addColsToRow(int rowId, const std::vector<int>& colIds,
+                    const std::vector<double>& coefs);
+
+  void setObjCoef(int colId, double coef);
+
+  // append all rows of buf, returns the handle of its first row
+  int addRows(const ILPRowBuffer& buf);
+
+  // named variants of the above
+  int addCol(const std::string& name, ColType colType, double objCoef);
+  int addCol(const std::string& name, ColType colType, double objCoef,
+             double lowBnd, double upBnd);
+  int addRow(const std::string& name, double bnd, RowType rowType);
 
-  virtual void addColToRow(const std::string& rowName,
-                           const std::string& colName, double coef) = 0;
-  virtual void addColToRow(int rowId, int colId, double coef) = 0;
+  void setNamed(bool named) { _named = named; }
+  bool isNamed() const { return _named; }
 
-  virtual int getVarByName(const std::string& name) const = 0;
-  virtual int getConstrByName(const std::string& name) const = 0;
+  void setColName(int colId, const std::string& name);
+  void setRowName(int rowId, const std::string& name);
 
-  virtual void setObjCoef(const std::string& name, double coef) const = 0;
-  virtual void setObjCoef(int colId, double coef) const = 0;
+  // the name of a column or row, a generic name is generated if none was set
+  std::string getColName(int colId) const;
+  std::string getRowName(int rowId) const;
+
+  int getVarByName(const std::string& name) const;
+  int getConstrByName(const std::string& name) const;
+
+  void setObjCoef(const std::string& name, double coef);
+  double getVarVal(const std::string& name) const;
+
+  int getNumConstrs() const { return _rows.size(); }
+  int getNumVars() const { return _cols.size(); }
+  size_t getNumNonZeros() const { return _coefVals.size(); }
+
+  // the constraint matrix in compressed sparse row form, with duplicate
+  // entries summed up. rowBeg has getNumConstrs() + 1 entries.
+  void getCSR(std::vector<int>* rowBeg, std::vector<int>* colInd,
+              std::vector<double>* vals) const;
+
+  const std::vector<ILPCol>& getCols() const { return _cols; }
+  const std::vector<ILPRow>& getRows() const { return _rows; }
+
+  // extend a starting solution for some columns to all columns: a column
+  // which is the single unset column of a row is set to the smallest value
+  // the row allows, until no such row is left. remaining columns are set to
+  // their lower bound (or 0). returns an empty solution if the completed
+  // solution violates a row or a column bound.
+  StarterSol completeStarter(const StarterSol& sol) const;
+
+  void setStarter(const StarterSol& starterSol) { _starter = starterSol; }
+  const StarterSol& getStarter() const { return _starter; }
+
+  // backend functions
 
   virtual double getVarVal(int colId) const = 0;
-  virtual double getVarVal(const std::string& name) const = 0;
 
   virtual void setTimeLim(int s) = 0;
   virtual int getTimeLim() const = 0;
@@ -57,22 +150,36 @@ class ILPSolver {
 
   virtual SolveType solve() = 0;
   virtual SolveType getStatus() = 0;
-  virtual void update() = 0;
+  virtual void update() {}
 
   virtual double getObjVal() const = 0;
 
-  virtual void setStarter(const StarterSol& starterSol) = 0;
-
-  virtual int getNumConstrs() const = 0;
-  virtual int getNumVars() const = 0;
-
   virtual void writeMps(const std::string& path) const = 0;
   void writeMst(const std::string& path, const StarterSol& sol) const {
     std::ofstream fo;
     fo.open(path);
 
-    for (auto kv : sol) fo << kv.first << "\t" << kv.second << "\n";
+    for (auto kv : sol) {
+      fo << getColName(kv.first) << "\t" << kv.second << "\n";
+    }
   }
+
+ private:
+  std::vector<ILPCol> _cols;
+  std::vector<ILPRow> _rows;
+
+  std::vector<int> _coefRows;
+  std::vector<int> _coefCols;
+  std::vector<double> _coefVals;
+
+  bool _named;
+  std::vector<std::string> _colNames;
+  std::vector<std::string> _rowNames;
+
+  std::unordered_map<std::string, int> _colIdx;
+  std::unordered_map<std::string, int> _rowIdx;
+
+  StarterSol _starter;
 };
 
 }  // namespace optim
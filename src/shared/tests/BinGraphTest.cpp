@@ -0,0 +1,305 @@
+// Copyright 2016
+// Author: Patrick Brosi
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "shared/linegraph/BinGraph.h"
+#include "shared/linegraph/LineGraph.h"
+#include "shared/tests/BinGraphTest.h"
+#include "util/Misc.h"
+#include "util/geo/output/GeoGraphJsonOutput.h"
+#include "util/http/Server.h"
+#include "util/log/Log.h"
+
+using shared::linegraph::BinGraphWriter;
+using shared::linegraph::LineGraph;
+
+namespace {
+// _____________________________________________________________________________
+std::string pos(const util::geo::DPoint& p) {
+  std::stringstream ss;
+  ss.precision(17);
+  ss << p.getX() << "," << p.getY();
+  return ss.str();
+}
+
+// _____________________________________________________________________________
+std::vector<std::string> summary(const LineGraph& g) {
+  std::vector<std::string> ret;
+
+  for (auto n : g.getNds()) {
+    std::stringstream ss;
+    ss << "N " << pos(*n->pl().getGeom()) << " " << n->getDeg() << " "
+       << n->pl().numConnExcs() << " " << n->pl().getNotServed().size();
+    for (const auto& s : n->pl().stops()) {
+      ss << " " << s.id << "/" << s.name << "/" << pos(s.pos);
+    }
+    ret.push_back(ss.str());
+
+    for (auto e : n->getAdjList()) {
+      if (e->getFrom() != n) continue;
+      std::stringstream es;
+      es << "E " << pos(*e->getFrom()->pl().getGeom()) << " "
+         << pos(*e->getTo()->pl().getGeom()) << " " << e->pl().dontContract();
+      for (const auto& p : e->pl().getPolyline().getLine()) {
+        es << " " << pos(p);
+      }
+      for (const auto& lo : e->pl().getLines()) {
+        es << " " << lo.line->id() << "/" << lo.line->label() << "/"
+           << lo.line->color() << "/"
+           << (lo.direction ? pos(*lo.direction->pl().getGeom()) : "-") << "/"
+           << (lo.style.isNull() ? "-" : lo.style.get().getCss()) << "/"
+           << n->pl().lineServed(lo.line) << e->getTo()->pl().lineServed(lo.line);
+      }
+      ret.push_back(es.str());
+    }
+  }
+
+  std::sort(ret.begin(), ret.end());
+  return ret;
+}
+
+// _____________________________________________________________________________
+std::string toBin(const LineGraph& g) {
+  std::stringstream ss;
+  BinGraphWriter().print(g, ss);
+  return ss.str();
+}
+
+// _____________________________________________________________________________
+bool throwsOnRead(const std::string& data) {
+  LineGraph g;
+  try {
+    g.readFromBin(data.data(), data.size(), 0);
+  } catch (const std::runtime_error& e) {
+    return true;
+  }
+  return false;
+}
+
+// answers with the binary graph read from the request payload, like the
+// --from-bin request handlers of the tools
+class BinGraphHandler : public util::http::Handler {
+ public:
+  util::http::Answer handle(const util::http::Req& req, int con) const {
+    UNUSED(con);
+    std::stringstream in(req.payload);
+    LineGraph g;
+    try {
+      g.readFromBin(&in, 0);
+    } catch (const std::runtime_error& exc) {
+      return util::http::Answer("400 Bad Request", exc.what());
+    }
+    return util::http::Answer("200 OK", toBin(g));
+  }
+};
+
+// _____________________________________________________________________________
+int freePort() {
+  int sock = socket(AF_INET, SOCK_STREAM, 0);
+  sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  addr.sin_port = 0;
+  bind(sock, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+  socklen_t len = sizeof(addr);
+  getsockname(sock, reinterpret_cast<sockaddr*>(&addr), &len);
+  close(sock);
+  return ntohs(addr.sin_port);
+}
+
+// _____________________________________________________________________________
+std::string post(int port, const std::string& body, std::string* status) {
+  sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  addr.sin_port = htons(port);
+
+  // the server may not be listening yet
+  int sock = -1;
+  for (size_t i = 0; i < 200 && sock < 0; i++) {
+    sock = socket(AF_INET, SOCK_STREAM, 0);
+    if (connect(sock, reinterpret_cast<sockaddr*>(&addr), sizeof(addr))) {
+      close(sock);
+      sock = -1;
+      usleep(10000);
+    }
+  }
+  if (sock < 0) return "";
+
+  std::string req = "POST / HTTP/1.1\r\nContent-Length: " +
+                    std::to_string(body.size()) + "\r\n\r\n" + body;
+  for (size_t w = 0; w < req.size();) {
+    ssize_t out = write(sock, req.data() + w, req.size() - w);
+    if (out <= 0) break;
+    w += out;
+  }
+
+  std::string answ;
+  char buf[4096];
+  ssize_t n;
+  while ((n = read(sock, buf, sizeof(buf))) > 0) answ.append(buf, n);
+  close(sock);
+
+  size_t statusEnd = answ.find("\r\n");
+  size_t hdrEnd = answ.find("\r\n\r\n");
+  if (statusEnd == std::string::npos || hdrEnd == std::string::npos) return "";
+  *status = answ.substr(9, statusEnd - 9);
+  return answ.substr(hdrEnd + 4);
+}
+}  // namespace
+
+// _____________________________________________________________________________
+void BinGraphTest::run() {
+  {
+    std::string json =
+        "{\"type\": \"FeatureCollection\", \"features\": ["
+        "{\"type\": \"Feature\", \"properties\": {\"id\": \"a\", "
+        "\"station_id\": \"s1\", \"station_label\": \"A\", \"not_serving\": "
+        "[\"2\"], \"excluded_line_conns\": [{\"route\": \"1\", "
+        "\"edge1_node\": \"b\", \"edge2_node\": \"c\"}]}, \"geometry\": "
+        "{\"type\": \"Point\", \"coordinates\": [0.1, 0.2]}},"
+        "{\"type\": \"Feature\", \"properties\": {\"id\": \"b\"}, \"geometry\": "
+        "{\"type\": \"Point\", \"coordinates\": [100, 0]}},"
+        "{\"type\": \"Feature\", \"properties\": {\"id\": \"c\"}, \"geometry\": "
+        "{\"type\": \"Point\", \"coordinates\": [-100, 0]}},"
+        "{\"type\": \"Feature\", \"geometry\": {\"type\": \"LineString\", "
+        "\"coordinates\": [[0.1, 0.2], [50.5, 1.0 ], [100, 0]]}, "
+        "\"properties\": {\"from\": \"a\", \"to\": \"b\", \"dontcontract\": 1, "
+        "\"lines\": [{\"id\": \"1\", \"label\": \"L1\", \"color\": \"ff0000\", "
+        "\"direction\": \"b\", \"style\": \"stroke-dasharray: 5\"}, {\"id\": "
+        "\"2\", \"label\": \"L2\", \"color\": \"00ff00\"}]}},"
+        "{\"type\": \"Feature\", \"geometry\": {\"type\": \"LineString\", "
+        "\"coordinates\": [[0.1, 0.2], [-100, 0]]}, \"properties\": {\"from\": "
+        "\"a\", \"to\": \"c\", \"lines\": [{\"id\": \"1\", \"label\": \"L1\", "
+        "\"color\": \"ff0000\"}, {\"id\": \"2\", \"label\": \"L2\", \"color\": "
+        "\"00ff00\"}]}}]}";
+
+    std::stringstream ss(json);
+    LineGraph g;
+    g.readFromJson(&ss, 0);
+
+    TEST(g.numConnExcs(), ==, 1);
+
+    std::string bin = toBin(g);
+
+    LineGraph g2;
+    g2.readFromBin(bin.data(), bin.size(), 0);
+
+    TEST(g2.numNds(), ==, 3);
+    TEST(g2.numEdgs(), ==, 2);
+    TEST(g2.numLines(), ==, 2);
+    TEST(g2.numConnExcs(), ==, 1);
+    TEST(summary(g) == summary(g2));
+
+    // writing the read graph again yields the same graph
+    std::stringstream s2(toBin(g2));
+    LineGraph g3;
+    g3.readFromBin(&s2, 0);
+    TEST(summary(g2) == summary(g3));
+
+    // unknown sections are skipped
+    std::string ext = bin;
+    ext += std::string("XXXX\x03\0\0\0\0\0\0\0abc", 15);
+    LineGraph g4;
+    g4.readFromBin(ext.data(), ext.size(), 0);
+    TEST(summary(g) == summary(g4));
+
+    // corrupt input
+    TEST(throwsOnRead(""));
+    TEST(throwsOnRead("{\"type\": \"FeatureCollection\"}"));
+    TEST(throwsOnRead(bin.substr(0, bin.size() - 1)));
+    TEST(throwsOnRead(bin.substr(0, 20)));
+
+    std::string badVersion = bin;
+    badVersion[8] = 2;
+    TEST(throwsOnRead(badVersion));
+  }
+
+  {
+    // binary round trip of real graphs, the read times of the GeoJSON and the
+    // binary format are reported
+    std::vector<std::string> files = {
+        "../src/loom/tests/datasets/freiburg-tram.json",
+        "../src/loom/tests/datasets/nonserving/test1.json",
+        "../examples/stuttgart.json",
+        "../examples/chicago.json",
+        "../examples/sydney.json",
+        "../examples/berlin.json",
+    };
+
+    double jsonT = 0, binT = 0;
+    size_t jsonSize = 0, binSize = 0;
+
+    for (const auto& f : files) {
+      LineGraph g;
+      std::ifstream in(f);
+      g.readFromJson(&in, 0);
+
+      std::stringstream json;
+      util::geo::output::GeoGraphJsonOutput().print(g, json);
+      std::string bin = toBin(g);
+
+      LineGraph fromJson, fromBin;
+
+      auto t0 = std::chrono::steady_clock::now();
+      fromJson.readFromJson(&json, 0);
+      auto t1 = std::chrono::steady_clock::now();
+      fromBin.readFromBin(bin.data(), bin.size(), 0);
+      auto t2 = std::chrono::steady_clock::now();
+
+      TEST(g.numNds(), >, 0);
+      TEST(summary(g) == summary(fromBin));
+      TEST(g.numConnExcs(), ==, fromBin.numConnExcs());
+      TEST(fromJson.numNds(), ==, fromBin.numNds());
+
+      jsonT += std::chrono::duration<double, std::milli>(t1 - t0).count();
+      binT += std::chrono::duration<double, std::milli>(t2 - t1).count();
+      jsonSize += json.str().size();
+      binSize += bin.size();
+    }
+
+    LOG(INFO) << "GeoJSON: " << jsonSize << " bytes, read in " << jsonT
+              << " ms, binary: " << binSize << " bytes, read in " << binT
+              << " ms";
+  }
+
+  {
+    // binary graphs posted to the HTTP server, the magic bytes contain a NUL,
+    // and the payload is larger than the socket read buffer
+    LineGraph g;
+    std::ifstream in("../src/loom/tests/datasets/freiburg-tram.json");
+    g.readFromJson(&in, 0);
+    std::string bin = toBin(g);
+    TEST(bin.size(), >, util::http::BSIZE);
+
+    // the server runs until the test process exits. It is never destroyed,
+    // its worker threads wait on its job queue.
+    int port = freePort();
+    auto h = new BinGraphHandler();
+    auto serv = new util::http::HttpServer(port, h, 1);
+    std::thread([serv] { serv->run(); }).detach();
+
+    std::string status;
+    std::string answ = post(port, bin, &status);
+    TEST(status, ==, "200 OK");
+    TEST(answ.size(), ==, bin.size());
+    TEST(answ == bin);
+
+    // malformed graphs are rejected
+    post(port, bin.substr(0, bin.size() / 2), &status);
+    TEST(status, ==, "400 Bad Request");
+  }
+}
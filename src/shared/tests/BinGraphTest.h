@@ -0,0 +1,12 @@
+// Copyright 2016
+// Author: Patrick Brosi
+
+#ifndef SHARED_TEST_BINGRAPHTEST_H_
+#define SHARED_TEST_BINGRAPHTEST_H_
+
+class BinGraphTest {
+  public:
+    void run();
+};
+
+#endif
@@ -0,0 +1,167 @@
+// Copyright 2016
+// Author: Patrick Brosi
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "shared/linegraph/LineGraph.h"
+#include "shared/tests/GeoJsonReaderTest.h"
+#include "util/Misc.h"
+#include "util/log/Log.h"
+
+using shared::linegraph::LineGraph;
+
+namespace {
+// _____________________________________________________________________________
+std::string pos(const util::geo::DPoint& p) {
+  std::stringstream ss;
+  ss << std::fixed << std::setprecision(3) << p.getX() << "," << p.getY();
+  return ss.str();
+}
+
+// _____________________________________________________________________________
+std::vector<std::string> summary(const LineGraph& g) {
+  std::vector<std::string> ret;
+
+  for (auto n : g.getNds()) {
+    std::stringstream ss;
+    ss << "N " << pos(*n->pl().getGeom()) << " " << n->getDeg() << " "
+       << n->pl().numConnExcs();
+    for (const auto& s : n->pl().stops()) ss << " " << s.id << "/" << s.name;
+    ret.push_back(ss.str());
+
+    for (auto e : n->getAdjList()) {
+      if (e->getFrom() != n) continue;
+      std::stringstream es;
+      es << "E " << pos(*e->getFrom()->pl().getGeom()) << " "
+         << pos(*e->getTo()->pl().getGeom()) << " "
+         << e->pl().getPolyline().getLine().size();
+      for (const auto& lo : e->pl().getLines()) {
+        es << " " << lo.line->id() << "/" << lo.line->label() << "/"
+           << lo.line->color() << "/"
+           << (lo.direction ? pos(*lo.direction->pl().getGeom()) : "-")
+           << "/" << n->pl().lineServed(lo.line)
+           << e->getTo()->pl().lineServed(lo.line);
+      }
+      ret.push_back(es.str());
+    }
+  }
+
+  std::sort(ret.begin(), ret.end());
+  return ret;
+}
+
+// _____________________________________________________________________________
+void readDom(std::istream* s, double smooth, LineGraph* g) {
+  nlohmann::json j;
+  (*s) >> j;
+  g->readFromGeoJson(j["features"], smooth);
+}
+}  // namespace
+
+// _____________________________________________________________________________
+void GeoJsonReaderTest::run() {
+  {
+    // edges before their nodes, properties after the geometry, foreign
+    // members, 3D coordinates and a trailing value which must not be read
+    std::string json =
+        "{\"features\": [{\"type\": \"Feature\", \"geometry\": {\"type\": "
+        "\"LineString\", \"coordinates\": [[0, 0, 5], [50.5, 0], [100, 0]]}, "
+        "\"properties\": {\"from\": \"a\", \"to\": \"b\", \"lines\": [{\"id\": "
+        "\"1\", \"label\": \"L1\", \"color\": \"ff0000\", \"direction\": "
+        "\"b\"}, {\"label\": \"L2\", \"color\": \"00ff00\"}]}},"
+        "{\"type\": \"Feature\", \"properties\": {\"id\": \"a\", "
+        "\"station_id\": 17, \"station_label\": \"A\", \"not_serving\": "
+        "[\"L2\"], \"foo\": {\"bar\": [1, {\"x\": null}]}}, \"geometry\": "
+        "{\"coordinates\": [0, 0], \"type\": \"Point\"}, \"bbox\": [0, 0]},"
+        "{\"type\": \"Feature\", \"properties\": {\"id\": \"b\"}, \"geometry\": "
+        "{\"type\": \"Point\", \"coordinates\": [100, 0]}},"
+        "{\"type\": \"Feature\", \"properties\": {\"from\": \"b\", \"to\": "
+        "\"\", \"lines\": [{\"id\": \"1\", \"color\": \"ff0000\"}]}, "
+        "\"geometry\": {\"type\": \"LineString\", \"coordinates\": [[100, 0], "
+        "[100, 100]]}}], \"type\": \"FeatureCollection\"} {\"rest\": 1}";
+
+    std::stringstream ss(json);
+    LineGraph g;
+    g.readFromJson(&ss, 0);
+
+    TEST(g.numNds(), ==, 3);
+    TEST(g.numEdgs(), ==, 2);
+    TEST(g.numLines(), ==, 2);
+
+    std::string rest;
+    std::getline(ss, rest);
+    TEST(rest, ==, " {\"rest\": 1}");
+
+    std::stringstream ss2(json);
+    LineGraph g2;
+    readDom(&ss2, 0, &g2);
+    TEST(summary(g) == summary(g2));
+
+    bool found = false;
+    for (auto n : g.getNds()) {
+      if (n->pl().stops().size()) {
+        found = true;
+        TEST(n->pl().stops().front().id, ==, "17");
+        TEST(n->pl().stops().front().name, ==, "A");
+        TEST(!n->pl().lineServed(g.getLine("L2")));
+        TEST(n->pl().lineServed(g.getLine("1")));
+      }
+    }
+    TEST(found);
+  }
+
+  {
+    std::stringstream ss("{\"type\": \"FeatureCollection\", \"features\": [");
+    LineGraph g;
+    bool thrown = false;
+    try {
+      g.readFromJson(&ss, 0);
+    } catch (const nlohmann::json::parse_error& e) {
+      thrown = true;
+    }
+    TEST(thrown);
+  }
+
+  {
+    // the streaming reader builds the same graph as the DOM reader, the
+    // parse times of both are reported
+    std::vector<std::string> files = {
+        "../src/loom/tests/datasets/freiburg-tram.json",
+        "../src/loom/tests/datasets/nonserving/test1.json",
+        "../examples/stuttgart.json",
+        "../examples/chicago.json",
+        "../examples/sydney.json",
+        "../examples/berlin.json",
+    };
+
+    double domT = 0, saxT = 0;
+
+    for (const auto& f : files) {
+      LineGraph dom, sax;
+
+      std::ifstream in(f);
+      auto t0 = std::chrono::steady_clock::now();
+      readDom(&in, 3, &dom);
+      auto t1 = std::chrono::steady_clock::now();
+
+      std::ifstream in2(f);
+      sax.readFromJson(&in2, 3);
+      auto t2 = std::chrono::steady_clock::now();
+
+      TEST(dom.numNds(), >, 0);
+      TEST(summary(dom) == summary(sax));
+      TEST(dom.numConnExcs(), ==, sax.numConnExcs());
+
+      domT += std::chrono::duration<double, std::milli>(t1 - t0).count();
+      saxT += std::chrono::duration<double, std::milli>(t2 - t1).count();
+    }
+
+    LOG(INFO) << "GeoJSON DOM reader: " << domT << " ms, streaming reader: "
+              << saxT << " ms";
+  }
+}
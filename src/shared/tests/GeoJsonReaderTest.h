@@ -0,0 +1,12 @@
+// Copyright 2016
+// Author: Patrick Brosi
+
+#ifndef SHARED_TEST_GEOJSONREADERTEST_H_
+#define SHARED_TEST_GEOJSONREADERTEST_H_
+
+class GeoJsonReaderTest {
+  public:
+    void run();
+};
+
+#endif
@@ -8,9 +8,31 @@
 #include "shared/tests/ILPSolverTest.h"
 #include "util/Misc.h"
 
+using shared::optim::ILPRowBuffer;
 using shared::optim::ILPSolver;
 using util::approx;
 
+namespace {
+// solver without a backend, only used to check the model building
+class ModelOnlySolver : public ILPSolver {
+ public:
+  using ILPSolver::getVarVal;
+  double getVarVal(int colId) const { return colId; }
+  void setTimeLim(int s) { UNUSED(s); }
+  int getTimeLim() const { return 0; }
+  void setCacheDir(const std::string& dir) { UNUSED(dir); }
+  std::string getCacheDir() const { return ""; }
+  void setCacheThreshold(double gb) { UNUSED(gb); }
+  double getCacheThreshold() const { return 0; }
+  void setNumThreads(int n) { UNUSED(n); }
+  int getNumThreads() const { return 0; }
+  shared::optim::SolveType solve() { return shared::optim::INF; }
+  shared::optim::SolveType getStatus() { return shared::optim::INF; }
+  double getObjVal() const { return 0; }
+  void writeMps(const std::string& path) const { UNUSED(path); }
+};
+}  // namespace
+
 #ifdef GUROBI_FOUND
 
 #include "shared/optim/GurobiSolver.h"
@@ -37,6 +59,174 @@ using shared::optim::COINSolver;
 
 // _____________________________________________________________________________
 void ILPSolverTest::run() {
+  {
+    ModelOnlySolver s;
+
+    int x = s.addCol(shared::optim::BIN, 1);
+    int y = s.addCol(shared::optim::INT, 2, 0, 5);
+    int z = s.addCol("z", shared::optim::CONT, 3);
+
+    TEST(x, ==, 0);
+    TEST(y, ==, 1);
+    TEST(z, ==, 2);
+
+    TEST(s.getCols()[x].upBnd, ==, 1);
+    TEST(s.getCols()[y].upBnd, ==, 5);
+
+    int r1 = s.addRow(4, shared::optim::UP);
+    int r2 = s.addRow("r", 1, shared::optim::LO);
+    int r3 = s.addRow(0, shared::optim::FIX);
+
+    // triplets are added out of row order, with a duplicate entry
+    s.addColToRow(r2, y, 1);
+    s.addColToRow(r1, z, 3);
+    s.addColToRow(r1, x, 1);
+    s.addColToRow(r2, x, 1);
+    s.addColsToRow(r1, {y, z}, {2, -1});
+
+    TEST(s.getNumVars(), ==, 3);
+    TEST(s.getNumConstrs(), ==, 3);
+    TEST(s.getNumNonZeros(), ==, 6);
+
+    std::vector<int> rowBeg, colInd;
+    std::vector<double> vals;
+    s.getCSR(&rowBeg, &colInd, &vals);
+
+    TEST(rowBeg.size(), ==, 4);
+    TEST(rowBeg[0], ==, 0);
+    TEST(rowBeg[1], ==, 3);
+    TEST(rowBeg[2], ==, 5);
+    TEST(rowBeg[r3 + 1], ==, 5);
+
+    TEST(colInd[0], ==, z);
+    TEST(vals[0], ==, approx(2));
+    TEST(colInd[1], ==, x);
+    TEST(vals[1], ==, approx(1));
+    TEST(colInd[2], ==, y);
+    TEST(vals[2], ==, approx(2));
+    TEST(colInd[3], ==, y);
+    TEST(colInd[4], ==, x);
+
+    // names are generated for unnamed columns and rows
+    TEST(s.getColName(x), ==, "c0");
+    TEST(s.getColName(z), ==, "z");
+    TEST(s.getRowName(r1), ==, "r0");
+    TEST(s.getRowName(r2), ==, "r");
+    TEST(s.getVarByName("z"), ==, z);
+    TEST(s.getVarByName("c0"), ==, -1);
+    TEST(s.getConstrByName("r"), ==, r2);
+    TEST(s.getVarVal("z"), ==, approx(2));
+
+    s.setObjCoef("z", 5);
+    TEST(s.getCols()[z].objCoef, ==, approx(5));
+  }
+  {
+    // rows built in buffers are appended with remapped row handles
+    ModelOnlySolver s;
+    s.setNamed(true);
+    int x = s.addCol(shared::optim::BIN, 1);
+    int y = s.addCol(shared::optim::BIN, 1);
+    int r0 = s.addRow(1, shared::optim::UP);
+    s.addColToRow(r0, x, 1);
+
+    ILPRowBuffer a(s.isNamed());
+    int a0 = a.addRow("a0", 1, shared::optim::FIX);
+    int a1 = a.addRow("a1", 2, shared::optim::LO);
+    a.addColToRow(a1, y, 3);
+    a.addColToRow(a0, x, 2);
+    TEST(a.size(), ==, 2);
+
+    ILPRowBuffer b(s.isNamed());
+    int b0 = b.addRow(0, shared::optim::UP);
+    b.addColToRow(b0, x, 1);
+    b.addColToRow(b0, y, -1);
+
+    TEST(s.addRows(a), ==, 1);
+    TEST(s.addRows(b), ==, 3);
+    TEST(s.getNumConstrs(), ==, 4);
+    TEST(s.getNumNonZeros(), ==, 5);
+    TEST(s.getRows()[2].type, ==, shared::optim::LO);
+    TEST(s.getRows()[2].bnd, ==, approx(2));
+    TEST(s.getConstrByName("a1"), ==, 2);
+    TEST(s.getRowName(3), ==, "r3");
+
+    std::vector<int> rowBeg, colInd;
+    std::vector<double> vals;
+    s.getCSR(&rowBeg, &colInd, &vals);
+
+    TEST(rowBeg[1], ==, 1);
+    TEST(rowBeg[2], ==, 2);
+    TEST(colInd[1], ==, x);
+    TEST(vals[1], ==, approx(2));
+    TEST(colInd[2], ==, y);
+    TEST(vals[2], ==, approx(3));
+    TEST(rowBeg[4] - rowBeg[3], ==, 2);
+  }
+  {
+    // completing a starting solution
+    ModelOnlySolver s;
+    int x1 = s.addCol(shared::optim::BIN, 0);
+    int x2 = s.addCol(shared::optim::BIN, 0);
+    int s12 = s.addCol(shared::optim::BIN, 0);
+    int s21 = s.addCol(shared::optim::BIN, 0);
+    int d = s.addCol(shared::optim::INT, 1);
+    int f = s.addCol(shared::optim::INT, 0);
+    int z = s.addCol(shared::optim::BIN, 0);
+
+    int r = s.addRow(1, shared::optim::FIX);
+    s.addColToRow(r, s12, 1);
+    s.addColToRow(r, s21, 1);
+
+    r = s.addRow(0, shared::optim::LO);
+    s.addColsToRow(r, {s12, x1, x2}, {2, 1, -1});
+    r = s.addRow(0, shared::optim::LO);
+    s.addColsToRow(r, {s21, x2, x1}, {2, 1, -1});
+
+    r = s.addRow(0, shared::optim::UP);
+    s.addColsToRow(r, {s12, d}, {1, -1});
+
+    r = s.addRow(2, shared::optim::FIX);
+    s.addColsToRow(r, {f, d}, {1, -1});
+
+    r = s.addRow(1, shared::optim::UP);
+    s.addColToRow(r, z, 1);
+
+    auto sol = s.completeStarter({{x1, 0}, {x2, 1}});
+
+    TEST(sol.size(), ==, 7);
+    TEST(sol[x1], ==, 0);
+    TEST(sol[x2], ==, 1);
+    TEST(sol[s12], ==, 1);
+    TEST(sol[s21], ==, 0);
+    TEST(sol[d], ==, 1);
+    TEST(sol[f], ==, 3);
+    TEST(sol[z], ==, 0);
+
+    sol = s.completeStarter({{x1, 1}, {x2, 0}});
+    TEST(sol[s12], ==, 0);
+    TEST(sol[s21], ==, 1);
+    TEST(sol[d], ==, 0);
+    TEST(sol[f], ==, 2);
+  }
+  {
+    // infeasible starting solutions are dropped
+    ModelOnlySolver s;
+    int x1 = s.addCol(shared::optim::BIN, 0);
+    int x2 = s.addCol(shared::optim::BIN, 0);
+    int y = s.addCol(shared::optim::INT, 0);
+
+    int r = s.addRow(1, shared::optim::UP);
+    s.addColsToRow(r, {x1, x2}, {1, 1});
+
+    r = s.addRow(1, shared::optim::LO);
+    s.addColsToRow(r, {x1, y}, {1, 1});
+
+    TEST(s.completeStarter({{x1, 1}, {x2, 0}}).size(), ==, 3);
+    TEST(s.completeStarter({{x1, 1}, {x2, 1}}).size(), ==, 0);
+
+    // the column bound of x2 is violated
+    TEST(s.completeStarter({{x1, 0}, {x2, 2}}).size(), ==, 0);
+  }
   {
     std::vector<ILPSolver*> solvers;
 
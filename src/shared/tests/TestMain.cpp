@@ -1,7 +1,10 @@
 // Copyright 2016
 // Author: Patrick Brosi
 
+#include "shared/tests/BinGraphTest.h"
+#include "shared/tests/GeoJsonReaderTest.h"
 #include "shared/tests/ILPSolverTest.h"
+#include "shared/tests/TopologizeTest.h"
 
 #include "util/Misc.h"
 
@@ -10,6 +13,12 @@ int main(int argc, char** argv) {
   UNUSED(argc);
   UNUSED(argv);
   ILPSolverTest gs;
+  GeoJsonReaderTest gjs;
+  BinGraphTest bgs;
+  TopologizeTest ts;
 
   gs.run();
+  gjs.run();
+  bgs.run();
+  ts.run();
 }
@@ -0,0 +1,213 @@
+// Copyright 2016
+// Author: Patrick Brosi
+
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "shared/linegraph/LineGraph.h"
+#include "shared/tests/TopologizeTest.h"
+#include "util/Misc.h"
+#include "util/log/Log.h"
+
+using shared::linegraph::LineGraph;
+using util::approx;
+
+namespace {
+// _____________________________________________________________________________
+std::string nd(const std::string& id, double x, double y) {
+  std::stringstream ss;
+  ss << "{\"type\": \"Feature\", \"properties\": {\"id\": \"" << id
+     << "\"}, \"geometry\": {\"type\": \"Point\", \"coordinates\": [" << x
+     << ", " << y << "]}}";
+  return ss.str();
+}
+
+// _____________________________________________________________________________
+std::string edg(const std::string& from, const std::string& to,
+                const std::vector<util::geo::DPoint>& pts,
+                const std::string& line) {
+  std::stringstream ss;
+  ss << "{\"type\": \"Feature\", \"properties\": {\"from\": \"" << from
+     << "\", \"to\": \"" << to << "\", \"lines\": [{\"id\": \"" << line
+     << "\", \"color\": \"ff0000\", \"direction\": \"" << to
+     << "\"}]}, \"geometry\": {\"type\": \"LineString\", \"coordinates\": [";
+  for (size_t i = 0; i < pts.size(); i++) {
+    if (i) ss << ", ";
+    ss << "[" << pts[i].getX() << ", " << pts[i].getY() << "]";
+  }
+  ss << "]}}";
+  return ss.str();
+}
+
+// _____________________________________________________________________________
+void read(const std::vector<std::string>& features, LineGraph* g) {
+  std::stringstream ss;
+  ss << "{\"type\": \"FeatureCollection\", \"features\": [";
+  for (size_t i = 0; i < features.size(); i++) {
+    if (i) ss << ",";
+    ss << features[i];
+  }
+  ss << "]}";
+  g->readFromJson(&ss, 0);
+}
+
+// _____________________________________________________________________________
+std::vector<std::string> line(const std::string& id, double x1, double y1,
+                              double x2, double y2) {
+  return {nd(id + "a", x1, y1), nd(id + "b", x2, y2),
+          edg(id + "a", id + "b", {{x1, y1}, {x2, y2}}, id)};
+}
+
+// _____________________________________________________________________________
+void crossingGrid(size_t n, LineGraph* g) {
+  // n horizontal lines crossing n vertical lines
+  std::vector<std::string> features;
+  for (size_t i = 0; i < n; i++) {
+    double c = 1000.0 * i + 500;
+    for (const auto& f : line("h" + std::to_string(i), 0, c, 1000.0 * n, c))
+      features.push_back(f);
+    for (const auto& f : line("v" + std::to_string(i), c, 0, c, 1000.0 * n))
+      features.push_back(f);
+  }
+  read(features, g);
+}
+
+// _____________________________________________________________________________
+bool directionsValid(const LineGraph& g) {
+  for (auto n : g.getNds()) {
+    for (auto e : n->getAdjList()) {
+      for (const auto& lo : e->pl().getLines()) {
+        if (lo.direction && lo.direction != e->getFrom() &&
+            lo.direction != e->getTo())
+          return false;
+      }
+    }
+  }
+  return true;
+}
+
+// _____________________________________________________________________________
+double totalLength(const LineGraph& g) {
+  double ret = 0;
+  for (auto n : g.getNds()) {
+    for (auto e : n->getAdjList()) {
+      if (e->getFrom() == n) ret += e->pl().getPolyline().getLength();
+    }
+  }
+  return ret;
+}
+}  // namespace
+
+// _____________________________________________________________________________
+void TopologizeTest::run() {
+  {
+    LineGraph g;
+    crossingGrid(5, &g);
+    TEST(g.numNds(), ==, 20);
+    TEST(g.numEdgs(), ==, 10);
+
+    g.topologizeIsects();
+
+    TEST(g.numNds(), ==, 20 + 25);
+    TEST(g.numEdgs(), ==, 10 * 6);
+    TEST(totalLength(g), ==, approx(10 * 5000));
+    TEST(directionsValid(g));
+
+    size_t crossings = 0;
+    for (auto n : g.getNds()) {
+      if (n->getDeg() == 4) {
+        crossings++;
+        auto p = *n->pl().getGeom();
+        TEST(fmod(p.getX() - 500, 1000), ==, approx(0));
+        TEST(fmod(p.getY() - 500, 1000), ==, approx(0));
+      } else {
+        TEST(n->getDeg(), ==, 1);
+      }
+    }
+    TEST(crossings, ==, 25);
+
+    // nothing left to split
+    g.topologizeIsects();
+    TEST(g.numNds(), ==, 20 + 25);
+    TEST(g.numEdgs(), ==, 10 * 6);
+  }
+
+  {
+    // three lines crossing in a single point are joined in a single node
+    std::vector<std::string> features;
+    for (const auto& f : line("a", -1000, 0, 1000, 0)) features.push_back(f);
+    for (const auto& f : line("b", 0, -1000, 0, 1000)) features.push_back(f);
+    for (const auto& f : line("c", -1000, -1000, 1000, 1000))
+      features.push_back(f);
+
+    LineGraph g;
+    read(features, &g);
+    g.topologizeIsects();
+
+    TEST(g.numNds(), ==, 7);
+    TEST(g.numEdgs(), ==, 6);
+    TEST(directionsValid(g));
+
+    size_t maxDeg = 0;
+    for (auto n : g.getNds()) maxDeg = std::max(maxDeg, n->getDeg());
+    TEST(maxDeg, ==, 6);
+  }
+
+  {
+    // crossings near a node shared by both edges are ignored
+    LineGraph g;
+    read({nd("s", 0, 0), nd("a", 1000, 20), nd("b", 1000, 0),
+          edg("s", "a", {{0, 0}, {40, 20}, {1000, 20}}, "1"),
+          edg("s", "b", {{0, 0}, {40, 40}, {60, 0}, {1000, 0}}, "2")},
+         &g);
+    g.topologizeIsects();
+
+    TEST(g.numNds(), ==, 3);
+    TEST(g.numEdgs(), ==, 2);
+  }
+
+  {
+    // an edge pair crossing twice is split at both crossings, the sub-edges
+    // between the crossings are merged into one edge
+    LineGraph g;
+    read({nd("a", 0, 0), nd("b", 3000, 0), nd("c", 0, -1000),
+          nd("d", 2000, -1000), edg("a", "b", {{0, 0}, {3000, 0}}, "1"),
+          edg("c", "d", {{0, -1000}, {1000, 1000}, {2000, -1000}}, "2")},
+         &g);
+    g.topologizeIsects();
+
+    TEST(g.numNds(), ==, 6);
+    TEST(g.numEdgs(), ==, 5);
+    TEST(directionsValid(g));
+
+    size_t crossings = 0;
+    for (auto n : g.getNds()) {
+      if (n->getDeg() == 3) crossings++;
+    }
+    TEST(crossings, ==, 2);
+  }
+
+  {
+    // the time needed to topologize growing grids of crossing lines
+    std::stringstream times;
+    for (size_t n : {8, 16, 32}) {
+      LineGraph g;
+      crossingGrid(n, &g);
+
+      auto t0 = std::chrono::steady_clock::now();
+      g.topologizeIsects();
+      auto t1 = std::chrono::steady_clock::now();
+
+      TEST(g.numNds(), ==, 4 * n + n * n);
+      TEST(g.numEdgs(), ==, 2 * n * (n + 1));
+
+      times << " " << n * n << " crossings: "
+            << std::chrono::duration<double, std::milli>(t1 - t0).count()
+            << " ms";
+    }
+
+    LOG(INFO) << "Topologizing crossing grids," << times.str();
+  }
+}
@@ -0,0 +1,12 @@
+// Copyright 2016
+// Author: Patrick Brosi
+
+#ifndef SHARED_TEST_TOPOLOGIZETEST_H_
+#define SHARED_TEST_TOPOLOGIZETEST_H_
+
+class TopologizeTest {
+  public:
+    void run();
+};
+
+#endif
@@ -8,6 +8,7 @@
 #include <iostream>
 #include <set>
 #include <string>
+#include "shared/linegraph/BinGraph.h"
 #include "shared/linegraph/LineGraph.h"
 #include "topo/mapconstructor/MapConstructor.h"
 #include "topo/statinserter/StatInserter.h"
@@ -19,9 +20,6 @@
 
 // _____________________________________________________________________________
 int main(int argc, char** argv) {
-  // disable output buffering for standard output
-  setbuf(stdout, NULL);
-
   // initialize randomness
   srand(time(NULL) + rand());
 
@@ -36,7 +34,17 @@ int main(int argc, char** argv) {
   cr.read(&cfg, argc, argv);
 
   // read input graph
-  tg.readFromJson(&(std::cin), 0);
+  if (cfg.fromBin) {
+    tg.readFromBin(&(std::cin), 0);
+  } else {
+    tg.readFromJson(&(std::cin), 0);
+  }
+
+  if (cfg.toGeoJson) {
+    util::geo::output::GeoGraphJsonOutput out;
+    out.print(tg, std::cout);
+    return (0);
+  }
 
   double lenBef = 0, lenAfter = 0;
 
@@ -123,7 +131,9 @@ int main(int argc, char** argv) {
 
   // output
   util::geo::output::GeoGraphJsonOutput out;
-  if (cfg.outputStats) {
+  if (cfg.toBin) {
+    shared::linegraph::BinGraphWriter().print(tg, std::cout);
+  } else if (cfg.outputStats) {
     util::json::Dict jsonStats = {
         {"statistics",
          util::json::Dict{
@@ -45,7 +45,13 @@ void ConfigReader::help(const char* bin) const {
             << std::setw(35) << "  --no-infer-restrs"
             << "don't infer turn restrictions\n"
             << std::setw(35) << "  --max-length-dev arg (=500)"
-            << "maxumum distance deviation for turn restrictions infer\n";
+            << "maxumum distance deviation for turn restrictions infer\n"
+            << std::setw(35) << "  --from-bin"
+            << "read input graph in binary format\n"
+            << std::setw(35) << "  --to-bin"
+            << "write output graph in binary format\n"
+            << std::setw(35) << "  --to-geojson"
+            << "only convert binary input graph to GeoJSON\n";
 }
 
 // _____________________________________________________________________________
@@ -58,6 +64,9 @@ void ConfigReader::read(TopoConfig* cfg, int argc, char** argv) const {
                          {"no-infer-restrs", no_argument, 0, 1},
                          {"write-stats", no_argument, 0, 2},
                          {"max-length-dev", required_argument, 0, 3},
+                         {"from-bin", no_argument, 0, 4},
+                         {"to-bin", no_argument, 0, 5},
+                         {"to-geojson", no_argument, 0, 6},
                          {0, 0, 0, 0}};
 
   char c;
@@ -81,6 +90,16 @@ void ConfigReader::read(TopoConfig* cfg, int argc, char** argv) const {
       case 3:
         cfg->maxAggrDistance = atof(optarg);
         break;
+      case 4:
+        cfg->fromBin = true;
+        break;
+      case 5:
+        cfg->toBin = true;
+        break;
+      case 6:
+        cfg->fromBin = true;
+        cfg->toGeoJson = true;
+        break;
       case ':':
         std::cerr << argv[optind - 1];
         std::cerr << " requires an argument" << std::endl;
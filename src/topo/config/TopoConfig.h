@@ -15,6 +15,9 @@ struct TopoConfig {
   double maxLengthDev = 500;
   bool outputStats = false;
   bool noInferRestrs = false;
+  bool fromBin = false;
+  bool toBin = false;
+  bool toGeoJson = false;
 };
 
 }  // namespace config
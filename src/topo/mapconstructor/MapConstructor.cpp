@@ -663,7 +663,13 @@ size_t MapConstructor::freeze() {
 // _____________________________________________________________________________
 void MapConstructor::combContEdgs(const LineEdge* a, const LineEdge* b) {
   for (auto& oe : _origEdgs) {
-    oe[a].insert(oe[b].begin(), oe[b].end());
+    auto& contA = oe[a];
+    // don't add an empty entry for b, the maps would otherwise grow with
+    // every edge of every collapse iteration
+    auto contB = oe.find(b);
+    if (contB != oe.end()) {
+      contA.insert(contB->second.begin(), contB->second.end());
+    }
   }
 }
 
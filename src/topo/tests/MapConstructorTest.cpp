@@ -0,0 +1,58 @@
+// Copyright 2016
+// Author: Patrick Brosi
+
+#include <cassert>
+#include <cmath>
+#include <fstream>
+#include <string>
+
+#include "shared/linegraph/LineGraph.h"
+#include "topo/config/TopoConfig.h"
+#include "topo/mapconstructor/MapConstructor.h"
+#include "topo/tests/MapConstructorTest.h"
+#include "util/Misc.h"
+
+// _____________________________________________________________________________
+void MapConstructorTest::run() {
+  // ___________________________________________________________________________
+  {
+    // collapse a real network like topo does
+    topo::config::TopoConfig cfg;
+    shared::linegraph::LineGraph tg;
+    topo::MapConstructor mc(&cfg, &tg);
+
+    std::ifstream in("../examples/stuttgart.json");
+    tg.readFromJson(&in, 0);
+
+    mc.freeze();
+    mc.averageNodePositions();
+    mc.cleanUpGeoms();
+    mc.removeNodeArtifacts(false);
+    mc.freeze();
+    mc.removeEdgeArtifacts();
+
+    size_t iters = 0;
+    iters += mc.collapseShrdSegs(10);
+    iters += mc.collapseShrdSegs(cfg.maxAggrDistance);
+
+    mc.removeNodeArtifacts(false);
+
+    size_t nds = tg.getNds().size();
+    size_t edgs = 0;
+    double len = 0;
+    for (auto nd : tg.getNds()) {
+      for (auto e : nd->getAdjList()) {
+        if (e->getFrom() != nd) continue;
+        edgs++;
+        len += e->pl().getPolyline().getLength();
+      }
+    }
+
+    // reference values of the collapse loop which rebuilds the whole
+    // network in every iteration, the collapse must reproduce them exactly
+    TEST(iters, ==, (size_t)4);
+    TEST(nds, ==, (size_t)61);
+    TEST(edgs, ==, (size_t)74);
+    TEST(std::round(len * 100), ==, 18438131);
+  }
+}
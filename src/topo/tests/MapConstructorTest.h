@@ -0,0 +1,12 @@
+// Copyright 2016
+// Author: Patrick Brosi
+
+#ifndef TOPO_TEST_MAPCONSTRUCTORTEST_H_
+#define TOPO_TEST_MAPCONSTRUCTORTEST_H_
+
+class MapConstructorTest {
+  public:
+    void run();
+};
+
+#endif
@@ -3,6 +3,7 @@
 
 #include "topo/tests/ContractTest.h"
 #include "topo/tests/ContractTest2.h"
+#include "topo/tests/MapConstructorTest.h"
 #include "topo/tests/TopologicalTest.h"
 #include "topo/tests/RestrInfTest.h"
 
@@ -16,9 +17,11 @@ int main(int argc, char** argv) {
   ContractTest ct;
   TopologicalTest tt;
   RestrInfTest rt;
+  MapConstructorTest mct;
 
   rt.run();
   ct2.run();
   ct.run();
   tt.run();
+  mct.run();
 }
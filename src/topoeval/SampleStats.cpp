@@ -0,0 +1,42 @@
+// Copyright 2022
+// University of Freiburg - Chair of Algorithms and Datastructures
+// Author: Patrick Brosi
+
+#include <limits>
+#include "topoeval/SampleStats.h"
+
+using topoeval::Sample;
+using topoeval::SampleStats;
+
+// _____________________________________________________________________________
+SampleStats topoeval::aggregate(const std::vector<Sample>& samples,
+                                double d) {
+  SampleStats ret;
+  ret.match = 0;
+  ret.unmatch = 0;
+  ret.minFrech = std::numeric_limits<double>::max();
+  ret.maxFrech = 0;
+  ret.frechAvg = 0;
+
+  // summed up in sample order to stay reproducible
+  for (const auto& s : samples) {
+    if (s.status == SKIPPED) continue;
+
+    if (s.status == UNMATCHED) {
+      ret.unmatch += 1;
+      continue;
+    }
+
+    ret.frechAvg += s.frechetDist;
+
+    if (s.frechetDist > ret.maxFrech) ret.maxFrech = s.frechetDist;
+    if (s.frechetDist < ret.minFrech) ret.minFrech = s.frechetDist;
+
+    if (s.frechetDist < d)
+      ret.match += 1;
+    else
+      ret.unmatch += 1;
+  }
+
+  return ret;
+}
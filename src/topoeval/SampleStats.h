@@ -0,0 +1,44 @@
+// Copyright 2022
+// University of Freiburg - Chair of Algorithms and Datastructures
+// Author: Patrick Brosi
+
+#ifndef TOPOEVAL_SAMPLESTATS_H_
+#define TOPOEVAL_SAMPLESTATS_H_
+
+#include <vector>
+
+namespace topoeval {
+
+// outcome of a single evaluation sample. The status is stored explicitly
+// because the build uses -ffinite-math-only, under which NaN or infinity
+// markers in the distance cannot be tested for.
+enum SampleStatus {
+  // no line at the sampled nodes, or no path in both graphs
+  SKIPPED,
+  // a path was only found in one of the graphs
+  UNMATCHED,
+  // paths were found in both graphs, frechetDist holds their distance
+  FOUND
+};
+
+struct Sample {
+  Sample() : status(SKIPPED), frechetDist(0) {}
+  SampleStatus status;
+  double frechetDist;
+};
+
+struct SampleStats {
+  double match;
+  double unmatch;
+  double minFrech;
+  double maxFrech;
+  double frechAvg;
+};
+
+// aggregate the samples in order, a found path pair matches if its Frechet
+// distance is below d
+SampleStats aggregate(const std::vector<Sample>& samples, double d);
+
+}  // namespace topoeval
+
+#endif  // TOPOEVAL_SAMPLESTATS_H_
@@ -4,23 +4,36 @@
 
 #include <stdio.h>
 #include <unistd.h>
+#include <cmath>
 #include <cstdlib>
 #include <fstream>
 #include <iostream>
+#include <limits>
+#include <map>
+#include <random>
 #include <set>
 #include <string>
+#include <unordered_map>
+#include <vector>
 #include "shared/linegraph/LineGraph.h"
 #include "topoeval/DirLineGraph.h"
+#include "topoeval/SampleStats.h"
 #include "util/geo/Geo.h"
+#include "util/geo/RTree.h"
 #include "util/geo/output/GeoGraphJsonOutput.h"
 #include "util/graph/EDijkstra.h"
 #include "util/log/Log.h"
+#ifdef _OPENMP
+#include <omp.h>
+#else
+#define omp_get_num_procs() 1
+#endif
 
 std::vector<shared::linegraph::LineNode*> gtNds;
 std::vector<std::string> gtStations;
 
-util::geo::Grid<topoeval::DirLineNode*, Point, double> testGrid;
-util::geo::Grid<topoeval::DirLineNode*, Point, double> gtGrid;
+util::geo::RTree<topoeval::DirLineNode*, Point, double> testIdx;
+util::geo::RTree<topoeval::DirLineNode*, Point, double> gtIdx;
 
 std::unordered_map<std::string, std::set<topoeval::DirLineNode*>> stationsGt;
 std::unordered_map<std::string, std::set<topoeval::DirLineNode*>> stationsTest;
@@ -165,19 +178,23 @@ std::pair<std::pair<std::set<topoeval::DirLineNode*>,
                     std::set<topoeval::DirLineNode*>>,
           std::pair<std::set<topoeval::DirLineNode*>,
                     std::set<topoeval::DirLineNode*>>>
-getFromToCandsStat() {
+getFromToCandsStat(std::mt19937* rng) {
   std::pair<std::pair<std::set<topoeval::DirLineNode*>,
                       std::set<topoeval::DirLineNode*>>,
             std::pair<std::set<topoeval::DirLineNode*>,
                       std::set<topoeval::DirLineNode*>>>
       ret;
-  auto fromStat = gtStations[rand() % gtStations.size()];
-  auto toStat = gtStations[rand() % gtStations.size()];
+  auto fromStat = gtStations[(*rng)() % gtStations.size()];
+  auto toStat = gtStations[(*rng)() % gtStations.size()];
 
-  ret.first.first = stationsGt[fromStat];
-  ret.first.second = stationsGt[toStat];
-  ret.second.first = stationsTest[fromStat];
-  ret.second.second = stationsTest[toStat];
+  // called concurrently, the station maps must not be modified here
+  ret.first.first = stationsGt.at(fromStat);
+  ret.first.second = stationsGt.at(toStat);
+
+  auto testFr = stationsTest.find(fromStat);
+  if (testFr != stationsTest.end()) ret.second.first = testFr->second;
+  auto testTo = stationsTest.find(toStat);
+  if (testTo != stationsTest.end()) ret.second.second = testTo->second;
 
   return ret;
 }
@@ -187,14 +204,14 @@ std::pair<std::pair<std::set<topoeval::DirLineNode*>,
                     std::set<topoeval::DirLineNode*>>,
           std::pair<std::set<topoeval::DirLineNode*>,
                     std::set<topoeval::DirLineNode*>>>
-getFromToCands(double d) {
+getFromToCands(double d, std::mt19937* rng) {
   std::pair<std::pair<std::set<topoeval::DirLineNode*>,
                       std::set<topoeval::DirLineNode*>>,
             std::pair<std::set<topoeval::DirLineNode*>,
                       std::set<topoeval::DirLineNode*>>>
       ret;
-  auto from = gtNds[rand() % gtNds.size()];
-  auto to = gtNds[rand() % gtNds.size()];
+  auto from = gtNds[(*rng)() % gtNds.size()];
+  auto to = gtNds[(*rng)() % gtNds.size()];
 
   std::set<topoeval::DirLineNode*> testNeighsFr;
   std::set<topoeval::DirLineNode*> testNeighsTo;
@@ -212,8 +229,8 @@ getFromToCands(double d) {
   // auto fromGeom = util::geo::Point<double>{875686, 6.11379e+06};
   // auto toGeom = util::geo::Point<double>{876380, 6.11301e+06};
 
-  testGrid.get(fromGeom, d, &testNeighsFr);
-  testGrid.get(toGeom, d, &testNeighsTo);
+  testIdx.get(fromGeom, d, &testNeighsFr);
+  testIdx.get(toGeom, d, &testNeighsTo);
 
   for (auto neigh : testNeighsFr) {
     if (util::geo::dist(*neigh->pl().getGeom(), fromGeom) <= d)
@@ -225,8 +242,8 @@ getFromToCands(double d) {
       testTo.insert(neigh);
   }
 
-  gtGrid.get(fromGeom, d, &gtNeighsFr);
-  gtGrid.get(toGeom, d, &gtNeighsTo);
+  gtIdx.get(fromGeom, d, &gtNeighsFr);
+  gtIdx.get(toGeom, d, &gtNeighsTo);
 
   for (auto neigh : gtNeighsFr) {
     if (util::geo::dist(*neigh->pl().getGeom(), fromGeom) <= d)
@@ -256,8 +273,11 @@ int main(int argc, char** argv) {
 
   double d = 150;
   size_t SAMPLES = 10000;
+  unsigned seed = rand();
+  size_t threads = 0;
 
   bool fromStations = false;
+  bool fromBin = false;
 
   std::string gtPath, testPath;
 
@@ -266,7 +286,8 @@ int main(int argc, char** argv) {
     if (cur == "-h" || cur == "--help") {
       std::cerr << "Usage: " << argv[0]
                 << "[-d <maxdist=150>] [-s <numsamples=10000>] "
-                   "[--sample-stations] <ground truth "
+                   "[--seed <seed>] [--threads <threads=0>] "
+                   "[--sample-stations] [--from-bin] <ground truth "
                    "graph> <test graph>"
                 << std::endl;
       exit(0);
@@ -278,12 +299,26 @@ int main(int argc, char** argv) {
       d = atof(argv[i]);
     } else if (cur == "--sample-stations") {
       fromStations = true;
+    } else if (cur == "--from-bin") {
+      fromBin = true;
     } else if (cur == "-s") {
       if (++i >= argc) {
         LOG(ERROR) << "Missing argument for samples (-s).";
         exit(1);
       }
       SAMPLES = atoi(argv[i]);
+    } else if (cur == "--seed") {
+      if (++i >= argc) {
+        LOG(ERROR) << "Missing argument for seed (--seed).";
+        exit(1);
+      }
+      seed = strtoul(argv[i], 0, 10);
+    } else if (cur == "--threads") {
+      if (++i >= argc) {
+        LOG(ERROR) << "Missing argument for threads (--threads).";
+        exit(1);
+      }
+      threads = atoi(argv[i]);
     } else {
       if (gtPath.empty())
         gtPath = cur;
@@ -313,12 +348,18 @@ int main(int argc, char** argv) {
 
   std::ifstream ifs;
 
-  ifs.open(gtPath);
-  gtGraph.readFromJson(&ifs, false);
+  ifs.open(gtPath, std::ios::binary);
+  if (fromBin)
+    gtGraph.readFromBin(&ifs, false);
+  else
+    gtGraph.readFromJson(&ifs, false);
   ifs.close();
 
-  ifs.open(testPath);
-  testGraph.readFromJson(&ifs, false);
+  ifs.open(testPath, std::ios::binary);
+  if (fromBin)
+    testGraph.readFromBin(&ifs, false);
+  else
+    testGraph.readFromJson(&ifs, false);
   ifs.close();
 
   LOG(DEBUG) << "Ground truth graph: " << gtGraph.getNds().size() << " nodes";
@@ -347,17 +388,15 @@ int main(int argc, char** argv) {
     }
   }
 
-  testGrid = util::geo::Grid<topoeval::DirLineNode*, Point, double>(
-      120, 120, testGraph.getBBox());
   for (auto nd : testDirGraph.getNds()) {
-    testGrid.add(*nd->pl().getGeom(), nd);
+    testIdx.add(*nd->pl().getGeom(), nd);
   }
+  testIdx.build();
 
-  gtGrid = util::geo::Grid<topoeval::DirLineNode*, Point, double>(
-      120, 120, gtGraph.getBBox());
   for (auto nd : gtDirGraph.getNds()) {
-    gtGrid.add(*nd->pl().getGeom(), nd);
+    gtIdx.add(*nd->pl().getGeom(), nd);
   }
+  gtIdx.build();
 
   gtNds = std::vector<shared::linegraph::LineNode*>(gtGraph.getNds().begin(),
                                                     gtGraph.getNds().end());
@@ -373,25 +412,37 @@ int main(int argc, char** argv) {
     }
   }
 
-  for (auto i : lineMap) {
-    for (auto nd : testGraph.getNds()) {
-      for (auto e : nd->getAdjList()) {
-        for (auto l : e->pl().getLines()) {
-          if (l.line->id() == i.first->id()) {
-            lineMap[i.first] = l.line;
-          }
-        }
-      }
+  std::unordered_map<std::string, const shared::linegraph::Line*> testLines;
+  for (auto nd : testGraph.getNds()) {
+    for (auto e : nd->getAdjList()) {
+      for (auto l : e->pl().getLines()) testLines[l.line->id()] = l.line;
     }
   }
 
-  double match = 0, unmatch = 0;
+  for (auto& i : lineMap) {
+    auto testLine = testLines.find(i.first->id());
+    if (testLine != testLines.end()) i.second = testLine->second;
+  }
+
+  if (threads == 0) threads = omp_get_num_procs();
 
-  double minFrech = std::numeric_limits<double>::max();
-  double maxFrech = 0;
-  double frechAvg = 0;
+  LOGTO(INFO, std::cerr) << "Evaluating " << SAMPLES << " samples with seed "
+                         << seed << " on " << threads << " threads";
 
+  // per sample, the outcome and the Frechet distance between both paths
+  std::vector<topoeval::Sample> samples(SAMPLES);
+
+  // the line of the first sample without a counterpart in the test data
+  const shared::linegraph::Line* missingLine = 0;
+  size_t missingSample = SAMPLES;
+
+#pragma omp parallel for num_threads(threads) schedule(dynamic, 16)
   for (size_t i = 0; i < SAMPLES; i++) {
+    // each sample draws from its own stream, the results do not depend on
+    // the number of threads
+    std::seed_seq seq{seed, static_cast<unsigned>(i)};
+    std::mt19937 rng(seq);
+
     std::vector<const shared::linegraph::Line*> lines;
     std::set<const shared::linegraph::Line*> linesSet;
 
@@ -402,9 +453,9 @@ int main(int argc, char** argv) {
         cands;
 
     if (fromStations)
-      cands = getFromToCandsStat();
+      cands = getFromToCandsStat(&rng);
     else
-      cands = getFromToCands(d);
+      cands = getFromToCands(d, &rng);
 
     auto gtFr = cands.first.first;
     auto gtTo = cands.first.second;
@@ -432,7 +483,9 @@ int main(int argc, char** argv) {
       }
     }
 
-    auto gtLine = lines[rand() % lines.size()];
+    if (lines.empty()) continue;
+
+    auto gtLine = lines[rng() % lines.size()];
     CostFunc cFuncGt(gtLine);
 
     util::graph::EList<topoeval::DirLineNodePL, topoeval::DirLineEdgePL>*
@@ -448,12 +501,18 @@ int main(int argc, char** argv) {
     auto cGt = util::graph::EDijkstra::shortestPath(gtFr, gtTo, cFuncGt,
                                                     resEdges, &resNodesGt);
 
-    if (!lineMap[gtLine]) {
-      LOG(ERROR) << "Input line " << gtLine->id() << " (" << gtLine->label()
-                 << ") not found in test data";
-      exit(1);
+    auto testLine = lineMap.find(gtLine);
+    if (testLine == lineMap.end() || !testLine->second) {
+#pragma omp critical
+      {
+        if (i < missingSample) {
+          missingSample = i;
+          missingLine = gtLine;
+        }
+      }
+      continue;
     }
-    CostFunc cFuncTest(lineMap[gtLine]);
+    CostFunc cFuncTest(testLine->second);
     auto cTest = util::graph::EDijkstra::shortestPath(
         testFr, testTo, cFuncTest, &resEdgesTest, &resNodesTest);
 
@@ -469,28 +528,27 @@ int main(int argc, char** argv) {
 
     if ((cGt > std::numeric_limits<double>::max()) ^
         (cTest > std::numeric_limits<double>::max())) {
-      unmatch += 1;
+      samples[i].status = topoeval::UNMATCHED;
       continue;
     }
 
-    double frechetDist = util::geo::frechetDist(lineTest, lineGt, 15);
+    samples[i].status = topoeval::FOUND;
+    samples[i].frechetDist = util::geo::frechetDist(lineTest, lineGt, 15);
     LOG(DEBUG) << " for line " << gtLine->label() << " : " << cGt << " vs "
-               << cTest << ": fr " << frechetDist;
-
-    frechAvg += frechetDist;
-
-    if (frechetDist > maxFrech) maxFrech = frechetDist;
-    if (frechetDist < minFrech) minFrech = frechetDist;
+               << cTest << ": fr " << samples[i].frechetDist;
+  }
 
-    if (frechetDist < d)
-      match += 1;
-    else {
-      unmatch += 1;
-    }
+  if (missingLine) {
+    LOG(ERROR) << "Input line " << missingLine->id() << " ("
+               << missingLine->label() << ") not found in test data";
+    exit(1);
   }
 
-  std::cout << match / (match + unmatch) << "\t" << minFrech << "\t" << maxFrech
-            << "\t" << frechAvg / (match + unmatch) << std::endl;
+  auto stats = topoeval::aggregate(samples, d);
+
+  std::cout << stats.match / (stats.match + stats.unmatch) << "\t"
+            << stats.minFrech << "\t" << stats.maxFrech << "\t"
+            << stats.frechAvg / (stats.match + stats.unmatch) << std::endl;
 
   return (0);
 }
@@ -0,0 +1,52 @@
+// Copyright 2022
+// Author: Patrick Brosi
+
+#include <vector>
+
+#include "topoeval/SampleStats.h"
+#include "topoeval/tests/SampleStatsTest.h"
+#include "util/Misc.h"
+
+using topoeval::Sample;
+using util::approx;
+
+// _____________________________________________________________________________
+void SampleStatsTest::run() {
+  // ___________________________________________________________________________
+  {
+    std::vector<Sample> samples(5);
+
+    // samples[0] stays skipped
+    samples[1].status = topoeval::FOUND;
+    samples[1].frechetDist = 10;
+
+    samples[2].status = topoeval::UNMATCHED;
+
+    samples[3].status = topoeval::FOUND;
+    samples[3].frechetDist = 150;
+
+    samples[4].status = topoeval::FOUND;
+    samples[4].frechetDist = 50;
+
+    auto stats = topoeval::aggregate(samples, 100);
+
+    // the skipped sample is not counted, the unmatched one is
+    TEST(stats.match, ==, approx(2));
+    TEST(stats.unmatch, ==, approx(2));
+    TEST(stats.minFrech, ==, approx(10));
+    TEST(stats.maxFrech, ==, approx(150));
+    TEST(stats.frechAvg, ==, approx(210));
+  }
+
+  // ___________________________________________________________________________
+  {
+    std::vector<Sample> samples(3);
+    samples[1].status = topoeval::UNMATCHED;
+
+    auto stats = topoeval::aggregate(samples, 100);
+
+    TEST(stats.match, ==, approx(0));
+    TEST(stats.unmatch, ==, approx(1));
+    TEST(stats.frechAvg, ==, approx(0));
+  }
+}
@@ -0,0 +1,12 @@
+// Copyright 2022
+// Author: Patrick Brosi
+
+#ifndef TOPOEVAL_TEST_SAMPLESTATSTEST_H_
+#define TOPOEVAL_TEST_SAMPLESTATSTEST_H_
+
+class SampleStatsTest {
+  public:
+    void run();
+};
+
+#endif
@@ -0,0 +1,15 @@
+// Copyright 2022
+// Author: Patrick Brosi
+
+#include "topoeval/tests/SampleStatsTest.h"
+
+#include "util/Misc.h"
+
+// _____________________________________________________________________________
+int main(int argc, char** argv) {
+  UNUSED(argc);
+  UNUSED(argv);
+  SampleStatsTest st;
+
+  st.run();
+}
@@ -7,36 +7,33 @@
 #include <fstream>
 #include <iostream>
 #include <set>
+#include <sstream>
+#include <stdexcept>
 #include <string>
+#include "3rdparty/json.hpp"
 #include "shared/rendergraph/Penalties.h"
 #include "shared/rendergraph/RenderGraph.h"
 #include "transitmap/config/ConfigReader.cpp"
 #include "transitmap/config/TransitMapConfig.h"
 #include "transitmap/graph/GraphBuilder.h"
 #include "transitmap/output/SvgRenderer.h"
+#include "util/Misc.h"
+#include "util/http/Server.h"
 #include "util/log/Log.h"
 
 // _____________________________________________________________________________
-int main(int argc, char** argv) {
-  // disable output buffering for standard output
-  setbuf(stdout, NULL);
-
-  // initialize randomness
-  srand(time(NULL) + rand());
-
-  transitmapper::config::Config cfg;
-
-  transitmapper::config::ConfigReader cr;
-  cr.read(&cfg, argc, argv);
-
+void render(const transitmapper::config::Config& cfg, std::istream* in,
+            std::ostream* os) {
   LOGTO(DEBUG, std::cerr) << "Reading graph...";
   shared::rendergraph::RenderGraph g(cfg.lineWidth, cfg.lineSpacing);
   transitmapper::graph::GraphBuilder b(&cfg);
 
   if (cfg.fromDot) {
-    g.readFromDot(&std::cin, cfg.inputSmoothing);
+    g.readFromDot(in, cfg.inputSmoothing);
+  } else if (cfg.fromBin) {
+    g.readFromBin(in, cfg.inputSmoothing);
   } else {
-    g.readFromJson(&std::cin, cfg.inputSmoothing);
+    g.readFromJson(in, cfg.inputSmoothing);
   }
 
   g.smooth();
@@ -51,10 +48,67 @@ int main(int argc, char** argv) {
 
   if (cfg.renderMethod == "svg") {
     LOGTO(DEBUG, std::cerr) << "Outputting to SVG ...";
-    transitmapper::output::SvgRenderer svgOut(&std::cout, &cfg);
+    transitmapper::output::SvgRenderer svgOut(os, &cfg);
     svgOut.print(g);
   } else {
-    LOG(ERROR) << "Unknown render method " << cfg.renderMethod;
+    throw std::runtime_error("Unknown render method " + cfg.renderMethod);
+  }
+}
+
+// _____________________________________________________________________________
+class TransitMapHandler : public util::http::Handler {
+ public:
+  explicit TransitMapHandler(const transitmapper::config::Config* cfg)
+      : _cfg(cfg) {}
+
+  util::http::Answer handle(const util::http::Req& req, int con) const {
+    UNUSED(con);
+    if (req.cmd != "POST") throw util::http::HttpErr("405 Method Not Allowed");
+
+    std::stringstream in(req.payload);
+    std::stringstream out;
+
+    try {
+      render(*_cfg, &in, &out);
+    } catch (const nlohmann::json::exception& exc) {
+      return util::http::Answer("400 Bad Request", exc.what());
+    } catch (const std::runtime_error& exc) {
+      // thrown on malformed binary graphs
+      return util::http::Answer("400 Bad Request", exc.what());
+    }
+
+    util::http::Answer answ("200 OK", out.str());
+    answ.params["Content-Type"] = "image/svg+xml";
+    return answ;
+  }
+
+ private:
+  const transitmapper::config::Config* _cfg;
+};
+
+// _____________________________________________________________________________
+int main(int argc, char** argv) {
+  // initialize randomness
+  srand(time(NULL) + rand());
+
+  transitmapper::config::Config cfg;
+
+  transitmapper::config::ConfigReader cr;
+  cr.read(&cfg, argc, argv);
+
+  try {
+    if (cfg.servePort > -1) {
+      LOGTO(INFO, std::cerr) << "Listening on port " << cfg.servePort
+                             << "...";
+      TransitMapHandler h(&cfg);
+      util::http::HttpServer serv(cfg.servePort, &h, cfg.serveThreads,
+                                  cfg.serveTimeout);
+      serv.run();
+    } else {
+      render(cfg, &std::cin, &std::cout);
+    }
+  } catch (const std::runtime_error& err) {
+    LOG(ERROR) << err.what();
     exit(1);
   }
 
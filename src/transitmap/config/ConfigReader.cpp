@@ -56,6 +56,8 @@ void ConfigReader::help(const char* bin) const {
             << "Misc:\n"
             << std::setw(37) << "  -D [ --from-dot ]"
             << "input is in dot format\n"
+            << std::setw(37) << "  --from-bin"
+            << "input is in binary line graph format\n"
             << std::setw(37) << "  --padding arg (=-1)"
             << "padding, -1 for auto\n"
             << std::setw(37) << "  --smoothing arg (=3)"
@@ -69,7 +71,15 @@ void ConfigReader::help(const char* bin) const {
             << std::setw(37) << "  --no-render-node-connections"
             << "don't render inner node connections\n"
             << std::setw(37) << "  --render-node-fronts"
-            << "render node fronts\n";
+            << "render node fronts\n\n"
+            << "Server:\n"
+            << std::setw(37) << "  --serve arg"
+            << "run as HTTP server on port arg, input graphs\n"
+            << std::setw(37) << " " << " are read from POST requests\n"
+            << std::setw(37) << "  --serve-threads arg (=1)"
+            << "max number of requests handled in parallel\n"
+            << std::setw(37) << "  --serve-timeout arg (=60)"
+            << "socket read/write timeout (seconds)\n";
 }
 
 // _____________________________________________________________________________
@@ -93,6 +103,10 @@ void ConfigReader::read(Config* cfg, int argc, char** argv) const {
                          {"padding", required_argument, 0, 13},
                          {"smoothing", required_argument, 0, 14},
                          {"render-node-fronts", no_argument, 0, 15},
+                         {"serve", required_argument, 0, 17},
+                         {"serve-threads", required_argument, 0, 18},
+                         {"serve-timeout", required_argument, 0, 19},
+                         {"from-bin", no_argument, 0, 20},
                          {0, 0, 0, 0}};
 
   char c;
@@ -152,6 +166,18 @@ void ConfigReader::read(Config* cfg, int argc, char** argv) const {
       case 16:
         cfg->dontLabelDeg2 = true;
         break;
+      case 17:
+        cfg->servePort = atoi(optarg);
+        break;
+      case 18:
+        cfg->serveThreads = atoi(optarg);
+        break;
+      case 19:
+        cfg->serveTimeout = atoi(optarg);
+        break;
+      case 20:
+        cfg->fromBin = true;
+        break;
       case 'D':
         cfg->fromDot = true;
         break;
@@ -35,12 +35,17 @@ struct Config {
   bool renderLabels = false;
   bool dontLabelDeg2 = false;
   bool fromDot = false;
+  bool fromBin = false;
 
   bool renderNodeConnections = true;
   bool tightStations = false;
 
   bool renderDirMarkers = false;
   std::string worldFilePath;
+
+  int servePort = -1;
+  size_t serveThreads = 1;
+  size_t serveTimeout = 60;
 };
 
 }  // namespace config
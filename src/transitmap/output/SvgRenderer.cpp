@@ -12,6 +12,7 @@
 #include "transitmap/config/TransitMapConfig.h"
 #include "transitmap/label/Labeller.h"
 #include "transitmap/output/SvgRenderer.h"
+#include "util/Misc.h"
 #include "util/String.h"
 #include "util/geo/PolyLine.h"
 #include "util/log/Log.h"
@@ -103,6 +104,14 @@ void SvgRenderer::print(const RenderGraph& outG) {
   if (_cfg->renderEdges) {
     outputEdges(outG, rparams);
   }
+
+  LOGTO(DEBUG, std::cerr) << "Rendering nodes...";
+  for (auto n : outG.getNds()) {
+    if (_cfg->renderNodeConnections) {
+      renderNodeConnections(outG, n, rparams);
+    }
+  }
+
   _w.openTag("svg", params);
 
   _w.openTag("defs");
@@ -130,14 +139,9 @@ void SvgRenderer::print(const RenderGraph& outG) {
     _w.closeTag();
   }
 
-  _w.closeTag();
+  renderStyleSheet();
 
-  LOGTO(DEBUG, std::cerr) << "Rendering nodes...";
-  for (auto n : outG.getNds()) {
-    if (_cfg->renderNodeConnections) {
-      renderNodeConnections(outG, n, rparams);
-    }
-  }
+  _w.closeTag();
 
   LOGTO(DEBUG, std::cerr) << "Writing edges...";
   renderDelegates(outG, rparams);
@@ -189,21 +193,19 @@ void SvgRenderer::renderNodeFronts(const RenderGraph& outG,
     std::string color = n->pl().stops().size() > 0 ? "red" : "black";
     for (auto& f : n->pl().fronts()) {
       const PolyLine<double> p = f.geom;
-      std::stringstream style;
-      style << "fill:none;stroke:" << color
-            << ";stroke-linejoin: "
-               "miter;stroke-linecap:round;stroke-opacity:0.9;stroke-width:1";
       std::map<std::string, std::string> params;
-      params["style"] = style.str();
+      params["style"] = "fill:none;stroke:" + color +
+                        ";stroke-linejoin: "
+                        "miter;stroke-linecap:round;stroke-opacity:0.9;"
+                        "stroke-width:1";
       printLine(p, params, rparams);
 
       DPoint a = p.getPointAt(.5).p;
 
-      std::stringstream styleA;
-      styleA << "fill:none;stroke:" << color
-             << ";stroke-linejoin: "
-                "miter;stroke-linecap:round;stroke-opacity:1;stroke-width:.5";
-      params["style"] = styleA.str();
+      params["style"] = "fill:none;stroke:" + color +
+                        ";stroke-linejoin: "
+                        "miter;stroke-linecap:round;stroke-opacity:1;"
+                        "stroke-width:.5";
 
       printLine(PolyLine<double>(*n->pl().getGeom(), a), params, rparams);
     }
@@ -408,26 +410,23 @@ void SvgRenderer::renderClique(const InnerClique& cc, const LineNode* n) {
         }
       }
 
-      std::stringstream styleOutlineCropped;
-      styleOutlineCropped << "fill:none;stroke:#000000";
-
-      styleOutlineCropped << ";stroke-linecap:butt;stroke-width:"
-                          << (_cfg->lineWidth + _cfg->outlineWidth) *
-                                 _cfg->outputResolution;
       Params paramsOutlineCropped;
-      paramsOutlineCropped["style"] = styleOutlineCropped.str();
       paramsOutlineCropped["class"] += " inner-geom-outline";
       paramsOutlineCropped["class"] += " " + getLineClass(c.geoms[i].from.line->id());
+      addStyle(&paramsOutlineCropped,
+               "fill:none;stroke:#000000;stroke-linecap:butt;stroke-width:" +
+                   util::formatFloat((_cfg->lineWidth + _cfg->outlineWidth) *
+                                         _cfg->outputResolution,
+                                     3));
 
-      std::stringstream styleStr;
-      styleStr << "fill:none;stroke:#" << c.geoms[i].from.line->color();
-
-      styleStr << ";stroke-linecap:round;stroke-opacity:1;stroke-width:"
-               << _cfg->lineWidth * _cfg->outputResolution;
       Params params;
-      params["style"] = styleStr.str();
       params["class"] += " inner-geom ";
       params["class"] += " " + getLineClass(c.geoms[i].from.line->id());
+      addStyle(&params, "fill:none;stroke:#" + c.geoms[i].from.line->color() +
+                            ";stroke-linecap:round;stroke-opacity:1;"
+                            "stroke-width:" +
+                            util::formatFloat(
+                                _cfg->lineWidth * _cfg->outputResolution, 3));
 
       _innerDelegates.back()[(uintptr_t)c.geoms[i].from.line].push_back(
           OutlinePrintPair(PrintDelegate(params, pl),
@@ -448,26 +447,24 @@ void SvgRenderer::renderLinePart(const PolyLine<double> p, double width,
                                  const Line& line, const std::string& css,
                                  const std::string& oCss,
                                  const std::string& endMarker) {
-  std::stringstream styleOutline;
-  styleOutline << "fill:none;stroke:#000000;stroke-linecap:round;stroke-width:"
-               << (width + _cfg->outlineWidth) * _cfg->outputResolution << ";"
-               << oCss;
   Params paramsOutline;
-  paramsOutline["style"] = styleOutline.str();
   paramsOutline["class"] = "transit-edge-outline " + getLineClass(line.id());
+  addStyle(&paramsOutline,
+           "fill:none;stroke:#000000;stroke-linecap:round;stroke-width:" +
+               util::formatFloat(
+                   (width + _cfg->outlineWidth) * _cfg->outputResolution, 3) +
+               ";" + oCss);
 
-  std::stringstream styleStr;
-  styleStr << "fill:none;stroke:#" << line.color() << ";" << css;
+  std::string style = "fill:none;stroke:#" + line.color() + ";" + css;
 
-  if (!endMarker.empty()) {
-    styleStr << ";marker-end:url(#" << endMarker << ")";
-  }
+  if (!endMarker.empty()) style += ";marker-end:url(#" + endMarker + ")";
+
+  style += ";stroke-linecap:round;stroke-opacity:1;stroke-width:" +
+           util::formatFloat(width * _cfg->outputResolution, 3);
 
-  styleStr << ";stroke-linecap:round;stroke-opacity:1;stroke-width:"
-           << width * _cfg->outputResolution;
   Params params;
-  params["style"] = styleStr.str();
   params["class"] = "transit-edge " + getLineClass(line.id());
+  addStyle(&params, style);
 
   _delegates[0].insert(_delegates[0].begin(),
                        OutlinePrintPair(PrintDelegate(params, p),
@@ -627,18 +624,14 @@ void SvgRenderer::printLine(const PolyLine<double>& l, const std::string& style,
 void SvgRenderer::printLine(const PolyLine<double>& l,
                             const std::map<std::string, std::string>& ps,
                             const RenderParams& rparams) {
-  std::map<std::string, std::string> params = ps;
-  std::stringstream points;
-
+  _points.clear();
   for (auto& p : l.getLine()) {
-    points << " " << (p.getX() - rparams.xOff) * _cfg->outputResolution << ","
-           << rparams.height -
-                  (p.getY() - rparams.yOff) * _cfg->outputResolution;
+    if (!_points.empty()) _points += ' ';
+    appendPoint(p, rparams, ',');
   }
 
-  params["points"] = points.str();
-
-  _w.openTag("polyline", params);
+  _w.openTag("polyline", ps);
+  _w.attr("points", _points);
   _w.closeTag();
 }
 
@@ -647,18 +640,16 @@ void SvgRenderer::printPolygon(const Polygon<double>& g,
                                const std::map<std::string, std::string>& ps,
                                const RenderParams& rparams) {
   std::map<std::string, std::string> params = ps;
-  std::stringstream points;
+  params["class"] = "station-poly";
 
+  _points.clear();
   for (auto& p : g.getOuter()) {
-    points << " " << (p.getX() - rparams.xOff) * _cfg->outputResolution << ","
-           << rparams.height -
-                  (p.getY() - rparams.yOff) * _cfg->outputResolution;
+    if (!_points.empty()) _points += ' ';
+    appendPoint(p, rparams, ',');
   }
 
-  params["points"] = points.str();
-  params["class"] = "station-poly";
-
   _w.openTag("polygon", params);
+  _w.attr("points", _points);
   _w.closeTag();
 }
 
@@ -720,25 +711,18 @@ void SvgRenderer::renderStationLabels(const Labeller& labeller,
       textPath.reverse();
     }
 
-    std::stringstream points;
     std::map<std::string, std::string> pathPars;
 
-    points << "M"
-           << (textPath.front().getX() - rparams.xOff) * _cfg->outputResolution
-           << " "
-           << rparams.height - (textPath.front().getY() - rparams.yOff) *
-                                   _cfg->outputResolution;
-
+    _points = "M";
+    appendPoint(textPath.front(), rparams, ' ');
     for (auto& p : textPath.getLine()) {
-      points << " L" << (p.getX() - rparams.xOff) * _cfg->outputResolution
-             << " "
-             << rparams.height -
-                    (p.getY() - rparams.yOff) * _cfg->outputResolution;
+      _points += " L";
+      appendPoint(p, rparams, ' ');
     }
 
     std::string idStr = "stlblp" + util::toString(id);
 
-    pathPars["d"] = points.str();
+    pathPars["d"] = _points;
     pathPars["id"] = idStr;
     id++;
 
@@ -783,25 +767,18 @@ void SvgRenderer::renderLineLabels(const Labeller& labeller,
       textPath.reverse();
     }
 
-    std::stringstream points;
     std::map<std::string, std::string> pathPars;
 
-    points << "M"
-           << (textPath.front().getX() - rparams.xOff) * _cfg->outputResolution
-           << " "
-           << rparams.height - (textPath.front().getY() - rparams.yOff) *
-                                   _cfg->outputResolution;
-
+    _points = "M";
+    appendPoint(textPath.front(), rparams, ' ');
     for (auto& p : textPath.getLine()) {
-      points << " L" << (p.getX() - rparams.xOff) * _cfg->outputResolution
-             << " "
-             << rparams.height -
-                    (p.getY() - rparams.yOff) * _cfg->outputResolution;
+      _points += " L";
+      appendPoint(p, rparams, ' ');
     }
 
     std::string idStr = "textp" + util::toString(id);
 
-    pathPars["d"] = points.str();
+    pathPars["d"] = _points;
     pathPars["id"] = idStr;
     id++;
 
@@ -865,6 +842,53 @@ std::string SvgRenderer::getLineClass(const std::string& id) const {
   return "line-" + std::to_string(lineClassId);
 }
 
+// _____________________________________________________________________________
+void SvgRenderer::addStyle(Params* params, const std::string& css) {
+  if (_styleSheetWritten) {
+    (*params)["style"] = css;
+    return;
+  }
+
+  auto i = _styleClasses.find(css);
+  if (i == _styleClasses.end()) {
+    i = _styleClasses
+            .insert({css, "s" + std::to_string(_styleClasses.size())})
+            .first;
+  }
+
+  (*params)["class"] += " " + i->second;
+}
+
+// _____________________________________________________________________________
+void SvgRenderer::renderStyleSheet() {
+  _styleSheetWritten = true;
+  if (_styleClasses.empty()) return;
+
+  std::string css;
+  for (const auto& s : _styleClasses) {
+    css += "." + s.second + "{" + s.first + "}\n";
+  }
+
+  _w.openTag("style", "type", "text/css");
+  _w.writeText(css);
+  _w.closeTag();
+}
+
+// _____________________________________________________________________________
+void SvgRenderer::appendCoord(double c) {
+  char buf[util::FLOAT_BUF_SIZE];
+  _points.append(buf, util::formatFloat(c, 2, buf));
+}
+
+// _____________________________________________________________________________
+void SvgRenderer::appendPoint(const DPoint& p, const RenderParams& rparams,
+                              char sep) {
+  appendCoord((p.getX() - rparams.xOff) * _cfg->outputResolution);
+  _points += sep;
+  appendCoord(rparams.height -
+              (p.getY() - rparams.yOff) * _cfg->outputResolution);
+}
+
 // _____________________________________________________________________________
 bool InnerClique::operator<(const InnerClique& rhs) const {
   // more weight = more to the bottom
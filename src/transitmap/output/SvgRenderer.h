@@ -113,6 +113,13 @@ class SvgRenderer : public Renderer {
   mutable std::map<std::string, int> lineClassIds;
   mutable int lineClassId = 0;
 
+  // identical line styles are written once as CSS classes
+  std::map<std::string, std::string> _styleClasses;
+  bool _styleSheetWritten = false;
+
+  // reused buffer for point lists
+  std::string _points;
+
   void outputNodes(const shared::rendergraph::RenderGraph& outputGraph,
                    const RenderParams& params);
   void outputEdges(const shared::rendergraph::RenderGraph& outputGraph,
@@ -167,6 +174,15 @@ class SvgRenderer : public Renderer {
 
   std::string getLineClass(const std::string& id) const;
 
+  // reference a style by its CSS class, or inline it if the style sheet has
+  // already been written
+  void addStyle(Params* params, const std::string& css);
+  void renderStyleSheet();
+
+  void appendCoord(double c);
+  void appendPoint(const util::geo::DPoint& p, const RenderParams& rparams,
+                   char sep);
+
   std::string getMarkerPathMale(double w) const;
   std::string getMarkerPathFemale(double w) const;
 };
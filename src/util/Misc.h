@@ -5,6 +5,7 @@
 #ifndef UTIL_MISC_H_
 #define UTIL_MISC_H_
 
+#include <algorithm>
 #include <cmath>
 #include <cstring>
 #include <chrono>
@@ -115,19 +116,88 @@ inline bool isFloatingPoint(const std::string& str) {
   return ss.eof() && ! ss.fail();
 }
 
+// maximum length of a number written by formatFloat()
+const size_t FLOAT_BUF_SIZE = 340;
+
 // _____________________________________________________________________________
-inline std::string formatFloat(double f, size_t digits) {
-  std::stringstream ss;
-  ss << std::fixed << std::setprecision(digits) << f;
-	std::string ret = ss.str();
-
-  if (ret.find('.') != std::string::npos) {
-		auto p = ret.find_last_not_of('0');
-    if (ret[p] == '.') return ret.substr(0, p);
-    return ret.substr(0, p + 1);
+inline size_t formatFloat(double f, size_t digits, char* buf) {
+  // writes f rounded half up to at most digits (<= 20) decimals into buf,
+  // without trailing zeros, returns the number of chars written. The shortest
+  // digits which read back as f are taken from Grisu2.
+  char* p = buf;
+
+  // checked on the bits, std::isnan() and std::isinf() are optimized away
+  // under -ffinite-math-only
+  uint64_t bits;
+  memcpy(&bits, &f, sizeof(bits));
+  if (((bits >> 52) & 0x7FF) == 0x7FF) {
+    if (bits & 0xFFFFFFFFFFFFF) {
+      memcpy(p, "nan", 3);
+      return 3;
+    }
+    if (f < 0) *p++ = '-';
+    memcpy(p, "inf", 3);
+    return p + 3 - buf;
   }
 
-  return ret;
+  if (f == 0) {
+    *p = '0';
+    return 1;
+  }
+
+  char d[32];
+  int len, k;
+  Grisu2(std::fabs(f), d, &len, &k);
+
+  // f = 0.d * 10^point
+  int point = len + k;
+
+  int keep = point + static_cast<int>(std::min<size_t>(digits, 20));
+  if (keep < len) {
+    bool up = keep >= 0 && d[keep] >= '5';
+    len = std::max(keep, 0);
+    if (up) {
+      int i = len - 1;
+      while (i >= 0 && d[i] == '9') d[i--] = '0';
+      if (i >= 0) {
+        d[i]++;
+      } else {
+        memmove(d + 1, d, len);
+        d[0] = '1';
+        len++;
+        point++;
+      }
+    }
+  }
+
+  while (len > std::max(point, 0) && d[len - 1] == '0') len--;
+
+  if (len == 0) {
+    *p = '0';
+    return 1;
+  }
+
+  if (f < 0) *p++ = '-';
+
+  if (point <= 0) {
+    *p++ = '0';
+  } else {
+    for (int i = 0; i < point; i++) *p++ = i < len ? d[i] : '0';
+  }
+
+  if (len > point) {
+    *p++ = '.';
+    for (int i = point; i < 0; i++) *p++ = '0';
+    for (int i = std::max(point, 0); i < len; i++) *p++ = d[i];
+  }
+
+  return p - buf;
+}
+
+// _____________________________________________________________________________
+inline std::string formatFloat(double f, size_t digits) {
+  char buf[FLOAT_BUF_SIZE];
+  return std::string(buf, formatFloat(f, digits, buf));
 }
 
 // _____________________________________________________________________________
@@ -232,6 +302,14 @@ size_t inversions(const std::vector<V>& v) {
   if (v.size() == 2) return v[1] < v[0];
   if (v.size() == 3) return (v[0] > v[1]) + (v[0] > v[2]) + (v[1] > v[2]);
 
+  // for short lists, counting pairwise is faster than merge sorting
+  if (v.size() < 16) {
+    size_t ret = 0;
+    for (size_t i = 0; i < v.size(); i++)
+      for (size_t j = i + 1; j < v.size(); j++) ret += v[j] < v[i];
+    return ret;
+  }
+
   auto tmpLst = new V[v.size()];
   auto lst = new V[v.size()];
 
@@ -1893,47 +1893,67 @@ inline Line<T> densify(const Line<T>& l, double d) {
 }
 
 // _____________________________________________________________________________
-template <typename T>
-inline double frechetDistC(size_t i, size_t j, const Line<T>& p,
-                           const Line<T>& q, std::vector<float>& ca) {
+template <typename T, typename DistF>
+inline double frechetDistRows(const Line<T>& p, const Line<T>& q, DistF distF,
+                              double maxD) {
   // based on Eiter / Mannila
   // http://www.kr.tuwien.ac.at/staff/eiter/et-archive/cdtr9464.pdf
+  // The coupling table is filled row by row, only the previous row is kept.
+  // Every coupling passes each row, so once a whole row exceeds maxD the
+  // distance does too, and infinity is returned early.
+
+  if (p.empty() || q.empty()) return std::numeric_limits<double>::infinity();
+
+  std::vector<float> prev(q.size()), cur(q.size()), d(q.size());
+
+  for (size_t i = 0; i < p.size(); i++) {
+    // distances first, in a loop without dependencies between the cells
+    for (size_t j = 0; j < q.size(); j++) d[j] = distF(p[i], q[j]);
+
+    if (i == 0) {
+      cur[0] = d[0];
+      for (size_t j = 1; j < q.size(); j++) cur[j] = std::max(cur[j - 1], d[j]);
+    } else {
+      cur[0] = std::max(prev[0], d[0]);
+      for (size_t j = 1; j < q.size(); j++) {
+        cur[j] = std::max(std::min(std::min(prev[j], prev[j - 1]), cur[j - 1]),
+                          d[j]);
+      }
+    }
+
+    if (*std::min_element(cur.begin(), cur.end()) > maxD)
+      return std::numeric_limits<double>::infinity();
 
-  if (ca[i * q.size() + j] > -1)
-    return ca[i * q.size() + j];
-  else if (i == 0 && j == 0)
-    ca[i * q.size() + j] = dist(p[0], q[0]);
-  else if (i > 0 && j == 0)
-    ca[i * q.size() + j] =
-        std::max(frechetDistC(i - 1, 0, p, q, ca), dist(p[i], q[0]));
-  else if (i == 0 && j > 0)
-    ca[i * q.size() + j] =
-        std::max(frechetDistC(0, j - 1, p, q, ca), dist(p[0], q[j]));
-  else if (i > 0 && j > 0)
-    ca[i * q.size() + j] =
-        std::max(std::min(std::min(frechetDistC(i - 1, j, p, q, ca),
-                                   frechetDistC(i - 1, j - 1, p, q, ca)),
-                          frechetDistC(i, j - 1, p, q, ca)),
-                 dist(p[i], q[j]));
-  else
-    ca[i * q.size() + j] = std::numeric_limits<float>::infinity();
+    std::swap(prev, cur);
+  }
 
-  return ca[i * q.size() + j];
+  return prev.back();
 }
 
 // _____________________________________________________________________________
 template <typename T>
 inline double frechetDist(const Line<T>& a, const Line<T>& b, double d) {
-  // based on Eiter / Mannila
-  // http://www.kr.tuwien.ac.at/staff/eiter/et-archive/cdtr9464.pdf
-
   const auto& p = densify(a, d);
   const auto& q = densify(b, d);
 
-  std::vector<float> ca(p.size() * q.size(), -1.0);
-  double fd = frechetDistC(p.size() - 1, q.size() - 1, p, q, ca);
+  return frechetDistRows(
+      p, q, [](const Point<T>& a, const Point<T>& b) { return dist(a, b); },
+      std::numeric_limits<double>::infinity());
+}
+
+// _____________________________________________________________________________
+template <typename T>
+inline bool frechetDistLeq(const Line<T>& a, const Line<T>& b, double d,
+                           double maxD) {
+  // true if the Frechet distance between a and b is at most maxD, stops as
+  // soon as it is certain to be larger
+  const auto& p = densify(a, d);
+  const auto& q = densify(b, d);
 
-  return fd;
+  return frechetDistRows(
+             p, q,
+             [](const Point<T>& a, const Point<T>& b) { return dist(a, b); },
+             maxD) <= maxD;
 }
 
 // _____________________________________________________________________________
@@ -1966,48 +1986,16 @@ inline double accFrechetDistC(const Line<T>& a, const Line<T>& b, double d) {
   return ca[p.size() * q.size() - 1];
 }
 
-// _____________________________________________________________________________
-template <typename T>
-inline double frechetDistCHav(size_t i, size_t j, const Line<T>& p,
-                              const Line<T>& q, std::vector<float>& ca) {
-  // based on Eiter / Mannila
-  // http://www.kr.tuwien.ac.at/staff/eiter/et-archive/cdtr9464.pdf
-
-  if (ca[i * q.size() + j] > -1)
-    return ca[i * q.size() + j];
-  else if (i == 0 && j == 0)
-    ca[i * q.size() + j] = haversine(p[0], q[0]);
-  else if (i > 0 && j == 0)
-    ca[i * q.size() + j] =
-        std::max(frechetDistCHav(i - 1, 0, p, q, ca), haversine(p[i], q[0]));
-  else if (i == 0 && j > 0)
-    ca[i * q.size() + j] =
-        std::max(frechetDistCHav(0, j - 1, p, q, ca), haversine(p[0], q[j]));
-  else if (i > 0 && j > 0)
-    ca[i * q.size() + j] =
-        std::max(std::min(std::min(frechetDistCHav(i - 1, j, p, q, ca),
-                                   frechetDistCHav(i - 1, j - 1, p, q, ca)),
-                          frechetDistCHav(i, j - 1, p, q, ca)),
-                 haversine(p[i], q[j]));
-  else
-    ca[i * q.size() + j] = std::numeric_limits<float>::infinity();
-
-  return ca[i * q.size() + j];
-}
-
 // _____________________________________________________________________________
 template <typename T>
 inline double frechetDistHav(const Line<T>& a, const Line<T>& b, double d) {
-  // based on Eiter / Mannila
-  // http://www.kr.tuwien.ac.at/staff/eiter/et-archive/cdtr9464.pdf
-
   const auto& p = densify(a, d);
   const auto& q = densify(b, d);
 
-  std::vector<float> ca(p.size() * q.size(), -1.0);
-  double fd = frechetDistCHav(p.size() - 1, q.size() - 1, p, q, ca);
-
-  return fd;
+  return frechetDistRows(
+      p, q,
+      [](const Point<T>& a, const Point<T>& b) { return haversine(a, b); },
+      std::numeric_limits<double>::infinity());
 }
 
 // _____________________________________________________________________________
@@ -96,6 +96,10 @@ class Grid {
   size_t getXWidth() const;
   size_t getYHeight() const;
 
+  double getCellWidth() const;
+  double getCellHeight() const;
+  const Box<T>& getBBox() const;
+
   size_t getCellXFromX(double lon) const;
   size_t getCellYFromY(double lat) const;
 
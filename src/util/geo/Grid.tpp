@@ -225,3 +225,21 @@ template <typename V, template <typename> class G, typename T>
 size_t Grid<V, G, T>::getYHeight() const {
   return _yHeight;
 }
+
+// _____________________________________________________________________________
+template <typename V, template <typename> class G, typename T>
+double Grid<V, G, T>::getCellWidth() const {
+  return _cellWidth;
+}
+
+// _____________________________________________________________________________
+template <typename V, template <typename> class G, typename T>
+double Grid<V, G, T>::getCellHeight() const {
+  return _cellHeight;
+}
+
+// _____________________________________________________________________________
+template <typename V, template <typename> class G, typename T>
+const Box<T>& Grid<V, G, T>::getBBox() const {
+  return _bb;
+}
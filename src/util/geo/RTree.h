@@ -0,0 +1,92 @@
+// Copyright 2016, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+// Author: Patrick Brosi <brosi@informatik.uni-freiburg.de>
+
+#ifndef UTIL_GEO_RTREE_H_
+#define UTIL_GEO_RTREE_H_
+
+#include <algorithm>
+#include <cmath>
+#include <queue>
+#include <set>
+#include <vector>
+#include "util/geo/Geo.h"
+
+namespace util {
+namespace geo {
+
+template <typename T>
+struct RTreeNode {
+  Box<T> bbox;   // bounding box of all entries below this node
+  size_t first;  // for leafs, index of the first value, for other nodes
+                 // index of the first child node
+  size_t num;    // number of values (leafs) or child nodes
+};
+
+// Static R-tree, bulk loaded with the sort-tile-recursive (STR) algorithm.
+// Values are collected with add() and become queryable after build(). Nodes
+// and values are kept in flat arrays, the children of each node are
+// contiguous. Meant for build-once, query-many workloads where a Grid would
+// need tuning to the (possibly very skewed) data density.
+template <typename V, template <typename> class G, typename T>
+class RTree {
+ public:
+  // the empty tree with a node capacity of 16
+  RTree();
+
+  // the empty tree, each node holds at most c values or child nodes
+  explicit RTree(size_t c);
+
+  // add value val with geometry geom, only visible after build()
+  void add(const G<T>& geom, V val);
+
+  // pack all values added so far into the tree
+  void build();
+
+  // all values whose bounding box intersects box
+  void get(const Box<T>& box, std::set<V>* s) const;
+  void get(const Box<T>& box, std::vector<V>* s) const;
+
+  // all values whose bounding box is within distance d of geom's bounding
+  // box
+  void get(const G<T>& geom, double d, std::set<V>* s) const;
+
+  // the (at most) k values nearest to p, ordered by increasing distance
+  void getNearest(const Point<T>& p, size_t k, std::vector<V>* s) const;
+
+  size_t size() const;
+  const Box<T>& getBBox() const;
+
+ private:
+  size_t _capa;
+
+  struct Entry {
+    Box<T> bbox;
+    V val;
+    size_t geom;
+  };
+
+  std::vector<Entry> _vals;
+  std::vector<G<T>> _geoms;
+
+  // the leafs come first, the root node is the last node
+  std::vector<RTreeNode<T>> _nds;
+  size_t _numLeafs;
+
+  Box<T> _bb;
+
+  template <typename E>
+  void pack(std::vector<E>* els, size_t first, size_t n);
+
+  template <typename Out>
+  void query(const Box<T>& box, Out out) const;
+
+  static double boxDist(const Point<T>& p, const Box<T>& b);
+};
+
+#include "util/geo/RTree.tpp"
+
+}  // namespace geo
+}  // namespace util
+
+#endif  // UTIL_GEO_RTREE_H_
@@ -0,0 +1,194 @@
+// Copyright 2016, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+// Author: Patrick Brosi <brosi@informatik.uni-freiburg.de>
+
+// _____________________________________________________________________________
+template <typename V, template <typename> class G, typename T>
+RTree<V, G, T>::RTree() : RTree<V, G, T>(16) {}
+
+// _____________________________________________________________________________
+template <typename V, template <typename> class G, typename T>
+RTree<V, G, T>::RTree(size_t c)
+    : _capa(std::max<size_t>(c, 2)), _numLeafs(0) {}
+
+// _____________________________________________________________________________
+template <typename V, template <typename> class G, typename T>
+void RTree<V, G, T>::add(const G<T>& geom, V val) {
+  _vals.push_back({getBoundingBox(geom), val, _geoms.size()});
+  _geoms.push_back(geom);
+}
+
+// _____________________________________________________________________________
+template <typename V, template <typename> class G, typename T>
+void RTree<V, G, T>::build() {
+  _nds.clear();
+  _numLeafs = 0;
+  _bb = Box<T>();
+
+  if (_vals.empty()) return;
+
+  // leaf level
+  pack(&_vals, 0, _vals.size());
+  for (size_t i = 0; i < _vals.size(); i += _capa) {
+    RTreeNode<T> nd{_vals[i].bbox, i, std::min(_capa, _vals.size() - i)};
+    for (size_t j = i + 1; j < i + nd.num; j++)
+      nd.bbox = extendBox(_vals[j].bbox, nd.bbox);
+    _nds.push_back(nd);
+  }
+  _numLeafs = _nds.size();
+
+  // pack each level into its parent level until a single root is left
+  size_t lvlFirst = 0;
+  while (_nds.size() - lvlFirst > 1) {
+    size_t lvlEnd = _nds.size();
+    pack(&_nds, lvlFirst, lvlEnd - lvlFirst);
+
+    for (size_t i = lvlFirst; i < lvlEnd; i += _capa) {
+      RTreeNode<T> nd{_nds[i].bbox, i, std::min(_capa, lvlEnd - i)};
+      for (size_t j = i + 1; j < i + nd.num; j++)
+        nd.bbox = extendBox(_nds[j].bbox, nd.bbox);
+      _nds.push_back(nd);
+    }
+
+    lvlFirst = lvlEnd;
+  }
+
+  _bb = _nds.back().bbox;
+}
+
+// _____________________________________________________________________________
+template <typename V, template <typename> class G, typename T>
+template <typename E>
+void RTree<V, G, T>::pack(std::vector<E>* els, size_t first, size_t n) {
+  // sort-tile-recursive: sort by x, cut into sqrt(P) vertical slices of
+  // sqrt(P) nodes each, and sort each slice by y. Consecutive runs of _capa
+  // elements then form the nodes.
+  size_t numNds = (n + _capa - 1) / _capa;
+  size_t numSlices = ceil(sqrt(numNds));
+  size_t sliceSize = numSlices * _capa;
+
+  auto beg = els->begin() + first;
+
+  std::sort(beg, beg + n, [](const E& a, const E& b) {
+    return a.bbox.getLowerLeft().getX() + a.bbox.getUpperRight().getX() <
+           b.bbox.getLowerLeft().getX() + b.bbox.getUpperRight().getX();
+  });
+
+  for (size_t i = 0; i < n; i += sliceSize) {
+    std::sort(beg + i, beg + std::min(n, i + sliceSize),
+              [](const E& a, const E& b) {
+                return a.bbox.getLowerLeft().getY() +
+                           a.bbox.getUpperRight().getY() <
+                       b.bbox.getLowerLeft().getY() +
+                           b.bbox.getUpperRight().getY();
+              });
+  }
+}
+
+// _____________________________________________________________________________
+template <typename V, template <typename> class G, typename T>
+template <typename Out>
+void RTree<V, G, T>::query(const Box<T>& box, Out out) const {
+  if (_nds.empty()) return;
+
+  std::vector<size_t> stack{_nds.size() - 1};
+
+  while (!stack.empty()) {
+    const auto& nd = _nds[stack.back()];
+    bool leaf = stack.back() < _numLeafs;
+    stack.pop_back();
+
+    if (!intersects(nd.bbox, box)) continue;
+
+    if (leaf) {
+      for (size_t i = nd.first; i < nd.first + nd.num; i++) {
+        if (intersects(_vals[i].bbox, box)) out(_vals[i].val);
+      }
+    } else {
+      for (size_t i = nd.first; i < nd.first + nd.num; i++) stack.push_back(i);
+    }
+  }
+}
+
+// _____________________________________________________________________________
+template <typename V, template <typename> class G, typename T>
+void RTree<V, G, T>::get(const Box<T>& box, std::set<V>* s) const {
+  query(box, [s](const V& v) { s->insert(v); });
+}
+
+// _____________________________________________________________________________
+template <typename V, template <typename> class G, typename T>
+void RTree<V, G, T>::get(const Box<T>& box, std::vector<V>* s) const {
+  query(box, [s](const V& v) { s->push_back(v); });
+}
+
+// _____________________________________________________________________________
+template <typename V, template <typename> class G, typename T>
+void RTree<V, G, T>::get(const G<T>& geom, double d, std::set<V>* s) const {
+  get(pad(getBoundingBox(geom), d), s);
+}
+
+// _____________________________________________________________________________
+template <typename V, template <typename> class G, typename T>
+void RTree<V, G, T>::getNearest(const Point<T>& p, size_t k,
+                                std::vector<V>* s) const {
+  if (_nds.empty() || k == 0) return;
+
+  // best-first search, the distance to a node's bounding box is a lower
+  // bound for the distance to all values below it
+  struct Cand {
+    double d;
+    size_t id;
+    bool val;
+    bool operator<(const Cand& o) const { return d > o.d; }
+  };
+
+  std::priority_queue<Cand> pq;
+  pq.push({boxDist(p, _nds.back().bbox), _nds.size() - 1, false});
+
+  size_t found = 0;
+
+  while (!pq.empty()) {
+    auto cur = pq.top();
+    pq.pop();
+
+    if (cur.val) {
+      s->push_back(_vals[cur.id].val);
+      if (++found == k) return;
+    } else if (cur.id < _numLeafs) {
+      const auto& nd = _nds[cur.id];
+      for (size_t i = nd.first; i < nd.first + nd.num; i++) {
+        pq.push({util::geo::dist(p, _geoms[_vals[i].geom]), i, true});
+      }
+    } else {
+      const auto& nd = _nds[cur.id];
+      for (size_t i = nd.first; i < nd.first + nd.num; i++) {
+        pq.push({boxDist(p, _nds[i].bbox), i, false});
+      }
+    }
+  }
+}
+
+// _____________________________________________________________________________
+template <typename V, template <typename> class G, typename T>
+size_t RTree<V, G, T>::size() const {
+  return _vals.size();
+}
+
+// _____________________________________________________________________________
+template <typename V, template <typename> class G, typename T>
+const Box<T>& RTree<V, G, T>::getBBox() const {
+  return _bb;
+}
+
+// _____________________________________________________________________________
+template <typename V, template <typename> class G, typename T>
+double RTree<V, G, T>::boxDist(const Point<T>& p, const Box<T>& b) {
+  double dx = std::max<double>(
+      0, std::max<double>(b.getLowerLeft().getX() - p.getX(),
+                          p.getX() - b.getUpperRight().getX()));
+  double dy = std::max<double>(
+      0, std::max<double>(b.getLowerLeft().getY() - p.getY(),
+                          p.getY() - b.getUpperRight().getY()));
+  return sqrt(dx * dx + dy * dy);
+}
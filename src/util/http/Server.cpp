@@ -10,6 +10,7 @@
 #include <netdb.h>
 #include <netinet/in.h>
 #include <netinet/tcp.h>
+#include <sys/time.h>
 #include <algorithm>
 #include <csignal>
 #include <memory>
@@ -93,7 +94,9 @@ void HttpServer::send(int sock, Answer* aw) {
   while (writes != buff.size()) {
     int64_t out = write(sock, buff.c_str() + writes, buff.size() - writes);
     if (out < 0) {
-      if (errno == EWOULDBLOCK || errno == EAGAIN || errno == EINTR) continue;
+      if (errno == EINTR) continue;
+      if (errno == EWOULDBLOCK || errno == EAGAIN)
+        throw std::runtime_error("Timeout while writing to socket");
       throw std::runtime_error("Failed to write to socket");
     }
     writes += out;
@@ -106,6 +109,14 @@ void HttpServer::handle() {
   while ((connection = _jobs.get()) != -1) {
     Answer answ;
 
+    if (_timeout) {
+      struct timeval tv;
+      tv.tv_sec = _timeout;
+      tv.tv_usec = 0;
+      setsockopt(connection, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+      setsockopt(connection, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+    }
+
     try {
       Req req = getReq(connection);
       answ = _handler->handle(req, connection);
@@ -162,7 +173,9 @@ Req HttpServer::getReq(int connection) {
 
   while ((curRcvd = read(connection, buf + rcvd, BSIZE - rcvd))) {
     if (curRcvd < 0) {
-      if (errno == EAGAIN || errno == EINTR) continue;
+      if (errno == EINTR) continue;
+      if (errno == EAGAIN || errno == EWOULDBLOCK)
+        throw HttpErr("408 Request Timeout");
       throw HttpErr("500 Internal Server Error");
     }
 
@@ -236,9 +249,11 @@ Req HttpServer::getReq(int connection) {
 
     rcvd += curRcvd;
 
+    // header is complete, the buffer may already hold parts of the payload
+    if (brk) break;
+
     // buffer is full
     if (rcvd == BSIZE) throw HttpErr("431 Request Header Fields Too Large");
-    if (brk) break;
   }
 
   // POST payload
@@ -247,8 +262,7 @@ Req HttpServer::getReq(int connection) {
     if (ret.params.count("Content-Length"))
       size = atoi(ret.params["Content-Length"].c_str());
     if (size) {
-      char* postBuf = new char[size + 1];
-      postBuf[size] = 0;
+      char* postBuf = new char[size];
       size_t rem = 0;
 
       // copy existing to new buffer
@@ -260,18 +274,21 @@ Req HttpServer::getReq(int connection) {
       rcvd = 0;
 
       if (rem < size) {
-        while ((curRcvd = read(connection, postBuf + rcvd + rem, size - rem))) {
-          if (curRcvd == -1 && (errno == EAGAIN || errno == EINTR)) continue;
-          if (curRcvd == -1) {
-            postBuf[rcvd + 1] = 0;
-            break;
+        while ((curRcvd = read(connection, postBuf + rcvd + rem,
+                               size - rem - rcvd))) {
+          if (curRcvd == -1 && errno == EINTR) continue;
+          if (curRcvd == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            delete[] postBuf;
+            throw HttpErr("408 Request Timeout");
           }
+          if (curRcvd == -1) break;
           rcvd += curRcvd;
           if (rcvd == size - rem) break;
         }
       }
 
-      ret.payload = postBuf;
+      // the payload may be binary and contain NUL bytes
+      ret.payload.assign(postBuf, rem + rcvd);
       delete[] postBuf;
     }
   }
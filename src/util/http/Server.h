@@ -115,7 +115,9 @@ class HttpServer {
  public:
   HttpServer(int port, const Handler* h) : HttpServer(port, h, 0) {}
   HttpServer(int port, const Handler* h, size_t threads)
-      : _port(port), _handler(h), _threads(threads) {
+      : HttpServer(port, h, threads, 0) {}
+  HttpServer(int port, const Handler* h, size_t threads, size_t timeout)
+      : _port(port), _handler(h), _threads(threads), _timeout(timeout) {
     if (!_threads) _threads = 8 * std::thread::hardware_concurrency();
   }
   void run();
@@ -126,6 +128,9 @@ class HttpServer {
   const Handler* _handler;
   size_t _threads;
 
+  // socket read and write timeout in seconds, 0 means no timeout
+  size_t _timeout;
+
   void handle();
 
   static void send(int sock, Answer* aw);
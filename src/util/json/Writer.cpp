@@ -2,8 +2,10 @@
 // Chair of Algorithms and Data Structures.
 // Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
 
-#include <iomanip>
+#include <cmath>
+#include <cstring>
 #include "Writer.h"
+#include "util/Misc.h"
 #include "util/String.h"
 using namespace util;
 using namespace json;
@@ -12,6 +14,8 @@ using std::ostream;
 using std::string;
 using std::map;
 
+static const size_t BUF_SIZE = 1 << 16;
+
 // _____________________________________________________________________________
 Writer::Writer(std::ostream* out)
     : _out(out), _pretty(false), _indent(2), _floatPrec(10) {}
@@ -35,7 +39,7 @@ void Writer::obj() {
   if (!_stack.empty() && _stack.top().type == KEY) _stack.pop();
   if (!_stack.empty() && _stack.top().type == ARR) valCheck();
   if (_stack.size() && _stack.top().type == ARR) prettor();
-  *_out << "{";
+  put('{');
   _stack.push({OBJ, 1});
 }
 
@@ -43,11 +47,14 @@ void Writer::obj() {
 void Writer::key(const std::string& k) {
   if (_stack.empty() || _stack.top().type != OBJ)
     throw WriterException("Keys only allowed in objects.");
-  if (!_stack.top().empty) (*_out) << ",";
+  if (!_stack.top().empty) put(',');
   _stack.top().empty = 0;
   prettor();
-  *_out << "\"" << k << "\""
-        << ":" << (_pretty ? " " : "");
+  put('"');
+  put(k);
+  put('"');
+  put(':');
+  if (_pretty) put(' ');
   _stack.push({KEY, 1});
 }
 
@@ -57,7 +64,10 @@ void Writer::valCheck() {
     throw WriterException("Value not allowed here.");
   if (!_stack.empty() && _stack.top().type == KEY) _stack.pop();
   if (!_stack.empty() && _stack.top().type == ARR) {
-    if (!_stack.top().empty) (*_out) << "," << (_pretty ? " " : "");
+    if (!_stack.top().empty) {
+      put(',');
+      if (_pretty) put(' ');
+    }
     _stack.top().empty = 0;
   }
 }
@@ -65,43 +75,50 @@ void Writer::valCheck() {
 // _____________________________________________________________________________
 void Writer::val(const std::string& v) {
   valCheck();
-  *_out << "\"" << util::jsonStringEscape(v) << "\"";
+  put('"');
+  put(util::jsonStringEscape(v));
+  put('"');
 }
 
 // _____________________________________________________________________________
 void Writer::val(const char* v) {
   valCheck();
-  *_out << "\"" << util::jsonStringEscape(v) << "\"";
+  put('"');
+  put(util::jsonStringEscape(v));
+  put('"');
 }
 
 // _____________________________________________________________________________
 void Writer::val(bool v) {
   valCheck();
-  *_out << (v ? "true" : "false");
+  if (v)
+    put("true", 4);
+  else
+    put("false", 5);
 }
 
 // _____________________________________________________________________________
 void Writer::val(int v) {
   valCheck();
-  *_out << v;
+  putInt(v);
 }
 
 // _____________________________________________________________________________
 void Writer::val(uint64_t v) {
   valCheck();
-  *_out << v;
+  putUInt(v);
 }
 
 // _____________________________________________________________________________
 void Writer::val(double v) {
   valCheck();
-  *_out << std::fixed << std::setprecision(_floatPrec) << v;
+  putFloat(v);
 }
 
 // _____________________________________________________________________________
 void Writer::val(Null) {
   valCheck();
-  *_out << "null";
+  put("null", 4);
 }
 
 // _____________________________________________________________________________
@@ -146,21 +163,22 @@ void Writer::arr() {
     throw WriterException("Array not allowed as key");
   if (!_stack.empty() && _stack.top().type == KEY) _stack.pop();
   if (!_stack.empty() && _stack.top().type == ARR) valCheck();
-  *_out << "[";
+  put('[');
   _stack.push({ARR, 1});
 }
 
 // _____________________________________________________________________________
 void Writer::prettor() {
   if (_pretty) {
-    *_out << "\n";
-    for (size_t i = 0; i < _indent * _stack.size(); i++) (*_out) << " ";
+    put('\n');
+    _buf.append(_indent * _stack.size(), ' ');
   }
 }
 
 // _____________________________________________________________________________
 void Writer::closeAll() {
   while (!_stack.empty()) close();
+  flush();
 }
 
 // _____________________________________________________________________________
@@ -170,13 +188,73 @@ void Writer::close() {
     case OBJ:
       _stack.pop();
       prettor();
-      (*_out) << "}";
+      put('}');
       break;
     case ARR:
       _stack.pop();
-      (*_out) << "]";
+      put(']');
       break;
     case KEY:
       throw WriterException("Missing value.");
   }
 }
+
+// _____________________________________________________________________________
+void Writer::flush() {
+  if (_buf.empty()) return;
+  _out->write(_buf.data(), _buf.size());
+  _buf.clear();
+}
+
+// _____________________________________________________________________________
+void Writer::put(char c) {
+  _buf.push_back(c);
+  if (_buf.size() >= BUF_SIZE) flush();
+}
+
+// _____________________________________________________________________________
+void Writer::put(const char* s, size_t n) {
+  _buf.append(s, n);
+  if (_buf.size() >= BUF_SIZE) flush();
+}
+
+// _____________________________________________________________________________
+void Writer::put(const std::string& s) { put(s.data(), s.size()); }
+
+// _____________________________________________________________________________
+void Writer::putUInt(uint64_t v) {
+  char buf[20];
+  char* p = buf + sizeof(buf);
+  do {
+    *--p = '0' + v % 10;
+    v /= 10;
+  } while (v);
+  put(p, buf + sizeof(buf) - p);
+}
+
+// _____________________________________________________________________________
+void Writer::putInt(int64_t v) {
+  if (v < 0) {
+    put('-');
+    putUInt(-static_cast<uint64_t>(v));
+  } else {
+    putUInt(v);
+  }
+}
+
+// _____________________________________________________________________________
+void Writer::putFloat(double v) {
+  // no JSON representation for inf and nan, checked on the bits because
+  // std::isfinite() is optimized away under -ffinite-math-only
+  uint64_t bits;
+  memcpy(&bits, &v, sizeof(bits));
+  if (((bits >> 52) & 0x7FF) == 0x7FF) return put("null", 4);
+
+  // integral values are written without a fractional part
+  if (std::fabs(v) < 9007199254740992.0 && v == std::floor(v)) {
+    return putInt(static_cast<int64_t>(v));
+  }
+
+  char buf[util::FLOAT_BUF_SIZE];
+  put(buf, util::formatFloat(v, _floatPrec, buf));
+}
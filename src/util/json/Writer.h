@@ -64,7 +64,7 @@ class Writer {
   Writer(std::ostream* out, size_t prec);
   Writer(std::ostream* out, size_t prec, bool pretty);
   Writer(std::ostream* out, size_t prec, bool pretty, size_t indent);
-  ~Writer(){};
+  ~Writer() { flush(); };
 
   void obj();
   void arr();
@@ -86,9 +86,16 @@ class Writer {
   void close();
   void closeAll();
 
+  // write the buffered output to the stream, done automatically by
+  // closeAll() and on destruction
+  void flush();
+
  private:
   std::ostream* _out;
 
+  // output is collected here and written to _out in large chunks
+  std::string _buf;
+
   enum NODE_T { OBJ, ARR, KEY };
 
   struct Node {
@@ -104,6 +111,13 @@ class Writer {
 
   void valCheck();
   void prettor();
+
+  void put(char c);
+  void put(const char* s, size_t n);
+  void put(const std::string& s);
+  void putUInt(uint64_t v);
+  void putInt(int64_t v);
+  void putFloat(double v);
 };
 
 }  // namespace json
@@ -0,0 +1,183 @@
+// Copyright 2016
+// Author: Patrick Brosi
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <set>
+#include <vector>
+#include "util/Misc.h"
+#include "util/geo/Grid.h"
+#include "util/geo/RTree.h"
+#include "util/log/Log.h"
+#include "util/tests/RTreeTest.h"
+
+using util::approx;
+using util::geo::DBox;
+using util::geo::DLine;
+using util::geo::DPoint;
+using util::geo::Grid;
+using util::geo::Line;
+using util::geo::Point;
+using util::geo::RTree;
+
+// _____________________________________________________________________________
+void RTreeTest::run() {
+  // ___________________________________________________________________________
+  {
+    RTree<int, Point, double> rt;
+    rt.build();
+
+    std::set<int> ret;
+    rt.get(DBox(DPoint(0, 0), DPoint(10, 10)), &ret);
+    TEST(ret.size(), ==, 0);
+
+    std::vector<int> nearest;
+    rt.getNearest({0, 0}, 3, &nearest);
+    TEST(nearest.size(), ==, 0);
+  }
+
+  // ___________________________________________________________________________
+  {
+    RTree<int, Point, double> rt(4);
+
+    rt.add({2, 2}, 0);
+    rt.add({0, 0}, 1);
+    rt.add({0, 1}, 2);
+    rt.add({6, 9}, 3);
+    rt.add({9, 0}, 4);
+    rt.build();
+
+    TEST(rt.size(), ==, 5);
+    TEST(rt.getBBox().getLowerLeft().getX(), ==, approx(0));
+    TEST(rt.getBBox().getUpperRight().getY(), ==, approx(9));
+
+    std::set<int> ret;
+    rt.get(DBox(DPoint(0, 0), DPoint(2, 2)), &ret);
+    TEST(ret.size(), ==, 3);
+    TEST(ret.count(0));
+    TEST(ret.count(1));
+    TEST(ret.count(2));
+
+    ret.clear();
+    rt.get(DPoint(9, 1), 1, &ret);
+    TEST(ret.size(), ==, 1);
+    TEST(ret.count(4));
+
+    std::vector<int> nearest;
+    rt.getNearest({5, 8}, 2, &nearest);
+    TEST(nearest.size(), ==, 2);
+    TEST(nearest[0], ==, 3);
+    TEST(nearest[1], ==, 0);
+
+    nearest.clear();
+    rt.getNearest({5, 8}, 10, &nearest);
+    TEST(nearest.size(), ==, 5);
+  }
+
+  // ___________________________________________________________________________
+  {
+    // random, heavily clustered lines against a brute force scan
+    std::mt19937 gen(42);
+    std::normal_distribution<double> center(5000, 200);
+    std::uniform_real_distribution<double> rural(0, 100000);
+    std::uniform_real_distribution<double> off(-50, 50);
+
+    std::vector<DLine> lines;
+    RTree<size_t, Line, double> rt;
+    for (size_t i = 0; i < 5000; i++) {
+      DPoint a = i % 10 ? DPoint(center(gen), center(gen))
+                        : DPoint(rural(gen), rural(gen));
+      DLine l{a, {a.getX() + off(gen), a.getY() + off(gen)},
+              {a.getX() + off(gen), a.getY() + off(gen)}};
+      lines.push_back(l);
+      rt.add(l, i);
+    }
+    rt.build();
+
+    TEST(rt.size(), ==, 5000);
+
+    for (size_t q = 0; q < 200; q++) {
+      DPoint p = q % 2 ? DPoint(center(gen), center(gen))
+                       : DPoint(rural(gen), rural(gen));
+      DBox box = util::geo::pad(util::geo::getBoundingBox(p), 300);
+
+      std::set<size_t> ret;
+      rt.get(box, &ret);
+
+      std::set<size_t> exp;
+      for (size_t i = 0; i < lines.size(); i++) {
+        if (util::geo::intersects(util::geo::getBoundingBox(lines[i]), box))
+          exp.insert(i);
+      }
+      TEST(ret == exp);
+
+      std::vector<size_t> nearest;
+      rt.getNearest(p, 5, &nearest);
+      TEST(nearest.size(), ==, 5);
+
+      std::vector<double> dists;
+      for (const auto& l : lines) dists.push_back(util::geo::dist(p, l));
+      std::sort(dists.begin(), dists.end());
+
+      for (size_t i = 0; i < nearest.size(); i++) {
+        TEST(util::geo::dist(p, lines[nearest[i]]), ==, approx(dists[i]));
+      }
+    }
+  }
+
+  // ___________________________________________________________________________
+  {
+    // build and query times against a Grid on clustered points
+    std::mt19937 gen(7);
+    std::normal_distribution<double> center(50000, 1000);
+
+    std::vector<DPoint> pts;
+    for (size_t i = 0; i < 200000; i++)
+      pts.push_back({center(gen), center(gen)});
+
+    DBox bbox;
+    for (const auto& p : pts) bbox = util::geo::extendBox(p, bbox);
+
+    auto t0 = std::chrono::steady_clock::now();
+    Grid<size_t, Point, double> grid(120, 120, bbox);
+    for (size_t i = 0; i < pts.size(); i++) grid.add(pts[i], i);
+
+    auto t1 = std::chrono::steady_clock::now();
+    RTree<size_t, Point, double> rt;
+    for (size_t i = 0; i < pts.size(); i++) rt.add(pts[i], i);
+    rt.build();
+    auto t2 = std::chrono::steady_clock::now();
+
+    size_t gridFound = 0;
+    for (size_t i = 0; i < pts.size(); i += 20) {
+      std::set<size_t> ret;
+      grid.get(pts[i], 20, &ret);
+      gridFound += ret.size();
+    }
+
+    auto t3 = std::chrono::steady_clock::now();
+
+    size_t rtFound = 0;
+    for (size_t i = 0; i < pts.size(); i += 20) {
+      std::set<size_t> ret;
+      rt.get(pts[i], 20, &ret);
+      rtFound += ret.size();
+    }
+
+    auto t4 = std::chrono::steady_clock::now();
+
+    // the grid returns whole cells, the tree only matching boxes
+    TEST(rtFound, <=, gridFound);
+
+    LOG(INFO) << "Indexing " << pts.size() << " points, build grid: "
+              << std::chrono::duration<double, std::milli>(t1 - t0).count()
+              << " ms, rtree: "
+              << std::chrono::duration<double, std::milli>(t2 - t1).count()
+              << " ms; " << pts.size() / 20 << " queries grid: "
+              << std::chrono::duration<double, std::milli>(t3 - t2).count()
+              << " ms, rtree: "
+              << std::chrono::duration<double, std::milli>(t4 - t3).count()
+              << " ms";
+  }
+}
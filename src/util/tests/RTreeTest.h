@@ -0,0 +1,12 @@
+// Copyright 2016
+// Author: Patrick Brosi
+
+#ifndef UTIL_TEST_RTREETEST_H_
+#define UTIL_TEST_RTREETEST_H_
+
+class RTreeTest {
+  public:
+    void run();
+};
+
+#endif
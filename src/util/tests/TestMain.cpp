@@ -2,12 +2,19 @@
 // Author: Patrick Brosi
 //
 
-#include <string>
 #include <clocale>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
 #include "util/Misc.h"
 #include "util/Nullable.h"
 #include "util/String.h"
 #include "util/tests/QuadTreeTest.h"
+#include "util/tests/RTreeTest.h"
 #include "util/geo/Geo.h"
 #include "util/geo/Grid.h"
 #include "util/graph/Algorithm.h"
@@ -17,6 +24,8 @@
 #include "util/graph/EDijkstra.h"
 #include "util/graph/UndirGraph.h"
 #include "util/json/Writer.h"
+#include "util/xml/XmlWriter.h"
+#include "util/log/Log.h"
 
 using namespace util;
 using namespace util::geo;
@@ -24,6 +33,27 @@ using namespace util::graph;
 
 using util::approx;
 
+// _____________________________________________________________________________
+double frechetDistRef(size_t i, size_t j, const Line<double>& p,
+                      const Line<double>& q, std::vector<float>* ca) {
+  // the recursive, fully memoized formulation, as a reference
+  float& c = (*ca)[i * q.size() + j];
+  if (c > -1) return c;
+
+  if (i == 0 && j == 0)
+    c = geo::dist(p[0], q[0]);
+  else if (j == 0)
+    c = std::max(frechetDistRef(i - 1, 0, p, q, ca), geo::dist(p[i], q[0]));
+  else if (i == 0)
+    c = std::max(frechetDistRef(0, j - 1, p, q, ca), geo::dist(p[0], q[j]));
+  else
+    c = std::max(std::min(std::min(frechetDistRef(i - 1, j, p, q, ca),
+                                   frechetDistRef(i - 1, j - 1, p, q, ca)),
+                          frechetDistRef(i, j - 1, p, q, ca)),
+                 geo::dist(p[i], q[j]));
+  return c;
+}
+
 // _____________________________________________________________________________
 int main(int argc, char** argv) {
 	UNUSED(argc);
@@ -32,6 +62,9 @@ int main(int argc, char** argv) {
   QuadTreeTest quadTreeTest;
   quadTreeTest.run();
 
+  RTreeTest rTreeTest;
+  rTreeTest.run();
+
   // ___________________________________________________________________________
   {
     TEST(geo::frechetDist(Line<double>{{0, 0}, {10, 10}}, Line<double>{{0, 0},
@@ -151,6 +184,132 @@ int main(int argc, char** argv) {
             ss.str() == "[1,[2.13,{\"B\":2.12,\"a\":1},4],0]"));
   }
 
+  // ___________________________________________________________________________
+  {
+    auto fmt = [](double v, size_t prec) {
+      std::stringstream ss;
+      util::json::Writer wr(&ss, prec, false);
+      wr.arr();
+      wr.val(v);
+      wr.closeAll();
+      return ss.str();
+    };
+
+    TEST(fmt(0, 10), ==, "[0]");
+    TEST(fmt(-0.0, 10), ==, "[0]");
+    TEST(fmt(4, 10), ==, "[4]");
+    TEST(fmt(-17, 2), ==, "[-17]");
+    TEST(fmt(1e20, 2), ==, "[100000000000000000000]");
+    TEST(fmt(0.1, 10), ==, "[0.1]");
+    TEST(fmt(-2.5, 10), ==, "[-2.5]");
+    TEST(fmt(2.125, 2), ==, "[2.13]");
+    TEST(fmt(0.999, 2), ==, "[1]");
+    TEST(fmt(-0.999, 2), ==, "[-1]");
+    TEST(fmt(9.996, 2), ==, "[10]");
+    TEST(fmt(0.006, 2), ==, "[0.01]");
+    TEST(fmt(0.004, 2), ==, "[0]");
+    TEST(fmt(-0.004, 2), ==, "[0]");
+    TEST(fmt(0.0004, 2), ==, "[0]");
+    TEST(fmt(1.5e-7, 10), ==, "[0.00000015]");
+    TEST(fmt(3.14159, 0), ==, "[3]");
+    TEST(fmt(877008.7576027387, 10), ==, "[877008.7576027387]");
+    TEST(fmt(877008.7576027387, 3), ==, "[877008.758]");
+    TEST(fmt(1.5e300, 2).size(), ==, (size_t)303);
+    TEST(fmt(std::numeric_limits<double>::infinity(), 2), ==, "[null]");
+    TEST(fmt(std::nan(""), 2), ==, "[null]");
+
+    // written values read back within the precision
+    srand(17);
+    for (size_t i = 0; i < 10000; i++) {
+      double v = (rand() - RAND_MAX / 2) * 1.0 / (rand() + 1) *
+                 std::pow(10, rand() % 12 - 6);
+      std::string s = fmt(v, 10);
+      double back = std::atof(s.substr(1, s.size() - 2).c_str());
+      TEST(std::fabs(back - v), <=, 0.5e-10 + std::fabs(v) * 1e-15);
+    }
+
+    std::stringstream ss;
+    util::json::Writer wr(&ss, 2, false);
+    wr.arr();
+    wr.val(-2147483647 - 1);
+    wr.val(std::numeric_limits<uint64_t>::max());
+    wr.closeAll();
+    TEST(ss.str(), ==, "[-2147483648,18446744073709551615]");
+  }
+
+  // ___________________________________________________________________________
+  {
+    // coordinates per second written by the JSON writer, compared to
+    // formatting them through the output stream as before
+    std::vector<double> coords;
+    srand(42);
+    for (size_t i = 0; i < 400000; i++) {
+      coords.push_back(800000 + rand() * 100000.0 / RAND_MAX);
+    }
+
+    std::stringstream ssStream;
+    T_START(stream);
+    ssStream << "[";
+    for (size_t i = 0; i < coords.size(); i++) {
+      if (i) ssStream << ",";
+      ssStream << std::fixed << std::setprecision(10) << coords[i];
+    }
+    ssStream << "]";
+    double streamT = T_STOP(stream);
+
+    std::stringstream ssWriter;
+    T_START(writer);
+    util::json::Writer wr(&ssWriter, 10, false);
+    wr.arr();
+    for (double c : coords) wr.val(c);
+    wr.closeAll();
+    double writerT = T_STOP(writer);
+
+    TEST(ssWriter.str().size(), >, coords.size());
+
+    LOG(INFO) << "JSON coordinates/s: stream formatting "
+              << coords.size() / (streamT / 1000) << ", writer "
+              << coords.size() / (writerT / 1000);
+  }
+
+  // ___________________________________________________________________________
+  {
+    std::stringstream ss;
+    {
+      util::xml::XmlWriter w(&ss, false, 0);
+      w.openTag("svg", {{"a", "1"}, {"b", "x\"<&>"}});
+      w.attr("points", "1,2 3,4");
+      w.openTag("g");
+      w.writeText("a<b & c");
+      w.closeTag();
+
+      // nothing is written before the buffer is flushed
+      TEST(ss.str(), ==, "");
+
+      bool thrown = false;
+      try {
+        w.attr("c", "2");
+      } catch (const util::xml::XmlWriterException&) {
+        thrown = true;
+      }
+      TEST(thrown);
+
+      w.flush();
+      TEST(ss.str(), ==,
+           "<svg a=\"1\" b=\"x&quot;&lt;&amp;&gt;\" points=\"1,2 3,4\"><g>"
+           "a&lt;b &amp; c</g>");
+
+      for (size_t i = 0; i < 100000; i++) {
+        w.openTag("p", "v", std::to_string(i));
+        w.closeTag();
+      }
+    }
+
+    // the rest is written on destruction
+    TEST(ss.str().size(), >, (size_t)100000 * 10);
+    TEST(ss.str().substr(ss.str().size() - 15), ==, "<p v=\"99999\" />");
+  }
+
   // ___________________________________________________________________________
   {
     DirGraph<int, int> g;
@@ -384,6 +543,49 @@ int main(int argc, char** argv) {
     TEST(fd, ==, approx(1));
   }
 
+  // ___________________________________________________________________________
+  {
+    // random lines against the recursive formulation
+    std::mt19937 gen(1);
+    std::uniform_real_distribution<double> coord(0, 100);
+    std::uniform_int_distribution<size_t> len(1, 8);
+
+    for (size_t k = 0; k < 300; k++) {
+      Line<double> a, b;
+      size_t la = len(gen), lb = len(gen);
+      for (size_t i = 0; i < la; i++) a.push_back({coord(gen), coord(gen)});
+      for (size_t i = 0; i < lb; i++) b.push_back({coord(gen), coord(gen)});
+
+      double d = 5;
+      auto p = geo::densify(a, d);
+      auto q = geo::densify(b, d);
+      std::vector<float> ca(p.size() * q.size(), -1.0);
+      double ref = frechetDistRef(p.size() - 1, q.size() - 1, p, q, &ca);
+
+      double fd = geo::frechetDist(a, b, d);
+      TEST(fd, ==, ref);
+
+      TEST(geo::frechetDist(b, a, d), ==, approx(fd));
+      TEST(geo::frechetDistLeq(a, b, d, fd));
+      TEST(geo::frechetDistLeq(a, b, d, fd + 1));
+      TEST(!geo::frechetDistLeq(a, b, d, fd * 0.99 - 0.01));
+    }
+  }
+
+  // ___________________________________________________________________________
+  {
+    // densely sampled lines, 8000 points each, the full table would need
+    // 64M cells
+    Line<double> a{{0, 0}, {400, 0}, {400, 400}};
+    Line<double> b{{0, 1}, {400, 1}, {400, 400}};
+
+    TEST(geo::frechetDist(a, b, 0.1), ==, approx(1));
+    TEST(geo::frechetDistLeq(a, b, 0.1, 1.5));
+
+    Line<double> c{{0, 50}, {400, 50}, {400, 400}};
+    TEST(!geo::frechetDistLeq(a, c, 0.1, 10));
+  }
+
   // ___________________________________________________________________________
   {
     Line<double> a;
@@ -3,6 +3,7 @@
 // Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
 
 #include <algorithm>
+#include <cstring>
 #include <map>
 #include <ostream>
 #include <stack>
@@ -38,17 +39,25 @@ void XmlWriter::openTag(const string& tag, const map<string, string>& attrs) {
   closeHanging();
   doIndent();
 
-  *_out << "<" << tag;
+  put('<');
+  put(tag);
 
-  for (auto kv : attrs) {
-    *_out << " ";
-    putEsced(_out, kv.first, '"');
-    *_out << "=\"";
-    putEsced(_out, kv.second, '"');
-    *_out << "\"";
+  _nstack.push(XmlNode(TAG, tag, true));
+
+  for (const auto& kv : attrs) attr(kv.first, kv.second);
+}
+
+// _____________________________________________________________________________
+void XmlWriter::attr(const string& key, const string& val) {
+  if (_nstack.empty() || _nstack.top().t != TAG || !_nstack.top().hanging) {
+    throw XmlWriterException("Attributes only allowed in opened tags.");
   }
 
-  _nstack.push(XmlNode(TAG, tag, true));
+  put(' ');
+  putEsced(key, '"');
+  put("=\"", 2);
+  putEsced(val, '"');
+  put('"');
 }
 
 // _____________________________________________________________________________
@@ -71,7 +80,7 @@ void XmlWriter::openComment() {
   closeHanging();
   doIndent();
 
-  *_out << "<!-- ";
+  put("<!-- ", 5);
 
   _nstack.push(XmlNode(COMMENT, "", false));
 }
@@ -83,7 +92,7 @@ void XmlWriter::writeText(const string& text) {
   }
   closeHanging();
   doIndent();
-  putEsced(_out, text, ' ');
+  putEsced(text, ' ');
 }
 
 // _____________________________________________________________________________
@@ -95,16 +104,18 @@ void XmlWriter::closeTag() {
   if (_nstack.top().t == COMMENT) {
     _nstack.pop();
     doIndent();
-    *_out << " -->";
+    put(" -->", 4);
   } else if (_nstack.top().t == TAG) {
     if (_nstack.top().hanging) {
-      *_out << " />";
+      put(" />", 3);
       _nstack.pop();
     } else {
       string tag = _nstack.top().pload;
       _nstack.pop();
       doIndent();
-      *_out << "</" << tag << ">";
+      put("</", 2);
+      put(tag);
+      put('>');
     }
   }
 }
@@ -112,13 +123,33 @@ void XmlWriter::closeTag() {
 // _____________________________________________________________________________
 void XmlWriter::closeTags() {
   while (!_nstack.empty()) closeTag();
+  flush();
+}
+
+// _____________________________________________________________________________
+void XmlWriter::flush() {
+  if (_buf.empty()) return;
+  _out->write(_buf.data(), _buf.size());
+  _buf.clear();
 }
 
+// _____________________________________________________________________________
+void XmlWriter::put(const char* str, size_t n) {
+  _buf.append(str, n);
+  if (_buf.size() >= (1 << 16)) flush();
+}
+
+// _____________________________________________________________________________
+void XmlWriter::put(const string& str) { put(str.data(), str.size()); }
+
+// _____________________________________________________________________________
+void XmlWriter::put(char c) { put(&c, 1); }
+
 // _____________________________________________________________________________
 void XmlWriter::doIndent() {
   if (_pretty) {
-    *_out << std::endl;
-    for (size_t i = 0; i < _nstack.size() * _indent; i++) *_out << " ";
+    put('\n');
+    _buf.append(_nstack.size() * _indent, ' ');
   }
 }
 
@@ -127,7 +158,7 @@ void XmlWriter::closeHanging() {
   if (_nstack.empty()) return;
 
   if (_nstack.top().hanging) {
-    *_out << ">";
+    put('>');
     _nstack.top().hanging = false;
   } else if (_nstack.top().t == TEXT) {
     _nstack.pop();
@@ -135,26 +166,34 @@ void XmlWriter::closeHanging() {
 }
 
 // _____________________________________________________________________________
-void XmlWriter::putEsced(ostream* out, const string& str, char quot) {
+void XmlWriter::putEsced(const string& str, char quot) {
   if (!_nstack.empty() && _nstack.top().t == COMMENT) {
-    *out << str;
+    put(str);
     return;
   }
 
-  for (const char& c : str) {
+  // copy runs of chars which need no escaping at once
+  size_t start = 0;
+  for (size_t i = 0; i < str.size(); i++) {
+    const char* esc = 0;
+    char c = str[i];
     if (quot == '"' && c == '"')
-      *out << "&quot;";
+      esc = "&quot;";
     else if (quot == '\'' && c == '\'')
-      *out << "&apos;";
+      esc = "&apos;";
     else if (c == '<')
-      *out << "&lt;";
+      esc = "&lt;";
     else if (c == '>')
-      *out << "&gt;";
+      esc = "&gt;";
     else if (c == '&')
-      *out << "&amp;";
-    else
-      *out << c;
+      esc = "&amp;";
+
+    if (!esc) continue;
+    put(str.data() + start, i - start);
+    put(esc, strlen(esc));
+    start = i + 1;
   }
+  put(str.data() + start, str.size() - start);
 }
 
 // _____________________________________________________________________________
@@ -30,7 +30,7 @@ class XmlWriter {
   explicit XmlWriter(std::ostream* out);
   XmlWriter(std::ostream* out, bool pretty);
   XmlWriter(std::ostream* out, bool pretty, size_t indent);
-  ~XmlWriter(){};
+  ~XmlWriter() { flush(); };
 
   // open tag without attributes
   void openTag(const std::string& tag);
@@ -43,6 +43,9 @@ class XmlWriter {
   void openTag(const std::string& tag,
                const std::map<std::string, std::string>& attrs);
 
+  // add an attribute to the tag opened last, before any content is written
+  void attr(const std::string& key, const std::string& val);
+
   // open comment
   void openComment();
 
@@ -55,6 +58,10 @@ class XmlWriter {
   // close all open tags, essentially closing the document
   void closeTags();
 
+  // write the buffered output to the stream, done automatically by
+  // closeTags() and on destruction
+  void flush();
+
  private:
   enum XML_NODE_T { TAG, TEXT, COMMENT };
 
@@ -69,6 +76,9 @@ class XmlWriter {
   std::ostream* _out;
   std::stack<XmlNode> _nstack;
 
+  // output is collected here and written to _out in large chunks
+  std::string _buf;
+
   bool _pretty;
   size_t _indent;
 
@@ -78,8 +88,12 @@ class XmlWriter {
   // close "hanging" tags
   void closeHanging();
 
-  // pushes XML escaped text to stream
-  void putEsced(std::ostream* out, const std::string& str, char quot);
+  // pushes XML escaped text to the output
+  void putEsced(const std::string& str, char quot);
+
+  void put(const char* str, size_t n);
+  void put(const std::string& str);
+  void put(char c);
 
   // checks tag names for validiy
   void checkTagName(const std::string& str) const;